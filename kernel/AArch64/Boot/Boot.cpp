@@ -4,6 +4,7 @@
 #include "../../PointerTypes.h"
 #include "ExceptionLevel.h"
 #include "MMU.h"
+#include "SMP.h"
 
 extern "C"
 {
@@ -38,18 +39,64 @@ extern "C"
             : "x0" // bashed registers
         );
 
-        // Adjust the stack pointer by KernalVirtualAddressStart so it points into kernel space
+        // Adjust the stack pointer by KernalVirtualAddressStart so it points into kernel space. The frame pointer has
+        // to move with it, since locals may be addressed through it, and the identity mapping is about to go
         // NOLINTNEXTLINE(hicpp-no-assembler)
         asm volatile(
             "mov x0, %[base] \n"
             "add sp, sp, x0 \n"
+            "add x29, x29, x0 \n"
             : // no outputs
             : [base] "r"(MemoryManager::KernelVirtualAddressOffset)
             : "x0" // bashed registers
         );
 
-        // #TODO: Unmap identity mapping
+        // The secondary cores need the identity mapping to turn their MMUs on, so they have to be started before it goes
+        AArch64::Boot::StartSecondaryCores();
 
-        Kernel::kmain(PhysicalPtr{ aDTBPointer }, aX1Reserved, aX2Reserved, aX3Reserved, PhysicalPtr{ aStartPointer });
+        // Nothing refers to the physical addresses any more, so the identity mapping can go
+        auto const bootTablesEnd = AArch64::Boot::RemoveIdentityMapping();
+
+        Kernel::kmain(PhysicalPtr{ aDTBPointer }, aX1Reserved, aX2Reserved, aX3Reserved, PhysicalPtr{ aStartPointer }, bootTablesEnd);
+    }
+
+    /**
+     * Called from assembly when a secondary core is released by StartSecondaryCores, to bring it to the same state
+     * boot_kernel brings the boot core to, and then jumps into SecondaryMain.
+     * 
+     * @param aCore The index of the core
+     */
+    void boot_secondary(uint64_t const aCore)
+    {
+        AArch64::Boot::SwitchToEL1();
+        // The boot core has already created the page tables, so we just need to turn them on
+        AArch64::Boot::EnableMMU();
+
+        // Move to the kernel address space the same way boot_kernel does. These can't be shared with boot_kernel
+        // through a function, as returning would take us back to the physical address we were called from
+
+        // NOLINTNEXTLINE(hicpp-no-assembler)
+        asm volatile(
+            "ldr x0, =1f \n"
+            "br x0 \n"
+            "1: \n"
+            : // no outputs
+            : // no inputs
+            : "x0" // bashed registers
+        );
+
+        // NOLINTNEXTLINE(hicpp-no-assembler)
+        asm volatile(
+            "mov x0, %[base] \n"
+            "add sp, sp, x0 \n"
+            "add x29, x29, x0 \n"
+            : // no outputs
+            : [base] "r"(MemoryManager::KernelVirtualAddressOffset)
+            : "x0" // bashed registers
+        );
+
+        AArch64::Boot::SecondaryCoreStarted();
+
+        Kernel::SecondaryMain(static_cast<uint32_t>(aCore));
     }
 }
\ No newline at end of file
@@ -60,6 +60,12 @@ namespace AArch64::Boot
             HSTR_EL2 const hstr_el2;
             HSTR_EL2::Write(hstr_el2);
 
+            // The scheduler ticks off each core's physical timer, which EL1 can only get at if EL2 lets it
+            CNTHCTL_EL2 cnthctl_el2;
+            cnthctl_el2.EL1PCTEN(true);
+            cnthctl_el2.EL1PCEN(true);
+            CNTHCTL_EL2::Write(cnthctl_el2);
+
             CPU::SwitchFromEL2ToEL1();
         }
     }
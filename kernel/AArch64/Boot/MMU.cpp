@@ -4,12 +4,15 @@
 #include <bit>
 #include <cstdint>
 #include <cstring>
+#include "../../ASIDAllocator.h"
 #include "../../MemoryManager.h"
 #include "../../PointerTypes.h"
 #include "../../Utils.h"
 #include "../MemoryDescriptor.h"
 #include "../MemoryPageTables.h"
+#include "../PageTableRanges.h"
 #include "../SystemRegisters.h"
+#include "../TLB.h"
 #include "MMU.h"
 #include "Output.h"
 
@@ -157,71 +160,61 @@ namespace AArch64::Boot
         };
 
         /**
-         * Gets or inserts a page table descriptor into the view for the given virtual address
-         * 
-         * @param arAllocator Allocator to use for getting new pages
-         * @param aTableView The table to check for the descriptor, or to insert a new descriptor into
-         * @param aVirtualAddress The virtual address the table will cover
+         * Gives the page table operations access to the boot tables, which are used before the MMU is on
          */
-        template<class ChildTableT, class PageTableT>
-        ChildTableT GetOrInsertPageDescriptor(PageBumpAllocator& arAllocator, PageTableT const aTableView,
-            VirtualPtr const aVirtualAddress)
+        class BootTables
         {
-            auto const entry = aTableView.GetEntryForVA(aVirtualAddress);
-            Descriptor::Table descriptor;
-            entry.Visit(Overloaded{
-                [&descriptor, &arAllocator, &aTableView, aVirtualAddress](Descriptor::Fault)
-                {
-                    descriptor.Address(arAllocator.Allocate());
-                    aTableView.SetEntryForVA(aVirtualAddress, descriptor);
-                },
-                [&descriptor](Descriptor::Table aTable)
-                {
-                    descriptor = aTable;
-                },
-                [](Descriptor::L1Block)
-                {
-                    Panic("Should not have level 1 blocks in boot tables");
-                },
-                [](Descriptor::L2Block)
-                {
-                    Panic("Should not have level 2 blocks in boot tables");
-                }
-            });
-
-            // no MMU, so physical address is the pointer
-            return ChildTableT{ std::bit_cast<uint64_t*>( descriptor.Address().GetAddress() ) };
-        }
+        public:
+            /**
+             * Sets up access to the tables
+             * 
+             * @param arAllocator Allocator to use for getting new tables
+             */
+            explicit BootTables(PageBumpAllocator& arAllocator)
+                : Allocator{ arAllocator }
+            {}
 
-        /**
-         * Inserts all the required data into the page tables for a level 3 table (which points at 4kb pages)
-         * covering the given virtual address.
-         * 
-         * @param arAllocator The allocator to use for getting new pages
-         * @param aRootPage The root level 0 table
-         * @param aVirtualAddress The virtual address we want to map and need a table for
-         * 
-         * @return The level 3 table covering the given virtual address (making it if necessary)
-         */
-        PageTable::Level3View InsertPageTable(PageBumpAllocator& arAllocator, PageTable::Level0View const aRootPage, VirtualPtr const aVirtualAddress)
-        {
-            // #TODO: We're assuming level 1 and 2 tables only contain pages and not blocks, which is going to be
-            // the case for how our code is currently written. Would be safer to have code that can handle the type
-            // of descriptor based on which table is being read.
+            /**
+             * Allocates a new table
+             * 
+             * @return The new table, zeroed out
+             */
+            PhysicalPtr AllocateTable()
+            {
+                return Allocator.Allocate();
+            }
 
-            // Level 0 table points to level 1 table (512GB range)
-            auto const level1Table = GetOrInsertPageDescriptor<PageTable::Level1View>(arAllocator, aRootPage, aVirtualAddress);
+            /**
+             * Converts a table's physical address into a pointer
+             * 
+             * @param aTable The table's physical address
+             * @return The pointer to the table
+             */
+            static uint64_t* GetTablePointer(PhysicalPtr const aTable)
+            {
+                // no MMU, so physical address is the pointer
+                return std::bit_cast<uint64_t*>(aTable.GetAddress());
+            }
 
-            // Level 1 table points to level 2 table (1GB range)
-            auto const level2Table = GetOrInsertPageDescriptor<PageTable::Level2View>(arAllocator, level1Table, aVirtualAddress);
+            /**
+             * Invalidates the cached translations for a run of pages
+             * 
+             * @param aStart The virtual address of the first page
+             * @param aSize The size of the run in bytes
+             */
+            static void InvalidateRun(VirtualPtr const /*aStart*/, size_t const /*aSize*/)
+            {
+                // the MMU isn't on yet, so nothing has been cached
+            }
 
-            // Level 2 table points to level 3 table (2MB range)
-            return GetOrInsertPageDescriptor<PageTable::Level3View>(arAllocator, level2Table, aVirtualAddress);
-        }
+        private:
+            PageBumpAllocator& Allocator;
+        };
 
         /**
          * Inserts entries into the page table to map the given virtual address to the memory block starting at the
-         * given physical address, with the given flags.
+         * given physical address, with the given flags. Uses 1GB and 2MB blocks wherever the range allows it, to keep
+         * the number of tables (and TLB entries) down
          * 
          * @param arAllocator Allocator for memory pages
          * @param aRootPage The root page table
@@ -229,44 +222,48 @@ namespace AArch64::Boot
          * @param aVAEnd The end of the virtual address range to map
          * @param aPhysicalAddress The physical address to map to
          * @param aMAIRIndex The index into the MAIR register for the attributes for this memory
+         * @param aGlobal Whether the mapping is visible in every address space, or only the kernel's ASID
          */
         void InsertEntriesForMemoryRange(PageBumpAllocator& arAllocator, PageTable::Level0View const aRootPage,
             InclusiveMemoryRange<VirtualPtr> const aVARange, PhysicalPtr const aPhysicalAddress,
-            uint8_t const aMAIRIndex)
+            uint8_t const aMAIRIndex, bool const aGlobal)
         {
-            auto curPA = aPhysicalAddress;
-            for (auto curVA = aVARange.Begin; curVA < aVARange.End;)
+            Descriptor::Page pageEntry;
+            pageEntry.AF(true); // don't fault when accessed
+            pageEntry.AP(Descriptor::Page::AccessPermissions::KernelRWUserNone); // only kernel can access
+            pageEntry.AttrIndx(aMAIRIndex);
+            pageEntry.SH(Descriptor::Page::Shareability::InnerShareable); // ignored for device memory
+            pageEntry.nG(!aGlobal);
+
+            // the range end is inclusive, and may not be on a page boundary
+            auto const size = MemoryManager::CalculateBlockStart(aVARange.End.GetAddress() - aVARange.Begin.GetAddress() + MemoryManager::PageSize, MemoryManager::PageSize);
+            BootTables tables{ arAllocator };
+            if (!PageTable::MapRangeWithBlocks(aRootPage, aVARange.Begin, size, aPhysicalAddress, pageEntry, tables))
             {
-                // Level 3 table points to 4kb blocks
-                auto const level3Table = InsertPageTable(arAllocator, aRootPage, curVA);
-
-                Descriptor::Page pageEntry;
-                pageEntry.Address(curPA);
-                pageEntry.AF(true); // don't fault when accessed
-                pageEntry.AP(Descriptor::Page::AccessPermissions::KernelRWUserNone); // only kernel can access
-                pageEntry.AttrIndx(aMAIRIndex);
-
-                level3Table.SetEntryForVA(curVA, pageEntry);
-
-                curVA = curVA.Offset(MemoryManager::PageSize);
-                curPA = curPA.Offset(MemoryManager::PageSize);
+                Panic("Unable to map boot memory range");
             }
         }
 
         /**
-         * Sets the page table registers to the given table
+         * Sets the page table registers to the given tables
          * 
-         * @param aTable The table to use
+         * @param aIdentityTable The table to use for the low half, which identity maps the kernel while the MMU is
+         * turned on
+         * @param aKernelTable The table to use for the high half
          */
-        void SwitchToPageTable(PhysicalPtr const aTable)
+        void SwitchToPageTables(PhysicalPtr const aIdentityTable, PhysicalPtr const aKernelTable)
         {
             // the apTable pointer gets the top 16 bits masked out (because it becomes the ASID), so we don't have
             // to do any adjustment to it to account for it being on a virtual kernel address
             // #TODO: In theory, but the debugger shows it at the physical address for an unknown reason.
-            TTBRn_EL1 ttbrn_el1;
-            ttbrn_el1.BADDR(aTable);
-            TTBRn_EL1::Write0(ttbrn_el1); // table for user space (0x0000'0000'0000'0000 - 0x0000'FFFF'FFFF'FFFF)
-            TTBRn_EL1::Write1(ttbrn_el1); // table for kernel space (0xFFFF'0000'0000'0000 - 0xFFFF'FFFF'FFFF'FFFF)
+            TTBRn_EL1 ttbr0_el1;
+            ttbr0_el1.BADDR(aIdentityTable);
+            ttbr0_el1.ASID(MemoryManager::KernelASID);
+            TTBRn_EL1::Write0(ttbr0_el1); // table for user space (0x0000'0000'0000'0000 - 0x0000'FFFF'FFFF'FFFF)
+
+            TTBRn_EL1 ttbr1_el1;
+            ttbr1_el1.BADDR(aKernelTable);
+            TTBRn_EL1::Write1(ttbr1_el1); // table for kernel space (0xFFFF'0000'0000'0000 - 0xFFFF'FFFF'FFFF'FFFF)
         }
     }
 
@@ -280,10 +277,10 @@ namespace AArch64::Boot
         // they need based on device tree information
         auto const deviceBasePA = MemoryManager::DeviceBaseAddress;
         auto const deviceEndPA = deviceBasePA.Offset(0x00FF'FFFF);
+        auto const localDeviceBasePA = MemoryManager::LocalDeviceBaseAddress;
+        auto const localDeviceEndPA = localDeviceBasePA.Offset(0x0000'00FF);
 
-        // Calculate the range of the kernel image in L2 block size
-        // #TODO: Originally this was done so we didn't have to set up 4k pages and could instead use 2MB blocks,
-        // but it may not make sense anymore, especially since we later want to flag certain areas as read-only
+        // Calculate the range of the kernel image in L2 block size, so the identity mapping is a single block
         // #TODO: Why are these symbols from the linker script pointing at physical addresses? (PC-relative apparently)
         auto const kernelBasePA = MemoryManager::CalculateBlockStart(PhysicalPtr{ std::bit_cast<uintptr_t>(&_kernel_image) }, MemoryManager::L2BlockSize);
         auto const kernelEndPA = MemoryManager::CalculateBlockEnd(PhysicalPtr{ std::bit_cast<uintptr_t>(&_kernel_image_end) }, MemoryManager::L2BlockSize);
@@ -294,39 +291,41 @@ namespace AArch64::Boot
             return VirtualPtr{ aPA.GetAddress() }.Offset(MemoryManager::KernelVirtualAddressOffset);
         };
 
-        auto const kernelRangeVA = InclusiveMemoryRange{ toVAOffsetMapping(kernelBasePA), toVAOffsetMapping(kernelEndPA) };
-        auto const deviceRangeVA = InclusiveMemoryRange{ toVAOffsetMapping(deviceBasePA), toVAOffsetMapping(deviceEndPA) };
-
         // physical addresses that the allocator returns are pointers since we have no MMU at this point
-        auto const rootPage = PageTable::Level0View{ std::bit_cast<uint64_t*>(allocator.Allocate().GetAddress()) };
+        // IMPORTANT: EnableMMU expects these to be the first two pages allocated
+        auto const identityRootPage = PageTable::Level0View{ std::bit_cast<uint64_t*>(allocator.Allocate().GetAddress()) };
+        auto const kernelRootPage = PageTable::Level0View{ std::bit_cast<uint64_t*>(allocator.Allocate().GetAddress()) };
+
+        // Map all of RAM (which includes the kernel image) and the devices into high memory. Everything is block
+        // aligned, so this ends up as 2MB blocks in a single level 2 table. The ARM local peripherals sit just past the
+        // first 1GB and only need a page, so they get their own small tables
+        // #TODO: Should scan the list of valid addresses from the device tree rather than assuming everything below
+        // the devices is RAM
+        auto const memoryEndPA = PhysicalPtr{ deviceBasePA.GetAddress() - 1 };
+        InsertEntriesForMemoryRange(allocator, kernelRootPage, InclusiveMemoryRange{ toVAOffsetMapping(PhysicalPtr{}), toVAOffsetMapping(memoryEndPA) }, PhysicalPtr{}, MemoryManager::NormalMAIRIndex, true /*global*/);
+        InsertEntriesForMemoryRange(allocator, kernelRootPage, InclusiveMemoryRange{ toVAOffsetMapping(deviceBasePA), toVAOffsetMapping(deviceEndPA) }, deviceBasePA, MemoryManager::DeviceMAIRIndex, true /*global*/);
+        InsertEntriesForMemoryRange(allocator, kernelRootPage, InclusiveMemoryRange{ toVAOffsetMapping(localDeviceBasePA), toVAOffsetMapping(localDeviceEndPA) }, localDeviceBasePA, MemoryManager::DeviceMAIRIndex, true /*global*/);
 
         // Identity mappings - so we don't break immediately when turning the MMU on (since the stack and IP will
-        // be pointing at the physical addresses)
-        InsertEntriesForMemoryRange(allocator, rootPage, InclusiveMemoryRange{ VirtualPtr{ kernelBasePA.GetAddress() }, VirtualPtr{ kernelEndPA.GetAddress() } }, kernelBasePA, MemoryManager::NormalMAIRIndex);
-        InsertEntriesForMemoryRange(allocator, rootPage, InclusiveMemoryRange{ VirtualPtr{ deviceBasePA.GetAddress() }, VirtualPtr{ deviceEndPA.GetAddress() } }, deviceBasePA, MemoryManager::DeviceMAIRIndex);
-
-        // Now map the kernel and devices into high memory
-        InsertEntriesForMemoryRange(allocator, rootPage, kernelRangeVA, kernelBasePA, MemoryManager::NormalMAIRIndex);
-        InsertEntriesForMemoryRange(allocator, rootPage, deviceRangeVA, deviceBasePA, MemoryManager::DeviceMAIRIndex);
-
-        // Map everything between the kernel range and device range for now
-        // #TODO: Should be able to remove this once the memory manager can scan the list of valid addresses from
-        // the device tree and map all physical memory into kernel space. Without this, any attempt to allocate
-        // pages in MemoryManager.cpp would fail because the memory the page is taken from wouldn't be mapped into
-        // kernel space
-        auto const extraRangeVA = InclusiveMemoryRange{ kernelRangeVA.End.Offset(1), VirtualPtr{ deviceRangeVA.Begin.GetAddress() - 1 } };
-        auto const startOfExtraPA = kernelEndPA.Offset(1);
-        InsertEntriesForMemoryRange(allocator, rootPage, extraRangeVA, startOfExtraPA, MemoryManager::NormalMAIRIndex);
+        // be pointing at the physical addresses). These live in the user half, so they're tagged with the kernel ASID
+        // to keep them from matching user addresses once a user task's tables are active
+        // IMPORTANT: RemoveIdentityMapping expects these tables to be allocated last, so they can be freed with the
+        // rest of the unused space
+        InsertEntriesForMemoryRange(allocator, identityRootPage, InclusiveMemoryRange{ VirtualPtr{ kernelBasePA.GetAddress() }, VirtualPtr{ kernelEndPA.GetAddress() } }, kernelBasePA, MemoryManager::NormalMAIRIndex, false /*global*/);
+        InsertEntriesForMemoryRange(allocator, identityRootPage, InclusiveMemoryRange{ VirtualPtr{ deviceBasePA.GetAddress() }, VirtualPtr{ deviceEndPA.GetAddress() } }, deviceBasePA, MemoryManager::DeviceMAIRIndex, false /*global*/);
     }
 
     void EnableMMU()
     {
+        // CreatePageTables allocates the identity root first, followed by the kernel root
         // #TODO: Linker seems to be using PC-relative addresses for these, why?
-        SwitchToPageTable(PhysicalPtr{ std::bit_cast<uintptr_t>(&_pg_dir) });
+        auto const identityRoot = PhysicalPtr{ std::bit_cast<uintptr_t>(&_pg_dir) };
+        SwitchToPageTables(identityRoot, identityRoot.Offset(MemoryManager::PageSize));
 
         MAIR_EL1 mair_el1;
         mair_el1.SetAttribute(MemoryManager::DeviceMAIRIndex, MAIR_EL1::Attribute::DeviceMemory());
-        mair_el1.SetAttribute(MemoryManager::NormalMAIRIndex, MAIR_EL1::Attribute::NormalMemory());
+        mair_el1.SetAttribute(MemoryManager::NormalMAIRIndex, MAIR_EL1::Attribute::NormalCacheableMemory());
+        mair_el1.SetAttribute(MemoryManager::NormalNonCacheableMAIRIndex, MAIR_EL1::Attribute::NormalMemory());
         MAIR_EL1::Write(mair_el1);
 
         // IMPORTANT: Do not change granule size or address bits, because we have a lot of constants that depend on
@@ -345,17 +344,69 @@ namespace AArch64::Boot
         // kernel space will have 48 bits of address space, with 4kb granule
         tcr_el1.T1SZ(LowAddressBits);
         tcr_el1.TG1(TCR_EL1::T1Granule::Size4kb);
+        // table walks go through the caches, so page table writes only need a barrier to be seen by the walker,
+        // rather than having to be cleaned out to memory
+        tcr_el1.IRGN0(TCR_EL1::Cacheability::WriteBackWriteAllocate);
+        tcr_el1.ORGN0(TCR_EL1::Cacheability::WriteBackWriteAllocate);
+        tcr_el1.SH0(TCR_EL1::Shareability::InnerShareable);
+        tcr_el1.IRGN1(TCR_EL1::Cacheability::WriteBackWriteAllocate);
+        tcr_el1.ORGN1(TCR_EL1::Cacheability::WriteBackWriteAllocate);
+        tcr_el1.SH1(TCR_EL1::Shareability::InnerShareable);
+        // ASIDs come from TTBR0 (A1 left clear), and use all 16 bits if the hardware has them
+        tcr_el1.AS(ID_AA64MMFR0_EL1::Read().ASIDBits() == ID_AA64MMFR0_EL1::ASIDSize::Bits16);
         
         TCR_EL1::Write(tcr_el1);
 
+        // Throw away anything the firmware may have left in the instruction cache or TLB, since neither is
+        // guaranteed to match what we're about to turn on
+        // NOLINTNEXTLINE(hicpp-no-assembler)
+        asm volatile(
+            "ic iallu\n"       // invalidate all instruction caches to the point of unification
+            "tlbi vmalle1\n"   // invalidate all stage 1 EL1 translations
+            : // no outputs
+            : // no inputs
+            : // no bashed registers
+        );
+
         // Make sure the above changes are seen before enabling the MMU
         InstructionBarrier();
 
         auto sctlr_el1 = SCTLR_EL1::Read();
         sctlr_el1.M(true); // enable MMU
+        sctlr_el1.C(true); // enable data caches
+        sctlr_el1.I(true); // enable instruction caches
         SCTLR_EL1::Write(sctlr_el1);
 
         // Make sure the MMU being enabled is seen by anything following this function
         InstructionBarrier();
     }
+
+    PhysicalPtr RemoveIdentityMapping()
+    {
+        // We're in the high half now, so the linker symbols are kernel virtual addresses
+        auto const identityRoot = PageTable::Level0View{ std::bit_cast<uint64_t*>(&_pg_dir) };
+
+        // The identity tables were allocated after everything else, so the first of them marks the end of the tables
+        // still in use
+        auto bootTablesEnd = PhysicalPtr{ std::bit_cast<uintptr_t>(&_pg_dir_end) - MemoryManager::KernelVirtualAddressOffset };
+        for (auto curEntry = 0U; curEntry < PageTable::PointersPerTable; ++curEntry)
+        {
+            auto const entryAddress = VirtualPtr{ curEntry * PageTable::Details::Level0EntrySpanC };
+            identityRoot.GetEntryForVA(entryAddress).Visit(Overloaded{
+                [&bootTablesEnd](Descriptor::Table const aTableDescriptor)
+                {
+                    bootTablesEnd = (aTableDescriptor.Address() < bootTablesEnd) ? aTableDescriptor.Address() : bootTablesEnd;
+                },
+                [](auto)
+                {
+                    // nothing else lives in the root
+                }
+            });
+            identityRoot.SetEntryForVA(entryAddress, Descriptor::Fault{});
+        }
+
+        // The identity mapping is tagged with the kernel ASID, while the high half is global and so isn't affected
+        TLB::InvalidateASID(MemoryManager::KernelASID);
+        return bootTablesEnd;
+    }
 }
\ No newline at end of file
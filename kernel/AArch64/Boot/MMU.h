@@ -1,6 +1,8 @@
 #ifndef KERNEL_AARCH64_BOOT_MMU_H
 #define KERNEL_AARCH64_BOOT_MMU_H
 
+#include "../../PointerTypes.h"
+
 namespace AArch64::Boot
 {
     /**
@@ -13,7 +15,15 @@ namespace AArch64::Boot
      */
     void EnableMMU();
 
-    // #TODO: Going to want to have a way to unmap the identity mapping once we no longer need it
+    /**
+     * Removes the identity mapping used to turn the MMU on. Must only be called once we're running from (and our
+     * stack is in) the kernel's high half. TTBR0 is left pointing at the emptied identity root table, which can be used
+     * by anything that doesn't have a user address space
+     * 
+     * @return Physical address past the last boot page table still in use - the rest of the boot page table space is
+     * free to be reused
+     */
+    [[nodiscard]] PhysicalPtr RemoveIdentityMapping();
 }
 
 #endif // KERNEL_AARCH64_BOOT_MMU_H
\ No newline at end of file
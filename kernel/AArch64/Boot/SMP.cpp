@@ -0,0 +1,60 @@
+#include "SMP.h"
+
+#include <bit>
+#include <cstdint>
+#include "../../MemoryManager.h"
+#include "../SchedulerDefines.h"
+
+extern "C"
+{
+    /**
+     * Where secondary cores start once they're released (Defined in Start.S)
+     */
+    extern void secondary_start();
+}
+
+namespace
+{
+    // Number of secondary cores that have made it to the high half
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+    uint32_t StartedSecondaryCores = 0;
+}
+
+namespace AArch64::Boot
+{
+    void StartSecondaryCores()
+    {
+        // The secondary cores start with the MMU off, so they need the physical address
+        auto const secondaryStartPA = std::bit_cast<uintptr_t>(&secondary_start) - MemoryManager::KernelVirtualAddressOffset;
+        for (auto curCore = 1U; curCore < CPU_COUNT; ++curCore)
+        {
+            // The spin table is in low memory, which is mapped into the high half like the rest of RAM
+            auto const slotAddress = SPIN_TABLE_ADDRESS + (curCore * sizeof(uint64_t)) + MemoryManager::KernelVirtualAddressOffset;
+            auto* const pslot = std::bit_cast<uint64_t*>(slotAddress);
+            *pslot = secondaryStartPA;
+            // The secondary cores read the slot with their caches off, so it has to be pushed out to memory
+            // NOLINTNEXTLINE(hicpp-no-assembler)
+            asm volatile("dc civac, %[slot]" : : [slot] "r"(pslot) : "memory");
+        }
+        // Wake the secondary cores once the slots have made it to memory
+        // NOLINTNEXTLINE(hicpp-no-assembler)
+        asm volatile(
+            "dsb sy\n"
+            "sev"
+            : // no outputs
+            : // no inputs
+            : "memory"
+        );
+
+        // A core that's still on its way up needs the identity mapping to turn its MMU on, so we can't carry on
+        // without it. Every core on the board is started, so they'll all turn up
+        while (__atomic_load_n(&StartedSecondaryCores, __ATOMIC_ACQUIRE) < (CPU_COUNT - 1))
+        {
+        }
+    }
+
+    void SecondaryCoreStarted()
+    {
+        __atomic_fetch_add(&StartedSecondaryCores, 1U, __ATOMIC_RELEASE);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,19 @@
+#ifndef KERNEL_AARCH64_BOOT_SMP_H
+#define KERNEL_AARCH64_BOOT_SMP_H
+
+namespace AArch64::Boot
+{
+    /**
+     * Releases the secondary cores from the firmware's spin table, and waits for all of them to make it to the
+     * kernel's high half. Must be called before the identity mapping is removed, since the secondary cores use it to
+     * turn on their MMUs
+     */
+    void StartSecondaryCores();
+
+    /**
+     * Called by each secondary core once it's running from the kernel's high half
+     */
+    void SecondaryCoreStarted();
+}
+
+#endif // KERNEL_AARCH64_BOOT_SMP_H
\ No newline at end of file
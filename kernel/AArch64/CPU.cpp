@@ -16,4 +16,16 @@ namespace AArch64::CPU
         exceptionLevel = (exceptionLevel >> 2U) & 0b11U;
         return static_cast<ExceptionLevel>(exceptionLevel);
     }
+
+    uint32_t GetCurrentCore()
+    {
+        uint64_t mpidr = 0;
+
+        // NOLINTNEXTLINE(hicpp-no-assembler)
+        asm volatile("mrs %[value], mpidr_el1" : [value] "=r"(mpidr));
+
+        // Affinity level 0 (the low byte) is the core within the cluster, and the Pi only has the one cluster
+        constexpr uint64_t Aff0Mask = 0xFF;
+        return static_cast<uint32_t>(mpidr & Aff0Mask);
+    }
 }
\ No newline at end of file
@@ -19,6 +19,14 @@ namespace AArch64::CPU
      * @return The current exception level
      */
     ExceptionLevel GetCurrentExceptionLevel();
+
+    /**
+     * Obtains the index of the core we're running on. Only stable while the caller can't be moved to another core
+     * (i.e. with preemption disabled)
+     * 
+     * @return The core index (0 to 3 on the Pi 3)
+     */
+    uint32_t GetCurrentCore();
 }
 
 #endif // KERNEL_AARCH64_CPU_H
\ No newline at end of file
@@ -57,6 +57,27 @@ namespace AArch64::Descriptor
         return ReadMultiBitValue<AccessPermissions>(DescriptorBits, APIndex_Mask, APIndex_Shift);
     }
 
+    void Page::SH(Shareability const aShareability)
+    {
+        WriteMultiBitValue(DescriptorBits, aShareability, SHIndex_Mask, SHIndex_Shift);
+    }
+
+    Page::Shareability Page::SH() const
+    {
+        return ReadMultiBitValue<Shareability>(DescriptorBits, SHIndex_Mask, SHIndex_Shift);
+    }
+
+    void Page::Software(uint8_t const aBits)
+    {
+        // #TODO: Range check aBits
+        WriteMultiBitValue(DescriptorBits, aBits, SoftwareIndex_Mask, SoftwareIndex_Shift);
+    }
+
+    uint8_t Page::Software() const
+    {
+        return ReadMultiBitValue<uint8_t>(DescriptorBits, SoftwareIndex_Mask, SoftwareIndex_Shift);
+    }
+
     void Page::Address(PhysicalPtr const aAddress)
     {
         // #TODO: Should probably range check address to make sure the mask doesn't pull off any bits
@@ -152,6 +152,33 @@ namespace AArch64
                     return ReadMultiBitValue<AccessPermissions>(DescriptorBits, APIndex_Mask, APIndex_Shift);
                 }
 
+                enum class Shareability: uint8_t
+                {
+                    NonShareable =      0b00,
+                    OuterShareable =    0b10,
+                    InnerShareable =    0b11,
+                };
+
+                /**
+                 * Sets the shareability for this block (ignored for device memory)
+                 * 
+                 * @param aShareability The block shareability
+                 */
+                void SH(Shareability const aShareability)
+                {
+                    WriteMultiBitValue(DescriptorBits, aShareability, SHIndex_Mask, SHIndex_Shift);
+                }
+
+                /**
+                 * Obtains the shareability for this block
+                 * 
+                 * @return The block shareability
+                 */
+                [[nodiscard]] Shareability SH() const
+                {
+                    return ReadMultiBitValue<Shareability>(DescriptorBits, SHIndex_Mask, SHIndex_Shift);
+                }
+
                 /**
                  * AF Bit - Access flag
                  * 
@@ -167,6 +194,57 @@ namespace AArch64
                  */
                 [[nodiscard]] bool AF() const { return DescriptorBits[AFIndex]; }
 
+                /**
+                 * nG Bit - Not global
+                 * 
+                 * @param aNotGlobal If true, TLB entries for this block are tagged with the current ASID and only match
+                 * while that ASID is active, otherwise they match in every address space
+                 */
+                void nG(bool const aNotGlobal) { DescriptorBits[nGIndex] = aNotGlobal; }
+
+                /**
+                 * nG Bit - Not global
+                 * 
+                 * @return True if the block belongs to a single address space
+                 */
+                [[nodiscard]] bool nG() const { return DescriptorBits[nGIndex]; }
+
+                /**
+                 * Contiguous Bit - Contiguous hint
+                 * 
+                 * @param aContiguous If true, this block is one of 16 adjacent blocks that map contiguous memory with
+                 * the same attributes, and the TLB may cache them as a single entry
+                 */
+                void Contiguous(bool const aContiguous) { DescriptorBits[ContiguousIndex] = aContiguous; }
+
+                /**
+                 * Contiguous Bit - Contiguous hint
+                 * 
+                 * @return True if the block is part of a contiguous run
+                 */
+                [[nodiscard]] bool Contiguous() const { return DescriptorBits[ContiguousIndex]; }
+
+                /**
+                 * Sets the bits reserved for software use, which the hardware ignores
+                 * 
+                 * @param aBits The software bits (only the low 4 bits are used)
+                 */
+                void Software(uint8_t const aBits)
+                {
+                    // #TODO: Range check aBits
+                    WriteMultiBitValue(DescriptorBits, aBits, SoftwareIndex_Mask, SoftwareIndex_Shift);
+                }
+
+                /**
+                 * Obtains the bits reserved for software use
+                 * 
+                 * @return The software bits
+                 */
+                [[nodiscard]] uint8_t Software() const
+                {
+                    return ReadMultiBitValue<uint8_t>(DescriptorBits, SoftwareIndex_Mask, SoftwareIndex_Shift);
+                }
+
                 /**
                  * Sets the block address this entry points at
                  * 
@@ -206,9 +284,10 @@ namespace AArch64
                 // NS           [5]
                 static constexpr unsigned APIndex_Shift = 6; // bits [7:6]
                 static constexpr uint64_t APIndex_Mask = 0b11;
-                // SH[1:0]      [9:8]
+                static constexpr unsigned SHIndex_Shift = 8; // bits [9:8]
+                static constexpr uint64_t SHIndex_Mask = 0b11;
                 static constexpr unsigned AFIndex = 10;
-                // NSE/nG       [11]
+                static constexpr unsigned nGIndex = 11;
                 // Reserved     [15:12] (Res0)
                 // nT           [16]    (Res0 if FEAT_BBM is not implemented)
                 // Reserved     [n:17]  (Res0) L1 n = 29, L2 n = 20
@@ -216,10 +295,11 @@ namespace AArch64
                 // Reserved     [49:48] (Res0)
                 // GP           [50]    (Res0 if FEAT_BTI not implemented)
                 // DBM          [51]    (Res0 if FEAT_HAFDBS not implemented)
-                // Contiguous   [52]
+                static constexpr unsigned ContiguousIndex = 52;
                 // PXN          [53]
                 // UXN/XN       [54]
-                // Ignored      [58:55] (Reserved for software use)
+                static constexpr unsigned SoftwareIndex_Shift = 55; // bits [58:55] (Reserved for software use)
+                static constexpr uint64_t SoftwareIndex_Mask = 0b1111;
                 // PBHA         [62:59] (Ignored if FEAT_HPDS2 not implemented)
                 // Ignored      [63]
                 static constexpr size_t BitCount = 64;
@@ -241,12 +321,43 @@ namespace AArch64
             */
             Fault() = default;
 
+            /**
+             * Constructor for a fault descriptor carrying a value of our own in the bits the MMU ignores
+             * 
+             * @param aValue The value to carry (the type bits are cleared)
+            */
+            explicit Fault(uint64_t const aValue)
+                : DescriptorBits{ aValue & ~Details::TypeMask }
+            {}
+
             /**
              * Constructor from a specific value
              * 
              * @param aValue The value to construct from
             */
-            Fault(uint64_t /*aValue*/, Details::ValueConstructTag /* aTag */) {}
+            Fault(uint64_t const aValue, Details::ValueConstructTag /* aTag */)
+                : DescriptorBits{ aValue }
+            {}
+
+            /**
+             * Obtains the value carried in the descriptor
+             * 
+             * @return The descriptor's bits (0 for a plain fault)
+            */
+            [[nodiscard]] uint64_t Value() const { return DescriptorBits; }
+
+            /**
+             * Writes the given entry to the table
+             * 
+             * @param aValue The entry to write
+             * @param apTable The table to write to
+             * @param aIndex The index in the table to write to
+             */
+            static void Write(Fault const aValue, uint64_t apTable[], size_t const aIndex) // NOLINT(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+            {
+                // #TODO: Range-check index with pointers per table - or make an array view type
+                apTable[aIndex] = aValue.DescriptorBits; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            }
 
             /**
              * Checks to see if the value represents a descriptor of this type
@@ -261,9 +372,9 @@ namespace AArch64
             }
 
         private:
-            // We don't actually use these bits directly (and a faulting descriptor is represented by any value with
-            // the low bit zeroed, but this gives us an easy one)
-            uint64_t DescriptorBits [[maybe_unused]] = 0;
+            // A faulting descriptor is represented by any value with the low bit zeroed, so the rest is free for the
+            // OS to keep track of unmapped memory with
+            uint64_t DescriptorBits = 0;
         };
 
         /**
@@ -439,6 +550,27 @@ namespace AArch64
              */
             [[nodiscard]] AccessPermissions AP() const;
 
+            enum class Shareability: uint8_t
+            {
+                NonShareable =      0b00,
+                OuterShareable =    0b10,
+                InnerShareable =    0b11,
+            };
+
+            /**
+             * Sets the shareability for this page (ignored for device memory)
+             * 
+             * @param aShareability The page shareability
+             */
+            void SH(Shareability aShareability);
+
+            /**
+             * Obtains the shareability for this page
+             * 
+             * @return The page shareability
+             */
+            [[nodiscard]] Shareability SH() const;
+
             /**
              * AF Bit - Access flag
              * 
@@ -454,6 +586,50 @@ namespace AArch64
              */
             [[nodiscard]] bool AF() const { return DescriptorBits[AFIndex]; }
 
+            /**
+             * nG Bit - Not global
+             * 
+             * @param aNotGlobal If true, TLB entries for this page are tagged with the current ASID and only match
+             * while that ASID is active, otherwise they match in every address space
+             */
+            void nG(bool const aNotGlobal) { DescriptorBits[nGIndex] = aNotGlobal; }
+
+            /**
+             * nG Bit - Not global
+             * 
+             * @return True if the page belongs to a single address space
+             */
+            [[nodiscard]] bool nG() const { return DescriptorBits[nGIndex]; }
+
+            /**
+             * Contiguous Bit - Contiguous hint
+             * 
+             * @param aContiguous If true, this page is one of 16 adjacent pages that map contiguous memory with the
+             * same attributes, and the TLB may cache them as a single entry
+             */
+            void Contiguous(bool const aContiguous) { DescriptorBits[ContiguousIndex] = aContiguous; }
+
+            /**
+             * Contiguous Bit - Contiguous hint
+             * 
+             * @return True if the page is part of a contiguous run
+             */
+            [[nodiscard]] bool Contiguous() const { return DescriptorBits[ContiguousIndex]; }
+
+            /**
+             * Sets the bits reserved for software use, which the hardware ignores
+             * 
+             * @param aBits The software bits (only the low 4 bits are used)
+             */
+            void Software(uint8_t aBits);
+
+            /**
+             * Obtains the bits reserved for software use
+             * 
+             * @return The software bits
+             */
+            [[nodiscard]] uint8_t Software() const;
+
             /**
              * Sets the page address this entry points at
              * 
@@ -486,17 +662,19 @@ namespace AArch64
             // NS           [5]
             static constexpr unsigned APIndex_Shift = 6; // bits [7:6]
             static constexpr uint64_t APIndex_Mask = 0b11;
-            // SH[1:0]      [9:8]
+            static constexpr unsigned SHIndex_Shift = 8; // bits [9:8]
+            static constexpr uint64_t SHIndex_Mask = 0b11;
             static constexpr unsigned AFIndex = 10;
-            // NSE/nG       [11]
+            static constexpr unsigned nGIndex = 11;
             static constexpr uint64_t Address_Mask = 0x0000'FFFF'FFFF'F000; // bits [47:12]
             // Reserved     [49:48] (Res0)
             // GP           [50]    (Res0 if FEAT_BTI not implemented)
             // DBM          [51]    (Res0 if FEAT_HAFDBS not implemented)
-            // Contiguous   [52]
+            static constexpr unsigned ContiguousIndex = 52;
             // PXN          [53]
             // UXN/XN       [54]
-            // Ignored      [58:55] (Reserved for software use)
+            static constexpr unsigned SoftwareIndex_Shift = 55; // bits [58:55] (Reserved for software use)
+            static constexpr uint64_t SoftwareIndex_Mask = 0b1111;
             // PBHA         [62:59] (Ignored if FEAT_HPDS2 not implemented)
             // Ignored      [63]
             static constexpr size_t BitCount = 64;
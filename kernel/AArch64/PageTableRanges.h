@@ -0,0 +1,596 @@
+#ifndef KERNEL_AARCH64_PAGE_TABLE_RANGES_H
+#define KERNEL_AARCH64_PAGE_TABLE_RANGES_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "../PointerTypes.h"
+#include "../Utils.h"
+#include "MemoryDescriptor.h"
+#include "MemoryPageTables.h"
+
+// Operations on runs of pages, which walk down to each last level table once and then fill its entries in a loop,
+// rather than walking from the root for every page.
+//
+// The TablesT parameter tells the operations how to get at the tables, since that depends on whether the MMU is on
+// and who owns the tables:
+//
+//   PhysicalPtr AllocateTable();                   - returns a new zeroed table, or null if out of memory (only
+//                                                    needed by operations that create tables)
+//   uint64_t* GetTablePointer(PhysicalPtr) const;  - converts a table's physical address into a usable pointer
+//   void InvalidateRun(VirtualPtr, size_t) const;  - drops any cached translations for a run of pages whose entries
+//                                                    were just made invalid (only needed by operations that change
+//                                                    existing entries)
+//
+// Apart from breaking up contiguous runs, none of the operations do any TLB maintenance, since the caller knows which
+// ASID the tables belong to and can batch up the invalidations.
+//
+// Mapping sets the contiguous hint on every aligned run of 16 entries that the range fully covers, which lets the TLB
+// cache the run as a single entry. Anything that only changes part of a run clears the hint from the whole run first,
+// so the run never has mismatched entries. That has to be done break-before-make, as the TLB may be holding the run as
+// a single entry, and would be free to keep using it (or report a conflict) if it saw entries without the hint while
+// it's still there.
+
+namespace AArch64::PageTable
+{
+    namespace Details
+    {
+        constexpr size_t PageSizeC = 1ULL << PageOffsetBits;
+
+        // How much address space a single entry covers at each level
+        constexpr size_t Level0EntrySpanC = 1ULL << (PageOffsetBits + (TableIndexBits * 3));
+        constexpr size_t Level1EntrySpanC = 1ULL << (PageOffsetBits + (TableIndexBits * 2));
+        constexpr size_t Level2EntrySpanC = 1ULL << (PageOffsetBits + TableIndexBits);
+
+        // How many adjacent entries the contiguous hint covers (with a 4KB granule), and how much address space a run
+        // of them covers at each level we use it at
+        constexpr size_t ContiguousEntriesC = 16;
+        constexpr size_t ContiguousPageSpanC = PageSizeC * ContiguousEntriesC;
+        constexpr size_t ContiguousLevel2SpanC = Level2EntrySpanC * ContiguousEntriesC;
+
+        /**
+         * Checks if the whole run of contiguous entries holding an address is being mapped, and to physical memory that
+         * is aligned the same way, so the run can have the contiguous hint
+         * 
+         * @param aAddress The address being mapped
+         * @param aPhysicalAddress The physical address it is being mapped to
+         * @param aStart The start of the range being mapped
+         * @param aSize The size of the range being mapped
+         * @param aRunSpan The address space covered by a run (must be a power of 2)
+         * @return True if the run is entirely inside the range and the physical memory lines up with it
+         */
+        constexpr bool CoversContiguousRun(VirtualPtr const aAddress, PhysicalPtr const aPhysicalAddress,
+            VirtualPtr const aStart, size_t const aSize, size_t const aRunSpan)
+        {
+            auto const runStart = aAddress.GetAddress() & ~(aRunSpan - 1);
+            return (((aAddress.GetAddress() - aPhysicalAddress.GetAddress()) & (aRunSpan - 1)) == 0)
+                && (runStart >= aStart.GetAddress())
+                && ((runStart - aStart.GetAddress()) + aRunSpan <= aSize);
+        }
+
+        /**
+         * Calculates how many bytes are left from the address to the end of the entry containing it
+         * 
+         * @param aAddress The address to start from
+         * @param aEntrySpan The address space covered by a single entry (must be a power of 2)
+         * @return The number of bytes to the end of the entry
+         */
+        constexpr size_t BytesToEntryEnd(VirtualPtr const aAddress, size_t const aEntrySpan)
+        {
+            // done this way so the top of the address space doesn't overflow
+            return aEntrySpan - (aAddress.GetAddress() & (aEntrySpan - 1));
+        }
+
+        /**
+         * Obtains the next table down for the given address, optionally creating it
+         * 
+         * @param aTable The table to look in
+         * @param aAddress The address the lower table has to cover
+         * @param arTables Access to the tables
+         * @return The lower table, or null if there isn't one (or it couldn't be made)
+         */
+        template<bool CreateTables, class TableViewT, class TablesT>
+        uint64_t* GetLowerTable(TableViewT const aTable, VirtualPtr const aAddress, TablesT& arTables)
+        {
+            auto tablePA = PhysicalPtr{};
+            aTable.GetEntryForVA(aAddress).Visit(Overloaded{
+                [&tablePA, &arTables, aTable, aAddress](Descriptor::Fault)
+                {
+                    if constexpr (CreateTables)
+                    {
+                        auto const newTable = arTables.AllocateTable();
+                        if (newTable != PhysicalPtr{})
+                        {
+                            Descriptor::Table tableDescriptor;
+                            tableDescriptor.Address(newTable);
+                            aTable.SetEntryForVA(aAddress, tableDescriptor);
+                            tablePA = newTable;
+                        }
+                    }
+                },
+                [&tablePA](Descriptor::Table const aTableDescriptor)
+                {
+                    tablePA = aTableDescriptor.Address();
+                },
+                [](auto)
+                {
+                    // blocks can't be walked through
+                }
+            });
+            return (tablePA == PhysicalPtr{}) ? nullptr : arTables.GetTablePointer(tablePA);
+        }
+
+        /**
+         * Walks down to the last level table for the given address
+         * 
+         * @param aRoot The level 0 table
+         * @param aAddress The address the table has to cover
+         * @param arTables Access to the tables
+         * @param arSkip OUT: If there is no table, how many bytes from the address are known to be unmapped
+         * @return The last level table, or null if there isn't one (or it couldn't be made)
+         */
+        template<bool CreateTables, class TablesT>
+        uint64_t* WalkToPageTable(Level0View const aRoot, VirtualPtr const aAddress, TablesT& arTables, size_t& arSkip)
+        {
+            auto* const plevel1 = GetLowerTable<CreateTables>(aRoot, aAddress, arTables);
+            if (plevel1 == nullptr)
+            {
+                arSkip = BytesToEntryEnd(aAddress, Level0EntrySpanC);
+                return nullptr;
+            }
+            auto* const plevel2 = GetLowerTable<CreateTables>(Level1View{ plevel1 }, aAddress, arTables);
+            if (plevel2 == nullptr)
+            {
+                arSkip = BytesToEntryEnd(aAddress, Level1EntrySpanC);
+                return nullptr;
+            }
+            arSkip = BytesToEntryEnd(aAddress, Level2EntrySpanC);
+            return GetLowerTable<CreateTables>(Level2View{ plevel2 }, aAddress, arTables);
+        }
+
+        /**
+         * Calls the functor once for each last level table covering the range, with the part of the range that table
+         * covers. Parts of the range without tables are skipped a whole missing table at a time
+         * 
+         * @param aRoot The level 0 table
+         * @param aStart The start of the range (page aligned)
+         * @param aSize The size of the range in bytes (multiple of the page size)
+         * @param arTables Access to the tables
+         * @param aFunctor Functor taking the Level3View, the start of the part of the range, and its size
+         * @return False if a needed table couldn't be made
+         */
+        template<bool CreateTables, class TablesT, class FunctorT>
+        bool ForEachPageTable(Level0View const aRoot, VirtualPtr const aStart, size_t const aSize, TablesT& arTables,
+            FunctorT const& aFunctor)
+        {
+            auto curAddress = aStart;
+            auto remaining = aSize;
+            while (remaining > 0)
+            {
+                auto span = size_t{ 0 };
+                auto* const ppageTable = WalkToPageTable<CreateTables>(aRoot, curAddress, arTables, span);
+                span = (span < remaining) ? span : remaining;
+                if (ppageTable != nullptr)
+                {
+                    aFunctor(Level3View{ ppageTable }, curAddress, span);
+                }
+                else if (CreateTables)
+                {
+                    return false;
+                }
+                curAddress = curAddress.Offset(span);
+                remaining -= span;
+            }
+            return true;
+        }
+    }
+
+    /**
+     * Clears the contiguous hint from the run of pages holding the address, so pages in the run can be changed on their
+     * own. The whole run is made invalid and dropped from the TLB before it's written back without the hint, so
+     * nothing cached for the run as a whole survives, and the caller only has to invalidate the pages it changes
+     * 
+     * @param aTable The last level table holding the run
+     * @param aAddress An address in the run
+     * @param aTables Access to the tables, to invalidate the run
+     */
+    template<class TablesT>
+    void BreakContiguousRun(Level3View const aTable, VirtualPtr const aAddress, TablesT const& aTables)
+    {
+        auto const runStart = VirtualPtr{ aAddress.GetAddress() & ~(Details::ContiguousPageSpanC - 1) };
+        // #TODO: Remove lint tag when we get std::array
+        // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+        Descriptor::Page runPages[Details::ContiguousEntriesC];
+        auto mappedPages = 0U; // bit per page in the run
+        auto hinted = false;
+        for (auto curEntry = 0U; curEntry < Details::ContiguousEntriesC; ++curEntry)
+        {
+            aTable.GetEntryForVA(runStart.Offset(curEntry * Details::PageSizeC)).Visit(Overloaded{
+                [&runPages, &mappedPages, &hinted, curEntry](Descriptor::Page const aPageDescriptor)
+                {
+                    runPages[curEntry] = aPageDescriptor; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+                    mappedPages |= 1U << curEntry;
+                    hinted = hinted || aPageDescriptor.Contiguous();
+                },
+                [](auto)
+                {
+                    // nothing mapped
+                }
+            });
+        }
+        if (!hinted)
+        {
+            return;
+        }
+
+        for (auto curEntry = 0U; curEntry < Details::ContiguousEntriesC; ++curEntry)
+        {
+            if ((mappedPages & (1U << curEntry)) != 0)
+            {
+                aTable.SetEntryForVA(runStart.Offset(curEntry * Details::PageSizeC), Descriptor::Fault{});
+            }
+        }
+        aTables.InvalidateRun(runStart, Details::ContiguousPageSpanC);
+        for (auto curEntry = 0U; curEntry < Details::ContiguousEntriesC; ++curEntry)
+        {
+            if ((mappedPages & (1U << curEntry)) != 0)
+            {
+                auto pageDescriptor = runPages[curEntry]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+                pageDescriptor.Contiguous(false);
+                aTable.SetEntryForVA(runStart.Offset(curEntry * Details::PageSizeC), pageDescriptor);
+            }
+        }
+    }
+
+    namespace Details
+    {
+        /**
+         * Breaks up the contiguous runs at either end of part of a range, if the range only covers some of them
+         * 
+         * @param aTable The last level table holding the part of the range
+         * @param aChunkStart The start of the part of the range
+         * @param aChunkSize The size of the part of the range
+         * @param aTables Access to the tables, to invalidate the runs
+         */
+        template<class TablesT>
+        void BreakPartialContiguousRuns(Level3View const aTable, VirtualPtr const aChunkStart, size_t const aChunkSize,
+            TablesT const& aTables)
+        {
+            if ((aChunkStart.GetAddress() & (ContiguousPageSpanC - 1)) != 0)
+            {
+                BreakContiguousRun(aTable, aChunkStart, aTables);
+            }
+            auto const chunkEnd = aChunkStart.Offset(aChunkSize);
+            if ((chunkEnd.GetAddress() & (ContiguousPageSpanC - 1)) != 0)
+            {
+                BreakContiguousRun(aTable, chunkEnd.Offset(0 - PageSizeC), aTables);
+            }
+        }
+
+        /**
+         * Sets the contiguous hint on a run of blocks
+         * 
+         * @param aTable The table holding the run
+         * @param aRunStart The address of the first block in the run
+         */
+        inline void SetContiguousBlockRun(Level2View const aTable, VirtualPtr const aRunStart)
+        {
+            for (auto offset = size_t{ 0 }; offset < ContiguousLevel2SpanC; offset += Level2EntrySpanC)
+            {
+                auto const curAddress = aRunStart.Offset(offset);
+                aTable.GetEntryForVA(curAddress).Visit(Overloaded{
+                    [aTable, curAddress](Descriptor::L2Block aBlockDescriptor)
+                    {
+                        aBlockDescriptor.Contiguous(true);
+                        aTable.SetEntryForVA(curAddress, aBlockDescriptor);
+                    },
+                    [](auto)
+                    {
+                        // the caller checked these are all blocks
+                    }
+                });
+            }
+        }
+    }
+
+    /**
+     * Makes a block descriptor with the same attributes as a page descriptor
+     * 
+     * @param aAttributes The page descriptor holding the attributes
+     * @param aAddress The address of the block
+     * @return The block descriptor
+     */
+    template<class BlockT>
+    BlockT MakeBlock(Descriptor::Page const aAttributes, PhysicalPtr const aAddress)
+    {
+        // the attribute fields are in the same place with the same meanings in blocks and pages
+        BlockT block;
+        block.Address(aAddress);
+        block.AttrIndx(aAttributes.AttrIndx());
+        block.AP(static_cast<typename BlockT::AccessPermissions>(aAttributes.AP()));
+        block.SH(static_cast<typename BlockT::Shareability>(aAttributes.SH()));
+        block.AF(aAttributes.AF());
+        block.nG(aAttributes.nG());
+        block.Software(aAttributes.Software());
+        return block;
+    }
+
+    /**
+     * Puts a block into the table, as long as nothing is there already
+     * 
+     * @param aTable The table to put the block in
+     * @param aAddress The virtual address of the block
+     * @param aBlock The block descriptor
+     * @return True if the block was added
+     */
+    template<class TableViewT, class BlockT>
+    bool TryAddBlock(TableViewT const aTable, VirtualPtr const aAddress, BlockT const aBlock)
+    {
+        auto isEmpty = false;
+        aTable.GetEntryForVA(aAddress).Visit(Overloaded{
+            [&isEmpty](Descriptor::Fault)
+            {
+                isEmpty = true;
+            },
+            [](auto)
+            {
+                // already mapped or split into a table, so leave it alone
+            }
+        });
+        if (isEmpty)
+        {
+            aTable.SetEntryForVA(aAddress, aBlock);
+        }
+        return isEmpty;
+    }
+
+    /**
+     * Finds the last level table holding the page entry for the given address
+     * 
+     * @param aRoot The level 0 table
+     * @param aAddress The address to look up
+     * @param arTables Access to the tables
+     * @return The last level table, or null if there isn't one (or it couldn't be made)
+     */
+    template<bool CreateTables, class TablesT>
+    uint64_t* FindPageTable(Level0View const aRoot, VirtualPtr const aAddress, TablesT& arTables)
+    {
+        auto unusedSkip = size_t{ 0 };
+        return Details::WalkToPageTable<CreateTables>(aRoot, aAddress, arTables, unusedSkip);
+    }
+
+    /**
+     * Finds the level 2 table holding the 2MB block (or page table) entry for the given address
+     * 
+     * @param aRoot The level 0 table
+     * @param aAddress The address to look up
+     * @param arTables Access to the tables
+     * @return The level 2 table, or null if there isn't one (or it couldn't be made)
+     */
+    template<bool CreateTables, class TablesT>
+    uint64_t* FindBlockTable(Level0View const aRoot, VirtualPtr const aAddress, TablesT& arTables)
+    {
+        auto* const plevel1 = Details::GetLowerTable<CreateTables>(aRoot, aAddress, arTables);
+        return (plevel1 == nullptr) ? nullptr : Details::GetLowerTable<CreateTables>(Level1View{ plevel1 }, aAddress, arTables);
+    }
+
+    /**
+     * Makes a last level table mapping the same memory as a 2MB block, with the same attributes, so the block can be
+     * replaced with pages that are then changed individually
+     * 
+     * @param aBlock The block to split
+     * @param arTables Access to the tables, and a way to allocate new ones
+     * @return The physical address of the new table, or null if it couldn't be allocated
+     */
+    template<class TablesT>
+    PhysicalPtr MakeTableFromBlock(Descriptor::L2Block const aBlock, TablesT& arTables)
+    {
+        auto const newTable = arTables.AllocateTable();
+        if (newTable == PhysicalPtr{})
+        {
+            return newTable;
+        }
+
+        Descriptor::Page page;
+        page.AttrIndx(aBlock.AttrIndx());
+        page.AP(static_cast<Descriptor::Page::AccessPermissions>(aBlock.AP()));
+        page.SH(static_cast<Descriptor::Page::Shareability>(aBlock.SH()));
+        page.AF(aBlock.AF());
+        page.nG(aBlock.nG());
+        page.Software(aBlock.Software());
+        // the block is aligned and mapped the same all the way through, so every run of pages in it is complete
+        page.Contiguous(true);
+
+        auto* const ptable = arTables.GetTablePointer(newTable);
+        for (auto curEntry = 0U; curEntry < PointersPerTable; ++curEntry)
+        {
+            page.Address(aBlock.Address().Offset(curEntry * Details::PageSizeC));
+            Descriptor::Page::Write(page, ptable, curEntry);
+        }
+        return newTable;
+    }
+
+    /**
+     * Maps a physically contiguous run of pages, making any tables needed along the way. Aligned runs of 16 pages
+     * get the contiguous hint
+     * 
+     * @param aRoot The level 0 table
+     * @param aStart The virtual address to map at (page aligned)
+     * @param aSize The size of the range in bytes (multiple of the page size)
+     * @param aPhysicalStart The physical address of the first page
+     * @param aAttributes Descriptor holding the attributes for every page (the address is ignored)
+     * @param arTables Access to the tables, and a way to allocate new ones
+     * @return False if a table couldn't be allocated, in which case the range may be partially mapped
+     */
+    template<class TablesT>
+    bool MapRange(Level0View const aRoot, VirtualPtr const aStart, size_t const aSize, PhysicalPtr const aPhysicalStart,
+        Descriptor::Page const aAttributes, TablesT& arTables)
+    {
+        return Details::ForEachPageTable<true>(aRoot, aStart, aSize, arTables,
+            [aStart, aSize, aPhysicalStart, aAttributes, &arTables](Level3View const aTable, VirtualPtr const aChunkStart, size_t const aChunkSize)
+            {
+                // Pages just outside the range won't match the new ones any more
+                Details::BreakPartialContiguousRuns(aTable, aChunkStart, aChunkSize, arTables);
+
+                auto pageDescriptor = aAttributes;
+                auto curPA = aPhysicalStart.Offset(aChunkStart.GetAddress() - aStart.GetAddress());
+                for (auto offset = size_t{ 0 }; offset < aChunkSize; offset += Details::PageSizeC)
+                {
+                    pageDescriptor.Address(curPA);
+                    pageDescriptor.Contiguous(Details::CoversContiguousRun(aChunkStart.Offset(offset), curPA, aStart, aSize, Details::ContiguousPageSpanC));
+                    aTable.SetEntryForVA(aChunkStart.Offset(offset), pageDescriptor);
+                    curPA = curPA.Offset(Details::PageSizeC);
+                }
+            });
+    }
+
+    /**
+     * Maps a physically contiguous run of memory using the largest descriptors that fit - 1GB blocks where the
+     * virtual and physical addresses are both 1GB aligned, 2MB blocks where they're 2MB aligned, and pages for the
+     * rest. Parts of the range that already have tables are mapped through those tables rather than replacing them.
+     * Aligned runs of 16 2MB blocks and 16 pages get the contiguous hint
+     * 
+     * @param aRoot The level 0 table
+     * @param aStart The virtual address to map at (page aligned)
+     * @param aSize The size of the range in bytes (multiple of the page size)
+     * @param aPhysicalStart The physical address of the start of the memory
+     * @param aAttributes Descriptor holding the attributes for every block and page (the address is ignored)
+     * @param arTables Access to the tables, and a way to allocate new ones
+     * @return False if a table couldn't be allocated, in which case the range may be partially mapped
+     */
+    template<class TablesT>
+    bool MapRangeWithBlocks(Level0View const aRoot, VirtualPtr const aStart, size_t const aSize,
+        PhysicalPtr const aPhysicalStart, Descriptor::Page const aAttributes, TablesT& arTables)
+    {
+        auto curVA = aStart;
+        auto curPA = aPhysicalStart;
+        auto remaining = aSize;
+        auto blocksInRun = size_t{ 0 };
+        while (remaining > 0)
+        {
+            auto const alignment = curVA.GetAddress() | curPA.GetAddress();
+            auto span = size_t{ 0 };
+            if ((curVA.GetAddress() & (Details::ContiguousLevel2SpanC - 1)) == 0)
+            {
+                blocksInRun = 0;
+            }
+            if (((alignment & (Details::Level1EntrySpanC - 1)) == 0) && (remaining >= Details::Level1EntrySpanC))
+            {
+                auto* const plevel1 = Details::GetLowerTable<true>(aRoot, curVA, arTables);
+                if ((plevel1 != nullptr) &&
+                    TryAddBlock(Level1View{ plevel1 }, curVA, MakeBlock<Descriptor::L1Block>(aAttributes, curPA)))
+                {
+                    span = Details::Level1EntrySpanC;
+                }
+            }
+            if ((span == 0) && ((alignment & (Details::Level2EntrySpanC - 1)) == 0) && (remaining >= Details::Level2EntrySpanC))
+            {
+                auto* const plevel2 = FindBlockTable<true>(aRoot, curVA, arTables);
+                if ((plevel2 != nullptr) &&
+                    TryAddBlock(Level2View{ plevel2 }, curVA, MakeBlock<Descriptor::L2Block>(aAttributes, curPA)))
+                {
+                    span = Details::Level2EntrySpanC;
+
+                    // Only hint the run once every block in it has been added by us, since some of it may have
+                    // already been mapped some other way
+                    if (Details::CoversContiguousRun(curVA, curPA, aStart, aSize, Details::ContiguousLevel2SpanC))
+                    {
+                        ++blocksInRun;
+                        if (blocksInRun == Details::ContiguousEntriesC)
+                        {
+                            Details::SetContiguousBlockRun(Level2View{ plevel2 }, VirtualPtr{ curVA.GetAddress() & ~(Details::ContiguousLevel2SpanC - 1) });
+                        }
+                    }
+                }
+            }
+            if (span == 0)
+            {
+                // Not aligned (or too small) for a block, so use pages up to the next point a block could start
+                span = Details::BytesToEntryEnd(curVA, Details::Level2EntrySpanC);
+                span = (span < remaining) ? span : remaining;
+                if (!MapRange(aRoot, curVA, span, curPA, aAttributes, arTables))
+                {
+                    return false;
+                }
+            }
+            curVA = curVA.Offset(span);
+            curPA = curPA.Offset(span);
+            remaining -= span;
+        }
+        return true;
+    }
+
+    /**
+     * Unmaps every page in the range. Tables are left in place, even if they end up empty, and blocks are skipped
+     * 
+     * @param aRoot The level 0 table
+     * @param aStart The start of the range (page aligned)
+     * @param aSize The size of the range in bytes (multiple of the page size)
+     * @param arTables Access to the tables
+     * @param aFunctor Called with the address and old descriptor of each page that was mapped, so the caller can
+     * release the page
+     */
+    template<class TablesT, class FunctorT>
+    void UnmapRange(Level0View const aRoot, VirtualPtr const aStart, size_t const aSize, TablesT& arTables,
+        FunctorT const& aFunctor)
+    {
+        Details::ForEachPageTable<false>(aRoot, aStart, aSize, arTables,
+            [&aFunctor, &arTables](Level3View const aTable, VirtualPtr const aChunkStart, size_t const aChunkSize)
+            {
+                Details::BreakPartialContiguousRuns(aTable, aChunkStart, aChunkSize, arTables);
+                for (auto offset = size_t{ 0 }; offset < aChunkSize; offset += Details::PageSizeC)
+                {
+                    auto const curAddress = aChunkStart.Offset(offset);
+                    aTable.GetEntryForVA(curAddress).Visit(Overloaded{
+                        [](Descriptor::Fault)
+                        {
+                            // nothing mapped
+                        },
+                        [&aFunctor, aTable, curAddress](Descriptor::Page const aPageDescriptor)
+                        {
+                            aTable.SetEntryForVA(curAddress, Descriptor::Fault{});
+                            aFunctor(curAddress, aPageDescriptor);
+                        }
+                    });
+                }
+            });
+    }
+
+    /**
+     * Changes the access permissions of every mapped page in the range. Unmapped pages and blocks are left alone
+     * 
+     * @param aRoot The level 0 table
+     * @param aStart The start of the range (page aligned)
+     * @param aSize The size of the range in bytes (multiple of the page size)
+     * @param aPermissions The new permissions
+     * @param arTables Access to the tables
+     */
+    template<class TablesT>
+    void ProtectRange(Level0View const aRoot, VirtualPtr const aStart, size_t const aSize,
+        Descriptor::Page::AccessPermissions const aPermissions, TablesT& arTables)
+    {
+        Details::ForEachPageTable<false>(aRoot, aStart, aSize, arTables,
+            [aPermissions, &arTables](Level3View const aTable, VirtualPtr const aChunkStart, size_t const aChunkSize)
+            {
+                // Runs entirely in the range all change the same way, so they can keep the hint
+                Details::BreakPartialContiguousRuns(aTable, aChunkStart, aChunkSize, arTables);
+                for (auto offset = size_t{ 0 }; offset < aChunkSize; offset += Details::PageSizeC)
+                {
+                    auto const curAddress = aChunkStart.Offset(offset);
+                    aTable.GetEntryForVA(curAddress).Visit(Overloaded{
+                        [](Descriptor::Fault)
+                        {
+                            // nothing mapped
+                        },
+                        [aPermissions, aTable, curAddress](Descriptor::Page aPageDescriptor)
+                        {
+                            aPageDescriptor.AP(aPermissions);
+                            aTable.SetEntryForVA(curAddress, aPageDescriptor);
+                        }
+                    });
+                }
+            });
+    }
+}
+
+#endif // KERNEL_AARCH64_PAGE_TABLE_RANGES_H
\ No newline at end of file
@@ -13,5 +13,6 @@
 //Exception classes:
 #define ESR_ELx_EC_SVC64    0x15    // 0b010101 - exception caused by SVC instruction in AArch64 state
 #define ESR_ELx_EC_DABT_LOW 0x24    // 0b100100 - data abort from a lower exception level
+#define ESR_ELx_EC_DABT_CUR 0x25    // 0b100101 - data abort from the current exception level
 
 #endif // KERNEL_AARCH64_REGISTER_DEFINES_H
\ No newline at end of file
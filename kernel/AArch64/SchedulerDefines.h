@@ -4,5 +4,11 @@
 #define KERNEL_AARCH64_SCHEDULER_DEFINES_H
 
 #define TASK_STRUCT_CONTEXT_OFFSET 0 // NOLINT(modernize-macro-to-enum, cppcoreguidelines-macro-usage)
+// Number of cores on the Pi 3
+#define CPU_COUNT 4 // NOLINT(modernize-macro-to-enum, cppcoreguidelines-macro-usage)
+// Physical address of the firmware's spin table, where each core has an 8 byte slot it waits on for a release address
+#define SPIN_TABLE_ADDRESS 0xD8 // NOLINT(modernize-macro-to-enum, cppcoreguidelines-macro-usage)
+// Boot (and then idle task) stack for each secondary core
+#define SECONDARY_STACK_SIZE 4096 // NOLINT(modernize-macro-to-enum, cppcoreguidelines-macro-usage)
 
 #endif // KERNEL_AARCH64_SCHEDULER_DEFINES_H
\ No newline at end of file
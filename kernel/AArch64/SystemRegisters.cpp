@@ -7,6 +7,33 @@
 
 namespace AArch64
 {
+    void CNTHCTL_EL2::Write(CNTHCTL_EL2 const aValue)
+    {
+        uint64_t const rawValue = aValue.RegisterValue.to_ulong();
+        // NOLINTNEXTLINE(hicpp-no-assembler)
+        asm volatile(
+            "msr cnthctl_el2, %[value]"
+            : // no outputs
+            :[value] "r"(rawValue) // inputs
+            : // no bashed registers
+        );
+    }
+
+    CNTHCTL_EL2 CNTHCTL_EL2::Read()
+    {
+        // Clang-tidy doesn't pick up on it being modified by the assembly
+        // NOLINTNEXTLINE(misc-const-correctness)
+        uint64_t readRawValue = 0;
+        // NOLINTNEXTLINE(hicpp-no-assembler)
+        asm volatile(
+            "mrs %[value], cnthctl_el2"
+            :[value] "=r"(readRawValue) // outputs
+            : // no inputs
+            : // no bashed registers
+        );
+        return CNTHCTL_EL2{ readRawValue };
+    }
+
     void CPACR_EL1::Write(CPACR_EL1 const aValue)
     {
         uint64_t const rawValue = aValue.RegisterValue.to_ulong();
@@ -125,6 +152,26 @@ namespace AArch64
         return HSTR_EL2{ readRawValue };
     }
 
+    ID_AA64MMFR0_EL1 ID_AA64MMFR0_EL1::Read()
+    {
+        // Clang-tidy doesn't pick up on it being modified by the assembly
+        // NOLINTNEXTLINE(misc-const-correctness)
+        uint64_t readRawValue = 0;
+        // NOLINTNEXTLINE(hicpp-no-assembler)
+        asm volatile(
+            "mrs %[value], id_aa64mmfr0_el1"
+            :[value] "=r"(readRawValue) // outputs
+            : // no inputs
+            : // no bashed registers
+        );
+        return ID_AA64MMFR0_EL1{ readRawValue };
+    }
+
+    ID_AA64MMFR0_EL1::ASIDSize ID_AA64MMFR0_EL1::ASIDBits() const
+    {
+        return ReadMultiBitValue<ASIDSize>(RegisterValue, ASIDBitsIndex_Mask, ASIDBitsIndex_Shift);
+    }
+
     /**
      * Construct the register data from a raw 64-bit value from the register
      * 
@@ -304,6 +351,36 @@ namespace AArch64
         return ReadMultiBitValue<T0Granule>(RegisterValue, TG0Index_Mask, TG0Index_Shift);
     }
 
+    void TCR_EL1::IRGN0(Cacheability const aCacheability)
+    {
+        WriteMultiBitValue(RegisterValue, aCacheability, IRGN0Index_Mask, IRGN0Index_Shift);
+    }
+
+    TCR_EL1::Cacheability TCR_EL1::IRGN0() const
+    {
+        return ReadMultiBitValue<Cacheability>(RegisterValue, IRGN0Index_Mask, IRGN0Index_Shift);
+    }
+
+    void TCR_EL1::ORGN0(Cacheability const aCacheability)
+    {
+        WriteMultiBitValue(RegisterValue, aCacheability, ORGN0Index_Mask, ORGN0Index_Shift);
+    }
+
+    TCR_EL1::Cacheability TCR_EL1::ORGN0() const
+    {
+        return ReadMultiBitValue<Cacheability>(RegisterValue, ORGN0Index_Mask, ORGN0Index_Shift);
+    }
+
+    void TCR_EL1::SH0(Shareability const aShareability)
+    {
+        WriteMultiBitValue(RegisterValue, aShareability, SH0Index_Mask, SH0Index_Shift);
+    }
+
+    TCR_EL1::Shareability TCR_EL1::SH0() const
+    {
+        return ReadMultiBitValue<Shareability>(RegisterValue, SH0Index_Mask, SH0Index_Shift);
+    }
+
     void TCR_EL1::T1SZ(uint8_t const aBits)
     {
         // #TODO: Panic if bits are out of range - might depend on the hardware, but anything over 52 is too much
@@ -330,6 +407,36 @@ namespace AArch64
         return ReadMultiBitValue<T1Granule>(RegisterValue, TG1Index_Mask, TG1Index_Shift);
     }
 
+    void TCR_EL1::IRGN1(Cacheability const aCacheability)
+    {
+        WriteMultiBitValue(RegisterValue, aCacheability, IRGN1Index_Mask, IRGN1Index_Shift);
+    }
+
+    TCR_EL1::Cacheability TCR_EL1::IRGN1() const
+    {
+        return ReadMultiBitValue<Cacheability>(RegisterValue, IRGN1Index_Mask, IRGN1Index_Shift);
+    }
+
+    void TCR_EL1::ORGN1(Cacheability const aCacheability)
+    {
+        WriteMultiBitValue(RegisterValue, aCacheability, ORGN1Index_Mask, ORGN1Index_Shift);
+    }
+
+    TCR_EL1::Cacheability TCR_EL1::ORGN1() const
+    {
+        return ReadMultiBitValue<Cacheability>(RegisterValue, ORGN1Index_Mask, ORGN1Index_Shift);
+    }
+
+    void TCR_EL1::SH1(Shareability const aShareability)
+    {
+        WriteMultiBitValue(RegisterValue, aShareability, SH1Index_Mask, SH1Index_Shift);
+    }
+
+    TCR_EL1::Shareability TCR_EL1::SH1() const
+    {
+        return ReadMultiBitValue<Shareability>(RegisterValue, SH1Index_Mask, SH1Index_Shift);
+    }
+
     void TTBRn_EL1::Write0(TTBRn_EL1 const aValue)
     {
         uint64_t const rawValue = aValue.RegisterValue.to_ulong();
@@ -393,4 +500,14 @@ namespace AArch64
     {
         return ReadMultiBitValue<PhysicalPtr>(RegisterValue, BADDRIndex_Mask, BADDRIndex_Shift);
     }
+
+    void TTBRn_EL1::ASID(uint16_t const aASID)
+    {
+        WriteMultiBitValue(RegisterValue, aASID, ASIDIndex_Mask, ASIDIndex_Shift);
+    }
+
+    uint16_t TTBRn_EL1::ASID() const
+    {
+        return ReadMultiBitValue<uint16_t>(RegisterValue, ASIDIndex_Mask, ASIDIndex_Shift);
+    }
 }
\ No newline at end of file
@@ -22,6 +22,85 @@ namespace UnitTests::AArch64::SystemRegisters::Details
 
 namespace AArch64
 {
+    /**
+     * Counter-timer Hypervisor Control Register
+     * https://developer.arm.com/documentation/ddi0595/2021-06/AArch64-Registers/CNTHCTL-EL2--Counter-timer-Hypervisor-Control-Register
+     * 
+     * Note that the definition of this class assumes HCR_EL2.E2H is 0. But since we never expect to turn it on (it's
+     * for hosting an OS at EL2) we should be fine.
+     */
+    class CNTHCTL_EL2
+    {
+        friend struct UnitTests::AArch64::SystemRegisters::Details::TestAccessor;
+        static_assert(sizeof(unsigned long) == sizeof(uint64_t), "Need to adjust which value is used to retrieve the bitset");
+    public:
+        /**
+         * Constructor - produces a value with all bits zeroed
+         */
+        CNTHCTL_EL2() = default;
+
+        /**
+         * Writes the given value to the CNTHCTL_EL2 register
+         * 
+         * @param aValue Value to write
+         */
+        static void Write(CNTHCTL_EL2 aValue);
+
+        /**
+         * Reads the current state of the CNTHCTL_EL2 register
+         * 
+         * @return The current state of the register
+         */
+        static CNTHCTL_EL2 Read();
+
+        /**
+         * EL1PCTEN Bit - Controls EL0 and EL1 access to the physical counter
+         * 
+         * @param aAllowAccess If true, reading the physical counter doesn't trap to EL2
+         */
+        void EL1PCTEN(bool const aAllowAccess) { RegisterValue[EL1PCTENIndex] = aAllowAccess; }
+
+        /**
+         * EL1PCTEN Bit - Controls EL0 and EL1 access to the physical counter
+         * 
+         * @return True if reading the physical counter doesn't trap to EL2
+         */
+        [[nodiscard]] bool EL1PCTEN() const { return RegisterValue[EL1PCTENIndex]; }
+
+        /**
+         * EL1PCEN Bit - Controls EL0 and EL1 access to the physical timer registers
+         * 
+         * @param aAllowAccess If true, accessing the physical timer doesn't trap to EL2
+         */
+        void EL1PCEN(bool const aAllowAccess) { RegisterValue[EL1PCENIndex] = aAllowAccess; }
+
+        /**
+         * EL1PCEN Bit - Controls EL0 and EL1 access to the physical timer registers
+         * 
+         * @return True if accessing the physical timer doesn't trap to EL2
+         */
+        [[nodiscard]] bool EL1PCEN() const { return RegisterValue[EL1PCENIndex]; }
+
+    private:
+        /**
+         * Create a register value from the given bits
+         * 
+         * @param aInitialValue The bits to start with
+         */
+        explicit CNTHCTL_EL2(uint64_t const aInitialValue)
+            : RegisterValue{ aInitialValue }
+        {}
+
+        static constexpr unsigned EL1PCTENIndex = 0;
+        static constexpr unsigned EL1PCENIndex = 1;
+        // EVNTEN       [2]
+        // EVNTDIR      [3]
+        // EVNTI        [7:4]
+        // Reserved     [63:8]  (Res0 without FEAT_ECV)
+        static constexpr size_t RegisterBitCount = 64;
+        std::bitset<RegisterBitCount> RegisterValue;
+    };
+
     /**
      * Architectural Feature Access Control Register
      * https://developer.arm.com/documentation/ddi0595/2021-06/AArch64-Registers/CPACR-EL1--Architectural-Feature-Access-Control-Register
@@ -349,6 +428,70 @@ namespace AArch64
         std::bitset<RegisterBitCount> RegisterValue;
     };
 
+    /**
+     * AArch64 Memory Model Feature Register 0 (read-only)
+     * https://developer.arm.com/documentation/ddi0601/2023-09/AArch64-Registers/ID-AA64MMFR0-EL1--AArch64-Memory-Model-Feature-Register-0
+     */
+    class ID_AA64MMFR0_EL1
+    {
+        friend struct UnitTests::AArch64::SystemRegisters::Details::TestAccessor;
+        static_assert(sizeof(unsigned long) == sizeof(uint64_t), "Need to adjust which value is used to retrieve the bitset");
+    public:
+        /**
+         * Constructor - produces a value with all bits zeroed
+         */
+        ID_AA64MMFR0_EL1() = default;
+
+        /**
+         * Reads the current state of the ID_AA64MMFR0_EL1 register
+         * 
+         * @return The current state of the register
+         */
+        static ID_AA64MMFR0_EL1 Read();
+
+        enum class ASIDSize: uint8_t
+        {
+            Bits8 = 0b0000,
+            Bits16 = 0b0010,
+        };
+
+        /**
+         * ASIDBits bits - number of ASID bits supported
+         * 
+         * @return The supported ASID size
+         */
+        [[nodiscard]] ASIDSize ASIDBits() const;
+
+    private:
+        /**
+         * Create a register value from the given bits
+         * 
+         * @param aInitialValue The bits to start with
+         */
+        explicit ID_AA64MMFR0_EL1(uint64_t const aInitialValue)
+            : RegisterValue{ aInitialValue }
+        {}
+
+        // PARange      [3:0]
+        static constexpr unsigned ASIDBitsIndex_Shift = 4; // bits [7:4]
+        static constexpr uint64_t ASIDBitsIndex_Mask = 0b1111;
+        // BigEnd       [11:8]
+        // SNSMem       [15:12]
+        // BigEndEL0    [19:16]
+        // TGran16      [23:20]
+        // TGran64      [27:24]
+        // TGran4       [31:28]
+        // TGran16_2    [35:32]
+        // TGran64_2    [39:36]
+        // TGran4_2     [43:40]
+        // ExS          [47:44]
+        // Reserved     [55:48] (Res0)
+        // FGT          [59:56]
+        // ECV          [63:60]
+        static constexpr size_t RegisterBitCount = 64;
+        std::bitset<RegisterBitCount> RegisterValue;
+    };
+
     /**
      * Memory Attribute Indirection Register
      * https://developer.arm.com/documentation/ddi0595/2020-12/AArch64-Registers/MAIR-EL1--Memory-Attribute-Indirection-Register--EL1-
@@ -401,6 +544,20 @@ namespace AArch64
                 return Attribute{ 0b0100'0100 }; // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
             }
 
+            /**
+             * Obtain an attribute representing normal memory that can be cached
+             * 
+             * @return An attribute representing cacheable normal memory
+             */
+            static constexpr Attribute NormalCacheableMemory()
+            {
+                // https://developer.arm.com/documentation/den0024/a/Memory-Ordering/Memory-attributes/Cacheable-and-shareable-memory-attributes
+
+                // Normal memory, outer write-back non-transient, read and write allocate
+                // Normal memory, inner write-back non-transient, read and write allocate
+                return Attribute{ 0b1111'1111 }; // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+            }
+
             /**
              * Obtain an attribute representing device memory
              * 
@@ -518,6 +675,34 @@ namespace AArch64
          */
         [[nodiscard]] bool M() const { return RegisterValue[MIndex]; }
 
+        /**
+         * C Bit - Data cache enable for EL1 & 0
+         * 
+         * @param aEnableDataCache If true, data accesses to cacheable memory will be cached
+         */
+        void C(bool const aEnableDataCache) { RegisterValue[CIndex] = aEnableDataCache; }
+
+        /**
+         * C Bit - Data cache enable for EL1 & 0
+         * 
+         * @return True if data accesses to cacheable memory will be cached
+         */
+        [[nodiscard]] bool C() const { return RegisterValue[CIndex]; }
+
+        /**
+         * I Bit - Instruction cache enable for EL1 & 0
+         * 
+         * @param aEnableInstructionCache If true, instruction fetches from cacheable memory will be cached
+         */
+        void I(bool const aEnableInstructionCache) { RegisterValue[IIndex] = aEnableInstructionCache; }
+
+        /**
+         * I Bit - Instruction cache enable for EL1 & 0
+         * 
+         * @return True if instruction fetches from cacheable memory will be cached
+         */
+        [[nodiscard]] bool I() const { return RegisterValue[IIndex]; }
+
     private:
         /**
          * Create a register value from the given bits
@@ -541,7 +726,7 @@ namespace AArch64
 
         static constexpr unsigned MIndex = 0;
         // A            [1]
-        // C            [2]
+        static constexpr unsigned CIndex = 2;
         // SA           [3]
         // SA0          [4]
         // CP15BEN      [5]     (Res0 if EL0 isn't capable of using AArch32)
@@ -551,7 +736,7 @@ namespace AArch64
         // UMA          [9]
         // EnRCTX       [10]    (Res0 if FEAT_SPECRES not implemented)
         // EOS          [11]    (Res1 if FEAT_ExS not implemented)
-        // I            [12]
+        static constexpr unsigned IIndex = 12;
         // EnDB         [13]    (Res0 if FEAT_PAuth not implemented)
         // DZE          [14]
         // UCT          [15]
@@ -804,6 +989,63 @@ namespace AArch64
          */
         [[nodiscard]] T0Granule TG0() const;
 
+        enum class Cacheability: uint8_t
+        {
+            NonCacheable = 0b00,
+            WriteBackWriteAllocate = 0b01,
+            WriteThrough = 0b10,
+            WriteBackNoWriteAllocate = 0b11,
+        };
+
+        enum class Shareability: uint8_t
+        {
+            NonShareable = 0b00,
+            OuterShareable = 0b10,
+            InnerShareable = 0b11,
+        };
+
+        /**
+         * IRGN0 bits - inner cacheability of table walks through TTBR0_EL1
+         * 
+         * @param aCacheability The inner cacheability for user region table walks
+         */
+        void IRGN0(Cacheability aCacheability);
+
+        /**
+         * IRGN0 bits - inner cacheability of table walks through TTBR0_EL1
+         * 
+         * @return The inner cacheability for user region table walks
+         */
+        [[nodiscard]] Cacheability IRGN0() const;
+
+        /**
+         * ORGN0 bits - outer cacheability of table walks through TTBR0_EL1
+         * 
+         * @param aCacheability The outer cacheability for user region table walks
+         */
+        void ORGN0(Cacheability aCacheability);
+
+        /**
+         * ORGN0 bits - outer cacheability of table walks through TTBR0_EL1
+         * 
+         * @return The outer cacheability for user region table walks
+         */
+        [[nodiscard]] Cacheability ORGN0() const;
+
+        /**
+         * SH0 bits - shareability of table walks through TTBR0_EL1
+         * 
+         * @param aShareability The shareability for user region table walks
+         */
+        void SH0(Shareability aShareability);
+
+        /**
+         * SH0 bits - shareability of table walks through TTBR0_EL1
+         * 
+         * @return The shareability for user region table walks
+         */
+        [[nodiscard]] Shareability SH0() const;
+
         /**
          * T1SZ bits - controls the size of the memory region addressed by TTBR1_EL1
          * 
@@ -839,6 +1081,63 @@ namespace AArch64
          */
         [[nodiscard]] T1Granule TG1() const;
 
+        /**
+         * AS Bit - ASID size
+         * 
+         * @param aUse16BitASID If true, the upper 16 bits of the TTBRs hold the ASID, otherwise only the lower 8 bits
+         * of that are used (only set if ID_AA64MMFR0_EL1 says 16 bits are supported)
+         */
+        void AS(bool const aUse16BitASID) { RegisterValue[ASIndex] = aUse16BitASID; }
+
+        /**
+         * AS Bit - ASID size
+         * 
+         * @return True if ASIDs are 16 bits, false for 8 bits
+         */
+        [[nodiscard]] bool AS() const { return RegisterValue[ASIndex]; }
+
+        /**
+         * IRGN1 bits - inner cacheability of table walks through TTBR1_EL1
+         * 
+         * @param aCacheability The inner cacheability for kernel region table walks
+         */
+        void IRGN1(Cacheability aCacheability);
+
+        /**
+         * IRGN1 bits - inner cacheability of table walks through TTBR1_EL1
+         * 
+         * @return The inner cacheability for kernel region table walks
+         */
+        [[nodiscard]] Cacheability IRGN1() const;
+
+        /**
+         * ORGN1 bits - outer cacheability of table walks through TTBR1_EL1
+         * 
+         * @param aCacheability The outer cacheability for kernel region table walks
+         */
+        void ORGN1(Cacheability aCacheability);
+
+        /**
+         * ORGN1 bits - outer cacheability of table walks through TTBR1_EL1
+         * 
+         * @return The outer cacheability for kernel region table walks
+         */
+        [[nodiscard]] Cacheability ORGN1() const;
+
+        /**
+         * SH1 bits - shareability of table walks through TTBR1_EL1
+         * 
+         * @param aShareability The shareability for kernel region table walks
+         */
+        void SH1(Shareability aShareability);
+
+        /**
+         * SH1 bits - shareability of table walks through TTBR1_EL1
+         * 
+         * @return The shareability for kernel region table walks
+         */
+        [[nodiscard]] Shareability SH1() const;
+
     private:
         /**
          * Create a register value from the given bits
@@ -856,23 +1155,29 @@ namespace AArch64
         static constexpr uint64_t T0SZIndex_Mask = 0b11'1111;
         // Reserved     [6]     (Res0)
         // EPD0         [7]
-        // IRGN0        [9:8]
-        // ORGN0        [11:10]
-        // SH0          [13:12]
+        static constexpr unsigned IRGN0Index_Shift = 8; // bits [9:8]
+        static constexpr uint64_t IRGN0Index_Mask = 0b11;
+        static constexpr unsigned ORGN0Index_Shift = 10; // bits [11:10]
+        static constexpr uint64_t ORGN0Index_Mask = 0b11;
+        static constexpr unsigned SH0Index_Shift = 12; // bits [13:12]
+        static constexpr uint64_t SH0Index_Mask = 0b11;
         static constexpr unsigned TG0Index_Shift = 14; // bits [15:14]
         static constexpr uint64_t TG0Index_Mask = 0b11;
         static constexpr unsigned T1SZIndex_Shift = 16; // bits [21:16]
         static constexpr uint64_t T1SZIndex_Mask = 0b11'1111;
         // A1           [22]
         // EPD1         [23]
-        // IRGN1        [25:24]
-        // ORGN1        [27:26]
-        // SH1          [29:28]
+        static constexpr unsigned IRGN1Index_Shift = 24; // bits [25:24]
+        static constexpr uint64_t IRGN1Index_Mask = 0b11;
+        static constexpr unsigned ORGN1Index_Shift = 26; // bits [27:26]
+        static constexpr uint64_t ORGN1Index_Mask = 0b11;
+        static constexpr unsigned SH1Index_Shift = 28; // bits [29:28]
+        static constexpr uint64_t SH1Index_Mask = 0b11;
         static constexpr unsigned TG1Index_Shift = 30; // bits [31:30]
         static constexpr uint64_t TG1Index_Mask = 0b11;
         // IPS          [34:32]
         // Reserved     [35]    (Res0)
-        // AS           [36]
+        static constexpr unsigned ASIndex = 36;
         // TBA0         [37]
         // TBA1         [38]
         // HA           [39]    (Res0 if FEAT_HAFDBS not implemented)
@@ -958,6 +1263,21 @@ namespace AArch64
          */
         [[nodiscard]] PhysicalPtr BADDR() const;
 
+        /**
+         * ASID bits - Address space identifier that tags TLB entries for non-global pages (only the TTBR selected by
+         * TCR_EL1.A1 supplies the ASID, and the top 8 bits are ignored unless TCR_EL1.AS is set)
+         * 
+         * @param aASID The address space ID
+         */
+        void ASID(uint16_t aASID);
+
+        /**
+         * ASID bits - Address space identifier that tags TLB entries for non-global pages
+         * 
+         * @return The address space ID
+         */
+        [[nodiscard]] uint16_t ASID() const;
+
     private:
         /**
          * Create a register value from the given bits
@@ -972,7 +1292,8 @@ namespace AArch64
         // not shifting because the data isn't shifted when stored, we just mask off the top and bottom bits
         static constexpr unsigned BADDRIndex_Shift = 0; // bits [47:1]
         static constexpr uint64_t BADDRIndex_Mask = 0x0000'FFFF'FFFF'FFFEULL;
-        // ASID         [63:48] (if implementation only supports 8 bits of ASID, then the top 8 bits are Res0)
+        static constexpr unsigned ASIDIndex_Shift = 48; // bits [63:48] (if implementation only supports 8 bits of ASID, then the top 8 bits are Res0)
+        static constexpr uint64_t ASIDIndex_Mask = 0xFFFF;
 
         // Sanity check to make sure we're masking what we think we are
         // NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
@@ -0,0 +1,91 @@
+#include "TLB.h"
+
+#include <cstddef>
+#include <cstdint>
+#include "../PointerTypes.h"
+
+namespace AArch64::TLB
+{
+    namespace
+    {
+        constexpr std::size_t PageSizeC = 1ULL << Details::PageNumber_Shift;
+
+        // Past this many pages it's cheaper to throw away the whole TLB than to invalidate one page at a time
+        constexpr std::size_t MaxRangePagesC = 64;
+    }
+
+    InvalidationBatch::InvalidationBatch()
+    {
+        // NOLINTNEXTLINE(hicpp-no-assembler)
+        asm volatile(
+            "dsb ishst" // make sure the page table updates are visible to the table walker before invalidating
+            : // no outputs
+            : // no inputs
+            : "memory"
+        );
+    }
+
+    InvalidationBatch::~InvalidationBatch()
+    {
+        // NOLINTNEXTLINE(hicpp-no-assembler)
+        asm volatile(
+            "dsb ish\n" // wait for the invalidations to complete
+            "isb"       // and make sure following instructions see them
+            : // no outputs
+            : // no inputs
+            : "memory"
+        );
+    }
+
+    void InvalidationBatch::Add(uint16_t const aASID, VirtualPtr const aAddress, Entries const aEntries)
+    {
+        auto const operand = Details::MakeOperand(aASID, aAddress);
+        if (aEntries == Entries::LastLevel)
+        {
+            // NOLINTNEXTLINE(hicpp-no-assembler)
+            asm volatile("tlbi vale1is, %[operand]" : : [operand] "r"(operand) : "memory");
+        }
+        else
+        {
+            // NOLINTNEXTLINE(hicpp-no-assembler)
+            asm volatile("tlbi vae1is, %[operand]" : : [operand] "r"(operand) : "memory");
+        }
+    }
+
+    void InvalidatePage(uint16_t const aASID, VirtualPtr const aAddress, Entries const aEntries)
+    {
+        InvalidationBatch const batch;
+        InvalidationBatch::Add(aASID, aAddress, aEntries);
+    }
+
+    void InvalidateRange(uint16_t const aASID, VirtualPtr const aStart, std::size_t const aSize, Entries const aEntries)
+    {
+        auto const firstPage = aStart.GetAddress() & ~(PageSizeC - 1);
+        auto const pageCount = ((aStart.GetAddress() + aSize + PageSizeC - 1) - firstPage) / PageSizeC;
+        if (pageCount > MaxRangePagesC)
+        {
+            InvalidateAll();
+            return;
+        }
+
+        InvalidationBatch const batch;
+        for (auto curPage = 0U; curPage < pageCount; ++curPage)
+        {
+            InvalidationBatch::Add(aASID, VirtualPtr{ firstPage + (curPage * PageSizeC) }, aEntries);
+        }
+    }
+
+    void InvalidateASID(uint16_t const aASID)
+    {
+        InvalidationBatch const batch;
+        // NOLINTNEXTLINE(hicpp-no-assembler)
+        asm volatile("tlbi aside1is, %[operand]" : : [operand] "r"(Details::MakeOperand(aASID, VirtualPtr{})) : "memory");
+    }
+
+    void InvalidateAll()
+    {
+        InvalidationBatch const batch;
+        // NOLINTNEXTLINE(hicpp-no-assembler)
+        asm volatile("tlbi vmalle1is" : : : "memory");
+    }
+}
\ No newline at end of file
@@ -0,0 +1,107 @@
+#ifndef KERNEL_AARCH64_TLB_H
+#define KERNEL_AARCH64_TLB_H
+
+#include <cstddef>
+#include <cstdint>
+#include "../PointerTypes.h"
+
+// TLB maintenance documentation: https://developer.arm.com/documentation/101811/0103/Translation-Lookaside-Buffer-maintenance
+
+namespace AArch64::TLB
+{
+    /**
+     * Which cached entries a by-address invalidation has to remove
+     */
+    enum class Entries : uint8_t
+    {
+        LastLevel, // only the page (or block) entry changed (vale1is)
+        AllLevels, // table entries on the way to the page changed too, so cached walks have to go as well (vae1is)
+    };
+
+    namespace Details
+    {
+        constexpr unsigned ASID_Shift = 48;
+        constexpr unsigned PageNumber_Shift = 12;
+        constexpr uint64_t PageNumber_Mask = 0x0000'0FFF'FFFF'FFFF; // VA[55:12]
+
+        /**
+         * Builds the operand for a by-address TLB invalidation instruction
+         * 
+         * @param aASID The ASID the entries are tagged with (ignored by the hardware for global entries)
+         * @param aAddress The virtual address to invalidate
+         * @return The operand to pass to the tlbi instruction
+         */
+        constexpr uint64_t MakeOperand(uint16_t const aASID, VirtualPtr const aAddress)
+        {
+            return (static_cast<uint64_t>(aASID) << ASID_Shift) | ((aAddress.GetAddress() >> PageNumber_Shift) & PageNumber_Mask);
+        }
+    }
+
+    /**
+     * Collects several invalidations so the barriers only have to be paid for once. Page table writes must be done
+     * before the batch is created, and nothing may rely on the invalidations until the batch is destroyed
+     */
+    class InvalidationBatch
+    {
+    public:
+        /**
+         * Starts the batch, making sure the page table writes are visible to the table walker before anything is
+         * invalidated
+         */
+        InvalidationBatch();
+
+        // Disable copying/moving, since the batch has to end exactly once
+        InvalidationBatch(InvalidationBatch const&) = delete;
+        InvalidationBatch(InvalidationBatch&&) = delete;
+        InvalidationBatch& operator=(InvalidationBatch const&) = delete;
+        InvalidationBatch& operator=(InvalidationBatch&&) = delete;
+
+        /**
+         * Waits for all the invalidations in the batch to complete on every core
+         */
+        ~InvalidationBatch();
+
+        /**
+         * Queues up the invalidation of a single page
+         * 
+         * @param aASID The ASID the page is mapped in
+         * @param aAddress The virtual address of the page
+         * @param aEntries Which entries for the page need to be invalidated
+         */
+        static void Add(uint16_t aASID, VirtualPtr aAddress, Entries aEntries);
+    };
+
+    /**
+     * Invalidates the cached translation for a single page
+     * 
+     * @param aASID The ASID the page is mapped in
+     * @param aAddress The virtual address of the page
+     * @param aEntries Which entries for the page need to be invalidated
+     */
+    void InvalidatePage(uint16_t aASID, VirtualPtr aAddress, Entries aEntries);
+
+    /**
+     * Invalidates the cached translations for a range of pages. Very large ranges invalidate everything instead, as
+     * that's cheaper than walking the range one page at a time
+     * 
+     * @param aASID The ASID the pages are mapped in
+     * @param aStart The virtual address of the first page
+     * @param aSize The size of the range in bytes
+     * @param aEntries Which entries for the pages need to be invalidated
+     */
+    void InvalidateRange(uint16_t aASID, VirtualPtr aStart, std::size_t aSize, Entries aEntries);
+
+    /**
+     * Invalidates every cached translation tagged with the ASID. Global entries are left alone
+     * 
+     * @param aASID The ASID to invalidate
+     */
+    void InvalidateASID(uint16_t aASID);
+
+    /**
+     * Invalidates every cached translation, for every ASID
+     */
+    void InvalidateAll();
+}
+
+#endif // KERNEL_AARCH64_TLB_H
\ No newline at end of file
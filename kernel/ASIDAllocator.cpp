@@ -0,0 +1,65 @@
+#include "ASIDAllocator.h"
+
+#include <cstdint>
+
+namespace MemoryManager
+{
+    bool ASIDAllocator::Refresh(uint64_t& arContext, uint64_t* const* const apLiveContexts, uint32_t const aLiveCount)
+    {
+        if ((arContext >> GenerationShiftC) == Generation)
+        {
+            return false;
+        }
+
+        auto newGeneration = false;
+        while ((NextASID < ASIDCount) && IsReserved(NextASID))
+        {
+            ++NextASID;
+        }
+        if (NextASID >= ASIDCount)
+        {
+            // Out of ASIDs, so anything tagged with an older generation has to go. The stale contexts will pick up
+            // new ASIDs as they're activated
+            ++Generation;
+            NextASID = KernelASID + 1;
+            newGeneration = true;
+
+            // Other CPUs are still running with their ASIDs, so those can't be handed to anyone else. They keep them
+            // into the new generation, which also stops them picking up new ones the next time they're activated
+            ReservedCount = 0;
+            for (auto curContext = 0U; (curContext < aLiveCount) && (ReservedCount < MaxLiveContextsC); ++curContext)
+            {
+                // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+                auto& rliveContext = *apLiveContexts[curContext];
+                if ((rliveContext == UnassignedContextC) || (&rliveContext == &arContext))
+                {
+                    continue;
+                }
+                auto const asid = GetASID(rliveContext);
+                rliveContext = (Generation << GenerationShiftC) | asid;
+                Reserved[ReservedCount++] = asid; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+            }
+            while (IsReserved(NextASID))
+            {
+                ++NextASID;
+            }
+        }
+
+        arContext = (Generation << GenerationShiftC) | NextASID;
+        ++NextASID;
+        return newGeneration;
+    }
+
+    bool ASIDAllocator::IsReserved(uint32_t const aASID) const
+    {
+        for (auto curReserved = 0U; curReserved < ReservedCount; ++curReserved)
+        {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+            if (Reserved[curReserved] == aASID)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,88 @@
+#ifndef KERNEL_ASID_ALLOCATOR_H
+#define KERNEL_ASID_ALLOCATOR_H
+
+#include <cstdint>
+
+namespace MemoryManager
+{
+    /**
+     * ASID used by the kernel (and the boot identity mappings), never handed out to a task
+     */
+    constexpr uint16_t KernelASID = 0;
+
+    /**
+     * Hands out address space IDs, which tag the TLB entries of non-global pages so switching address spaces doesn't
+     * require throwing away the TLB. ASIDs are handed out in order and never recycled individually. Once they run out
+     * a new generation is started, which requires the caller to invalidate the whole TLB, and every address space
+     * tagged with an older generation picks up a new ASID the next time it's activated. Address spaces live on other
+     * CPUs when the generation rolls over keep their ASIDs, since those CPUs are still using them.
+     */
+    class ASIDAllocator
+    {
+    public:
+        /**
+         * Value for an address space that has never been given an ASID
+         */
+        static constexpr uint64_t UnassignedContextC = 0;
+
+        /**
+         * The most live contexts that can be carried over to a new generation
+         */
+        static constexpr uint32_t MaxLiveContextsC = 8;
+
+        /**
+         * Sets up the allocator
+         * 
+         * @param aASIDCount The number of ASIDs the hardware supports (256 or 65536), including the kernel's
+         */
+        explicit constexpr ASIDAllocator(uint32_t const aASIDCount)
+            : ASIDCount{ aASIDCount }
+        {}
+
+        /**
+         * Makes sure the context holds an ASID from the current generation, assigning a new one if it doesn't
+         * 
+         * @param arContext The context to check, which holds the generation and ASID (UnassignedContextC if the
+         * address space hasn't been given one yet)
+         * @param apLiveContexts The contexts of the address spaces active on other CPUs, which are moved to the new
+         * generation with their ASIDs intact if one is started (no more than MaxLiveContextsC)
+         * @param aLiveCount The number of entries in apLiveContexts
+         * @return True if a new generation was started, in which case the entire TLB must be invalidated before the
+         * ASID is used
+         */
+        bool Refresh(uint64_t& arContext, uint64_t* const* apLiveContexts = nullptr, uint32_t aLiveCount = 0);
+
+        /**
+         * Obtains the ASID from a context
+         * 
+         * @param aContext The context, as set by Refresh
+         * @return The ASID to put in TTBR0_EL1
+         */
+        static constexpr uint16_t GetASID(uint64_t const aContext)
+        {
+            return static_cast<uint16_t>(aContext & ASIDMaskC);
+        }
+
+    private:
+        static constexpr unsigned GenerationShiftC = 16;
+        static constexpr uint64_t ASIDMaskC = 0xFFFF;
+
+        /**
+         * Checks if an ASID was carried over into the current generation
+         * 
+         * @param aASID The ASID to check
+         * @return True if the ASID is reserved
+         */
+        bool IsReserved(uint32_t aASID) const;
+
+        uint32_t ASIDCount = 0;
+        uint64_t Generation = 1; // starts at 1, so a context of 0 is never current
+        uint32_t NextASID = KernelASID + 1;
+        // #TODO: Remove lint tag when we get std::array
+        // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+        uint16_t Reserved[MaxLiveContextsC] = {}; // ASIDs carried over into the current generation
+        uint32_t ReservedCount = 0;
+    };
+}
+
+#endif // KERNEL_ASID_ALLOCATOR_H
\ No newline at end of file
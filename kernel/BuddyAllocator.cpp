@@ -0,0 +1,294 @@
+#include "BuddyAllocator.h"
+
+#include <cstddef>
+#include <cstdint>
+#include "MemoryManager.h"
+#include "PointerTypes.h"
+
+namespace MemoryManager
+{
+    namespace
+    {
+        // How many blocks to check in each of the smaller free lists when first looking for a color, so a fragmented
+        // list doesn't make every allocation walk all of memory. Blocks of order 3 and up hold every color, so the first
+        // one will always do. Only if no allowed color turns up within the limit are the lists scanned in full
+        constexpr auto ColorScanLimitC = 16U;
+        constexpr auto FullScanC = UINT32_MAX;
+    }
+
+    void BuddyAllocator::Init(PhysicalPtr const aBase, PageFrame* const apFrames, size_t const aFrameCount)
+    {
+        // #TODO: Panic if the base isn't page aligned, or we have more frames than we can index
+        Base = aBase;
+        pFrames = apFrames;
+        FrameCount = aFrameCount;
+        FreePageCount = 0;
+        for (auto& freeListHead : FreeLists)
+        {
+            freeListHead = PageFrame::InvalidIndexC;
+        }
+        for (auto curFrame = 0U; curFrame < FrameCount; ++curFrame)
+        {
+            Frame(curFrame) = PageFrame{};
+        }
+    }
+
+    void BuddyAllocator::AddFreeRange(PhysicalPtr const aBegin, PhysicalPtr const aEnd)
+    {
+        if (FrameCount == 0)
+        {
+            return;
+        }
+
+        // Clamp the range to the pages we actually manage
+        auto const managedEnd = Base.Offset(FrameCount * PageSize);
+        auto const begin = CalculateBlockStart(PhysicalPtr{ aBegin.GetAddress() + PageSize - 1 }, PageSize);
+        auto const end = CalculateBlockStart(aEnd, PageSize);
+        if ((end <= Base) || (begin >= managedEnd) || (begin >= end))
+        {
+            return;
+        }
+        auto curIndex = (begin < Base) ? 0ULL : ((begin.GetAddress() - Base.GetAddress()) / PageSize);
+        auto const endIndex = (end > managedEnd) ? FrameCount : ((end.GetAddress() - Base.GetAddress()) / PageSize);
+
+        // Carve the range into the largest naturally-aligned blocks that fit, so we only touch a handful of frames
+        // per block rather than freeing every page one at a time
+        while (curIndex < endIndex)
+        {
+            auto order = 0U;
+            while ((order < MaxOrderC) &&
+                ((curIndex & ((2ULL << order) - 1)) == 0) &&
+                ((curIndex + (2ULL << order)) <= endIndex))
+            {
+                ++order;
+            }
+            FreeBlock(static_cast<uint32_t>(curIndex), order);
+            curIndex += (1ULL << order);
+        }
+    }
+
+    PhysicalPtr BuddyAllocator::Allocate(unsigned const aOrder)
+    {
+        if ((FrameCount == 0) || (aOrder > MaxOrderC))
+        {
+            return PhysicalPtr{};
+        }
+
+        // Find the smallest order that has a block available
+        auto foundOrder = aOrder;
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+        while ((foundOrder <= MaxOrderC) && (FreeLists[foundOrder] == PageFrame::InvalidIndexC))
+        {
+            ++foundOrder;
+        }
+        if (foundOrder > MaxOrderC)
+        {
+            return PhysicalPtr{};
+        }
+
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+        auto const index = FreeLists[foundOrder];
+        return TakeBlock(index, foundOrder, index, aOrder);
+    }
+
+    PhysicalPtr BuddyAllocator::AllocateColored(uint8_t const aColorMask, unsigned const aPreferredColor)
+    {
+        if (FrameCount == 0)
+        {
+            return PhysicalPtr{};
+        }
+        auto const allocateAllowedColor = [this, aColorMask, aPreferredColor](uint32_t const aScanLimit)
+        {
+            for (auto curColor = 0U; curColor < ColorCountC; ++curColor)
+            {
+                auto const color = (aPreferredColor + curColor) % ColorCountC;
+                if ((aColorMask & (1U << color)) == 0)
+                {
+                    continue;
+                }
+                auto const page = AllocatePageOfColor(color, aScanLimit);
+                if (page != PhysicalPtr{})
+                {
+                    return page;
+                }
+            }
+            return PhysicalPtr{};
+        };
+
+        // A quick pass over every allowed color first, so we don't walk a whole list for the preferred color when the
+        // next one is close to hand, and then a full one, so a page that's there is never missed
+        auto const page = allocateAllowedColor(ColorScanLimitC);
+        if (page != PhysicalPtr{})
+        {
+            return page;
+        }
+        return allocateAllowedColor(FullScanC);
+    }
+
+    unsigned BuddyAllocator::GetColor(PhysicalPtr const aPage)
+    {
+        // Colored by physical address rather than index, so it matches the cache no matter where the base is
+        return (aPage.GetAddress() / PageSize) % ColorCountC;
+    }
+
+    void BuddyAllocator::Free(PhysicalPtr const aBlock)
+    {
+        auto* const pframe = GetFrame(aBlock);
+        if ((pframe == nullptr) || ((pframe->Flags & PageFrameFlags::AllocatedC) == 0))
+        {
+            // #TODO: Panic on double free or a pointer we never handed out
+            return;
+        }
+        auto const index = static_cast<uint32_t>((aBlock.GetAddress() - Base.GetAddress()) / PageSize);
+        FreeBlock(index, pframe->Order);
+    }
+
+    void BuddyAllocator::SplitAllocated(PhysicalPtr const aBlock)
+    {
+        auto* const pframe = GetFrame(aBlock);
+        if ((pframe == nullptr) || ((pframe->Flags & PageFrameFlags::AllocatedC) == 0))
+        {
+            // #TODO: Panic on a pointer we never handed out
+            return;
+        }
+        auto const index = static_cast<uint32_t>((aBlock.GetAddress() - Base.GetAddress()) / PageSize);
+        auto const pageCount = 1U << pframe->Order;
+        auto const refCount = pframe->RefCount;
+        for (auto curPage = 0U; curPage < pageCount; ++curPage)
+        {
+            auto& frame = Frame(index + curPage);
+            frame.Order = 0;
+            frame.Flags = PageFrameFlags::AllocatedC;
+            frame.RefCount = refCount;
+        }
+    }
+
+    PhysicalPtr BuddyAllocator::TakeBlock(uint32_t aIndex, unsigned aOrder, uint32_t const aTargetIndex, unsigned const aTargetOrder)
+    {
+        RemoveFreeBlock(aIndex, aOrder);
+
+        // Split the block down to the size requested, returning the halves without the target to the free lists
+        while (aOrder > aTargetOrder)
+        {
+            --aOrder;
+            auto const upperHalf = aIndex + (1U << aOrder);
+            if (aTargetIndex >= upperHalf)
+            {
+                PushFreeBlock(aIndex, aOrder);
+                aIndex = upperHalf;
+            }
+            else
+            {
+                PushFreeBlock(upperHalf, aOrder);
+            }
+        }
+
+        auto& frame = Frame(aIndex);
+        frame.Order = static_cast<uint8_t>(aTargetOrder);
+        frame.Flags = PageFrameFlags::AllocatedC;
+        frame.RefCount = 0;
+        return Base.Offset(aIndex * PageSize);
+    }
+
+    PhysicalPtr BuddyAllocator::AllocatePageOfColor(unsigned const aColor, uint32_t const aScanLimit)
+    {
+        // Prefer the smallest blocks, so we don't break up large ones just for their color
+        for (auto curOrder = 0U; curOrder <= MaxOrderC; ++curOrder)
+        {
+            auto scanned = 0U;
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+            for (auto curIndex = FreeLists[curOrder]; (curIndex != PageFrame::InvalidIndexC) && (scanned < aScanLimit); curIndex = Frame(curIndex).Next)
+            {
+                // Blocks are aligned to their size, so a block's colors run up from its first page's without wrapping
+                auto const offset = (aColor - GetColor(Base.Offset(curIndex * PageSize))) % ColorCountC;
+                if (offset < (1U << curOrder))
+                {
+                    return TakeBlock(curIndex, curOrder, curIndex + offset, 0);
+                }
+                ++scanned;
+            }
+        }
+        return PhysicalPtr{};
+    }
+
+    PageFrame* BuddyAllocator::GetFrame(PhysicalPtr const aPage) const
+    {
+        if ((aPage < Base) || (aPage >= Base.Offset(FrameCount * PageSize)))
+        {
+            return nullptr;
+        }
+        return &Frame(static_cast<uint32_t>((aPage.GetAddress() - Base.GetAddress()) / PageSize));
+    }
+
+    void BuddyAllocator::PushFreeBlock(uint32_t const aIndex, unsigned const aOrder)
+    {
+        auto& frame = Frame(aIndex);
+        frame.Order = static_cast<uint8_t>(aOrder);
+        frame.Flags = PageFrameFlags::FreeC;
+        frame.Prev = PageFrame::InvalidIndexC;
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+        frame.Next = FreeLists[aOrder];
+        if (frame.Next != PageFrame::InvalidIndexC)
+        {
+            Frame(frame.Next).Prev = aIndex;
+        }
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+        FreeLists[aOrder] = aIndex;
+        FreePageCount += (1ULL << aOrder);
+    }
+
+    void BuddyAllocator::RemoveFreeBlock(uint32_t const aIndex, unsigned const aOrder)
+    {
+        auto& frame = Frame(aIndex);
+        if (frame.Prev != PageFrame::InvalidIndexC)
+        {
+            Frame(frame.Prev).Next = frame.Next;
+        }
+        else
+        {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+            FreeLists[aOrder] = frame.Next;
+        }
+        if (frame.Next != PageFrame::InvalidIndexC)
+        {
+            Frame(frame.Next).Prev = frame.Prev;
+        }
+        frame.Next = PageFrame::InvalidIndexC;
+        frame.Prev = PageFrame::InvalidIndexC;
+        frame.Flags = 0;
+        FreePageCount -= (1ULL << aOrder);
+    }
+
+    void BuddyAllocator::FreeBlock(uint32_t aIndex, unsigned aOrder)
+    {
+        Frame(aIndex).Flags = 0;
+
+        // Merge with our buddy for as long as it is free and the same size as us. Each step doubles the block size,
+        // so this is bounded by MaxOrderC
+        while (aOrder < MaxOrderC)
+        {
+            auto const buddyIndex = aIndex ^ (1U << aOrder);
+            if (buddyIndex >= FrameCount)
+            {
+                break;
+            }
+            auto const& buddy = Frame(buddyIndex);
+            if (((buddy.Flags & PageFrameFlags::FreeC) == 0) || (buddy.Order != aOrder))
+            {
+                break;
+            }
+            RemoveFreeBlock(buddyIndex, aOrder);
+            // the merged block starts at whichever of the two is lower
+            aIndex &= ~(1U << aOrder);
+            ++aOrder;
+        }
+        PushFreeBlock(aIndex, aOrder);
+    }
+
+    PageFrame& BuddyAllocator::Frame(uint32_t const aIndex) const
+    {
+        // #TODO: Range check the index
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        return pFrames[aIndex];
+    }
+}
\ No newline at end of file
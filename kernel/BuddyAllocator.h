@@ -0,0 +1,206 @@
+#ifndef KERNEL_BUDDY_ALLOCATOR_H
+#define KERNEL_BUDDY_ALLOCATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include "PointerTypes.h"
+
+namespace MemoryManager
+{
+    namespace PageFrameFlags
+    {
+        constexpr uint8_t FreeC = 0x1;      // Frame heads a block sitting in one of the free lists
+        constexpr uint8_t AllocatedC = 0x2; // Frame heads a block handed out by the allocator
+        constexpr uint8_t SlabC = 0x4;      // Frame is part of a slab (set by the slab allocator, on every frame)
+    }
+
+    /**
+     * Bookkeeping for a single physical page. Lives in a seperate array (rather than in the page itself) so the
+     * allocator never has to touch the memory it hands out
+     */
+    struct PageFrame
+    {
+        static constexpr uint32_t InvalidIndexC = 0xFFFF'FFFFU;
+
+        uint32_t Next = InvalidIndexC; // next block in the free list (only valid when free)
+        uint32_t Prev = InvalidIndexC; // previous block in the free list (only valid when free)
+        uint8_t Order = 0; // order of the block this frame heads (only valid on block heads and slab frames)
+        uint8_t Flags = 0; // PageFrameFlags
+        uint16_t RefCount = 0; // number of user mappings of the block (only valid on allocated block heads)
+    };
+
+    /**
+     * Binary buddy allocator for physical pages. Blocks are 2^order pages in size, and are always aligned to their
+     * own size (relative to the base address), so a block's buddy can be found by flipping a single bit in its index.
+     */
+    class BuddyAllocator
+    {
+    public:
+        /**
+         * The largest order the allocator will hand out (2^MaxOrderC pages)
+         */
+        static constexpr unsigned MaxOrderC = 10;
+
+        /**
+         * Number of page colors in the L2 cache. Pages with the same color compete for the same cache sets (the
+         * BCM2837's Cortex-A53 cluster shares a 512KB 16-way L2, so each way covers 32KB, or 8 pages)
+         */
+        static constexpr unsigned ColorCountC = 8;
+
+        /**
+         * Color mask allowing every color
+         */
+        static constexpr uint8_t AllColorsC = 0xFF;
+
+        /**
+         * Constructs an empty allocator, which will fail all allocations until Init is called
+         */
+        BuddyAllocator() = default;
+
+        // Disable copying/moving, since the free lists refer to the frame array we were given
+        BuddyAllocator(BuddyAllocator const&) = delete;
+        BuddyAllocator(BuddyAllocator&&) = delete;
+        BuddyAllocator& operator=(BuddyAllocator const&) = delete;
+        BuddyAllocator& operator=(BuddyAllocator&&) = delete;
+        ~BuddyAllocator() = default;
+
+        /**
+         * Sets up the allocator to manage the given span of physical memory. All pages start out reserved, and need
+         * to be handed to the allocator with AddFreeRange before they can be allocated
+         * 
+         * @param aBase The physical address of the first page being managed (must be page aligned)
+         * @param apFrames Frame array, one per page. Must outlive the allocator
+         * @param aFrameCount Number of frames in the array (and pages being managed)
+         */
+        void Init(PhysicalPtr aBase, PageFrame* apFrames, size_t aFrameCount);
+
+        /**
+         * Hands a range of memory over to the allocator to be allocated from
+         * 
+         * @param aBegin The start of the range (rounded up to a page)
+         * @param aEnd The end of the range - exclusive (rounded down to a page)
+         */
+        void AddFreeRange(PhysicalPtr aBegin, PhysicalPtr aEnd);
+
+        /**
+         * Allocates a block of physically contiguous pages
+         * 
+         * @param aOrder The order of the block (block will be 2^aOrder pages in size)
+         * @return The physical address of the first page in the block, or null if no block could be found
+         */
+        [[nodiscard]] PhysicalPtr Allocate(unsigned aOrder);
+
+        /**
+         * Allocates a single page with one of the allowed cache colors, trying the preferred color first and then the
+         * allowed colors above it in turn. Only gives up once every free list has been searched
+         * 
+         * @param aColorMask Bit mask of the colors the page may have
+         * @param aPreferredColor The color to try first
+         * @return The physical address of the page, or null if no page with an allowed color could be found
+         */
+        [[nodiscard]] PhysicalPtr AllocateColored(uint8_t aColorMask, unsigned aPreferredColor);
+
+        /**
+         * Obtains the cache color of a page
+         * 
+         * @param aPage The page's physical address
+         * @return The page's color (less than ColorCountC)
+         */
+        [[nodiscard]] static unsigned GetColor(PhysicalPtr aPage);
+
+        /**
+         * Returns a block allocated with Allocate or AllocateColored to the allocator
+         * 
+         * @param aBlock The address returned from Allocate
+         */
+        void Free(PhysicalPtr aBlock);
+
+        /**
+         * Splits an allocated block into single pages, which can then be freed one at a time. Every page gets the
+         * block's reference count
+         * 
+         * @param aBlock The address returned from Allocate
+         */
+        void SplitAllocated(PhysicalPtr aBlock);
+
+        /**
+         * Obtains the frame for the given page
+         * 
+         * @param aPage The page to get the frame for
+         * @return The frame for the page, or null if the page is not managed by this allocator
+         */
+        [[nodiscard]] PageFrame* GetFrame(PhysicalPtr aPage) const;
+
+        /**
+         * Obtains the number of pages sitting in the free lists
+         * 
+         * @return The number of free pages
+         */
+        [[nodiscard]] size_t GetFreePageCount() const { return FreePageCount; }
+
+    private:
+        /**
+         * Takes a free block out of its free list, and splits it down until only the target block is left, returning
+         * the rest to the free lists
+         * 
+         * @param aIndex The index of the first page in the free block
+         * @param aOrder The order of the free block
+         * @param aTargetIndex The index of the first page in the block to keep (must be aligned to its order, and
+         * inside the free block)
+         * @param aTargetOrder The order of the block to keep
+         * @return The physical address of the kept block, which is now allocated
+         */
+        PhysicalPtr TakeBlock(uint32_t aIndex, unsigned aOrder, uint32_t aTargetIndex, unsigned aTargetOrder);
+
+        /**
+         * Allocates a single page of the given color
+         * 
+         * @param aColor The color of the page
+         * @param aScanLimit The most blocks to check in each free list
+         * @return The physical address of the page, or null if no page of that color could be found within the limit
+         */
+        PhysicalPtr AllocatePageOfColor(unsigned aColor, uint32_t aScanLimit);
+
+        /**
+         * Pushes a block onto the front of the free list for the given order
+         * 
+         * @param aIndex The index of the first page in the block
+         * @param aOrder The order of the block
+         */
+        void PushFreeBlock(uint32_t aIndex, unsigned aOrder);
+
+        /**
+         * Removes a block from the free list for the given order
+         * 
+         * @param aIndex The index of the first page in the block
+         * @param aOrder The order of the block
+         */
+        void RemoveFreeBlock(uint32_t aIndex, unsigned aOrder);
+
+        /**
+         * Frees a block, merging it with its buddies as far as possible
+         * 
+         * @param aIndex The index of the first page in the block
+         * @param aOrder The order of the block
+         */
+        void FreeBlock(uint32_t aIndex, unsigned aOrder);
+
+        /**
+         * Obtains the frame at the given index
+         * 
+         * @param aIndex The index of the frame
+         * @return The frame
+         */
+        [[nodiscard]] PageFrame& Frame(uint32_t aIndex) const;
+
+        PhysicalPtr Base;
+        PageFrame* pFrames = nullptr;
+        size_t FrameCount = 0;
+        size_t FreePageCount = 0;
+        // #TODO: Remove lint tag when we get std::array
+        // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+        uint32_t FreeLists[MaxOrderC + 1] = {};
+    };
+}
+
+#endif // KERNEL_BUDDY_ALLOCATOR_H
\ No newline at end of file
@@ -0,0 +1,25 @@
+#include "CoreMailbox.h"
+
+#include <cstdint>
+#include "AArch64/CPU.h"
+#include "Peripherals/CoreMailbox.h"
+#include "Utils.h"
+
+namespace CoreMailbox
+{
+    // Only mailbox 0 is used, and only one bit of it, since the message is always the same
+
+    void Send(uint32_t const aCore)
+    {
+        constexpr uint32_t WakeMessage = 1U << 0U;
+        MemoryMappedIO::Put32(MemoryMappedIO::CoreMailbox::Core0Mailbox0Set.Offset(aCore * MemoryMappedIO::CoreMailbox::MailboxStride), WakeMessage);
+    }
+
+    void HandleIRQ()
+    {
+        // The interrupt stays raised until every bit is cleared
+        constexpr uint32_t AllBits = 0xFFFF'FFFFU;
+        auto const core = AArch64::CPU::GetCurrentCore();
+        MemoryMappedIO::Put32(MemoryMappedIO::CoreMailbox::Core0Mailbox0ReadClear.Offset(core * MemoryMappedIO::CoreMailbox::MailboxStride), AllBits);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,22 @@
+#ifndef KERNEL_CORE_MAILBOX_H
+#define KERNEL_CORE_MAILBOX_H
+
+#include <cstdint>
+
+namespace CoreMailbox
+{
+    /**
+     * Interrupts another core. Its only effect is to wake the core if it's waiting for an interrupt, so it can take
+     * another look at whatever it was waiting for
+     * 
+     * @param aCore The core to interrupt
+     */
+    void Send(uint32_t aCore);
+
+    /**
+     * Handle an interrupt from the calling core's mailbox
+     */
+    void HandleIRQ();
+}
+
+#endif // KERNEL_CORE_MAILBOX_H
\ No newline at end of file
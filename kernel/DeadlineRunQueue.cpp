@@ -0,0 +1,149 @@
+#include "DeadlineRunQueue.h"
+
+#include <cstdint>
+#include "RedBlackTree.h"
+#include "TaskStructs.h"
+
+namespace Scheduler
+{
+    namespace
+    {
+        /**
+         * Obtains the task linked into a tree by a node
+         * 
+         * @param aNode The node
+         * @return The task
+         */
+        TaskStruct* GetTask(Containers::RedBlackNode const& aNode)
+        {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+            return reinterpret_cast<RunQueueTreeNode const&>(aNode).pTask;
+        }
+
+        /**
+         * Links a task into a tree by its deadline, after any tasks with the same deadline
+         * 
+         * @param arTree The tree to link it into
+         * @param arTask The task to link
+         */
+        void Insert(Containers::RedBlackTree& arTree, TaskStruct& arTask)
+        {
+            arTree.InsertOrdered(arTask.QueuedNode.Node,
+                [](Containers::RedBlackNode const& aLhs, Containers::RedBlackNode const& aRhs)
+                {
+                    return GetTask(aLhs)->AbsoluteDeadline < GetTask(aRhs)->AbsoluteDeadline;
+                });
+        }
+    }
+
+    uint64_t DeadlineRunQueue::GetBandwidth(uint64_t const aRuntime, uint64_t const aPeriod)
+    {
+        // Round up, so a lot of small reservations can't add up to more than they look like
+        return ((aRuntime * FullBandwidthC) + aPeriod - 1) / aPeriod;
+    }
+
+    bool DeadlineRunQueue::CanAdmit(TaskStruct const& aTask, uint64_t const aRuntime, uint64_t const aPeriod) const
+    {
+        auto const replacedBandwidth = (aTask.Policy == SchedulingPolicy::Deadline) ?
+            GetBandwidth(aTask.DeadlineRuntime, aTask.DeadlinePeriod) : 0;
+        return (TotalBandwidth - replacedBandwidth + GetBandwidth(aRuntime, aPeriod)) <= MaxBandwidthC;
+    }
+
+    void DeadlineRunQueue::Reserve(TaskStruct const& aTask)
+    {
+        TotalBandwidth += GetBandwidth(aTask.DeadlineRuntime, aTask.DeadlinePeriod);
+    }
+
+    void DeadlineRunQueue::Release(TaskStruct const& aTask)
+    {
+        TotalBandwidth -= GetBandwidth(aTask.DeadlineRuntime, aTask.DeadlinePeriod);
+    }
+
+    void DeadlineRunQueue::Enqueue(TaskStruct& arTask, uint64_t const aNow)
+    {
+        arTask.QueuedNode.pTask = &arTask;
+        // Running out what's left of the period would take more than the task's share of the CPU, and could push
+        // everyone else past their deadlines, so it has to start over instead
+        if ((arTask.AbsoluteDeadline <= aNow) ||
+            (GetBandwidth(arTask.RemainingRuntime, arTask.AbsoluteDeadline - aNow) > GetBandwidth(arTask.DeadlineRuntime, arTask.DeadlinePeriod)))
+        {
+            arTask.AbsoluteDeadline = aNow + arTask.DeadlinePeriod;
+            arTask.RemainingRuntime = arTask.DeadlineRuntime;
+        }
+        // A task that used up its runtime before blocking waits out the rest of its period as before
+        arTask.Throttled = (arTask.RemainingRuntime == 0);
+        Insert(arTask.Throttled ? ThrottledTree : ReadyTree, arTask);
+        arTask.Queued = true;
+        ++Count;
+        Publish();
+    }
+
+    void DeadlineRunQueue::Remove(TaskStruct& arTask)
+    {
+        (arTask.Throttled ? ThrottledTree : ReadyTree).Remove(arTask.QueuedNode.Node);
+        arTask.Queued = false;
+        arTask.Throttled = false;
+        --Count;
+        Publish();
+    }
+
+    void DeadlineRunQueue::ChargeRuntime(TaskStruct& arTask, uint64_t const aRanCycles)
+    {
+        if (aRanCycles < arTask.RemainingRuntime)
+        {
+            // Still has runtime left, and the deadline (and so its place in the tree) hasn't changed
+            arTask.RemainingRuntime -= aRanCycles;
+            return;
+        }
+        arTask.RemainingRuntime = 0;
+        ReadyTree.Remove(arTask.QueuedNode.Node);
+        Insert(ThrottledTree, arTask);
+        arTask.Throttled = true;
+        Publish();
+    }
+
+    void DeadlineRunQueue::Replenish(uint64_t const aNow)
+    {
+        auto* pfirst = ThrottledTree.GetFirst();
+        while ((pfirst != nullptr) && (GetTask(*pfirst)->AbsoluteDeadline <= aNow))
+        {
+            auto& rtask = *GetTask(*pfirst);
+            ThrottledTree.Remove(*pfirst);
+            rtask.AbsoluteDeadline += rtask.DeadlinePeriod;
+            if (rtask.AbsoluteDeadline <= aNow)
+            {
+                // Replenished late enough to miss a whole period, so start over from now rather than get a deadline
+                // that's already passed and jump ahead of everything else
+                rtask.AbsoluteDeadline = aNow + rtask.DeadlinePeriod;
+            }
+            rtask.RemainingRuntime = rtask.DeadlineRuntime;
+            rtask.Throttled = false;
+            Insert(ReadyTree, rtask);
+            pfirst = ThrottledTree.GetFirst();
+        }
+        Publish();
+    }
+
+    TaskStruct* DeadlineRunQueue::PickNext() const
+    {
+        auto const* const pfirst = ReadyTree.GetFirst();
+        return (pfirst == nullptr) ? nullptr : GetTask(*pfirst);
+    }
+
+    bool DeadlineRunQueue::HasReady() const
+    {
+        return __atomic_load_n(&AnyReady, __ATOMIC_RELAXED);
+    }
+
+    uint64_t DeadlineRunQueue::GetNextReplenish() const
+    {
+        return __atomic_load_n(&NextReplenish, __ATOMIC_RELAXED);
+    }
+
+    void DeadlineRunQueue::Publish()
+    {
+        auto const* const pfirstThrottled = ThrottledTree.GetFirst();
+        __atomic_store_n(&AnyReady, ReadyTree.GetFirst() != nullptr, __ATOMIC_RELAXED);
+        __atomic_store_n(&NextReplenish, (pfirstThrottled == nullptr) ? UINT64_MAX : GetTask(*pfirstThrottled)->AbsoluteDeadline, __ATOMIC_RELAXED);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,155 @@
+#ifndef KERNEL_DEADLINE_RUN_QUEUE_H
+#define KERNEL_DEADLINE_RUN_QUEUE_H
+
+#include <cstdint>
+#include "RedBlackTree.h"
+
+namespace Scheduler
+{
+    struct TaskStruct;
+
+    /**
+     * Run queue that runs the task with the earliest deadline first. Each task reserves a runtime out of every period,
+     * and its deadline is the end of the current period. Once a task has used up its runtime it's throttled until its
+     * deadline, when the next period starts with its runtime refilled, so a task can never take more than it reserved.
+     * The reservations are checked on the way in, so as long as they add up to less than the whole CPU every task gets
+     * its runtime by its deadline. A task keeps its reservation while it's off the queue (blocked), and when it comes
+     * back it carries on with its current period unless what's left of it would let it run faster than it reserved
+     * (the constant bandwidth server wakeup rule), so blocking never earns a task a fresh runtime early.
+     */
+    class DeadlineRunQueue
+    {
+    public:
+        /**
+         * Bandwidth of a task that reserves the whole CPU (bandwidths are fixed point fractions of this)
+         */
+        static constexpr uint64_t FullBandwidthC = 1ULL << 20U;
+
+        /**
+         * Most bandwidth the tasks on a queue can reserve between them (95%, rounded up the same as GetBandwidth),
+         * leaving some for the other classes
+         */
+        static constexpr uint64_t MaxBandwidthC = ((FullBandwidthC * 95) + 99) / 100;
+
+        /**
+         * Obtains the share of the CPU a reservation takes
+         * 
+         * @param aRuntime The runtime reserved each period, in counter-timer cycles
+         * @param aPeriod The length of the period, in counter-timer cycles
+         * @return The bandwidth, as a fraction of FullBandwidthC
+         */
+        static uint64_t GetBandwidth(uint64_t aRuntime, uint64_t aPeriod);
+
+        /**
+         * Checks if a task's new reservation fits on the queue. If the task already has a reservation on this queue
+         * (it's a deadline task), it's replaced by the new one
+         * 
+         * @param aTask The task making the reservation
+         * @param aRuntime The runtime to reserve each period, in counter-timer cycles
+         * @param aPeriod The length of the period, in counter-timer cycles
+         * @return True if the reservation fits
+         */
+        [[nodiscard]] bool CanAdmit(TaskStruct const& aTask, uint64_t aRuntime, uint64_t aPeriod) const;
+
+        /**
+         * Takes a task's reservation, which is kept until Release whether or not the task is on the queue
+         * 
+         * @param aTask The task, with its new reservation (must have been admitted)
+         */
+        void Reserve(TaskStruct const& aTask);
+
+        /**
+         * Gives a task's reservation back
+         * 
+         * @param aTask The task, with the reservation it was given (must have been reserved on this queue)
+         */
+        void Release(TaskStruct const& aTask);
+
+        /**
+         * Adds a task to the queue. The task carries on with its current period if it can finish its remaining runtime
+         * by its deadline without running faster than it reserved, otherwise it starts a new period from now (as it
+         * does if the period is over, or it has never run)
+         * 
+         * @param arTask The task to add (must not already be on a queue, and must be reserved on this one)
+         * @param aNow The current counter-timer value
+         */
+        void Enqueue(TaskStruct& arTask, uint64_t aNow);
+
+        /**
+         * Removes a task from the queue, keeping its reservation and the rest of its current period
+         * 
+         * @param arTask The task to remove (must be on this queue)
+         */
+        void Remove(TaskStruct& arTask);
+
+        /**
+         * Charges a task for time it spent running, throttling it if it has used up its runtime
+         * 
+         * @param arTask The task that ran (must be on this queue, and not throttled)
+         * @param aRanCycles The number of counter-timer cycles it ran for
+         */
+        void ChargeRuntime(TaskStruct& arTask, uint64_t aRanCycles);
+
+        /**
+         * Starts the next period of every throttled task whose deadline has passed
+         * 
+         * @param aNow The current counter-timer value
+         */
+        void Replenish(uint64_t aNow);
+
+        /**
+         * Obtains the task that should run next - the one with the earliest deadline that isn't throttled. The task
+         * stays on the queue
+         * 
+         * @return The task to run next, or null if every task is throttled (or the queue is empty)
+         */
+        [[nodiscard]] TaskStruct* PickNext() const;
+
+        /**
+         * Checks if any task on the queue isn't throttled. Safe to call without the kernel lock, though the answer may
+         * be out of date by the time it's used
+         * 
+         * @return True if PickNext would find a task
+         */
+        [[nodiscard]] bool HasReady() const;
+
+        /**
+         * Obtains when the next throttled task will be replenished. Safe to call without the kernel lock, though the
+         * answer may be out of date by the time it's used
+         * 
+         * @return The counter-timer value the first throttled task's deadline is at, or UINT64_MAX if none are throttled
+         */
+        [[nodiscard]] uint64_t GetNextReplenish() const;
+
+        /**
+         * Obtains the bandwidth reserved on the queue, including by tasks that are off it
+         * 
+         * @return The bandwidth, as a fraction of FullBandwidthC
+         */
+        [[nodiscard]] uint64_t GetTotalBandwidth() const { return TotalBandwidth; }
+
+        /**
+         * Obtains the number of tasks on the queue, throttled or not
+         * 
+         * @return The number of tasks
+         */
+        [[nodiscard]] uint32_t GetCount() const { return Count; }
+
+    private:
+        /**
+         * Updates the copies of the trees' state that HasReady and GetNextReplenish read, once the trees have changed
+         */
+        void Publish();
+
+        Containers::RedBlackTree ReadyTree; // RunQueueTreeNode, ordered by TaskStruct::AbsoluteDeadline
+        Containers::RedBlackTree ThrottledTree; // RunQueueTreeNode, ordered by TaskStruct::AbsoluteDeadline
+        uint64_t TotalBandwidth = 0;
+        uint32_t Count = 0;
+        // Other CPUs may change the trees (under the kernel lock) while the queue's own CPU checks them at its tick
+        // (without it), so the tick reads these instead of walking trees that may be half rebalanced
+        bool AnyReady = false;
+        uint64_t NextReplenish = UINT64_MAX;
+    };
+}
+
+#endif // KERNEL_DEADLINE_RUN_QUEUE_H
\ No newline at end of file
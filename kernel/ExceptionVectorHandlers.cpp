@@ -1,5 +1,9 @@
 #include <cstdint>
+#include "AArch64/CPU.h"
+#include "CoreMailbox.h"
+#include "Peripherals/CoreMailbox.h"
 #include "Peripherals/IRQ.h"
+#include "Peripherals/Timer.h"
 #include "PointerTypes.h"
 #include "Print.h"
 #include "Timer.h"
@@ -41,6 +45,13 @@ namespace
 
     // Sourced from:
     // https://www.raspberrypi.org/documentation/hardware/raspberrypi/bcm2836/QA7_rev3.4.pdf
+    // Physical timer, which raises the secure or non-secure line depending on the world we're running in
+    constexpr uint32_t CoreTimerIRQs = (1U << 0U) | (1U << 1U);
+    // Mailbox 0 (in the core mailbox interrupt control register, and in the core IRQ source register)
+    constexpr uint32_t Mailbox0IRQControl = 1U << 0U;
+    constexpr uint32_t Mailbox0IRQ = 1U << 4U;
+    // Something from the GPU's interrupt controller (only ever routed to core 0)
+    constexpr uint32_t GPUIRQ = 1U << 8U;
     // constexpr uint32_t LocalTimerIRQ = 1U << 11U;
 }
 
@@ -69,9 +80,19 @@ extern "C"
     {
         // #TODO: Multiple flags can be set at the same time, so we'll want to handle them all
 
-        const auto irqPending1 = MemoryMappedIO::Get32(MemoryMappedIO::IRQ::IRQPending1);
-        if (irqPending1 != 0)
+        auto const core = AArch64::CPU::GetCurrentCore();
+        auto const coreIRQPending = MemoryMappedIO::Get32(MemoryMappedIO::IRQ::Core0IRQSource.Offset(core * MemoryMappedIO::IRQ::CoreRegisterStride));
+        if ((coreIRQPending & CoreTimerIRQs) != 0)
         {
+            CoreTimer::HandleIRQ();
+        }
+        else if ((coreIRQPending & Mailbox0IRQ) != 0)
+        {
+            CoreMailbox::HandleIRQ();
+        }
+        else if ((coreIRQPending & GPUIRQ) != 0)
+        {
+            const auto irqPending1 = MemoryMappedIO::Get32(MemoryMappedIO::IRQ::IRQPending1);
             if (irqPending1 == SystemTimerIRQ1)
             {
                 Timer::HandleIRQ();
@@ -81,20 +102,10 @@ extern "C"
                 Print::FormatToMiniUART("Unknown pending IRQ: {:x}\r\n", irqPending1);
             }
         }
-        /* #TODO: Local core IRQs cannot be used until we figure out how to map in the local peripheral addresses
-        const auto core0IRQPending = MemoryMappedIO::Get32(MemoryMappedIO::IRQ::Core0IRQSource);
-        if (core0IRQPending != 0)
+        else
         {
-            if (core0IRQPending == LocalTimerIRQ)
-            {
-                LocalTimer::HandleIRQ();
-            }
-            else
-            {
-                Print::FormatToMiniUART("Unknown pending Core 0 IRQ: {:x}\r\n", core0IRQPending);
-            }
+            Print::FormatToMiniUART("Unknown pending core {} IRQ: {:x}\r\n", core, coreIRQPending);
         }
-        */
     }
 }
 
@@ -102,6 +113,11 @@ namespace ExceptionVectors
 {
     void EnableInterruptController()
     {
-        MemoryMappedIO::Put32(MemoryMappedIO::IRQ::InterruptEnable1, SystemTimerIRQ1);
+        // GPU interrupts (like the system timer) only ever go to core 0, so scheduling is driven by each core's own
+        // timer instead, which just needs routing to the core as an IRQ
+        auto const core = AArch64::CPU::GetCurrentCore();
+        MemoryMappedIO::Put32(MemoryMappedIO::CoreTimer::Core0InterruptControl.Offset(core * MemoryMappedIO::CoreTimer::CoreRegisterStride), CoreTimerIRQs);
+        // Other cores use our mailbox to wake us when we're idle
+        MemoryMappedIO::Put32(MemoryMappedIO::CoreMailbox::Core0InterruptControl.Offset(core * MemoryMappedIO::CoreMailbox::InterruptControlStride), Mailbox0IRQControl);
     }
 }
\ No newline at end of file
@@ -4,7 +4,8 @@
 namespace ExceptionVectors
 {
     /**
-     * Enable the interrupt controller
+     * Enable the interrupt controller for the calling core, routing it its timer and mailbox interrupts (every core has
+     * to call this for itself)
      */
     void EnableInterruptController();
 }
@@ -0,0 +1,127 @@
+#include "FairRunQueue.h"
+
+#include <cstdint>
+#include "RedBlackTree.h"
+#include "TaskStructs.h"
+
+namespace Scheduler
+{
+    namespace
+    {
+        // Weight of each nice level from MinNiceC to MaxNiceC, with each about 1.25 times the next. These are the same
+        // values Linux uses, so nice levels behave the way people expect
+        // #TODO: Remove lint tag when we get std::array
+        // NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+        // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+        constexpr uint64_t NiceWeightsC[] = {
+            88761, 71755, 56483, 46273, 36291,
+            29154, 23254, 18705, 14949, 11916,
+            9548, 7620, 6100, 4904, 3906,
+            3121, 2501, 1991, 1586, 1277,
+            1024, 820, 655, 526, 423,
+            335, 272, 215, 172, 137,
+            110, 87, 70, 56, 45,
+            36, 29, 23, 18, 15
+        };
+        // NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+        static_assert(sizeof(NiceWeightsC) / sizeof(NiceWeightsC[0]) == (FairRunQueue::MaxNiceC - FairRunQueue::MinNiceC + 1), "Missing nice weights");
+
+        /**
+         * Obtains the task linked into the tree by a node
+         * 
+         * @param aNode The node
+         * @return The task
+         */
+        TaskStruct* GetTask(Containers::RedBlackNode const& aNode)
+        {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+            return reinterpret_cast<RunQueueTreeNode const&>(aNode).pTask;
+        }
+    }
+
+    uint64_t FairRunQueue::GetWeight(int32_t const aNice)
+    {
+        auto const nice = (aNice < MinNiceC) ? MinNiceC : ((aNice > MaxNiceC) ? MaxNiceC : aNice);
+        return NiceWeightsC[nice - MinNiceC]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+    }
+
+    void FairRunQueue::Enqueue(TaskStruct& arTask)
+    {
+        arTask.QueuedNode.pTask = &arTask;
+        Insert(arTask);
+        arTask.Queued = true;
+        TotalWeight += GetWeight(arTask.Nice);
+        ++Count;
+        UpdateMinVirtualRuntime();
+    }
+
+    void FairRunQueue::Remove(TaskStruct& arTask)
+    {
+        Tree.Remove(arTask.QueuedNode.Node);
+        arTask.Queued = false;
+        TotalWeight -= GetWeight(arTask.Nice);
+        --Count;
+        UpdateMinVirtualRuntime();
+    }
+
+    void FairRunQueue::ChargeRuntime(TaskStruct& arTask, uint64_t const aRanCycles)
+    {
+        // The key can't change while the task is in the tree, so it has to come out and go back in
+        Tree.Remove(arTask.QueuedNode.Node);
+        arTask.VirtualRuntime += (aRanCycles * NiceZeroWeightC) / GetWeight(arTask.Nice);
+        Insert(arTask);
+        UpdateMinVirtualRuntime();
+    }
+
+    TaskStruct* FairRunQueue::PickNext() const
+    {
+        auto const* const pfirst = Tree.GetFirst();
+        return (pfirst == nullptr) ? nullptr : GetTask(*pfirst);
+    }
+
+    TaskStruct* FairRunQueue::FindStealable(TaskStruct const* const apExclude) const
+    {
+        // Only the excluded task can get in the way, so at most two tasks are looked at
+        auto const* const plast = Tree.GetLast();
+        if (plast == nullptr)
+        {
+            return nullptr;
+        }
+        if (GetTask(*plast) != apExclude)
+        {
+            return GetTask(*plast);
+        }
+        auto const* const pprevious = Containers::RedBlackTree::GetPrevious(*plast);
+        return (pprevious == nullptr) ? nullptr : GetTask(*pprevious);
+    }
+
+    uint64_t FairRunQueue::GetTimeSlice(TaskStruct const& aTask, uint64_t const aTargetLatency, uint64_t const aMinGranularity) const
+    {
+        auto const weight = GetWeight(aTask.Nice);
+        // A task that isn't on the queue (i.e. is about to join it) still needs counting
+        auto const totalWeight = aTask.Queued ? TotalWeight : (TotalWeight + weight);
+        auto const count = aTask.Queued ? Count : (Count + 1);
+
+        auto const minPeriod = aMinGranularity * count;
+        auto const period = (aTargetLatency > minPeriod) ? aTargetLatency : minPeriod;
+        return (period * weight) / totalWeight;
+    }
+
+    void FairRunQueue::Insert(TaskStruct& arTask)
+    {
+        Tree.InsertOrdered(arTask.QueuedNode.Node,
+            [](Containers::RedBlackNode const& aLhs, Containers::RedBlackNode const& aRhs)
+            {
+                return GetTask(aLhs)->VirtualRuntime < GetTask(aRhs)->VirtualRuntime;
+            });
+    }
+
+    void FairRunQueue::UpdateMinVirtualRuntime()
+    {
+        auto const* const pfirst = PickNext();
+        if ((pfirst != nullptr) && (pfirst->VirtualRuntime > MinVirtualRuntime))
+        {
+            MinVirtualRuntime = pfirst->VirtualRuntime;
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,129 @@
+#ifndef KERNEL_FAIR_RUN_QUEUE_H
+#define KERNEL_FAIR_RUN_QUEUE_H
+
+#include <cstdint>
+#include "RedBlackTree.h"
+
+namespace Scheduler
+{
+    struct TaskStruct;
+
+    /**
+     * Run queue that shares the CPU between tasks in proportion to their weight. Each task tracks its virtual runtime -
+     * the counter-timer cycles it has run for, scaled down by its weight - and the tasks are kept in a red-black tree
+     * ordered by it. The task that has had the least runs next, so heavier tasks (with a lower nice level) get to run
+     * for longer before another task has had less than them.
+     */
+    class FairRunQueue
+    {
+    public:
+        /**
+         * Nice level that gets the most CPU
+         */
+        static constexpr int32_t MinNiceC = -20;
+
+        /**
+         * Nice level that gets the least CPU
+         */
+        static constexpr int32_t MaxNiceC = 19;
+
+        /**
+         * Weight of a task with a nice level of 0, which sees its virtual runtime go up at the same rate as real time
+         */
+        static constexpr uint64_t NiceZeroWeightC = 1024;
+
+        /**
+         * Obtains the weight of a nice level. Each level is about 1.25 times the weight of the next, so a task gets
+         * roughly 10% more CPU than a task one level nicer than it
+         * 
+         * @param aNice The nice level (clamped to MinNiceC to MaxNiceC)
+         * @return The weight
+         */
+        static uint64_t GetWeight(int32_t aNice);
+
+        /**
+         * Adds a task to the queue, keyed by its current virtual runtime
+         * 
+         * @param arTask The task to add (must not already be on a queue)
+         */
+        void Enqueue(TaskStruct& arTask);
+
+        /**
+         * Removes a task from the queue
+         * 
+         * @param arTask The task to remove (must be on this queue)
+         */
+        void Remove(TaskStruct& arTask);
+
+        /**
+         * Charges a task for time it spent running, moving it back in the queue
+         * 
+         * @param arTask The task that ran (must be on this queue)
+         * @param aRanCycles The number of counter-timer cycles it ran for
+         */
+        void ChargeRuntime(TaskStruct& arTask, uint64_t aRanCycles);
+
+        /**
+         * Obtains the task that should run next - the one with the least virtual runtime. The task stays on the queue
+         * 
+         * @return The task to run next, or null if the queue is empty
+         */
+        [[nodiscard]] TaskStruct* PickNext() const;
+
+        /**
+         * Finds a task another queue can take, preferring the ones with the most virtual runtime, since they have the
+         * longest wait to run here
+         * 
+         * @param apExclude A task not to pick (i.e. the one currently running)
+         * @return The task, or null if there is no task other than the excluded one
+         */
+        [[nodiscard]] TaskStruct* FindStealable(TaskStruct const* apExclude) const;
+
+        /**
+         * Obtains how long a task should run before another gets a turn. Every task on the queue should get a turn
+         * within the target latency, with each getting a share of it in proportion to its weight. If there are too
+         * many tasks to give each the minimum granularity, the latency is stretched until they can
+         * 
+         * @param aTask The task to get the time slice for
+         * @param aTargetLatency The target latency, in counter-timer cycles
+         * @param aMinGranularity The shortest slice to give a task of average weight, in counter-timer cycles
+         * @return The time slice, in counter-timer cycles
+         */
+        [[nodiscard]] uint64_t GetTimeSlice(TaskStruct const& aTask, uint64_t aTargetLatency, uint64_t aMinGranularity) const;
+
+        /**
+         * Obtains the smallest virtual runtime on the queue (which never goes backwards). Tasks joining the queue
+         * start from here, so they neither starve the others nor wait behind them
+         * 
+         * @return The minimum virtual runtime
+         */
+        [[nodiscard]] uint64_t GetMinVirtualRuntime() const { return MinVirtualRuntime; }
+
+        /**
+         * Obtains the number of tasks on the queue
+         * 
+         * @return The number of tasks
+         */
+        [[nodiscard]] uint32_t GetCount() const { return Count; }
+
+    private:
+        /**
+         * Links a task into the tree by its virtual runtime, after any tasks with the same virtual runtime
+         * 
+         * @param arTask The task to link
+         */
+        void Insert(TaskStruct& arTask);
+
+        /**
+         * Moves the minimum virtual runtime up to the first task's, if it has gone past it
+         */
+        void UpdateMinVirtualRuntime();
+
+        Containers::RedBlackTree Tree; // RunQueueTreeNode, ordered by TaskStruct::VirtualRuntime
+        uint64_t MinVirtualRuntime = 0;
+        uint64_t TotalWeight = 0;
+        uint32_t Count = 0;
+    };
+}
+
+#endif // KERNEL_FAIR_RUN_QUEUE_H
\ No newline at end of file
@@ -0,0 +1,266 @@
+#include "LZ4.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// The compressor and decompressor walk raw byte buffers, so indexing the pointers is the whole point
+// NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+namespace LZ4
+{
+    namespace
+    {
+        // Shortest match the format can encode
+        constexpr size_t MinMatchC = 4;
+        // The block always ends in at least this many literals
+        constexpr size_t LastLiteralsC = 5;
+        // Matches can't start within this many bytes of the end of the block
+        constexpr size_t MatchFindLimitC = 12;
+        // Furthest back a match can be
+        constexpr size_t MaxOffsetC = 0xFFFF;
+        // A length nibble of this value means more length bytes follow
+        constexpr uint8_t LengthNibbleMaxC = 0xF;
+        // Each extra length byte adds this much, and a byte less than it ends the length
+        constexpr uint8_t ExtraLengthByteMaxC = 0xFF;
+        constexpr unsigned TokenLiteralShiftC = 4;
+
+        /**
+         * Reads 4 bytes as a single value (byte order doesn't matter, it's only hashed and compared)
+         * 
+         * @param apBytes The bytes to read
+         * @return The value
+         */
+        uint32_t Read32(uint8_t const* const apBytes)
+        {
+            uint32_t value = 0;
+            memcpy(&value, apBytes, sizeof(value));
+            return value;
+        }
+
+        /**
+         * Hashes 4 bytes into an index into the compression table
+         * 
+         * @param aSequence The bytes to hash
+         * @return The index in the table
+         */
+        uint32_t HashSequence(uint32_t const aSequence)
+        {
+            // Knuth's multiplicative hash, keeping the top bits
+            constexpr auto multiplierC = 2654435761U;
+            constexpr auto hashShiftC = 32U - CompressionTable::HashBitsC;
+            return (aSequence * multiplierC) >> hashShiftC;
+        }
+
+        /**
+         * Writes the extra bytes for a length that didn't fit in its token nibble
+         * 
+         * @param aLength The length, less what the nibble already holds
+         * @param apDest The output buffer
+         * @param aDestCapacity The size of the output buffer
+         * @param arDestPos IN/OUT: Where to write in the output buffer
+         * @return False if the output buffer is full
+         */
+        bool WriteExtraLength(size_t aLength, uint8_t* const apDest, size_t const aDestCapacity, size_t& arDestPos)
+        {
+            while (aLength >= ExtraLengthByteMaxC)
+            {
+                if (arDestPos >= aDestCapacity)
+                {
+                    return false;
+                }
+                apDest[arDestPos++] = ExtraLengthByteMaxC;
+                aLength -= ExtraLengthByteMaxC;
+            }
+            if (arDestPos >= aDestCapacity)
+            {
+                return false;
+            }
+            apDest[arDestPos++] = static_cast<uint8_t>(aLength);
+            return true;
+        }
+
+        /**
+         * Writes a sequence - a run of literals, optionally followed by a match
+         * 
+         * @param apLiterals The literal bytes
+         * @param aLiteralCount The number of literal bytes
+         * @param aOffset How far back the match is (0 for the final sequence, which has no match)
+         * @param aMatchLength The length of the match
+         * @param apDest The output buffer
+         * @param aDestCapacity The size of the output buffer
+         * @param arDestPos IN/OUT: Where to write in the output buffer
+         * @return False if the output buffer is full
+         */
+        bool WriteSequence(uint8_t const* const apLiterals, size_t const aLiteralCount, size_t const aOffset,
+            size_t const aMatchLength, uint8_t* const apDest, size_t const aDestCapacity, size_t& arDestPos)
+        {
+            if (arDestPos >= aDestCapacity)
+            {
+                return false;
+            }
+            auto const literalNibble = (aLiteralCount < LengthNibbleMaxC) ? aLiteralCount : LengthNibbleMaxC;
+            auto const matchExtra = (aOffset == 0) ? 0 : (aMatchLength - MinMatchC);
+            auto const matchNibble = (matchExtra < LengthNibbleMaxC) ? matchExtra : LengthNibbleMaxC;
+            apDest[arDestPos++] = static_cast<uint8_t>((literalNibble << TokenLiteralShiftC) | matchNibble);
+
+            if ((literalNibble == LengthNibbleMaxC) && !WriteExtraLength(aLiteralCount - LengthNibbleMaxC, apDest, aDestCapacity, arDestPos))
+            {
+                return false;
+            }
+            if ((aDestCapacity - arDestPos) < aLiteralCount)
+            {
+                return false;
+            }
+            memcpy(apDest + arDestPos, apLiterals, aLiteralCount);
+            arDestPos += aLiteralCount;
+
+            if (aOffset == 0)
+            {
+                return true;
+            }
+            if ((aDestCapacity - arDestPos) < 2)
+            {
+                return false;
+            }
+            // offset is little endian
+            apDest[arDestPos++] = static_cast<uint8_t>(aOffset & 0xFFU);
+            apDest[arDestPos++] = static_cast<uint8_t>(aOffset >> 8U);
+            return (matchNibble != LengthNibbleMaxC) || WriteExtraLength(matchExtra - LengthNibbleMaxC, apDest, aDestCapacity, arDestPos);
+        }
+
+        /**
+         * Reads the extra bytes for a length whose token nibble was maxed out
+         * 
+         * @param apSource The compressed data
+         * @param aSourceSize The size of the compressed data
+         * @param arSourcePos IN/OUT: Where to read in the compressed data
+         * @param arLength IN/OUT: The length to add to
+         * @return False if the compressed data ran out
+         */
+        bool ReadExtraLength(uint8_t const* const apSource, size_t const aSourceSize, size_t& arSourcePos, size_t& arLength)
+        {
+            uint8_t curByte = 0;
+            do
+            {
+                if (arSourcePos >= aSourceSize)
+                {
+                    return false;
+                }
+                curByte = apSource[arSourcePos++];
+                arLength += curByte;
+            } while (curByte == ExtraLengthByteMaxC);
+            return true;
+        }
+    }
+
+    size_t CompressBlock(uint8_t const* const apSource, size_t const aSourceSize, uint8_t* const apDest,
+        size_t const aDestCapacity, CompressionTable& arTable)
+    {
+        if (aSourceSize > MaxInputSizeC)
+        {
+            return 0;
+        }
+        // Positions left over from the last block would point at garbage. Every candidate is checked before use,
+        // but clearing them keeps the matches (and so the output) the same for the same input
+        memset(arTable.Positions, 0, sizeof(arTable.Positions));
+
+        auto destPos = size_t{ 0 };
+        auto anchor = size_t{ 0 }; // start of the literals not written yet
+        auto curPos = size_t{ 0 };
+        if (aSourceSize >= MatchFindLimitC)
+        {
+            auto const lastMatchStart = aSourceSize - MatchFindLimitC;
+            auto const matchEndLimit = aSourceSize - LastLiteralsC;
+            while (curPos <= lastMatchStart)
+            {
+                auto const sequence = Read32(apSource + curPos);
+                auto& rtableEntry = arTable.Positions[HashSequence(sequence)]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+                size_t const candidate = rtableEntry;
+                rtableEntry = static_cast<uint16_t>(curPos);
+                if ((candidate >= curPos) || ((curPos - candidate) > MaxOffsetC) || (Read32(apSource + candidate) != sequence))
+                {
+                    ++curPos;
+                    continue;
+                }
+
+                auto matchLength = MinMatchC;
+                while (((curPos + matchLength) < matchEndLimit) && (apSource[candidate + matchLength] == apSource[curPos + matchLength]))
+                {
+                    ++matchLength;
+                }
+                if (!WriteSequence(apSource + anchor, curPos - anchor, curPos - candidate, matchLength, apDest, aDestCapacity, destPos))
+                {
+                    return 0;
+                }
+                curPos += matchLength;
+                anchor = curPos;
+            }
+        }
+
+        if (!WriteSequence(apSource + anchor, aSourceSize - anchor, 0, 0, apDest, aDestCapacity, destPos))
+        {
+            return 0;
+        }
+        return destPos;
+    }
+
+    bool DecompressBlock(uint8_t const* const apSource, size_t const aSourceSize, uint8_t* const apDest,
+        size_t const aDestCapacity, size_t& arDecompressedSize)
+    {
+        auto sourcePos = size_t{ 0 };
+        auto destPos = size_t{ 0 };
+        while (sourcePos < aSourceSize)
+        {
+            auto const token = apSource[sourcePos++];
+
+            auto literalCount = size_t{ static_cast<uint8_t>(token >> TokenLiteralShiftC) };
+            if ((literalCount == LengthNibbleMaxC) && !ReadExtraLength(apSource, aSourceSize, sourcePos, literalCount))
+            {
+                return false;
+            }
+            if (((aSourceSize - sourcePos) < literalCount) || ((aDestCapacity - destPos) < literalCount))
+            {
+                return false;
+            }
+            memcpy(apDest + destPos, apSource + sourcePos, literalCount);
+            sourcePos += literalCount;
+            destPos += literalCount;
+
+            // The final sequence is just literals
+            if (sourcePos == aSourceSize)
+            {
+                break;
+            }
+
+            if ((aSourceSize - sourcePos) < 2)
+            {
+                return false;
+            }
+            auto const offset = size_t{ apSource[sourcePos] } | (size_t{ apSource[sourcePos + 1] } << 8U);
+            sourcePos += 2;
+            if ((offset == 0) || (offset > destPos))
+            {
+                return false;
+            }
+            auto matchLength = size_t{ static_cast<uint8_t>(token & LengthNibbleMaxC) };
+            if ((matchLength == LengthNibbleMaxC) && !ReadExtraLength(apSource, aSourceSize, sourcePos, matchLength))
+            {
+                return false;
+            }
+            matchLength += MinMatchC;
+            if ((aDestCapacity - destPos) < matchLength)
+            {
+                return false;
+            }
+            // Byte at a time, since the match may overlap what it's writing (that's how runs are encoded)
+            for (auto curByte = size_t{ 0 }; curByte < matchLength; ++curByte)
+            {
+                apDest[destPos + curByte] = apDest[destPos - offset + curByte];
+            }
+            destPos += matchLength;
+        }
+        arDecompressedSize = destPos;
+        return true;
+    }
+}
+// NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
\ No newline at end of file
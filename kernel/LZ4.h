@@ -0,0 +1,53 @@
+#ifndef KERNEL_LZ4_H
+#define KERNEL_LZ4_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace LZ4
+{
+    /**
+     * The largest input CompressBlock will take (match positions are kept in 16 bits)
+     */
+    constexpr size_t MaxInputSizeC = 0x1'0000;
+
+    /**
+     * Scratch space for CompressBlock, which remembers where recently seen 4 byte sequences were. Too big to live on a
+     * kernel stack, so callers keep one around and make sure only one compression uses it at a time
+     */
+    struct CompressionTable
+    {
+        static constexpr unsigned HashBitsC = 12;
+
+        // #TODO: Remove lint tag when we get std::array
+        // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+        uint16_t Positions[1U << HashBitsC] = {};
+    };
+
+    /**
+     * Compresses a block of data into the LZ4 block format (no frame header or checksums)
+     * 
+     * @param apSource The data to compress
+     * @param aSourceSize The number of bytes to compress (no more than MaxInputSizeC)
+     * @param apDest Where to write the compressed data
+     * @param aDestCapacity The number of bytes available at apDest
+     * @param arTable Scratch space for the compressor
+     * @return The number of compressed bytes written, or 0 if the compressed data didn't fit (or the input is too
+     * large)
+     */
+    size_t CompressBlock(uint8_t const* apSource, size_t aSourceSize, uint8_t* apDest, size_t aDestCapacity, CompressionTable& arTable);
+
+    /**
+     * Decompresses a block of data in the LZ4 block format
+     * 
+     * @param apSource The compressed data
+     * @param aSourceSize The number of compressed bytes
+     * @param apDest Where to write the decompressed data
+     * @param aDestCapacity The number of bytes available at apDest
+     * @param arDecompressedSize OUT: The number of bytes written to apDest
+     * @return False if the compressed data is malformed, or doesn't fit in the destination
+     */
+    bool DecompressBlock(uint8_t const* apSource, size_t aSourceSize, uint8_t* apDest, size_t aDestCapacity, size_t& arDecompressedSize);
+}
+
+#endif // KERNEL_LZ4_H
\ No newline at end of file
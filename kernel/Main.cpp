@@ -6,6 +6,7 @@
 #include "UnitTests/Framework.h"
 #include "ExceptionVectorHandlers.h"
 #include "IRQ.h"
+#include "MemoryManager.h"
 #include "MiniUart.h"
 #include "PointerTypes.h"
 #include "Print.h"
@@ -17,13 +18,16 @@
 //#define OUTPUT_DEVICE_TREE
 #ifdef OUTPUT_DEVICE_TREE
 #include "Peripherals/DeviceTree.h"
-#include "MemoryManager.h"
 #endif // OUTPUT_DEVICE_TREE
 
 namespace
 {
     using StaticInitFunction = void (*)();
     using StaticFiniFunction = void (*)();
+
+    // Set by kmain once the secondary cores can start running tasks
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+    bool SecondaryCoresReleased = false;
 }
 
 extern "C"
@@ -104,11 +108,14 @@ extern "C"
 namespace Kernel
 {
     void kmain(PhysicalPtr const aDTBPointer, uint64_t const aX1Reserved, uint64_t const aX2Reserved,
-        uint64_t const aX3Reserved, PhysicalPtr const aStartPointer)
+        uint64_t const aX3Reserved, PhysicalPtr const aStartPointer, PhysicalPtr const aBootTablesEnd)
     {
         CallStaticConstructors();
+        // Anything that disables preemption needs to know what's running, so this has to come before everything else
+        Scheduler::InitCPU();
 
         MiniUART::Init();
+        MemoryManager::Init(aDTBPointer, aBootTablesEnd);
         irq_vector_init();
         Scheduler::InitTimer();
         ExceptionVectors::EnableInterruptController();
@@ -126,16 +133,34 @@ namespace Kernel
 
         UnitTests::Run();
 
+        // Everything is set up, so the other cores can start taking tasks
+        __atomic_store_n(&SecondaryCoresReleased, true, __ATOMIC_RELEASE);
+        // NOLINTNEXTLINE(hicpp-no-assembler)
+        asm volatile(
+            "dsb ish\n"
+            "sev"
+            : // no outputs
+            : // no inputs
+            : "memory"
+        );
+
         const auto clockFrequencyHz = Timing::GetSystemCounterClockFrequencyHz();
         Print::FormatToMiniUART("System clock freq: {}hz\r\n", clockFrequencyHz);
 
+        if (Scheduler::CopyProcess(Scheduler::CreationFlags::KernelThreadC, MemoryManager::ZeroPageThread, nullptr) < 0)
+        {
+            MiniUART::SendString("Error while starting zero page thread\r\n");
+        }
+        if (Scheduler::CopyProcess(Scheduler::CreationFlags::KernelThreadC, MemoryManager::PageMergeThread, nullptr) < 0)
+        {
+            MiniUART::SendString("Error while starting page merge thread\r\n");
+        }
+
         const auto processID = Scheduler::CopyProcess(Scheduler::CreationFlags::KernelThreadC, KernelProcess, nullptr);
         if (processID >= 0)
         {
-            while (true)
-            {
-                Scheduler::Schedule();
-            }
+            // We're now this core's idle task
+            Scheduler::RunIdleLoop();
         }
         else
         {
@@ -148,4 +173,25 @@ namespace Kernel
 
         UnitTests::RunPostStaticDestructors();
     }
+
+    void SecondaryMain(uint32_t const aCore)
+    {
+        while (!__atomic_load_n(&SecondaryCoresReleased, __ATOMIC_ACQUIRE))
+        {
+            // Woken by the sev in kmain
+            // NOLINTNEXTLINE(hicpp-no-assembler)
+            asm volatile("wfe");
+        }
+
+        Scheduler::InitCPU();
+        irq_vector_init();
+        Scheduler::InitTimer();
+        ExceptionVectors::EnableInterruptController();
+        enable_irq();
+
+        Print::FormatToMiniUART("Core {} started\r\n", aCore);
+
+        // We're now this core's idle task
+        Scheduler::RunIdleLoop();
+    }
 }
\ No newline at end of file
@@ -14,9 +14,18 @@ namespace Kernel
      * @param aX2Reserved Reserved for future use by the firmware
      * @param aX3Reserved Reserved for future use by the firmware
      * @param aStartPointer Pointer to _start which the firmware launched
+     * @param aBootTablesEnd Physical address past the last boot page table still in use
      */
     void kmain(PhysicalPtr aDTBPointer, uint64_t aX1Reserved, uint64_t aX2Reserved,
-        uint64_t aX3Reserved, PhysicalPtr aStartPointer);
+        uint64_t aX3Reserved, PhysicalPtr aStartPointer, PhysicalPtr aBootTablesEnd);
+
+    /**
+     * Entry point for the secondary cores, which wait for kmain to finish setting up the kernel before they start
+     * running tasks (does not return)
+     * 
+     * @param aCore The index of the core
+     */
+    void SecondaryMain(uint32_t aCore);
 }
 
 #endif // KERNEL_MAIN_H
\ No newline at end of file
@@ -1,15 +1,25 @@
 #include "MemoryManager.h"
 
 #include <bit>
-#include <bitset>
 #include <cstdint>
 #include <cstring>
 #include "AArch64/MemoryDescriptor.h"
 #include "AArch64/MemoryPageTables.h"
+#include "AArch64/PageTableRanges.h"
+#include "AArch64/SystemRegisters.h"
+#include "AArch64/TLB.h"
+#include "ASIDAllocator.h"
+#include "BuddyAllocator.h"
+#include "LZ4.h"
+#include "MiniUart.h"
+#include "Peripherals/DeviceTree.h"
 #include "PointerTypes.h"
+#include "Print.h"
 #include "Scheduler.h"
+#include "SlabAllocator.h"
 #include "TaskStructs.h"
 #include "Utils.h"
+#include "VirtualMemoryArea.h"
 
 extern "C"
 {
@@ -18,249 +28,2458 @@ extern "C"
 
     // Functions defined in MemoryManager.S
     /**
-     * Set the current page global directory
+     * Make sure following instructions see any system register changes
+     */
+    void instruction_barrier();
+
+    /**
+     * Wait for page table writes to be visible to the table walker
+     */
+    void sync_page_tables();
+
+    /**
+     * Clean the data cache for a range of memory, and invalidate the whole instruction cache
      * 
-     * @param apNewPGD Pointer to the new page global directory
+     * @param aStart Virtual address of the start of the range
+     * @param aEnd Virtual address of the end of the range (exclusive)
      */
-    void set_pgd(void const* apNewPGD);
+    void sync_instruction_cache(uintptr_t aStart, uintptr_t aEnd);
 }
 
-namespace MemoryManager
-{
-    namespace
+namespace MemoryManager
+{
+    namespace
+    {
+        /**
+         * Calculates the end of the kernel image (including the boot page tables)
+         * 
+         * @return The physical address of the end of the kernel image
+        */
+        PhysicalPtr CalculateKernelImagePAEnd()
+        {
+            // #TODO: Why is _kernel_image_end here a virtual address when in the boot process it's a physical
+            // address?
+            auto const kernalImageEndVA = std::bit_cast<uintptr_t>(&_kernel_image_end);
+            return PhysicalPtr{ kernalImageEndVA - KernelVirtualAddressOffset };
+        }
+
+        constexpr auto PageMask = ~(PageSize - 1);
+
+        // Software bits we use in page descriptors
+        namespace PageSoftwareBits
+        {
+            constexpr uint8_t CopyOnWriteC = 0x1; // Page is shared read-only, and should be copied on write
+        }
+
+        // TTBR0 covers as much address space as TTBR1 does
+        constexpr auto UserAddressSpaceSizeC = ~KernelVirtualAddressOffset + 1;
+
+        // Boot only maps the memory below the devices into kernel space, so that's all we can hand out for now
+        constexpr auto MaxUsablePA = DeviceBaseAddress;
+
+        // Device tree reservations, plus the low memory + kernel image, the device tree blob, and the frame array
+        constexpr auto MaxReservedRanges = DeviceTree::MemoryMap::MaxRangesC + 3;
+
+        // Pages zeroed ahead of time by the zero page thread, so allocations that need a zeroed page usually don't
+        // have to clear one while the caller waits
+        constexpr auto ZeroedPagePoolSizeC = 32U;
+        // How many pages the zero page thread clears before giving up the CPU again
+        constexpr auto ZeroPagesPerTurnC = 4U;
+        // Once the pool is full, the zero page thread blocks until fewer than this many are left in it
+        constexpr auto ZeroedPageLowWaterC = ZeroedPagePoolSizeC / 4;
+
+        // How many pages around a faulting address get mapped along with it, unless changed by SetFaultAroundPages
+        constexpr auto DefaultFaultAroundPagesC = 16U;
+
+        // How many pages the page merge thread looks at before giving up the CPU again
+        constexpr auto MergePagesPerTurnC = 64U;
+        // How many times the page merge thread gives up the CPU between passes over every task
+        constexpr auto MergePassRestTurnsC = 64U;
+
+        // When fewer pages than this are free, user page allocations push cold pages out to the compressed store
+        constexpr auto ReclaimLowWaterPagesC = 64U;
+        // How many pages each reclaim tries to free
+        constexpr auto ReclaimBatchPagesC = 16U;
+        // How many pages each reclaim looks at before giving up, so a system full of busy pages doesn't stall
+        constexpr auto ReclaimScanPagesC = 1024U;
+        // Pages that don't compress to this or smaller aren't worth storing (the record fits the largest heap size
+        // class)
+        constexpr auto MaxCompressedPageSizeC = (PageSize / 2) - sizeof(uint16_t);
+
+        // Order of the physical blocks backing huge pages, which are mapped with a single level 2 block descriptor
+        constexpr auto HugePageOrderC = 9U;
+        static_assert((PageSize << HugePageOrderC) == L2BlockSize, "Huge pages should match the level 2 block size");
+
+        // Amount of address space covered by each entry of the level 1 and root tables
+        constexpr size_t Level1EntrySpanC = L2BlockSize * AArch64::PageTable::PointersPerTable;
+        constexpr size_t Level0EntrySpanC = Level1EntrySpanC * AArch64::PageTable::PointersPerTable;
+
+        // Kernel virtual allocations live in the root table entry after the linear map, so they never share tables
+        // with it
+        constexpr auto KernelAreaStartC = VirtualPtr{ KernelVirtualAddressOffset + Level0EntrySpanC };
+        constexpr auto KernelAreaSizeC = Level1EntrySpanC;
+
+        // Number of ASIDs when TCR_EL1.AS is clear
+        constexpr auto SmallASIDCountC = 256U;
+        // Number of ASIDs when TCR_EL1.AS is set
+        constexpr auto LargeASIDCountC = 65536U;
+
+        // NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+        BuddyAllocator PageAllocator;
+        // Boot only turns on 16-bit ASIDs when supported, so start with the smaller count until Init checks
+        ASIDAllocator AddressSpaceIDs{ SmallASIDCountC };
+        // Empty table left in TTBR0 by boot, for tasks without a user address space
+        PhysicalPtr EmptyUserTable;
+        // Root table for the kernel half, set up by boot
+        PhysicalPtr KernelRootTable;
+        TypedObjectCache<VirtualMemoryArea> AreaCache;
+        // Ranges handed out by AllocateKernelVirtual
+        Containers::RedBlackTree KernelAreas;
+
+        // #TODO: Remove lint tag when we get std::array
+        // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+        PhysicalPtr ZeroedPagePool[ZeroedPagePoolSizeC] = {};
+        auto ZeroedPageCount = 0U;
+        // Blocked while the zeroed page pool doesn't need refilling
+        Scheduler::TaskStruct* pZeroPageTask = nullptr;
+        // Page of zeros shared read-only by every user page that has been read but never written
+        PhysicalPtr ZeroPage;
+        // Size of the aligned window of pages mapped on each translation fault (a power of two, 1 to disable)
+        auto FaultAroundPages = DefaultFaultAroundPagesC;
+        // When set, user pages are picked by cache color (see AllocateUserPageFrame)
+        auto PageColoringEnabled = false;
+        // Cache colors reserved by tasks for themselves, which nobody else's user pages will use
+        uint8_t ReservedCacheColors = 0;
+        // Where the reclaim clock hand is - the task slot, and the address in that task's areas
+        auto ReclaimHandProcess = 0U;
+        VirtualPtr ReclaimHandAddress;
+        // Scratch space for compressing pages, which is only done by ReclaimPages with preemption disabled
+        LZ4::CompressionTable CompressionScratch;
+        // #TODO: Remove lint tag when we get std::array
+        // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+        uint8_t CompressionBuffer[MaxCompressedPageSizeC] = {};
+        // NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+        /**
+         * Calls the functor for each part of the given range that does not overlap any of the reserved ranges
+         * 
+         * @param aRange The range to split
+         * @param apReserved The reserved ranges to remove (do not need to be sorted, and may overlap)
+         * @param aReservedCount The number of reserved ranges
+         * @param aFunctor Functor taking the begin and end (exclusive) of each free range, in ascending order
+         */
+        template<typename FunctorT>
+        void ForEachFreeRange(DeviceTree::MemoryRange const aRange, DeviceTree::MemoryRange const* const apReserved,
+            size_t const aReservedCount, FunctorT aFunctor)
+        {
+            auto curBegin = aRange.Begin;
+            while (curBegin < aRange.End)
+            {
+                // Find the lowest reservation that overlaps what's left of the range
+                DeviceTree::MemoryRange const* pnextReserved = nullptr;
+                for (auto curReserved = 0U; curReserved < aReservedCount; ++curReserved)
+                {
+                    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+                    auto const& reserved = apReserved[curReserved];
+                    if ((reserved.Begin < aRange.End) && (reserved.End > curBegin) &&
+                        ((pnextReserved == nullptr) || (reserved.Begin < pnextReserved->Begin)))
+                    {
+                        pnextReserved = &reserved;
+                    }
+                }
+
+                if (pnextReserved == nullptr)
+                {
+                    aFunctor(curBegin, aRange.End);
+                    break;
+                }
+                if (pnextReserved->Begin > curBegin)
+                {
+                    aFunctor(curBegin, pnextReserved->Begin);
+                }
+                curBegin = pnextReserved->End;
+            }
+        }
+
+        /**
+         * Converts a physical address into the kernel virtual address it is mapped to
+         * 
+         * @param aPhysicalAddress The physical address to convert
+         * @return The kernel virtual address
+         */
+        void* PhysicalToKernelVirtual(PhysicalPtr const aPhysicalAddress)
+        {
+            // have to add the KernelVirtualAddressStart because that's where the physical address is mapped to in
+            // kernel space
+            return std::bit_cast<void*>(aPhysicalAddress.Offset(KernelVirtualAddressOffset).GetAddress());
+        }
+
+        /**
+         * Allocate a block of physical pages. The page allocator isn't safe to re-enter, so this makes sure we
+         * aren't preempted by another task using it
+         * 
+         * @param aOrder The order of the block
+         * @return Physical address of the block (not zeroed), or null if out of memory
+         */
+        PhysicalPtr AllocatePhysicalBlock(unsigned const aOrder)
+        {
+            Scheduler::DisablePreemptingInScope const disablePreempt;
+            return PageAllocator.Allocate(aOrder);
+        }
+
+        /**
+         * Free a block of physical pages allocated with AllocatePhysicalBlock
+         * 
+         * @param aBlock Physical address of the block
+         */
+        void FreePhysicalBlock(PhysicalPtr const aBlock)
+        {
+            Scheduler::DisablePreemptingInScope const disablePreempt;
+            PageAllocator.Free(aBlock);
+        }
+
+        /**
+         * Take a page out of the zeroed page pool
+         * 
+         * @return Physical address of the zeroed page, or null if the pool is empty
+         */
+        PhysicalPtr PopZeroedPage()
+        {
+            Scheduler::DisablePreemptingInScope const disablePreempt;
+            if (ZeroedPageCount == 0)
+            {
+                return PhysicalPtr{};
+            }
+            --ZeroedPageCount;
+            if ((ZeroedPageCount < ZeroedPageLowWaterC) && (pZeroPageTask != nullptr))
+            {
+                Scheduler::Unblock(*pZeroPageTask);
+            }
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+            return ZeroedPagePool[ZeroedPageCount];
+        }
+
+        /**
+         * Add a page to the zeroed page pool
+         * 
+         * @param aPage Physical address of the page, which must already be zeroed
+         * @return True if the page was added, false if the pool is already full
+         */
+        bool PushZeroedPage(PhysicalPtr const aPage)
+        {
+            Scheduler::DisablePreemptingInScope const disablePreempt;
+            if (ZeroedPageCount == ZeroedPagePoolSizeC)
+            {
+                return false;
+            }
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+            ZeroedPagePool[ZeroedPageCount] = aPage;
+            ++ZeroedPageCount;
+            return true;
+        }
+
+        /**
+         * Allocate a page of memory
+         * 
+         * @return Physical address of the new allocated page of memory, zeroed out
+         */
+        PhysicalPtr GetFreePage()
+        {
+            auto newPagePA = PopZeroedPage();
+            if (newPagePA == PhysicalPtr{})
+            {
+                // The zero page thread hasn't kept up, so clear one ourselves
+                newPagePA = AllocatePhysicalBlock(0);
+                if (newPagePA != PhysicalPtr{})
+                {
+                    memset(PhysicalToKernelVirtual(newPagePA), 0, PageSize);
+                }
+            }
+            return newPagePA;
+        }
+
+        /**
+         * Allocate a page of memory without zeroing it, for callers that are going to overwrite all of it anyway
+         * 
+         * @return Physical address of the new allocated page of memory, with undefined contents
+         */
+        PhysicalPtr GetUnzeroedPage()
+        {
+            // Leave the zeroed pages for those that need them, unless there's nothing else left
+            auto const newPagePA = AllocatePhysicalBlock(0);
+            if (newPagePA == PhysicalPtr{})
+            {
+                return PopZeroedPage();
+            }
+            return newPagePA;
+        }
+
+        /**
+         * Gives the page table operations access to tables through the kernel's offset mapping
+         */
+        struct OffsetMappedTables
+        {
+            /**
+             * Converts a table's physical address into a pointer
+             * 
+             * @param aTable The table's physical address
+             * @return The kernel virtual address of the table
+             */
+            static uint64_t* GetTablePointer(PhysicalPtr const aTable)
+            {
+                return static_cast<uint64_t*>(PhysicalToKernelVirtual(aTable));
+            }
+        };
+
+        /**
+         * Gives the page table operations access to a task's tables. New tables aren't recorded anywhere else, the
+         * task's page tables are the only record of which tables it owns
+         */
+        struct TaskTables: public OffsetMappedTables
+        {
+            /**
+             * Allocates a new table for the task
+             * 
+             * @return The new table, zeroed out, or null if out of memory
+             */
+            static PhysicalPtr AllocateTable()
+            {
+                return GetFreePage();
+            }
+        };
+
+        /**
+         * Gives the page table operations a way to drop a task's cached translations, for breaking up contiguous runs
+         */
+        struct TaskTLB
+        {
+            uint16_t ASID = 0; // the ASID the task's pages are tagged with
+
+            /**
+             * Invalidates the task's cached translations for a run of pages
+             * 
+             * @param aStart The virtual address of the first page
+             * @param aSize The size of the run in bytes
+             */
+            void InvalidateRun(VirtualPtr const aStart, size_t const aSize) const
+            {
+                AArch64::TLB::InvalidateRange(ASID, aStart, aSize, AArch64::TLB::Entries::LastLevel);
+            }
+        };
+
+        /**
+         * Gives the page table operations access to the kernel half's tables. Tables made for kernel virtual
+         * allocations are kept when the allocations are freed, since every address space shares them and the region
+         * only needs a few
+         */
+        struct KernelTables: public OffsetMappedTables
+        {
+            /**
+             * Allocates a new table for the kernel half
+             * 
+             * @return The new table, zeroed out, or null if out of memory
+             */
+            static PhysicalPtr AllocateTable()
+            {
+                return GetFreePage();
+            }
+        };
+
+        /**
+         * Obtains a view of the task's page global directory
+         * 
+         * @param aPageGlobalDirectory The physical address of the page global directory
+         * @return The view over the table
+         */
+        AArch64::PageTable::Level0View GetRootTable(PhysicalPtr const aPageGlobalDirectory)
+        {
+            return AArch64::PageTable::Level0View{ OffsetMappedTables::GetTablePointer(aPageGlobalDirectory) };
+        }
+
+        /**
+         * Makes sure the task has a page global directory, allocating one if needed
+         * 
+         * @param arTask The task to check
+         * @return False if we ran out of memory for the page global directory
+         */
+        bool EnsurePageGlobalDirectory(Scheduler::TaskStruct& arTask)
+        {
+            if (arTask.MemoryState.PageGlobalDirectory == PhysicalPtr{})
+            {
+                arTask.MemoryState.PageGlobalDirectory = TaskTables::AllocateTable();
+            }
+            return arTask.MemoryState.PageGlobalDirectory != PhysicalPtr{};
+        }
+
+        /**
+         * Makes the descriptor used to map user memory
+         * 
+         * @param aPhysicalPage The physical page to map
+         * @param aProtection The AreaProtection flags of the area the page is in
+         * @param aCopyOnWrite If true, the page is mapped read-only and flagged to be copied when written to
+         * @return The page descriptor
+         */
+        AArch64::Descriptor::Page MakeUserPageDescriptor(PhysicalPtr const aPhysicalPage, uint8_t const aProtection,
+            bool const aCopyOnWrite)
+        {
+            AArch64::Descriptor::Page pageDescriptor;
+            pageDescriptor.Address(aPhysicalPage);
+            pageDescriptor.AttrIndx(NormalMAIRIndex); // normal memory
+            pageDescriptor.SH(AArch64::Descriptor::Page::Shareability::InnerShareable);
+            pageDescriptor.AF(true); // don't trap on access
+            pageDescriptor.nG(true); // only valid in this task's address space
+            if (aCopyOnWrite)
+            {
+                // read-only for the kernel too, so a kernel write can't scribble over a page someone else can see
+                pageDescriptor.AP(AArch64::Descriptor::Page::AccessPermissions::KernelROUserRO);
+                pageDescriptor.Software(PageSoftwareBits::CopyOnWriteC);
+            }
+            else if ((aProtection & AreaProtection::WriteC) == 0)
+            {
+                pageDescriptor.AP(AArch64::Descriptor::Page::AccessPermissions::KernelROUserRO);
+            }
+            else
+            {
+                pageDescriptor.AP(AArch64::Descriptor::Page::AccessPermissions::KernelRWUserRW); // let user r/w it
+            }
+            return pageDescriptor;
+        }
+
+        /**
+         * Makes the descriptor used to map a page of a kernel virtual allocation
+         * 
+         * @param aPhysicalPage The physical page to map
+         * @return The page descriptor
+         */
+        AArch64::Descriptor::Page MakeKernelPageDescriptor(PhysicalPtr const aPhysicalPage)
+        {
+            AArch64::Descriptor::Page pageDescriptor;
+            pageDescriptor.Address(aPhysicalPage);
+            pageDescriptor.AttrIndx(NormalMAIRIndex); // normal memory
+            pageDescriptor.SH(AArch64::Descriptor::Page::Shareability::InnerShareable);
+            pageDescriptor.AF(true); // don't trap on access
+            pageDescriptor.AP(AArch64::Descriptor::Page::AccessPermissions::KernelRWUserNone); // only kernel can access
+            // left global, since the kernel half is the same in every address space
+            return pageDescriptor;
+        }
+
+        /**
+         * Map a new table entry into the page table. If the entry was part of a contiguous run, the run is broken up
+         * since the entry won't match the rest of it any more
+         * 
+         * @param aTaskASID The ASID of the task that owns the table, to invalidate a broken up run
+         * @param aTableVirtualAddress Kernel virtual address for the table
+         * @param aUserVirtualAddress User virtual address we want to map
+         * @param aPhysicalPage The physical page to map
+         * @param aProtection The AreaProtection flags of the area the page is in
+         * @param aCopyOnWrite If true, the page is mapped read-only and flagged to be copied when written to
+         */
+        void MapTableEntry(uint16_t const aTaskASID, AArch64::PageTable::Level3View const aTable, const VirtualPtr aUserVirtualAddress,
+            PhysicalPtr const aPhysicalPage, uint8_t const aProtection, bool const aCopyOnWrite)
+        {
+            AArch64::PageTable::BreakContiguousRun(aTable, aUserVirtualAddress, TaskTLB{ aTaskASID });
+            aTable.SetEntryForVA(aUserVirtualAddress, MakeUserPageDescriptor(aPhysicalPage, aProtection, aCopyOnWrite));
+        }
+
+        /**
+         * Makes the block descriptor used to map a huge page
+         * 
+         * @param aPhysicalBlock The physical block to map
+         * @param aProtection The AreaProtection flags of the area the block is in
+         * @param aCopyOnWrite If true, the block is mapped read-only and flagged to be copied when written to
+         * @return The block descriptor
+         */
+        AArch64::Descriptor::L2Block MakeUserBlockDescriptor(PhysicalPtr const aPhysicalBlock, uint8_t const aProtection,
+            bool const aCopyOnWrite)
+        {
+            return AArch64::PageTable::MakeBlock<AArch64::Descriptor::L2Block>(MakeUserPageDescriptor(aPhysicalBlock, aProtection, aCopyOnWrite), aPhysicalBlock);
+        }
+
+        /**
+         * Finds the last level table holding the page entry for the specified address
+         * 
+         * @param aPageGlobalDirectory The physical address of the task's page global directory
+         * @param aUserVirtualAddress The user virtual address to look up
+         * @return The kernel virtual address of the table, or null if the address has no table
+         */
+        uint64_t* FindPageTable(PhysicalPtr const aPageGlobalDirectory, VirtualPtr const aUserVirtualAddress)
+        {
+            if (aPageGlobalDirectory == PhysicalPtr{})
+            {
+                return nullptr;
+            }
+            OffsetMappedTables tables;
+            return AArch64::PageTable::FindPageTable<false>(GetRootTable(aPageGlobalDirectory), aUserVirtualAddress, tables);
+        }
+
+        /**
+         * Finds the level 2 table holding the huge page entry for the specified address
+         * 
+         * @param aPageGlobalDirectory The physical address of the task's page global directory
+         * @param aUserVirtualAddress The user virtual address to look up
+         * @return The kernel virtual address of the table, or null if the address has no table
+         */
+        uint64_t* FindBlockTable(PhysicalPtr const aPageGlobalDirectory, VirtualPtr const aUserVirtualAddress)
+        {
+            if (aPageGlobalDirectory == PhysicalPtr{})
+            {
+                return nullptr;
+            }
+            OffsetMappedTables tables;
+            return AArch64::PageTable::FindBlockTable<false>(GetRootTable(aPageGlobalDirectory), aUserVirtualAddress, tables);
+        }
+
+        /**
+         * Obtains the huge page block descriptor for the specified address
+         * 
+         * @param aTable The level 2 table holding the address
+         * @param aUserVirtualAddress The user virtual address to look up
+         * @param arDescriptor OUT: The block descriptor, if there is one
+         * @return True if the address is mapped by a huge page that hasn't been split
+         */
+        bool GetBlockDescriptor(AArch64::PageTable::Level2View const aTable, VirtualPtr const aUserVirtualAddress, AArch64::Descriptor::L2Block& arDescriptor)
+        {
+            auto found = false;
+            aTable.GetEntryForVA(aUserVirtualAddress).Visit(Overloaded{
+                [&found, &arDescriptor](AArch64::Descriptor::L2Block const aBlockDescriptor)
+                {
+                    found = true;
+                    arDescriptor = aBlockDescriptor;
+                },
+                [](auto)
+                {
+                    // not mapped, or split into pages
+                }
+            });
+            return found;
+        }
+
+        /**
+         * Obtains the page descriptor for the specified address
+         * 
+         * @param aTable The last level table holding the address
+         * @param aUserVirtualAddress The user virtual address to look up
+         * @param arDescriptor OUT: The page descriptor, if there is one
+         * @return True if the address is mapped to a page
+         */
+        bool GetPageDescriptor(AArch64::PageTable::Level3View const aTable, VirtualPtr const aUserVirtualAddress, AArch64::Descriptor::Page& arDescriptor)
+        {
+            auto found = false;
+            aTable.GetEntryForVA(aUserVirtualAddress).Visit(Overloaded{
+                [](AArch64::Descriptor::Fault)
+                {
+                    // not mapped
+                },
+                [&found, &arDescriptor](AArch64::Descriptor::Page const aPageDescriptor)
+                {
+                    found = true;
+                    arDescriptor = aPageDescriptor;
+                }
+            });
+            return found;
+        }
+
+        /**
+         * Obtains the ASID the task's user pages are tagged with
+         * 
+         * @param aTask The task to get the ASID for
+         * @return The task's ASID
+         */
+        uint16_t GetTaskASID(Scheduler::TaskStruct const& aTask)
+        {
+            return ASIDAllocator::GetASID(aTask.MemoryState.ASIDContext);
+        }
+
+        /**
+         * Adds a user mapping to a page's reference count
+         * 
+         * @param aPhysicalPage The page being mapped
+         */
+        void AddPageReference(PhysicalPtr const aPhysicalPage)
+        {
+            if (aPhysicalPage == ZeroPage)
+            {
+                // Never freed, and mapped far too often for the count to keep up
+                return;
+            }
+            auto* const pframe = PageAllocator.GetFrame(aPhysicalPage);
+            if (pframe != nullptr)
+            {
+                __atomic_add_fetch(&pframe->RefCount, 1, __ATOMIC_RELAXED);
+            }
+        }
+
+        /**
+         * Removes a user mapping from a page's reference count, freeing the page when nothing maps it any more
+         * 
+         * @param aPhysicalPage The page being unmapped
+         */
+        void ReleasePageReference(PhysicalPtr const aPhysicalPage)
+        {
+            if (aPhysicalPage == ZeroPage)
+            {
+                return;
+            }
+            auto* const pframe = PageAllocator.GetFrame(aPhysicalPage);
+            if ((pframe != nullptr) && (__atomic_sub_fetch(&pframe->RefCount, 1, __ATOMIC_ACQ_REL) == 0))
+            {
+                FreePhysicalBlock(aPhysicalPage);
+            }
+        }
+
+        /**
+         * Checks if a huge page's physical block is still whole, rather than split into pages
+         * 
+         * @param aPhysicalBlock The block backing the huge page
+         * @return True if the block is whole, and so its reference count covers every page in it
+         */
+        bool IsWholeHugePage(PhysicalPtr const aPhysicalBlock)
+        {
+            auto const* const pframe = PageAllocator.GetFrame(aPhysicalBlock);
+            return (pframe != nullptr) && (pframe->Order == HugePageOrderC);
+        }
+
+        /**
+         * Adds a user mapping of a huge page to the reference counts
+         * 
+         * @param aPhysicalBlock The block backing the huge page
+         */
+        void AddHugePageReference(PhysicalPtr const aPhysicalBlock)
+        {
+            if (IsWholeHugePage(aPhysicalBlock))
+            {
+                AddPageReference(aPhysicalBlock);
+                return;
+            }
+            // Someone split the block, so every page is counted on its own
+            for (auto offset = size_t{ 0 }; offset < L2BlockSize; offset += PageSize)
+            {
+                AddPageReference(aPhysicalBlock.Offset(offset));
+            }
+        }
+
+        /**
+         * Removes a user mapping of a huge page from the reference counts, freeing whatever nothing maps any more
+         * 
+         * @param aPhysicalBlock The block backing the huge page
+         */
+        void ReleaseHugePageReference(PhysicalPtr const aPhysicalBlock)
+        {
+            if (IsWholeHugePage(aPhysicalBlock))
+            {
+                ReleasePageReference(aPhysicalBlock);
+                return;
+            }
+            for (auto offset = size_t{ 0 }; offset < L2BlockSize; offset += PageSize)
+            {
+                ReleasePageReference(aPhysicalBlock.Offset(offset));
+            }
+        }
+
+        /**
+         * Allocate a page to back a user address. With page coloring on, the page's cache color follows the virtual
+         * address, so each task's pages are spread evenly over the colors it is allowed to use and a task that
+         * reserved colors never shares cache sets with anyone else's user pages
+         * 
+         * @param aTask The task the page is for
+         * @param aVirtualAddress The user virtual address the page will be mapped at
+         * @param aZeroed If true, the page is zeroed
+         * @return Physical address of the new page, or null if out of memory
+         */
+        PhysicalPtr AllocateUserPageFrame(Scheduler::TaskStruct const& aTask, VirtualPtr const aVirtualAddress, bool const aZeroed)
+        {
+            if (!PageColoringEnabled)
+            {
+                return aZeroed ? GetFreePage() : GetUnzeroedPage();
+            }
+
+            auto newPagePA = PhysicalPtr{};
+            {
+                Scheduler::DisablePreemptingInScope const disablePreempt;
+                auto const allowedColors = (aTask.MemoryState.CacheColors != 0) ?
+                    aTask.MemoryState.CacheColors :
+                    static_cast<uint8_t>(BuddyAllocator::AllColorsC & ~ReservedCacheColors);
+
+                // Cycle through the allowed colors as the virtual pages go up
+                auto allowedCount = 0U;
+                for (auto curColor = 0U; curColor < BuddyAllocator::ColorCountC; ++curColor)
+                {
+                    allowedCount += ((allowedColors >> curColor) & 1U);
+                }
+                auto colorsToSkip = (aVirtualAddress.GetAddress() / PageSize) % allowedCount;
+                auto preferredColor = 0U;
+                while ((((allowedColors >> preferredColor) & 1U) == 0) || (colorsToSkip-- != 0))
+                {
+                    ++preferredColor;
+                }
+                newPagePA = PageAllocator.AllocateColored(allowedColors, preferredColor);
+            }
+            if (aZeroed && (newPagePA != PhysicalPtr{}))
+            {
+                memset(PhysicalToKernelVirtual(newPagePA), 0, PageSize);
+            }
+            return newPagePA;
+        }
+
+        /**
+         * A user page pushed out to the compressed store. The page's table entry is left faulting, but holds the
+         * physical address of the record so the page can be brought back when it's touched. The compressed data
+         * follows straight after
+         */
+        struct CompressedPage
+        {
+            uint16_t Size = 0; // number of compressed bytes
+        };
+
+        /**
+         * Obtains the record for a compressed page from its table entry
+         * 
+         * @param aEntryValue The value carried by the faulting table entry
+         * @return The record
+         */
+        CompressedPage* GetCompressedPage(uint64_t const aEntryValue)
+        {
+            return static_cast<CompressedPage*>(PhysicalToKernelVirtual(PhysicalPtr{ aEntryValue }));
+        }
+
+        /**
+         * Makes the faulting table entry that points at a compressed page's record
+         * 
+         * @param apRecord The record
+         * @return The table entry
+         */
+        AArch64::Descriptor::Fault MakeCompressedPageEntry(CompressedPage const* const apRecord)
+        {
+            return AArch64::Descriptor::Fault{ std::bit_cast<uintptr_t>(apRecord) - KernelVirtualAddressOffset };
+        }
+
+        /**
+         * Obtains the compressed page stored in the table entry for the specified address
+         * 
+         * @param aTable The last level table holding the address
+         * @param aUserVirtualAddress The user virtual address to look up
+         * @return The record, or null if the address isn't a compressed page
+         */
+        CompressedPage* FindCompressedPage(AArch64::PageTable::Level3View const aTable, VirtualPtr const aUserVirtualAddress)
+        {
+            CompressedPage* precord = nullptr;
+            aTable.GetEntryForVA(aUserVirtualAddress).Visit(Overloaded{
+                [&precord](AArch64::Descriptor::Fault const aFault)
+                {
+                    if (aFault.Value() != 0)
+                    {
+                        precord = GetCompressedPage(aFault.Value());
+                    }
+                },
+                [](AArch64::Descriptor::Page)
+                {
+                    // mapped
+                }
+            });
+            return precord;
+        }
+
+        /**
+         * Obtains the compressed data that follows a record
+         * 
+         * @param apRecord The record
+         * @return The compressed data
+         */
+        uint8_t* GetCompressedData(CompressedPage* const apRecord)
+        {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            return std::bit_cast<uint8_t*>(apRecord) + sizeof(CompressedPage);
+        }
+
+        /**
+         * Allocates a record for a compressed page from the heap
+         * 
+         * @param aSize The number of compressed bytes the record holds
+         * @return The record, with the data uninitialized, or null if out of memory
+         */
+        CompressedPage* AllocateCompressedPage(uint16_t const aSize)
+        {
+            auto* const precord = static_cast<CompressedPage*>(HeapAllocate(sizeof(CompressedPage) + aSize));
+            if (precord != nullptr)
+            {
+                precord->Size = aSize;
+            }
+            return precord;
+        }
+
+        /**
+         * Compresses a page into a new record. Pages that don't shrink to MaxCompressedPageSizeC are left alone, as
+         * are ones we can't allocate a record for
+         * 
+         * @param aPage The page to compress
+         * @return The record, or null if the page wasn't stored
+         */
+        CompressedPage* CompressPage(PhysicalPtr const aPage)
+        {
+            auto const size = LZ4::CompressBlock(static_cast<uint8_t const*>(PhysicalToKernelVirtual(aPage)), PageSize,
+                CompressionBuffer, MaxCompressedPageSizeC, CompressionScratch);
+            if (size == 0)
+            {
+                return nullptr;
+            }
+            auto* const precord = AllocateCompressedPage(static_cast<uint16_t>(size));
+            if (precord != nullptr)
+            {
+                memcpy(GetCompressedData(precord), CompressionBuffer, size);
+            }
+            return precord;
+        }
+
+        /**
+         * Makes a copy of a compressed page, for a forked task
+         * 
+         * @param arRecord The record to copy
+         * @return The copy, or null if out of memory
+         */
+        CompressedPage* DuplicateCompressedPage(CompressedPage& arRecord)
+        {
+            auto* const pcopy = AllocateCompressedPage(arRecord.Size);
+            if (pcopy != nullptr)
+            {
+                memcpy(GetCompressedData(pcopy), GetCompressedData(&arRecord), arRecord.Size);
+            }
+            return pcopy;
+        }
+
+        /**
+         * Decompresses a compressed page
+         * 
+         * @param arRecord The record to decompress
+         * @param aPage The page to decompress into
+         * @return False if the record doesn't decompress to a whole page
+         */
+        bool DecompressPage(CompressedPage& arRecord, PhysicalPtr const aPage)
+        {
+            auto decompressedSize = size_t{ 0 };
+            return LZ4::DecompressBlock(GetCompressedData(&arRecord), arRecord.Size, static_cast<uint8_t*>(PhysicalToKernelVirtual(aPage)),
+                PageSize, decompressedSize) && (decompressedSize == PageSize);
+        }
+
+        /**
+         * Calls the functor for each page of a task's areas, starting from a cursor. Parts of the areas without a
+         * last level table have nothing to look at (or are huge pages, which we leave alone) and are skipped
+         * 
+         * @param aTask The task to walk
+         * @param arCursor IN/OUT: The user virtual address to start from, left where the walk stopped
+         * @param arBudget IN/OUT: How many pages (or skipped tables) the walk may look at, reduced by how many it did
+         * @param aFunctor Functor taking the area, the last level table, and the address of each page. Returning
+         * false stops the walk after that page
+         * @return True if the walk reached the end of the task's areas
+         */
+        template<typename FunctorT>
+        bool WalkTaskPages(Scheduler::TaskStruct const& aTask, VirtualPtr& arCursor, unsigned& arBudget, FunctorT aFunctor)
+        {
+            auto const* parea = GetFirstArea(aTask.MemoryState.Areas);
+            while ((parea != nullptr) && (parea->Start.Offset(parea->Length) <= arCursor))
+            {
+                parea = GetNextArea(*parea);
+            }
+
+            for (; parea != nullptr; parea = GetNextArea(*parea))
+            {
+                auto const areaEnd = parea->Start.Offset(parea->Length);
+                auto curAddress = (arCursor < parea->Start) ? parea->Start : arCursor;
+                while (curAddress < areaEnd)
+                {
+                    if (arBudget == 0)
+                    {
+                        arCursor = curAddress;
+                        return false;
+                    }
+                    auto const blockEnd = CalculateBlockStart(curAddress, L2BlockSize).Offset(L2BlockSize);
+                    auto const chunkEnd = (areaEnd < blockEnd) ? areaEnd : blockEnd;
+                    auto* const ppageTable = FindPageTable(aTask.MemoryState.PageGlobalDirectory, curAddress);
+                    if (ppageTable == nullptr)
+                    {
+                        curAddress = chunkEnd;
+                        --arBudget;
+                        continue;
+                    }
+                    auto const pageTable = AArch64::PageTable::Level3View{ ppageTable };
+                    for (; (curAddress < chunkEnd) && (arBudget > 0); curAddress = curAddress.Offset(PageSize))
+                    {
+                        --arBudget;
+                        if (!aFunctor(*parea, pageTable, curAddress))
+                        {
+                            arCursor = curAddress.Offset(PageSize);
+                            return false;
+                        }
+                    }
+                }
+                arCursor = areaEnd;
+            }
+            return true;
+        }
+
+        /**
+         * Gives a page a turn of the reclaim clock. A page that was used since the hand last came by gets its access
+         * flag cleared, so the next use faults and sets it again. A page that wasn't is compressed into the
+         * compressed store and freed. Only private pages are reclaimed, since a shared page would have to be pushed
+         * out of every task that maps it
+         * 
+         * @param aTask The task the page belongs to
+         * @param aTable The last level table holding the page
+         * @param aVirtualAddress The user virtual address of the page
+         * @return True if the page was freed
+         */
+        bool ReclaimPage(Scheduler::TaskStruct const& aTask, AArch64::PageTable::Level3View const aTable, VirtualPtr const aVirtualAddress)
+        {
+            AArch64::Descriptor::Page pageDescriptor;
+            if (!GetPageDescriptor(aTable, aVirtualAddress, pageDescriptor) || (pageDescriptor.Address() == ZeroPage))
+            {
+                return false;
+            }
+            auto const* const pframe = PageAllocator.GetFrame(pageDescriptor.Address());
+            if ((pframe == nullptr) || (__atomic_load_n(&pframe->RefCount, __ATOMIC_RELAXED) != 1))
+            {
+                return false;
+            }
+
+            // The entry is about to stop matching the rest of its run either way
+            AArch64::PageTable::BreakContiguousRun(aTable, aVirtualAddress, TaskTLB{ GetTaskASID(aTask) });
+            pageDescriptor.Contiguous(false);
+            if (pageDescriptor.AF())
+            {
+                pageDescriptor.AF(false);
+                aTable.SetEntryForVA(aVirtualAddress, pageDescriptor);
+                AArch64::TLB::InvalidatePage(GetTaskASID(aTask), aVirtualAddress, AArch64::TLB::Entries::LastLevel);
+                return false;
+            }
+
+            auto* const precord = CompressPage(pageDescriptor.Address());
+            if (precord == nullptr)
+            {
+                return false;
+            }
+            aTable.SetEntryForVA(aVirtualAddress, MakeCompressedPageEntry(precord));
+            AArch64::TLB::InvalidatePage(GetTaskASID(aTask), aVirtualAddress, AArch64::TLB::Entries::LastLevel);
+            ReleasePageReference(pageDescriptor.Address());
+            return true;
+        }
+
+        /**
+         * Moves the reclaim clock hand over every task's pages until enough pages have been freed. Preemption is
+         * disabled throughout, since the tables and the compression buffers are shared with everyone
+         * 
+         * @param aPageCount How many pages to try to free
+         * @return The number of pages freed
+         */
+        unsigned ReclaimPages(unsigned const aPageCount)
+        {
+            Scheduler::DisablePreemptingInScope const disablePreempt;
+            auto reclaimed = 0U;
+            auto budget = ReclaimScanPagesC;
+            // Twice round, so pages only marked cold on the first trip can be taken on the second
+            for (auto tasksVisited = 0U; (tasksVisited < (2 * Scheduler::MaxTasksC)) && (reclaimed < aPageCount); ++tasksVisited)
+            {
+                auto const* const ptask = Scheduler::GetTask(ReclaimHandProcess);
+                if ((ptask != nullptr) && (ptask->MemoryState.PageGlobalDirectory != PhysicalPtr{}))
+                {
+                    auto const finished = WalkTaskPages(*ptask, ReclaimHandAddress, budget,
+                        [ptask, aPageCount, &reclaimed](VirtualMemoryArea const&, AArch64::PageTable::Level3View const aTable, VirtualPtr const aVirtualAddress)
+                        {
+                            if (ReclaimPage(*ptask, aTable, aVirtualAddress))
+                            {
+                                ++reclaimed;
+                            }
+                            return reclaimed < aPageCount;
+                        });
+                    if (!finished)
+                    {
+                        // Either we're done or out of budget, and the hand picks up here next time
+                        break;
+                    }
+                }
+                ReclaimHandProcess = (ReclaimHandProcess + 1) % Scheduler::MaxTasksC;
+                ReclaimHandAddress = VirtualPtr{};
+            }
+            return reclaimed;
+        }
+
+        /**
+         * Allocate a page to back a user address, pushing cold pages out to the compressed store first if memory is
+         * getting low (or has run out)
+         * 
+         * @param aTask The task the page is for
+         * @param aVirtualAddress The user virtual address the page will be mapped at
+         * @param aZeroed If true, the page is zeroed
+         * @return Physical address of the new page, or null if out of memory
+         */
+        PhysicalPtr GetUserPage(Scheduler::TaskStruct const& aTask, VirtualPtr const aVirtualAddress, bool const aZeroed)
+        {
+            // Reclaiming before we're completely out leaves the heap room to store what gets compressed
+            if (PageAllocator.GetFreePageCount() < ReclaimLowWaterPagesC)
+            {
+                ReclaimPages(ReclaimBatchPagesC);
+            }
+            auto newPagePA = AllocateUserPageFrame(aTask, aVirtualAddress, aZeroed);
+            if ((newPagePA == PhysicalPtr{}) && (ReclaimPages(ReclaimBatchPagesC) != 0))
+            {
+                newPagePA = AllocateUserPageFrame(aTask, aVirtualAddress, aZeroed);
+            }
+            return newPagePA;
+        }
+
+        /**
+         * Maps a user page for the specified task
+         * 
+         * @param arTask The task the page is for
+         * @param aVirtualAddress The user virtual address for the page
+         * @param aPhysicalPage The physical page the virtual page should map to
+         * @param aProtection The AreaProtection flags of the area the page is in
+         * @param aCopyOnWrite If true, the page is shared with another task and should be copied on write
+         * @return False if we ran out of memory for the page tables
+         */
+        bool MapPage(Scheduler::TaskStruct& arTask, VirtualPtr const aVirtualAddress, PhysicalPtr const aPhysicalPage,
+            uint8_t const aProtection, bool const aCopyOnWrite)
+        {
+            if (!EnsurePageGlobalDirectory(arTask))
+            {
+                return false;
+            }
+
+            TaskTables tables;
+
+            auto* const ppageTable = AArch64::PageTable::FindPageTable<true>(GetRootTable(arTask.MemoryState.PageGlobalDirectory), aVirtualAddress, tables);
+            if (ppageTable == nullptr)
+            {
+                return false;
+            }
+            auto const pageTableEntry = AArch64::PageTable::Level3View{ ppageTable };
+
+            AArch64::Descriptor::Page oldDescriptor;
+            auto const replacing = GetPageDescriptor(pageTableEntry, aVirtualAddress, oldDescriptor);
+
+            MapTableEntry(GetTaskASID(arTask), pageTableEntry, aVirtualAddress, aPhysicalPage, aProtection, aCopyOnWrite);
+            AddPageReference(aPhysicalPage);
+            if (!replacing)
+            {
+                // Invalid entries are never cached, so there's nothing stale in the TLB to invalidate, but the walker
+                // still needs to see the new tables before anyone touches the page
+                sync_page_tables();
+                return true;
+            }
+
+            // The old translation may still be cached, but only the page entry changed
+            AArch64::TLB::InvalidatePage(GetTaskASID(arTask), aVirtualAddress, AArch64::TLB::Entries::LastLevel);
+            ReleasePageReference(oldDescriptor.Address());
+            return true;
+        }
+
+        /**
+         * Maps a huge page for the specified task with a single level 2 block
+         * 
+         * @param arTask The task the huge page is for
+         * @param aVirtualAddress The user virtual address for the huge page (2MB aligned)
+         * @param aPhysicalBlock The physical block the huge page should map to (2MB aligned)
+         * @param aProtection The AreaProtection flags of the area the huge page is in
+         * @param aCopyOnWrite If true, the block is shared with another task and should be copied on write
+         * @return False if something is already mapped in the 2MB, or we ran out of memory for the page tables
+         */
+        bool MapHugePage(Scheduler::TaskStruct& arTask, VirtualPtr const aVirtualAddress, PhysicalPtr const aPhysicalBlock,
+            uint8_t const aProtection, bool const aCopyOnWrite)
+        {
+            if (!EnsurePageGlobalDirectory(arTask))
+            {
+                return false;
+            }
+
+            TaskTables tables;
+            auto* const pblockTable = AArch64::PageTable::FindBlockTable<true>(GetRootTable(arTask.MemoryState.PageGlobalDirectory), aVirtualAddress, tables);
+            if ((pblockTable == nullptr) ||
+                !AArch64::PageTable::TryAddBlock(AArch64::PageTable::Level2View{ pblockTable }, aVirtualAddress, MakeUserBlockDescriptor(aPhysicalBlock, aProtection, aCopyOnWrite)))
+            {
+                return false;
+            }
+
+            AddHugePageReference(aPhysicalBlock);
+            // The entry was invalid before, so there is nothing to invalidate
+            sync_page_tables();
+            return true;
+        }
+
+        /**
+         * Swaps the pages backing the 2MB around an address for a single huge page, once the task has written to every
+         * one of them. Waiting until then means a huge page is never 2MB of zeros the task may not touch, and the pages
+         * are only copied once they're all the task's own. Never done while page coloring restricts the task's colors,
+         * as a huge page holds every color
+         * 
+         * @param arTask The task that owns the pages
+         * @param aArea The area holding the address
+         * @param aVirtualAddress A user virtual address in the 2MB
+         * @return True if the 2MB is now mapped by a huge page
+         */
+        bool TryCollapseHugePage(Scheduler::TaskStruct& arTask, VirtualMemoryArea const& aArea, VirtualPtr const aVirtualAddress)
+        {
+            // A task with colors of its own must stay inside them, and everyone else must stay out of the reserved ones
+            if (PageColoringEnabled && ((arTask.MemoryState.CacheColors != 0) || (ReservedCacheColors != 0)))
+            {
+                return false;
+            }
+
+            auto const blockVA = CalculateBlockStart(aVirtualAddress, L2BlockSize);
+            if (!aArea.Contains(blockVA) || !aArea.Contains(CalculateBlockEnd(aVirtualAddress, L2BlockSize)))
+            {
+                return false;
+            }
+            auto* const pblockTable = FindBlockTable(arTask.MemoryState.PageGlobalDirectory, blockVA);
+            auto* const ppageTable = FindPageTable(arTask.MemoryState.PageGlobalDirectory, blockVA);
+            if ((pblockTable == nullptr) || (ppageTable == nullptr))
+            {
+                return false;
+            }
+
+            // Anything not mapped, shared (including the zero page) or compressed is left as pages until it's written
+            auto const pageTable = AArch64::PageTable::Level3View{ ppageTable };
+            for (auto offset = size_t{ 0 }; offset < L2BlockSize; offset += PageSize)
+            {
+                AArch64::Descriptor::Page pageDescriptor;
+                if (!GetPageDescriptor(pageTable, blockVA.Offset(offset), pageDescriptor) ||
+                    (pageDescriptor.AP() != AArch64::Descriptor::Page::AccessPermissions::KernelRWUserRW))
+                {
+                    return false;
+                }
+                auto const* const pframe = PageAllocator.GetFrame(pageDescriptor.Address());
+                if ((pframe == nullptr) || (__atomic_load_n(&pframe->RefCount, __ATOMIC_ACQUIRE) != 1))
+                {
+                    return false;
+                }
+            }
+
+            auto const newBlock = AllocatePhysicalBlock(HugePageOrderC);
+            if (newBlock == PhysicalPtr{})
+            {
+                return false;
+            }
+            for (auto offset = size_t{ 0 }; offset < L2BlockSize; offset += PageSize)
+            {
+                AArch64::Descriptor::Page pageDescriptor;
+                GetPageDescriptor(pageTable, blockVA.Offset(offset), pageDescriptor);
+                memcpy(PhysicalToKernelVirtual(newBlock.Offset(offset)), PhysicalToKernelVirtual(pageDescriptor.Address()), PageSize);
+            }
+            if ((aArea.Protection & AreaProtection::ExecuteC) != 0)
+            {
+                // the pages may hold code
+                SyncInstructionCache(PhysicalToKernelVirtual(newBlock), L2BlockSize);
+            }
+
+            // Break-before-make - the pages, and the walk through their table, have to be out of the TLB before the
+            // block goes in. That's too many pages to invalidate one at a time, so the task's whole ASID goes
+            auto const blockTable = AArch64::PageTable::Level2View{ pblockTable };
+            blockTable.SetEntryForVA(blockVA, AArch64::Descriptor::Fault{});
+            AArch64::TLB::InvalidateASID(GetTaskASID(arTask));
+            blockTable.SetEntryForVA(blockVA, MakeUserBlockDescriptor(newBlock, aArea.Protection, false));
+            sync_page_tables();
+            AddHugePageReference(newBlock);
+
+            for (auto offset = size_t{ 0 }; offset < L2BlockSize; offset += PageSize)
+            {
+                AArch64::Descriptor::Page pageDescriptor;
+                GetPageDescriptor(pageTable, blockVA.Offset(offset), pageDescriptor);
+                ReleasePageReference(pageDescriptor.Address());
+            }
+            FreePhysicalBlock(PhysicalPtr{ std::bit_cast<uintptr_t>(ppageTable) - KernelVirtualAddressOffset });
+            return true;
+        }
+
+        /**
+         * Splits a huge page into a table of pages with the same attributes, so the pages can be changed one at a time
+         * 
+         * @param arTask The task that owns the huge page
+         * @param aBlockTable The level 2 table holding the huge page
+         * @param aVirtualAddress A user virtual address in the huge page
+         * @param aBlock The huge page's block descriptor
+         * @return False if we ran out of memory for the new table
+         */
+        bool SplitHugePage(Scheduler::TaskStruct& arTask, AArch64::PageTable::Level2View const aBlockTable,
+            VirtualPtr const aVirtualAddress, AArch64::Descriptor::L2Block const aBlock)
+        {
+            TaskTables tables;
+            auto const newTable = AArch64::PageTable::MakeTableFromBlock(aBlock, tables);
+            if (newTable == PhysicalPtr{})
+            {
+                return false;
+            }
+
+            // The pages are about to be referenced (and copied and freed) one at a time, so the physical block has to
+            // be split too. Anyone else still mapping the whole block will see that and count each page
+            if (IsWholeHugePage(aBlock.Address()))
+            {
+                Scheduler::DisablePreemptingInScope const disablePreempt;
+                PageAllocator.SplitAllocated(aBlock.Address());
+            }
+
+            // Break-before-make - the block has to be out of the TLB before the table goes in, otherwise both could be
+            // cached at once
+            aBlockTable.SetEntryForVA(aVirtualAddress, AArch64::Descriptor::Fault{});
+            AArch64::TLB::InvalidatePage(GetTaskASID(arTask), aVirtualAddress, AArch64::TLB::Entries::LastLevel);
+            AArch64::Descriptor::Table tableDescriptor;
+            tableDescriptor.Address(newTable);
+            aBlockTable.SetEntryForVA(aVirtualAddress, tableDescriptor);
+            sync_page_tables();
+            return true;
+        }
+
+        /**
+         * Handles a write to a copy-on-write huge page that nobody else maps any more, by making it writable again
+         * 
+         * @param arTask The task that faulted
+         * @param aArea The area holding the huge page
+         * @param aBlockTable The level 2 table holding the huge page
+         * @param aVirtualAddress The user virtual address that was written to
+         * @param aBlock The huge page's block descriptor
+         * @return False if the huge page is still shared, in which case it should be split instead
+         */
+        bool ReuseHugePageOnWrite(Scheduler::TaskStruct& arTask, VirtualMemoryArea const& aArea,
+            AArch64::PageTable::Level2View const aBlockTable, VirtualPtr const aVirtualAddress,
+            AArch64::Descriptor::L2Block const aBlock)
+        {
+            // Copying all 2MB for a write to one page would hold up the task, and waste memory on pages it may never
+            // write. So a shared huge page is always split, and its pages copied as they're written (if another task
+            // already split it, its pages are counted one at a time anyway)
+            auto const sharedBlock = aBlock.Address();
+            if (!IsWholeHugePage(sharedBlock) ||
+                (__atomic_load_n(&PageAllocator.GetFrame(sharedBlock)->RefCount, __ATOMIC_ACQUIRE) > 1))
+            {
+                return false;
+            }
+
+            // Everyone else that shared the block has already made their own copy, so we can just take it
+            auto const blockVA = CalculateBlockStart(aVirtualAddress, L2BlockSize);
+            aBlockTable.SetEntryForVA(blockVA, MakeUserBlockDescriptor(sharedBlock, aArea.Protection, false));
+            // The old read-only translation may still be cached
+            AArch64::TLB::InvalidatePage(GetTaskASID(arTask), blockVA, AArch64::TLB::Entries::LastLevel);
+            return true;
+        }
+
+        /**
+         * Handles a write to a copy-on-write page, giving the task its own writable copy of the page
+         * 
+         * @param arTask The task that faulted
+         * @param aArea The area holding the page, which must be writable
+         * @param aVirtualAddress The user virtual address of the page that was written to
+         * @return True if the fault was handled, false if the page isn't copy-on-write or we are out of memory
+         */
+        bool HandleCopyOnWriteFault(Scheduler::TaskStruct& arTask, VirtualMemoryArea const& aArea, VirtualPtr const aVirtualAddress)
+        {
+            auto* const pblockTable = FindBlockTable(arTask.MemoryState.PageGlobalDirectory, aVirtualAddress);
+            AArch64::Descriptor::L2Block blockDescriptor;
+            if ((pblockTable != nullptr) && GetBlockDescriptor(AArch64::PageTable::Level2View{ pblockTable }, aVirtualAddress, blockDescriptor))
+            {
+                if ((blockDescriptor.Software() & PageSoftwareBits::CopyOnWriteC) == 0)
+                {
+                    return false;
+                }
+                if (ReuseHugePageOnWrite(arTask, aArea, AArch64::PageTable::Level2View{ pblockTable }, aVirtualAddress, blockDescriptor))
+                {
+                    return true;
+                }
+                // Still shared, so split it up and just copy the page that was written to
+                if (!SplitHugePage(arTask, AArch64::PageTable::Level2View{ pblockTable }, aVirtualAddress, blockDescriptor))
+                {
+                    return false;
+                }
+            }
+
+            auto* const ppageTable = FindPageTable(arTask.MemoryState.PageGlobalDirectory, aVirtualAddress);
+            if (ppageTable == nullptr)
+            {
+                return false;
+            }
+            auto const pageTable = AArch64::PageTable::Level3View{ ppageTable };
+            AArch64::Descriptor::Page pageDescriptor;
+            if (!GetPageDescriptor(pageTable, aVirtualAddress, pageDescriptor) ||
+                ((pageDescriptor.Software() & PageSoftwareBits::CopyOnWriteC) == 0))
+            {
+                return false;
+            }
+
+            auto const sharedPage = pageDescriptor.Address();
+            auto const* const psharedFrame = PageAllocator.GetFrame(sharedPage);
+            if (psharedFrame == nullptr)
+            {
+                // #TODO: Panic, since we only share pages we allocated
+                return false;
+            }
+
+            auto newPage = sharedPage;
+            if (sharedPage == ZeroPage)
+            {
+                // Nothing to copy, the task just needs a zeroed page of its own
+                newPage = GetUserPage(arTask, aVirtualAddress, true);
+                if (newPage == PhysicalPtr{})
+                {
+                    return false;
+                }
+                AddPageReference(newPage);
+            }
+            else if (__atomic_load_n(&psharedFrame->RefCount, __ATOMIC_ACQUIRE) > 1)
+            {
+                // Still shared, so copy it. No need to zero the new page since we're about to overwrite all of it
+                newPage = GetUserPage(arTask, aVirtualAddress, false);
+                if (newPage == PhysicalPtr{})
+                {
+                    return false;
+                }
+                memcpy(PhysicalToKernelVirtual(newPage), PhysicalToKernelVirtual(sharedPage), PageSize);
+                // the page may hold code
+                SyncInstructionCache(PhysicalToKernelVirtual(newPage), PageSize);
+                AddPageReference(newPage);
+                ReleasePageReference(sharedPage);
+            }
+            // Otherwise everyone else that shared the page has already made their own copy, so we can just take it
+
+            MapTableEntry(GetTaskASID(arTask), pageTable, aVirtualAddress, newPage, aArea.Protection, false);
+            // The old read-only translation may still be cached
+            AArch64::TLB::InvalidatePage(GetTaskASID(arTask), aVirtualAddress, AArch64::TLB::Entries::LastLevel);
+            return true;
+        }
+
+        /**
+         * Maps the untouched pages in the aligned fault-around window holding a faulting address, so tasks walking
+         * through memory take one fault per window instead of one per page. The pages all get the zero page, even
+         * when the fault was a write - a task writing one page may never write its neighbours, so each page written
+         * still faults and only then gets a page of its own
+         * 
+         * @param arTask The task that faulted
+         * @param aArea The area holding the address that faulted
+         * @param aVirtualAddress The user virtual address that faulted, which must already be mapped with a page
+         */
+        void MapFaultAround(Scheduler::TaskStruct& arTask, VirtualMemoryArea const& aArea, VirtualPtr const aVirtualAddress)
+        {
+            auto const windowSize = FaultAroundPages * PageSize;
+            if (windowSize <= PageSize)
+            {
+                return;
+            }
+            auto* const ppageTable = FindPageTable(arTask.MemoryState.PageGlobalDirectory, aVirtualAddress);
+            if (ppageTable == nullptr)
+            {
+                return;
+            }
+            auto const pageTable = AArch64::PageTable::Level3View{ ppageTable };
+
+            // The window is never bigger than a table's worth of pages and is aligned to its size, so it is all in
+            // the same table as the fault
+            auto const windowStart = CalculateBlockStart(aVirtualAddress, windowSize);
+            auto const start = (windowStart < aArea.Start) ? aArea.Start : windowStart;
+            auto const areaEnd = aArea.Start.Offset(aArea.Length);
+            auto const windowEnd = windowStart.Offset(windowSize);
+            auto const end = (areaEnd < windowEnd) ? areaEnd : windowEnd;
+
+            auto mappedAny = false;
+            for (auto curAddress = start; curAddress < end; curAddress = curAddress.Offset(PageSize))
+            {
+                auto isEmpty = false;
+                pageTable.GetEntryForVA(curAddress).Visit(Overloaded{
+                    [&isEmpty](AArch64::Descriptor::Fault const aFault)
+                    {
+                        // compressed pages come back when they're touched
+                        isEmpty = (aFault.Value() == 0);
+                    },
+                    [](AArch64::Descriptor::Page)
+                    {
+                        // already mapped (which includes the faulting page)
+                    }
+                });
+                if (!isEmpty)
+                {
+                    continue;
+                }
+
+                MapTableEntry(GetTaskASID(arTask), pageTable, curAddress, ZeroPage, aArea.Protection, true);
+                mappedAny = true;
+            }
+
+            if (mappedAny)
+            {
+                // The entries were all invalid before, so there is nothing to invalidate
+                sync_page_tables();
+            }
+        }
+
+        /**
+         * Result of trying to bring a compressed page back
+         */
+        enum class RestoreResult
+        {
+            NotCompressed, // the address wasn't a compressed page
+            Restored,
+            Failed, // out of memory
+        };
+
+        /**
+         * Brings a page pushed out to the compressed store back in, if the faulting address is one
+         * 
+         * @param arTask The task that faulted
+         * @param aArea The area holding the address that faulted
+         * @param aVirtualAddress The user virtual address that faulted
+         * @return Whether the page was restored
+         */
+        RestoreResult RestoreCompressedPage(Scheduler::TaskStruct& arTask, VirtualMemoryArea const& aArea, VirtualPtr const aVirtualAddress)
+        {
+            auto* const ppageTable = FindPageTable(arTask.MemoryState.PageGlobalDirectory, aVirtualAddress);
+            if (ppageTable == nullptr)
+            {
+                return RestoreResult::NotCompressed;
+            }
+            auto const pageTable = AArch64::PageTable::Level3View{ ppageTable };
+            auto* const precord = FindCompressedPage(pageTable, aVirtualAddress);
+            if (precord == nullptr)
+            {
+                return RestoreResult::NotCompressed;
+            }
+
+            // Reclaim never touches entries that are already compressed, so the record stays put while we wait
+            auto const newPage = GetUserPage(arTask, aVirtualAddress, false);
+            if (newPage == PhysicalPtr{})
+            {
+                return RestoreResult::Failed;
+            }
+            if (!DecompressPage(*precord, newPage))
+            {
+                // #TODO: Panic, we only store what we compressed ourselves
+                FreePhysicalBlock(newPage);
+                return RestoreResult::Failed;
+            }
+            // the page may hold code
+            SyncInstructionCache(PhysicalToKernelVirtual(newPage), PageSize);
+
+            MapTableEntry(GetTaskASID(arTask), pageTable, aVirtualAddress, newPage, aArea.Protection, false);
+            AddPageReference(newPage);
+            HeapFree(precord);
+            // The entry was invalid before, so there is nothing to invalidate
+            sync_page_tables();
+            return RestoreResult::Restored;
+        }
+
+        /**
+         * Sets the access flag on a page the reclaim clock cleared it on, marking the page as in use again
+         * 
+         * @param aTask The task that faulted
+         * @param aVirtualAddress The user virtual address that faulted
+         * @return False if the address isn't mapped to a page
+         */
+        bool HandleAccessFlagFault(Scheduler::TaskStruct const& aTask, VirtualPtr const aVirtualAddress)
+        {
+            auto* const ppageTable = FindPageTable(aTask.MemoryState.PageGlobalDirectory, aVirtualAddress);
+            if (ppageTable == nullptr)
+            {
+                return false;
+            }
+            auto const pageTable = AArch64::PageTable::Level3View{ ppageTable };
+            AArch64::Descriptor::Page pageDescriptor;
+            if (!GetPageDescriptor(pageTable, aVirtualAddress, pageDescriptor))
+            {
+                return false;
+            }
+            pageDescriptor.AF(true);
+            pageTable.SetEntryForVA(aVirtualAddress, pageDescriptor);
+            // Entries without the access flag aren't cached, so there is nothing to invalidate
+            sync_page_tables();
+            return true;
+        }
+
+        /**
+         * Shares the pages mapped in part of an area with another task. If the area is writable, the pages are made
+         * copy-on-write first. The caller is responsible for invalidating the source task's TLB entries
+         * 
+         * @param arDestinationTask The task to map the pages into
+         * @param aSourceTable The source task's last level table covering the range
+         * @param aArea The area the range is in
+         * @param aStart The start of the range (all in the same last level table)
+         * @param aSize The size of the range
+         * @return False if we ran out of memory for the page tables or compressed page copies
+         */
+        bool SharePages(Scheduler::TaskStruct& arDestinationTask, AArch64::PageTable::Level3View const aSourceTable,
+            VirtualMemoryArea const& aArea, VirtualPtr const aStart, size_t const aSize)
+        {
+            if (!EnsurePageGlobalDirectory(arDestinationTask))
+            {
+                return false;
+            }
+            TaskTables tables;
+            auto* const pdestinationPageTable = AArch64::PageTable::FindPageTable<true>(GetRootTable(arDestinationTask.MemoryState.PageGlobalDirectory), aStart, tables);
+            if (pdestinationPageTable == nullptr)
+            {
+                return false;
+            }
+
+            auto const copyOnWrite = (aArea.Protection & AreaProtection::WriteC) != 0;
+            auto const destinationTable = AArch64::PageTable::Level3View{ pdestinationPageTable };
+            for (auto offset = size_t{ 0 }; offset < aSize; offset += PageSize)
+            {
+                auto const curAddress = aStart.Offset(offset);
+                AArch64::Descriptor::Page pageDescriptor;
+                if (!GetPageDescriptor(aSourceTable, curAddress, pageDescriptor))
+                {
+                    // Compressed pages aren't shared, so the new task gets its own copy of the record
+                    auto* const precord = FindCompressedPage(aSourceTable, curAddress);
+                    if (precord != nullptr)
+                    {
+                        auto* const pcopy = DuplicateCompressedPage(*precord);
+                        if (pcopy == nullptr)
+                        {
+                            return false;
+                        }
+                        destinationTable.SetEntryForVA(curAddress, MakeCompressedPageEntry(pcopy));
+                    }
+                    continue;
+                }
+                if (copyOnWrite)
+                {
+                    // Contiguous runs only come from splitting huge pages, which are always entirely inside an area,
+                    // and every page in the area changes the same way, so the runs can stay whole
+                    auto const contiguous = pageDescriptor.Contiguous();
+                    pageDescriptor = MakeUserPageDescriptor(pageDescriptor.Address(), aArea.Protection, true);
+                    pageDescriptor.Contiguous(contiguous);
+                    aSourceTable.SetEntryForVA(curAddress, pageDescriptor);
+                }
+                // Copied as-is, so the runs match the source's
+                destinationTable.SetEntryForVA(curAddress, pageDescriptor);
+                AddPageReference(pageDescriptor.Address());
+            }
+            return true;
+        }
+
+        /**
+         * Shares everything mapped in one of the source task's areas with the destination task. If the area is
+         * writable, the source's mappings are made copy-on-write first. The caller is responsible for invalidating the
+         * source task's TLB entries
+         * 
+         * @param arDestinationTask The task to map the area's pages into
+         * @param aSourcePageGlobalDirectory The physical address of the source task's page global directory
+         * @param aArea The area to share
+         * @return False if we ran out of memory for the page tables
+         */
+        bool ShareArea(Scheduler::TaskStruct& arDestinationTask, PhysicalPtr const aSourcePageGlobalDirectory, VirtualMemoryArea const& aArea)
+        {
+            auto const copyOnWrite = (aArea.Protection & AreaProtection::WriteC) != 0;
+            auto curAddress = aArea.Start;
+            auto remaining = aArea.Length;
+            while (remaining > 0)
+            {
+                // Go a level 2 entry at a time, since that's what a single huge page or last level table covers
+                auto const bytesToBlockEnd = CalculateBlockEnd(curAddress, L2BlockSize).GetAddress() - curAddress.GetAddress() + 1;
+                auto const chunkSize = (bytesToBlockEnd < remaining) ? bytesToBlockEnd : remaining;
+
+                auto* const psourceBlockTable = FindBlockTable(aSourcePageGlobalDirectory, curAddress);
+                AArch64::Descriptor::L2Block blockDescriptor;
+                if ((psourceBlockTable != nullptr) && GetBlockDescriptor(AArch64::PageTable::Level2View{ psourceBlockTable }, curAddress, blockDescriptor))
+                {
+                    // Huge pages are only made when the area covers the whole block
+                    if (copyOnWrite)
+                    {
+                        AArch64::PageTable::Level2View{ psourceBlockTable }.SetEntryForVA(curAddress, MakeUserBlockDescriptor(blockDescriptor.Address(), aArea.Protection, true));
+                    }
+                    if (!MapHugePage(arDestinationTask, curAddress, blockDescriptor.Address(), aArea.Protection, copyOnWrite))
+                    {
+                        return false;
+                    }
+                }
+                else
+                {
+                    auto* const psourcePageTable = FindPageTable(aSourcePageGlobalDirectory, curAddress);
+                    if ((psourcePageTable != nullptr) &&
+                        !SharePages(arDestinationTask, AArch64::PageTable::Level3View{ psourcePageTable }, aArea, curAddress, chunkSize))
+                    {
+                        return false;
+                    }
+                }
+
+                curAddress = curAddress.Offset(chunkSize);
+                remaining -= chunkSize;
+            }
+            return true;
+        }
+
+        /**
+         * Releases every page mapped by a last level table, and then frees the table
+         * 
+         * @param aTable The physical address of the table
+         */
+        void FreeLevel3Table(PhysicalPtr const aTable)
+        {
+            auto const table = AArch64::PageTable::Level3View{ OffsetMappedTables::GetTablePointer(aTable) };
+            for (auto curEntry = 0U; curEntry < AArch64::PageTable::PointersPerTable; ++curEntry)
+            {
+                table.GetEntryForVA(VirtualPtr{ curEntry * PageSize }).Visit(Overloaded{
+                    [](AArch64::Descriptor::Fault const aFault)
+                    {
+                        if (aFault.Value() != 0)
+                        {
+                            HeapFree(GetCompressedPage(aFault.Value()));
+                        }
+                    },
+                    [](AArch64::Descriptor::Page const aPageDescriptor)
+                    {
+                        ReleasePageReference(aPageDescriptor.Address());
+                    }
+                });
+            }
+            FreePhysicalBlock(aTable);
+        }
+
+        /**
+         * Releases every huge page mapped by a level 2 table, frees the tables under it, and then frees the table
+         * 
+         * @param aTable The physical address of the table
+         */
+        void FreeLevel2Table(PhysicalPtr const aTable)
+        {
+            auto const table = AArch64::PageTable::Level2View{ OffsetMappedTables::GetTablePointer(aTable) };
+            for (auto curEntry = 0U; curEntry < AArch64::PageTable::PointersPerTable; ++curEntry)
+            {
+                table.GetEntryForVA(VirtualPtr{ curEntry * L2BlockSize }).Visit(Overloaded{
+                    [](AArch64::Descriptor::Fault)
+                    {
+                        // nothing mapped
+                    },
+                    [](AArch64::Descriptor::Table const aTableDescriptor)
+                    {
+                        FreeLevel3Table(aTableDescriptor.Address());
+                    },
+                    [](AArch64::Descriptor::L2Block const aBlockDescriptor)
+                    {
+                        ReleaseHugePageReference(aBlockDescriptor.Address());
+                    }
+                });
+            }
+            FreePhysicalBlock(aTable);
+        }
+
+        /**
+         * Frees the tables under a level 1 table, and then frees the table
+         * 
+         * @param aTable The physical address of the table
+         */
+        void FreeLevel1Table(PhysicalPtr const aTable)
+        {
+            auto const table = AArch64::PageTable::Level1View{ OffsetMappedTables::GetTablePointer(aTable) };
+            for (auto curEntry = 0U; curEntry < AArch64::PageTable::PointersPerTable; ++curEntry)
+            {
+                table.GetEntryForVA(VirtualPtr{ curEntry * Level1EntrySpanC }).Visit(Overloaded{
+                    [](AArch64::Descriptor::Table const aTableDescriptor)
+                    {
+                        FreeLevel2Table(aTableDescriptor.Address());
+                    },
+                    [](auto)
+                    {
+                        // nothing mapped (user memory is never mapped with level 1 blocks)
+                    }
+                });
+            }
+            FreePhysicalBlock(aTable);
+        }
+
+        /**
+         * A private page seen by the page merge thread during a pass, which later pages with the same contents can be
+         * merged into. The task may have changed or dropped the page since, so it has to be checked before use
+         */
+        struct MergeCandidate: Containers::RedBlackNode
+        {
+            uint64_t Hash = 0; // hash of the page's contents when it was seen
+            Scheduler::TaskStruct const* pTask = nullptr; // only for checking the task is still the same one
+            uint32_t ProcessID = 0;
+            VirtualPtr Address;
+            PhysicalPtr Page;
+        };
+
+        // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+        TypedObjectCache<MergeCandidate> MergeCandidateCache;
+
+        /**
+         * Hashes the contents of a page
+         * 
+         * @param aPage The page to hash
+         * @param arIsZero OUT: Set to true if the page is all zeros
+         * @return The hash of the page
+         */
+        uint64_t HashPage(PhysicalPtr const aPage, bool& arIsZero)
+        {
+            // 64-bit FNV-1a, a word at a time
+            constexpr auto fnvOffsetBasisC = 0xCBF2'9CE4'8422'2325ULL;
+            constexpr auto fnvPrimeC = 0x0000'0100'0000'01B3ULL;
+            auto const* const pwords = static_cast<uint64_t const*>(PhysicalToKernelVirtual(aPage));
+            auto hash = fnvOffsetBasisC;
+            auto allBits = uint64_t{ 0 };
+            for (auto curWord = 0U; curWord < (PageSize / sizeof(uint64_t)); ++curWord)
+            {
+                // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+                auto const word = pwords[curWord];
+                allBits |= word;
+                hash = (hash ^ word) * fnvPrimeC;
+            }
+            arIsZero = (allBits == 0);
+            return hash;
+        }
+
+        /**
+         * Finds a candidate with the given hash
+         * 
+         * @param aCandidates The candidates seen so far this pass
+         * @param aHash The hash to look for
+         * @return A candidate with the hash, or null if there isn't one
+         */
+        MergeCandidate* FindMergeCandidate(Containers::RedBlackTree const& aCandidates, uint64_t const aHash)
+        {
+            auto* pcurNode = aCandidates.GetRoot();
+            while (pcurNode != nullptr)
+            {
+                auto* const pcandidate = static_cast<MergeCandidate*>(pcurNode);
+                if (aHash == pcandidate->Hash)
+                {
+                    return pcandidate;
+                }
+                pcurNode = (aHash < pcandidate->Hash) ? pcurNode->pLeft : pcurNode->pRight;
+            }
+            return nullptr;
+        }
+
+        /**
+         * Finds the last level table still mapping a candidate's page at the candidate's address
+         * 
+         * @param aCandidate The candidate to check
+         * @param apArea OUT: The area the candidate is in
+         * @return The table, or null if the task is gone or no longer maps the page there
+         */
+        uint64_t* FindCandidateTable(MergeCandidate const& aCandidate, VirtualMemoryArea const*& apArea)
+        {
+            auto const* const ptask = Scheduler::GetTask(aCandidate.ProcessID);
+            if ((ptask != aCandidate.pTask) || (ptask->MemoryState.PageGlobalDirectory == PhysicalPtr{}))
+            {
+                return nullptr;
+            }
+            apArea = FindArea(ptask->MemoryState.Areas, aCandidate.Address);
+            auto* const ppageTable = FindPageTable(ptask->MemoryState.PageGlobalDirectory, aCandidate.Address);
+            AArch64::Descriptor::Page descriptor;
+            if ((apArea == nullptr) || (ppageTable == nullptr) ||
+                !GetPageDescriptor(AArch64::PageTable::Level3View{ ppageTable }, aCandidate.Address, descriptor) ||
+                (descriptor.Address() != aCandidate.Page))
+            {
+                return nullptr;
+            }
+            return ppageTable;
+        }
+
+        /**
+         * Points one of a task's pages at a shared page instead, copy-on-write, and lets go of the old page
+         * 
+         * @param arTask The task that owns the mapping
+         * @param aArea The area the page is in
+         * @param aTable The last level table holding the page
+         * @param aVirtualAddress The user virtual address of the page
+         * @param aOldPage The page currently mapped
+         * @param aSharedPage The page to share
+         */
+        void RemapToSharedPage(Scheduler::TaskStruct& arTask, VirtualMemoryArea const& aArea, AArch64::PageTable::Level3View const aTable,
+            VirtualPtr const aVirtualAddress, PhysicalPtr const aOldPage, PhysicalPtr const aSharedPage)
+        {
+            MapTableEntry(GetTaskASID(arTask), aTable, aVirtualAddress, aSharedPage, aArea.Protection, true);
+            AddPageReference(aSharedPage);
+            // The old writable translation may still be cached
+            AArch64::TLB::InvalidatePage(GetTaskASID(arTask), aVirtualAddress, AArch64::TLB::Entries::LastLevel);
+            ReleasePageReference(aOldPage);
+        }
+
+        /**
+         * Makes one of a task's pages copy-on-write, without changing the page it maps. Tasks on other CPUs can write
+         * through cached translations without faulting, so a page has to be protected before its contents can be
+         * trusted not to change. A page left copy-on-write with a single reference is handed back on the next write
+         * 
+         * @param aTaskASID The ASID of the task that owns the mapping
+         * @param aArea The area the page is in
+         * @param aTable The last level table holding the page
+         * @param aVirtualAddress The user virtual address of the page
+         * @param aPage The page currently mapped
+         */
+        void WriteProtectPage(uint16_t const aTaskASID, VirtualMemoryArea const& aArea, AArch64::PageTable::Level3View const aTable,
+            VirtualPtr const aVirtualAddress, PhysicalPtr const aPage)
+        {
+            MapTableEntry(aTaskASID, aTable, aVirtualAddress, aPage, aArea.Protection, true);
+            AArch64::TLB::InvalidatePage(aTaskASID, aVirtualAddress, AArch64::TLB::Entries::LastLevel);
+        }
+
+        /**
+         * Merges one of a task's private pages with an identical page seen earlier in the pass, or remembers it so
+         * later pages can be merged with it. Must be called with preemption disabled, so no fault can change the
+         * mappings while we're looking at them
+         * 
+         * @param arTask The task that owns the page
+         * @param aProcessID The task's process ID
+         * @param aArea The area the page is in
+         * @param aTable The last level table holding the page
+         * @param aVirtualAddress The user virtual address of the page
+         * @param arCandidates The candidates seen so far this pass
+         */
+        void MergePage(Scheduler::TaskStruct& arTask, uint32_t const aProcessID, VirtualMemoryArea const& aArea,
+            AArch64::PageTable::Level3View const aTable, VirtualPtr const aVirtualAddress, Containers::RedBlackTree& arCandidates)
+        {
+            AArch64::Descriptor::Page descriptor;
+            if (!GetPageDescriptor(aTable, aVirtualAddress, descriptor))
+            {
+                return;
+            }
+            auto const page = descriptor.Address();
+            auto const* const pframe = PageAllocator.GetFrame(page);
+            if ((page == ZeroPage) || (pframe == nullptr) || (__atomic_load_n(&pframe->RefCount, __ATOMIC_ACQUIRE) != 1))
+            {
+                // already shared
+                return;
+            }
+
+            auto isZero = false;
+            auto const hash = HashPage(page, isZero);
+            if (isZero)
+            {
+                // Check again once it can't be written, in case a task on another CPU wrote to it in the meantime
+                WriteProtectPage(GetTaskASID(arTask), aArea, aTable, aVirtualAddress, page);
+                HashPage(page, isZero);
+                if (isZero)
+                {
+                    RemapToSharedPage(arTask, aArea, aTable, aVirtualAddress, page, ZeroPage);
+                }
+                return;
+            }
+
+            auto* const pcandidate = FindMergeCandidate(arCandidates, hash);
+            if (pcandidate != nullptr)
+            {
+                VirtualMemoryArea const* pcandidateArea = nullptr;
+                auto* const pcandidateTable = FindCandidateTable(*pcandidate, pcandidateArea);
+                if ((pcandidateTable != nullptr) && (pcandidate->Page != page))
+                {
+                    // Either page may still be writable by a task on another CPU, so both are made copy-on-write
+                    // before comparing, otherwise one could change between the compare and the remap
+                    WriteProtectPage(GetTaskASID(*pcandidate->pTask), *pcandidateArea, AArch64::PageTable::Level3View{ pcandidateTable }, pcandidate->Address, pcandidate->Page);
+                    WriteProtectPage(GetTaskASID(arTask), aArea, aTable, aVirtualAddress, page);
+                    if (memcmp(PhysicalToKernelVirtual(pcandidate->Page), PhysicalToKernelVirtual(page), PageSize) == 0)
+                    {
+                        RemapToSharedPage(arTask, aArea, aTable, aVirtualAddress, page, pcandidate->Page);
+                        return;
+                    }
+                }
+
+                // The candidate is stale, or just happened to hash the same, so this page takes its place (the hash
+                // is the same, so its spot in the tree still works)
+                pcandidate->pTask = &arTask;
+                pcandidate->ProcessID = aProcessID;
+                pcandidate->Address = aVirtualAddress;
+                pcandidate->Page = page;
+                return;
+            }
+
+            auto* const pnewCandidate = MergeCandidateCache.Allocate();
+            if (pnewCandidate == nullptr)
+            {
+                // Not worth failing over, this page just won't get merged this pass
+                return;
+            }
+            pnewCandidate->Hash = hash;
+            pnewCandidate->pTask = &arTask;
+            pnewCandidate->ProcessID = aProcessID;
+            pnewCandidate->Address = aVirtualAddress;
+            pnewCandidate->Page = page;
+            arCandidates.InsertOrdered(*pnewCandidate,
+                [](Containers::RedBlackNode const& aLhs, Containers::RedBlackNode const& aRhs)
+                {
+                    return static_cast<MergeCandidate const&>(aLhs).Hash < static_cast<MergeCandidate const&>(aRhs).Hash;
+                });
+        }
+
+        /**
+         * Runs the page merge over the next few pages of a task, starting from the cursor. Preemption is disabled for
+         * the whole turn, and the task and its areas are looked up fresh each turn, since the task may have changed or
+         * exited while we were waiting for the CPU
+         * 
+         * @param aProcessID The process ID of the task
+         * @param apTask The task that was in the slot when we started on it
+         * @param arCursor IN/OUT: The user virtual address to carry on from
+         * @param arCandidates The candidates seen so far this pass
+         * @return True if the task is done, false if there are more pages to look at
+         */
+        bool MergeTaskPages(uint32_t const aProcessID, Scheduler::TaskStruct* const apTask, VirtualPtr& arCursor,
+            Containers::RedBlackTree& arCandidates)
+        {
+            Scheduler::DisablePreemptingInScope const disablePreempt;
+            if ((Scheduler::GetTask(aProcessID) != apTask) || (apTask->MemoryState.PageGlobalDirectory == PhysicalPtr{}))
+            {
+                return true;
+            }
+
+            auto budget = MergePagesPerTurnC;
+            return WalkTaskPages(*apTask, arCursor, budget,
+                [apTask, aProcessID, &arCandidates](VirtualMemoryArea const& aArea, AArch64::PageTable::Level3View const aTable, VirtualPtr const aVirtualAddress)
+                {
+                    MergePage(*apTask, aProcessID, aArea, aTable, aVirtualAddress, arCandidates);
+                    return true;
+                });
+        }
+
+        /**
+         * Backs a page of a kernel virtual allocation the first time it's touched
+         * 
+         * @param aVirtualAddress The kernel virtual address that faulted
+         * @return False if the address isn't in an allocation, or we ran out of memory
+         */
+        bool MapKernelVirtualPage(VirtualPtr const aVirtualAddress)
+        {
+            if (FindArea(KernelAreas, aVirtualAddress) == nullptr)
+            {
+                return false;
+            }
+            KernelTables tables;
+            auto* const ppageTable = AArch64::PageTable::FindPageTable<true>(GetRootTable(KernelRootTable), aVirtualAddress, tables);
+            if (ppageTable == nullptr)
+            {
+                return false;
+            }
+            auto const pageTable = AArch64::PageTable::Level3View{ ppageTable };
+
+            AArch64::Descriptor::Page existingDescriptor;
+            if (GetPageDescriptor(pageTable, aVirtualAddress, existingDescriptor))
+            {
+                // already backed, the fault was from before the entry was visible
+                return true;
+            }
+            auto const newPage = GetFreePage();
+            if (newPage == PhysicalPtr{})
+            {
+                return false;
+            }
+            pageTable.SetEntryForVA(aVirtualAddress, MakeKernelPageDescriptor(newPage));
+            // The entry was invalid before, so there is nothing to invalidate
+            sync_page_tables();
+            return true;
+        }
+    }
+
+    void Init(PhysicalPtr const aDTBPointer, PhysicalPtr const aBootTablesEnd)
+    {
+        EmptyUserTable = AArch64::TTBRn_EL1::Read0().BADDR();
+        KernelRootTable = AArch64::TTBRn_EL1::Read1().BADDR();
+        AddressSpaceIDs = ASIDAllocator{ AArch64::TCR_EL1::Read().AS() ? LargeASIDCountC : SmallASIDCountC };
+
+        // #TODO: Should find a better way to go from the pointer from the firmware to our virtual address
+        auto const* const pdtb = std::bit_cast<uint8_t const*>(aDTBPointer.Offset(KernelVirtualAddressOffset).GetAddress());
+        DeviceTree::MemoryMap memoryMap;
+        if (!DeviceTree::ReadMemoryMap(pdtb, memoryMap))
+        {
+            // Without a device tree, all we know is the memory we mapped in boot is there
+            Print::FormatToMiniUART("Unable to read memory map from device tree, assuming memory up to {}\r\n", MaxUsablePA);
+            memoryMap.Memory[0] = DeviceTree::MemoryRange{ PhysicalPtr{}, MaxUsablePA };
+            memoryMap.MemoryCount = 1;
+        }
+
+        // #TODO: Remove lint tag when we get std::array
+        // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+        DeviceTree::MemoryRange reserved[MaxReservedRanges];
+        auto reservedCount = 0U;
+        for (auto curReserved = 0U; curReserved < memoryMap.ReservedCount; ++curReserved)
+        {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+            reserved[reservedCount++] = memoryMap.Reserved[curReserved];
+        }
+        // The boot stack grows down from the kernel image start, and the boot page tables sit at the end of the image.
+        // Only the tables boot actually used need to stay reserved
+        auto const imageEnd = CalculateKernelImagePAEnd();
+        auto const bootTablesEnd = ((aBootTablesEnd == PhysicalPtr{}) || (imageEnd < aBootTablesEnd)) ? imageEnd : aBootTablesEnd;
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+        reserved[reservedCount++] = DeviceTree::MemoryRange{ PhysicalPtr{}, bootTablesEnd };
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+        reserved[reservedCount++] = DeviceTree::MemoryRange{ aDTBPointer, aDTBPointer.Offset(memoryMap.BlobSize) };
+
+        // Clamp the memory to what we can access, and figure out the span of pages the allocator has to cover
+        auto spanBegin = MaxUsablePA;
+        auto spanEnd = PhysicalPtr{};
+        for (auto curMemory = 0U; curMemory < memoryMap.MemoryCount; ++curMemory)
+        {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+            auto& memory = memoryMap.Memory[curMemory];
+            memory.End = (memory.End > MaxUsablePA) ? MaxUsablePA : memory.End;
+            if (memory.Begin >= memory.End)
+            {
+                continue;
+            }
+            spanBegin = (memory.Begin < spanBegin) ? memory.Begin : spanBegin;
+            spanEnd = (memory.End > spanEnd) ? memory.End : spanEnd;
+        }
+        // Align the start to the largest block so that blocks are aligned in physical (and kernel virtual) memory and
+        // not just relative to the first page, which lets the slab allocator find slab headers by masking addresses
+        spanBegin = CalculateBlockStart(spanBegin, PageSize << BuddyAllocator::MaxOrderC);
+        spanEnd = CalculateBlockStart(spanEnd, PageSize);
+        if (spanBegin >= spanEnd)
+        {
+            MiniUART::SendString("No usable physical memory found\r\n");
+            return;
+        }
+
+        // The frame array has to come out of the memory it describes, so find the first free range big enough
+        auto const frameCount = (spanEnd.GetAddress() - spanBegin.GetAddress()) / PageSize;
+        auto const frameArraySize = CalculateBlockStart((frameCount * sizeof(PageFrame)) + PageSize - 1, PageSize);
+        auto frameArrayPA = PhysicalPtr{};
+        for (auto curMemory = 0U; (curMemory < memoryMap.MemoryCount) && (frameArrayPA == PhysicalPtr{}); ++curMemory)
+        {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+            ForEachFreeRange(memoryMap.Memory[curMemory], reserved, reservedCount,
+                [&frameArrayPA, frameArraySize](PhysicalPtr const aBegin, PhysicalPtr const aEnd)
+                {
+                    auto const alignedBegin = CalculateBlockStart(aBegin.Offset(PageSize - 1), PageSize);
+                    if ((frameArrayPA == PhysicalPtr{}) && (alignedBegin.Offset(frameArraySize) <= aEnd))
+                    {
+                        frameArrayPA = alignedBegin;
+                    }
+                });
+        }
+        if (frameArrayPA == PhysicalPtr{})
+        {
+            MiniUART::SendString("Unable to find memory for the page frame array\r\n");
+            return;
+        }
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+        reserved[reservedCount++] = DeviceTree::MemoryRange{ frameArrayPA, frameArrayPA.Offset(frameArraySize) };
+
+        PageAllocator.Init(spanBegin, static_cast<PageFrame*>(PhysicalToKernelVirtual(frameArrayPA)), frameCount);
+        for (auto curMemory = 0U; curMemory < memoryMap.MemoryCount; ++curMemory)
+        {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+            ForEachFreeRange(memoryMap.Memory[curMemory], reserved, reservedCount,
+                [](PhysicalPtr const aBegin, PhysicalPtr const aEnd)
+                {
+                    PageAllocator.AddFreeRange(aBegin, aEnd);
+                });
+        }
+
+        ZeroPage = GetFreePage();
+        if (ZeroPage == PhysicalPtr{})
+        {
+            // #TODO: Panic, since every untouched user page read relies on it
+            return;
+        }
+
+        Print::FormatToMiniUART("Physical memory: {} - {}, {} pages free\r\n", spanBegin, spanEnd, PageAllocator.GetFreePageCount());
+    }
+
+    void* AllocatePages(unsigned const aOrder)
     {
-        /**
-         * Calculates the start of paging memory based on the end of the kernel image
-         * 
-         * @return The physical address that starts our paging memory
-        */
-        PhysicalPtr CalculatePagingMemoryPAStart()
+        if (aOrder == 0)
         {
-            // #TODO: Why is _kernel_image_end here a virtual address when in the boot process it's a physical
-            // address?
-            auto const kernalImageEndVA = std::bit_cast<uintptr_t>(&_kernel_image_end);
-            auto const kernelImageEndPA = PhysicalPtr{ kernalImageEndVA - KernelVirtualAddressOffset };
-            return CalculateBlockEnd(kernelImageEndPA, L2BlockSize).Offset(1);
+            // single pages can come out of the zeroed pool
+            auto const physicalPage = GetFreePage();
+            return (physicalPage == PhysicalPtr{}) ? nullptr : PhysicalToKernelVirtual(physicalPage);
         }
 
-        constexpr auto PageMask = ~(PageSize - 1);
+        auto* const pkernelVA = AllocateUnzeroedPages(aOrder);
+        if (pkernelVA != nullptr)
+        {
+            memset(pkernelVA, 0, PageSize << aOrder);
+        }
+        return pkernelVA;
+    }
 
-        // #TODO: Hardcoding only 64 pages for now, we need something better for this (probably once we calculate what
-        // is available from the device tree)
-        constexpr auto MaxPageCount = 64U;
-        // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
-        std::bitset<MaxPageCount> PageInUse;
+    void* AllocateUnzeroedPages(unsigned const aOrder)
+    {
+        auto const physicalBlock = (aOrder == 0) ? GetUnzeroedPage() : AllocatePhysicalBlock(aOrder);
+        if (physicalBlock == PhysicalPtr{})
+        {
+            return nullptr;
+        }
+        // map the physical block to the kernel address space (offset-mapped)
+        return PhysicalToKernelVirtual(physicalBlock);
+    }
 
-        /**
-         * Allocate a page of memory
-         * 
-         * @return Physical address of the new allocated page of memory, zeroed out
-         */
-        PhysicalPtr GetFreePage()
+    void FreePages(void* const apPages)
+    {
+        if (apPages == nullptr)
+        {
+            return;
+        }
+        FreePhysicalBlock(PhysicalPtr{ std::bit_cast<uintptr_t>(apPages) - KernelVirtualAddressOffset });
+    }
+
+    PageFrame* GetPageFrame(void const* const apKernelAddress)
+    {
+        auto const kernelAddress = std::bit_cast<uintptr_t>(apKernelAddress);
+        if (kernelAddress < KernelVirtualAddressOffset)
+        {
+            return nullptr;
+        }
+        return PageAllocator.GetFrame(PhysicalPtr{ kernelAddress - KernelVirtualAddressOffset });
+    }
+
+    void* AllocateKernelPage()
+    {
+        return AllocatePages(0);
+    }
+
+    void* AllocateKernelVirtual(size_t const aSize)
+    {
+        if ((aSize == 0) || (aSize > KernelAreaSizeC))
+        {
+            return nullptr;
+        }
+        auto* const parea = AreaCache.Allocate();
+        if (parea == nullptr)
+        {
+            return nullptr;
+        }
+        parea->Length = CalculateBlockStart(aSize + PageSize - 1, PageSize);
+        parea->Protection = AreaProtection::ReadC | AreaProtection::WriteC;
+
+        Scheduler::DisablePreemptingInScope const disablePreempt;
+        // Leaving a page unmapped between allocations makes running off the end of one fault, rather than
+        // scribbling over the next
+        if (!FindFreeRange(KernelAreas, KernelAreaStartC, KernelAreaSizeC, parea->Length, PageSize, parea->Start))
+        {
+            AreaCache.Free(parea);
+            return nullptr;
+        }
+        InsertArea(KernelAreas, *parea);
+        return std::bit_cast<void*>(parea->Start.GetAddress());
+    }
+
+    void FreeKernelVirtual(void* const apMemory)
+    {
+        if (apMemory == nullptr)
+        {
+            return;
+        }
+        auto const start = VirtualPtr{ std::bit_cast<uintptr_t>(apMemory) };
+
+        Scheduler::DisablePreemptingInScope const disablePreempt;
+        auto* const parea = FindArea(KernelAreas, start);
+        if ((parea == nullptr) || (parea->Start != start))
+        {
+            // #TODO: Panic, since this isn't memory we handed out
+            return;
+        }
+        KernelAreas.Remove(*parea);
+
+        auto curAddress = start;
+        auto const end = start.Offset(parea->Length);
+        while (curAddress < end)
         {
-            // Very simple for now, just find the first unused page and return it
-            auto const pageMemoryStartPA = CalculatePagingMemoryPAStart();
-            for (auto curPage = 0ULL; curPage < PageInUse.size(); ++curPage)
+            auto const blockEnd = CalculateBlockStart(curAddress, L2BlockSize).Offset(L2BlockSize);
+            auto const chunkEnd = (end < blockEnd) ? end : blockEnd;
+            auto* const ppageTable = FindPageTable(KernelRootTable, curAddress);
+            for (; (ppageTable != nullptr) && (curAddress < chunkEnd); curAddress = curAddress.Offset(PageSize))
             {
-                if (!PageInUse[curPage])
+                auto const pageTable = AArch64::PageTable::Level3View{ ppageTable };
+                AArch64::Descriptor::Page pageDescriptor;
+                if (GetPageDescriptor(pageTable, curAddress, pageDescriptor))
                 {
-                    PageInUse[curPage] = true;
-                    auto newPageStartPA = pageMemoryStartPA.Offset(curPage * PageSize);
-                    // have to add the KernelVirtualAddressStart because that's where the physical address is mapped to
-                    // in kernel space
-                    memset(std::bit_cast<void*>(newPageStartPA.Offset(KernelVirtualAddressOffset).GetAddress()), 0, PageSize);
-                    return newPageStartPA;
+                    pageTable.SetEntryForVA(curAddress, AArch64::Descriptor::Fault{});
+                    // The entry is global, so it's invalidated whatever ASID we give
+                    AArch64::TLB::InvalidatePage(KernelASID, curAddress, AArch64::TLB::Entries::LastLevel);
+                    FreePhysicalBlock(pageDescriptor.Address());
                 }
             }
-            return PhysicalPtr{};
+            curAddress = chunkEnd;
         }
+        AreaCache.Free(parea);
+    }
 
-        /**
-         * Free a page of memory
-         * 
-         * @param apPage Physical address of the page to free
-         */
-        /* Currently unused
-        void FreePage(void* apPage)
+    bool IsKernelVirtualAddress(void const* const apAddress)
+    {
+        auto const address = std::bit_cast<uintptr_t>(apAddress);
+        return (address >= KernelAreaStartC.GetAddress()) && ((address - KernelAreaStartC.GetAddress()) < KernelAreaSizeC);
+    }
+
+    bool MapAnonymousArea(Scheduler::TaskStruct& arTask, VirtualPtr const aStart, size_t const aLength, uint8_t const aProtection)
+    {
+        if ((aLength == 0) || ((aStart.GetAddress() & (PageSize - 1)) != 0) || ((aLength & (PageSize - 1)) != 0) ||
+            (aStart.GetAddress() >= UserAddressSpaceSizeC) || (aLength > UserAddressSpaceSizeC - aStart.GetAddress()))
         {
-            // #TODO: Double-check that the page is valid
-            auto const pageMemoryStart = CalculatePagingMemoryPAStart();
-            const auto index = (reinterpret_cast<uintptr_t>(apPage) - pageMemoryStart) / PageSize;
-            PageInUse[index] = false;
+            return false;
         }
-        */
 
-       /**
-         * Map a new table, or get the existing table for the specified table, shift, and virtual address
-         * 
-         * @param aTable The table to add the entry to
-         * @param aUserVirtualAddress The user virtual address we want to map
-         * @param arNewTable OUT: Set to true if a new table had to be made, otherwise false
-         * @return The table for the specified address - new or existing
-         */
-        template<class LowerTableViewT, class TableViewT>
-        LowerTableViewT MapTable(TableViewT aTable, VirtualPtr const aUserVirtualAddress, bool& arNewTable)
+        auto* const parea = AreaCache.Allocate();
+        if (parea == nullptr)
         {
-            // #TODO: Can we make a relationship between TableViewT and LowerTableViewT so it can be deduced?
+            return false;
+        }
+        parea->Start = aStart;
+        parea->Length = aLength;
+        parea->Protection = aProtection;
+        parea->Backing = AreaBacking::Anonymous;
 
-            arNewTable = false; // assume we don't need a new table
+        Scheduler::DisablePreemptingInScope const disablePreempt;
+        if (!InsertArea(arTask.MemoryState.Areas, *parea))
+        {
+            AreaCache.Free(parea);
+            return false;
+        }
+        return true;
+    }
 
-            auto const entry = aTable.GetEntryForVA(aUserVirtualAddress);
-            PhysicalPtr pagePA;
-            entry.Visit(Overloaded{
-                [&arNewTable, &pagePA, aTable, aUserVirtualAddress](AArch64::Descriptor::Fault)
-                {
-                    // this part hasn't been set up yet, so add an entry
-                    arNewTable = true;
+    void* AllocateUserPage(Scheduler::TaskStruct& arTask, VirtualPtr const aVirtualAddress)
+    {
+        auto const* const parea = FindArea(arTask.MemoryState.Areas, aVirtualAddress);
+        if (parea == nullptr)
+        {
+            return nullptr;
+        }
 
-                    AArch64::Descriptor::Table tableDescriptor;
-                    pagePA = GetFreePage();
-                    tableDescriptor.Address(pagePA);
+        auto const physicalPage = GetUserPage(arTask, aVirtualAddress, true);
+        if (physicalPage == PhysicalPtr{})
+        {
+            return nullptr;
+        }
 
-                    aTable.SetEntryForVA(aUserVirtualAddress, tableDescriptor);
-                },
-                [&pagePA](AArch64::Descriptor::Table aTableDescriptor)
-                {
-                    pagePA = aTableDescriptor.Address();
-                },
-                [](AArch64::Descriptor::L1Block)
+        if (!MapPage(arTask, aVirtualAddress, physicalPage, parea->Protection, false))
+        {
+            FreePhysicalBlock(physicalPage);
+            return nullptr;
+        }
+        // map the physical page to the kernel address space (offset-mapped)
+        return PhysicalToKernelVirtual(physicalPage);
+    }
+
+    bool CopyVirtualMemory(Scheduler::TaskStruct& arDestinationTask, const Scheduler::TaskStruct& aCurrentTask)
+    {
+        // Rather than copying every page, both tasks share the pages read-only, and whoever writes to a page first
+        // gets their own copy in do_mem_abort
+        auto anyWritableShared = false;
+        for (auto const* pcurArea = GetFirstArea(aCurrentTask.MemoryState.Areas); pcurArea != nullptr; pcurArea = GetNextArea(*pcurArea))
+        {
+            auto* const pnewArea = AreaCache.Allocate();
+            if (pnewArea == nullptr)
+            {
+                return false;
+            }
+            pnewArea->Start = pcurArea->Start;
+            pnewArea->Length = pcurArea->Length;
+            pnewArea->Protection = pcurArea->Protection;
+            pnewArea->Backing = pcurArea->Backing;
+            // Can't overlap anything, since the areas are being copied from a tree that doesn't overlap
+            InsertArea(arDestinationTask.MemoryState.Areas, *pnewArea);
+
+            if (aCurrentTask.MemoryState.PageGlobalDirectory != PhysicalPtr{})
+            {
+                if (!ShareArea(arDestinationTask, aCurrentTask.MemoryState.PageGlobalDirectory, *pcurArea))
                 {
-                    // #TODO: Panic if this ever happens
-                },
-                [](AArch64::Descriptor::L2Block)
+                    return false;
+                }
+                anyWritableShared = anyWritableShared || ((pcurArea->Protection & AreaProtection::WriteC) != 0);
+            }
+        }
+
+        if (anyWritableShared)
+        {
+            // The current task may have the writable translations cached. That's potentially every entry in the
+            // address space, which is more than is worth invalidating one at a time
+            AArch64::TLB::InvalidateASID(GetTaskASID(aCurrentTask));
+        }
+        return true;
+    }
+
+    void ReleaseAddressSpace(Scheduler::TaskStruct& arTask)
+    {
+        if (arTask.MemoryState.CacheColors != 0)
+        {
+            Scheduler::DisablePreemptingInScope const disablePreempt;
+            ReservedCacheColors &= static_cast<uint8_t>(~arTask.MemoryState.CacheColors);
+            arTask.MemoryState.CacheColors = 0;
+        }
+
+        while (!arTask.MemoryState.Areas.IsEmpty())
+        {
+            auto* const parea = GetFirstArea(arTask.MemoryState.Areas);
+            arTask.MemoryState.Areas.Remove(*parea);
+            AreaCache.Free(parea);
+        }
+
+        auto const pageGlobalDirectory = arTask.MemoryState.PageGlobalDirectory;
+        if (pageGlobalDirectory == PhysicalPtr{})
+        {
+            return;
+        }
+        arTask.MemoryState.PageGlobalDirectory = PhysicalPtr{};
+        if (&arTask == &Scheduler::GetCurrentTask())
+        {
+            // The walker has to stop using the tables before they can be freed
+            ActivateAddressSpace(arTask);
+        }
+        if (arTask.MemoryState.ASIDContext != ASIDAllocator::UnassignedContextC)
+        {
+            // Nothing else will use the ASID until the next generation, but the pages and tables are about to be
+            // handed out again, so nothing can be left cached for them
+            AArch64::TLB::InvalidateASID(GetTaskASID(arTask));
+        }
+
+        // The page tables are the only record of what the task had mapped
+        auto const rootTable = GetRootTable(pageGlobalDirectory);
+        for (auto curEntry = 0U; curEntry < AArch64::PageTable::PointersPerTable; ++curEntry)
+        {
+            rootTable.GetEntryForVA(VirtualPtr{ curEntry * Level0EntrySpanC }).Visit(Overloaded{
+                [](AArch64::Descriptor::Table const aTableDescriptor)
                 {
-                    // #TODO: Panic if this ever happens
+                    FreeLevel1Table(aTableDescriptor.Address());
                 },
-                [](AArch64::Descriptor::Page)
+                [](auto)
                 {
-                    // #TODO: Panic if this ever happens
+                    // nothing mapped
                 }
             });
+        }
+        FreePhysicalBlock(pageGlobalDirectory);
+    }
+
+    void SetPageColoring(bool const aEnabled)
+    {
+        PageColoringEnabled = aEnabled;
+    }
 
-            // virtual address for memory in the kernel is physical address plus offset
-            auto* const ppageVA = std::bit_cast<uint64_t*>(pagePA.Offset(KernelVirtualAddressOffset).GetAddress());
-            return LowerTableViewT{ ppageVA };
+    bool ReserveCacheColors(Scheduler::TaskStruct& arTask, uint8_t const aColors)
+    {
+        Scheduler::DisablePreemptingInScope const disablePreempt;
+        auto const othersReserved = static_cast<uint8_t>(ReservedCacheColors & ~arTask.MemoryState.CacheColors);
+        // Everyone else has to be left at least one color
+        if ((aColors == 0) || ((othersReserved & aColors) != 0) || ((othersReserved | aColors) == BuddyAllocator::AllColorsC))
+        {
+            return false;
         }
+        ReservedCacheColors = othersReserved | aColors;
+        arTask.MemoryState.CacheColors = aColors;
+        return true;
+    }
 
-        /**
-         * Map a new table entry into the page table
-         * 
-         * @param aTableVirtualAddress Kernel virtual address for the table
-         * @param aUserVirtualAddress User virtual address we want to map
-         * @param aPhysicalPage The physical page to map
-         */
-        void MapTableEntry(AArch64::PageTable::Level3View const aTable, const VirtualPtr aUserVirtualAddress, PhysicalPtr const aPhysicalPage)
+    void SetFaultAroundPages(unsigned const aPageCount)
+    {
+        // Keep the window a power of two no bigger than a table, so it always lines up inside one table
+        auto pageCount = 1U;
+        while (((pageCount * 2) <= aPageCount) && ((pageCount * 2) <= AArch64::PageTable::PointersPerTable))
         {
-            AArch64::Descriptor::Page pageDescriptor;
-            pageDescriptor.Address(aPhysicalPage);
-            pageDescriptor.AttrIndx(NormalMAIRIndex); // normal memory
-            pageDescriptor.AF(true); // don't trap on access
-            pageDescriptor.AP(AArch64::Descriptor::Page::AccessPermissions::KernelRWUserRW); // let user r/w it
-            
-            aTable.SetEntryForVA(aUserVirtualAddress, pageDescriptor);
+            pageCount *= 2;
         }
+        FaultAroundPages = pageCount;
+    }
 
-        /**
-         * Maps a user page for the specified task
-         * 
-         * @param arTask The task the page is for
-         * @param aVirtualAddress The user virtual address for the page
-         * @param aPhysicalPage The physical page the virtual page should map to
-         */
-        void MapPage(Scheduler::TaskStruct& arTask, VirtualPtr const aVirtualAddress, PhysicalPtr const aPhysicalPage)
+    void ZeroPageThread(void const* const /*apParam*/)
+    {
         {
-            if (arTask.MemoryState.PageGlobalDirectory == PhysicalPtr{})
+            Scheduler::DisablePreemptingInScope const disablePreempt;
+            pZeroPageTask = &Scheduler::GetCurrentTask();
+        }
+        while (true)
+        {
+            // Only do a little at a time, so we don't hold up anyone with real work to do
+            for (auto curPage = 0U; (curPage < ZeroPagesPerTurnC) && (ZeroedPageCount < ZeroedPagePoolSizeC); ++curPage)
             {
-                arTask.MemoryState.PageGlobalDirectory = GetFreePage();
-                // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
-                arTask.MemoryState.KernelPages[arTask.MemoryState.KernelPagesCount] = arTask.MemoryState.PageGlobalDirectory;
-                ++arTask.MemoryState.KernelPagesCount;
+                auto const page = AllocatePhysicalBlock(0);
+                if (page == PhysicalPtr{})
+                {
+                    break;
+                }
+                memset(PhysicalToKernelVirtual(page), 0, PageSize);
+                if (!PushZeroedPage(page))
+                {
+                    // someone else filled the pool while we were zeroing
+                    FreePhysicalBlock(page);
+                    break;
+                }
             }
-
-            // helper to convert a table's pointer to the physical memory address, assuming offset mapping
-            auto tablePtrToPAOffset = [](uint64_t const* const apTable)
             {
-                return PhysicalPtr{ std::bit_cast<uintptr_t>(apTable) - KernelVirtualAddressOffset};
-            };
+                // Checked with preemption disabled, so a page taken between here and the schedule still unblocks us.
+                // Waiting for the pool to drain a bit means we don't wake to replace every single page
+                Scheduler::DisablePreemptingInScope const disablePreempt;
+                if (ZeroedPageCount == ZeroedPagePoolSizeC)
+                {
+                    Scheduler::Block();
+                }
+            }
+            Scheduler::Schedule();
+        }
+    }
 
-            // PGD addresses are offset-mapped to virtual addresses
-            auto const pageGlobalDirectoryVA = VirtualPtr{ arTask.MemoryState.PageGlobalDirectory.GetAddress() }.Offset(KernelVirtualAddressOffset);
-            auto const pageGlobalDirectory = AArch64::PageTable::Level0View{ std::bit_cast<uint64_t*>(pageGlobalDirectoryVA.GetAddress()) };
-            auto newTable = false;
-            auto const pageUpperDirectory = MapTable<AArch64::PageTable::Level1View>(pageGlobalDirectory, aVirtualAddress, newTable);
-            if (newTable)
+    void PageMergeThread(void const* const /*apParam*/)
+    {
+        while (true)
+        {
+            // The candidates only last a pass - pages change, so anything not merged gets a fresh look next time
+            Containers::RedBlackTree candidates;
+            for (auto curProcess = 0U; curProcess < Scheduler::MaxTasksC; ++curProcess)
             {
-                // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
-                arTask.MemoryState.KernelPages[arTask.MemoryState.KernelPagesCount] = tablePtrToPAOffset(pageUpperDirectory.GetTablePtr());
-                ++arTask.MemoryState.KernelPagesCount;
+                auto* const ptask = Scheduler::GetTask(curProcess);
+                if (ptask == nullptr)
+                {
+                    continue;
+                }
+                auto cursor = VirtualPtr{};
+                while (!MergeTaskPages(curProcess, ptask, cursor, candidates))
+                {
+                    Scheduler::Schedule();
+                }
             }
-
-            auto const pageMiddleDirectory = MapTable<AArch64::PageTable::Level2View>(pageUpperDirectory, aVirtualAddress, newTable);
-            if (newTable)
+            while (!candidates.IsEmpty())
             {
-                // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
-                arTask.MemoryState.KernelPages[arTask.MemoryState.KernelPagesCount] = tablePtrToPAOffset(pageMiddleDirectory.GetTablePtr());
-                ++arTask.MemoryState.KernelPagesCount;
+                auto* const pcandidate = static_cast<MergeCandidate*>(candidates.GetRoot());
+                candidates.Remove(*pcandidate);
+                MergeCandidateCache.Free(pcandidate);
             }
 
-            auto const pageTableEntry = MapTable<AArch64::PageTable::Level3View>(pageMiddleDirectory, aVirtualAddress, newTable);
-            if (newTable)
+            // Give everyone else a good run before looking again
+            for (auto curTurn = 0U; curTurn < MergePassRestTurnsC; ++curTurn)
             {
-                // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
-                arTask.MemoryState.KernelPages[arTask.MemoryState.KernelPagesCount] = tablePtrToPAOffset(pageTableEntry.GetTablePtr());
-                ++arTask.MemoryState.KernelPagesCount;
+                Scheduler::Schedule();
             }
-
-            MapTableEntry(pageTableEntry, aVirtualAddress, aPhysicalPage);
-            // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
-            arTask.MemoryState.UserPages[arTask.MemoryState.UserPagesCount] = Scheduler::UserPage{ aPhysicalPage, aVirtualAddress };
-            ++arTask.MemoryState.UserPagesCount;
         }
     }
 
-    void* AllocateKernelPage()
+    void SyncInstructionCache(void const* const apStart, size_t const aSize)
     {
-        auto const physicalPage = GetFreePage();
-        if (physicalPage == PhysicalPtr{})
-        {
-            return nullptr;
-        }
-        // map the physical page to the kernel address space (offset-mapped)
-        return std::bit_cast<void*>(physicalPage.Offset(KernelVirtualAddressOffset).GetAddress());
+        auto const start = std::bit_cast<uintptr_t>(apStart);
+        sync_instruction_cache(start, start + aSize);
     }
 
-    void* AllocateUserPage(Scheduler::TaskStruct& arTask, VirtualPtr const aVirtualAddress)
+    void ActivateAddressSpace(Scheduler::TaskStruct& arTask)
     {
-        auto const physicalPage = GetFreePage();
-        if (physicalPage == PhysicalPtr{})
+        Scheduler::DisablePreemptingInScope const disablePreempt;
+
+        AArch64::TTBRn_EL1 ttbr0;
+        if (arTask.MemoryState.PageGlobalDirectory == PhysicalPtr{})
         {
-            return nullptr;
+            // Kernel threads don't have a user address space, so point the walker at an empty table rather than
+            // whatever happens to be at physical address 0
+            ttbr0.BADDR(EmptyUserTable);
+            ttbr0.ASID(KernelASID);
         }
-
-        MapPage(arTask, aVirtualAddress, physicalPage);
-        // map the physical page to the kernel address space (offset-mapped)
-        return std::bit_cast<void*>(physicalPage.Offset(KernelVirtualAddressOffset).GetAddress());
-    }
-
-    bool CopyVirtualMemory(Scheduler::TaskStruct& arDestinationTask, const Scheduler::TaskStruct& aCurrentTask)
-    {
-        for (auto curPage = 0U; curPage < aCurrentTask.MemoryState.UserPagesCount; ++curPage)
+        else
         {
-            // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
-            auto* const pkernelVA = AllocateUserPage(arDestinationTask, aCurrentTask.MemoryState.UserPages[curPage].VirtualAddress);
-            if (pkernelVA == nullptr)
+            // Address spaces running on the other CPUs have to keep their ASIDs if a new generation is started
+            static_assert(Scheduler::MaxCPUsC <= ASIDAllocator::MaxLiveContextsC, "Not enough room for every CPU's context");
+            // #TODO: Remove lint tag when we get std::array
+            // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+            uint64_t* liveContexts[Scheduler::MaxCPUsC] = {};
+            auto liveCount = 0U;
+            for (auto curCPU = 0U; curCPU < Scheduler::MaxCPUsC; ++curCPU)
             {
-                return false;
+                auto* const ptask = Scheduler::GetRunningTask(curCPU);
+                if ((ptask != nullptr) && (ptask != &arTask) && (ptask->MemoryState.PageGlobalDirectory != PhysicalPtr{}))
+                {
+                    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+                    liveContexts[liveCount++] = &ptask->MemoryState.ASIDContext;
+                }
             }
-            // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
-            memcpy(pkernelVA, std::bit_cast<const void*>(aCurrentTask.MemoryState.UserPages[curPage].VirtualAddress.GetAddress()), PageSize);
+            if (AddressSpaceIDs.Refresh(arTask.MemoryState.ASIDContext, liveContexts, liveCount))
+            {
+                // ASIDs have been handed out again, so translations cached under the old owners have to go
+                AArch64::TLB::InvalidateAll();
+            }
+            ttbr0.BADDR(arTask.MemoryState.PageGlobalDirectory);
+            ttbr0.ASID(ASIDAllocator::GetASID(arTask.MemoryState.ASIDContext));
         }
-        return true;
-    }
 
-    void SetPageGlobalDirectory(PhysicalPtr const aNewPGD)
-    {
-        set_pgd(std::bit_cast<void const*>(aNewPGD.GetAddress()));
+        // Make sure the walker can see the tables before they're used, and that nothing after the switch uses the old
+        // ones. Entries from other address spaces are tagged with their ASID, so nothing needs invalidating
+        sync_page_tables();
+        AArch64::TTBRn_EL1::Write0(ttbr0);
+        instruction_barrier();
     }
 }
 
@@ -277,6 +2496,9 @@ extern "C"
     // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
     int do_mem_abort(uintptr_t const aAddress, uintptr_t const aESR)
     {
+        // Reclaim and page merging may be walking this task's tables from another CPU
+        Scheduler::DisablePreemptingInScope const disablePreempt;
+
         constexpr auto dfscMask = 0b11'1111U;
         const auto dataFaultStatusCode = aESR & dfscMask;
         // Translation faults are: 100, 101, 110, and 111 depending on the level
@@ -284,17 +2506,106 @@ extern "C"
         // and no higher bits in the status code are
         constexpr auto anyTranslationFaultMask = 0b11'1100U;
         constexpr auto anyTranslationFault = 0b100U;
+        constexpr auto writeNotReadBit = 1U << 6U;
+        auto const isWrite = (aESR & writeNotReadBit) != 0;
+
+        // Only addresses inside one of the task's areas can be backed, and only in the ways the area allows
+        auto& currentTask = Scheduler::GetCurrentTask();
+        auto const faultAddress = VirtualPtr{ aAddress & MemoryManager::PageMask };
+        auto const* const parea = MemoryManager::FindArea(currentTask.MemoryState.Areas, faultAddress);
+        if ((parea == nullptr) || (isWrite && ((parea->Protection & MemoryManager::AreaProtection::WriteC) == 0)))
+        {
+            return -1;
+        }
+
+        // Access flag faults are 1000 through 1011, and are only taken on pages the reclaim clock marked as cold
+        constexpr auto anyAccessFlagFault = 0b1000U;
+        if ((dataFaultStatusCode & anyTranslationFaultMask) == anyAccessFlagFault)
+        {
+            return MemoryManager::HandleAccessFlagFault(currentTask, faultAddress) ? 0 : -1;
+        }
+
         if ((dataFaultStatusCode & anyTranslationFaultMask) == anyTranslationFault)
         {
-            const auto newPage = MemoryManager::GetFreePage();
-            if (newPage == PhysicalPtr{})
+            switch (MemoryManager::RestoreCompressedPage(currentTask, *parea, faultAddress))
             {
+            case MemoryManager::RestoreResult::Restored:
+                return 0;
+            case MemoryManager::RestoreResult::Failed:
                 return -1;
+            case MemoryManager::RestoreResult::NotCompressed:
+                break;
+            }
+
+            if (!isWrite)
+            {
+                // Memory that was never written can only read back zeros, so share the zero page until it's written
+                if (!MemoryManager::MapPage(currentTask, faultAddress, MemoryManager::ZeroPage, parea->Protection, true))
+                {
+                    return -1;
+                }
             }
+            else
+            {
+                const auto newPage = MemoryManager::GetUserPage(currentTask, faultAddress, true);
+                if (newPage == PhysicalPtr{})
+                {
+                    return -1;
+                }
+
+                if (!MemoryManager::MapPage(currentTask, faultAddress, newPage, parea->Protection, false))
+                {
+                    MemoryManager::FreePhysicalBlock(newPage);
+                    return -1;
+                }
+
+                // Once every page in the 2MB has been written, they become a huge page to save on TLB entries
+                if (MemoryManager::TryCollapseHugePage(currentTask, *parea, faultAddress))
+                {
+                    return 0;
+                }
+            }
+            MemoryManager::MapFaultAround(currentTask, *parea, faultAddress);
+            return 0;
+        }
 
-            MemoryManager::MapPage(Scheduler::GetCurrentTask(), VirtualPtr{ aAddress & MemoryManager::PageMask }, newPage);
+        // Permission faults are 1100 through 1111, and we only care about writes, which are flagged by WnR (bit 6)
+        constexpr auto anyPermissionFault = 0b1100U;
+        if (((dataFaultStatusCode & anyTranslationFaultMask) == anyPermissionFault) && isWrite)
+        {
+            if (!MemoryManager::HandleCopyOnWriteFault(currentTask, *parea, faultAddress))
+            {
+                return -1;
+            }
+            // A split huge page comes back together once every page has been copied
+            MemoryManager::TryCollapseHugePage(currentTask, *parea, faultAddress);
             return 0;
         }
         return -1;
     }
+
+    /**
+     * Called when a EL1 data abort fault is triggered
+     * 
+     * @param aAddress The faulting address
+     * @param aESR The value of the ESR_EL1 register
+     * @return 0 if it was handled, non-zero if it was not
+     */
+    // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+    int do_kernel_mem_abort(uintptr_t const aAddress, uintptr_t const aESR)
+    {
+        // Another CPU may be faulting in the same kernel allocation
+        Scheduler::DisablePreemptingInScope const disablePreempt;
+
+        // The only faults the kernel expects of itself are translation faults on kernel virtual allocations that
+        // haven't been touched yet
+        constexpr auto dfscMask = 0b11'1111U;
+        constexpr auto anyTranslationFaultMask = 0b11'1100U;
+        constexpr auto anyTranslationFault = 0b100U;
+        if (((aESR & dfscMask) & anyTranslationFaultMask) != anyTranslationFault)
+        {
+            return -1;
+        }
+        return MemoryManager::MapKernelVirtualPage(VirtualPtr{ aAddress & MemoryManager::PageMask }) ? 0 : -1;
+    }
 }
\ No newline at end of file
@@ -12,8 +12,11 @@ namespace Scheduler
 
 namespace MemoryManager
 {
+    struct PageFrame;
+
     constexpr auto KernelVirtualAddressOffset = 0xFFFF'0000'0000'0000ULL;
     constexpr auto DeviceBaseAddress = PhysicalPtr{ 0x3F00'0000 };
+    constexpr auto LocalDeviceBaseAddress = PhysicalPtr{ 0x4000'0000 }; // ARM local peripherals (per-core timers and interrupts)
 
     // sizes depend on how many bits the descriptor uses to index into pages or tables
     constexpr size_t PageSize = 1ULL << AArch64::PageTable::PageOffsetBits;
@@ -22,12 +25,53 @@ namespace MemoryManager
     static_assert(AArch64::PageTable::PointersPerTable * sizeof(AArch64::Descriptor::Fault) == PageSize, "Expected to be able to fit a table into a page");
 
     // #TODO: These should probably be unique types
-    // #TODO: We should look into making all this stuff cachable for performance, once we figure out how to manage
-    // caches
 
     // Indicies into the MAIR register
     constexpr uint8_t DeviceMAIRIndex = 0; // Device nGnRnE memory
-    constexpr uint8_t NormalMAIRIndex = 1; // Normal non-cachable memory
+    constexpr uint8_t NormalMAIRIndex = 1; // Normal write-back cacheable memory
+    constexpr uint8_t NormalNonCacheableMAIRIndex = 2; // Normal non-cachable memory (for sharing with non-coherent devices)
+
+    /**
+     * Sets up the physical page allocator from the memory described by the device tree. Must be called before any
+     * pages are allocated
+     * 
+     * @param aDTBPointer Physical address of the device tree blob
+     * @param aBootTablesEnd Physical address past the last boot page table still in use. Anything between here and
+     * the end of the kernel image is given to the allocator
+     */
+    void Init(PhysicalPtr aDTBPointer, PhysicalPtr aBootTablesEnd);
+
+    /**
+     * Allocates a block of physically contiguous pages in the kernel virtual address space
+     * 
+     * @param aOrder The order of the block (block will be 2^aOrder pages in size)
+     * @return The address of the first page in kernel VA space, zeroed out, or null if out of memory
+     */
+    void* AllocatePages(unsigned aOrder);
+
+    /**
+     * Allocates a block of physically contiguous pages in the kernel virtual address space without zeroing it, for
+     * callers that are going to overwrite the memory anyway
+     * 
+     * @param aOrder The order of the block (block will be 2^aOrder pages in size)
+     * @return The address of the first page in kernel VA space, with undefined contents, or null if out of memory
+     */
+    void* AllocateUnzeroedPages(unsigned aOrder);
+
+    /**
+     * Frees a block of pages allocated by AllocatePages, AllocateUnzeroedPages, or AllocateKernelPage
+     * 
+     * @param apPages The address returned by the allocation function
+     */
+    void FreePages(void* apPages);
+
+    /**
+     * Obtains the frame tracking the page containing the given address
+     * 
+     * @param apKernelAddress An address in kernel VA space
+     * @return The frame for the page, or null if the address isn't in memory managed by the page allocator
+     */
+    PageFrame* GetPageFrame(void const* apKernelAddress);
 
     /**
      * Allocates a page of memory in the kernel virtual address space
@@ -36,17 +80,56 @@ namespace MemoryManager
      */
     void* AllocateKernelPage();
 
+    /**
+     * Reserves a range of kernel virtual addresses above the linear map. The range isn't backed by physically
+     * contiguous memory - each page is zeroed and mapped the first time it's touched, so large kernel buffers don't
+     * depend on finding a large free physical block
+     * 
+     * @param aSize The size of the allocation in bytes (rounded up to whole pages)
+     * @return The address of the allocation in kernel VA space, or null if out of address space or memory
+     */
+    void* AllocateKernelVirtual(size_t aSize);
+
+    /**
+     * Frees memory allocated by AllocateKernelVirtual, along with whatever pages were mapped for it
+     * 
+     * @param apMemory The address returned by AllocateKernelVirtual (may be null)
+     */
+    void FreeKernelVirtual(void* apMemory);
+
+    /**
+     * Checks if an address is in the region AllocateKernelVirtual hands out
+     * 
+     * @param apAddress The address to check
+     * @return True if the address is in the kernel virtual allocation region
+     */
+    bool IsKernelVirtualAddress(void const* apAddress);
+
+    /**
+     * Adds an area of anonymous memory to the task's address space. Nothing is allocated up front - pages are
+     * zeroed and mapped as they're touched
+     * 
+     * @param arTask The task to add the area to
+     * @param aStart The start of the area (page aligned)
+     * @param aLength The size of the area in bytes (a multiple of the page size)
+     * @param aProtection What user code is allowed to do with the area (AreaProtection flags)
+     * @return False if the area is invalid, overlaps an existing area, or we ran out of memory
+     */
+    bool MapAnonymousArea(Scheduler::TaskStruct& arTask, VirtualPtr aStart, size_t aLength, uint8_t aProtection);
+
     /**
      * Allocates a page of memory in the task's virtual address space that contains the specified address
      * 
      * @param arTask The task that will hold the page
-     * @param aVirtualAddress The address that the page should start on
-     * @return The newly allocated page in kernal virtual address space
+     * @param aVirtualAddress The address that the page should start on, which must be in one of the task's areas
+     * @return The newly allocated page in kernal virtual address space, or null if the address isn't in an area or
+     * we're out of memory
      */
     void* AllocateUserPage(Scheduler::TaskStruct& arTask, VirtualPtr aVirtualAddress);
 
     /**
-     * Copies the virtual memory from the source task into the destination task
+     * Copies the virtual memory from the source task into the destination task. Pages are shared copy-on-write
+     * rather than copied, so the source task's pages become read-only until one of the tasks writes to them
      * 
      * @param arDestinationTask The task to copy the memory into
      * @param aCurrentTask The task to copy the memory from (assumed to be the current task)
@@ -54,11 +137,76 @@ namespace MemoryManager
     bool CopyVirtualMemory(Scheduler::TaskStruct& arDestinationTask, const Scheduler::TaskStruct& aCurrentTask);
 
     /**
-     * Set the current page global directory
+     * Frees the task's user address space - its areas, its page tables, and every page mapped in it that nothing
+     * else maps. If the task is the current one, it's switched over to an empty address space first
+     * 
+     * @param arTask The task whose address space should be freed
+     */
+    void ReleaseAddressSpace(Scheduler::TaskStruct& arTask);
+
+    /**
+     * Turns page coloring on or off. With it on, user pages are picked so each task's pages are spread across the L2
+     * cache colors, and reserved colors are kept for the tasks that reserved them. Huge pages hold every color, so
+     * none are built while any colors are reserved. Only pages allocated afterwards are affected
+     * 
+     * @param aEnabled True to turn page coloring on
+     */
+    void SetPageColoring(bool aEnabled);
+
+    /**
+     * Reserves L2 cache colors for a task, so that (with page coloring on) its user pages only use those colors and
+     * no other task's user pages do. The reservation replaces any the task already had, and is dropped when the
+     * task's address space is released
+     * 
+     * @param arTask The task to reserve the colors for
+     * @param aColors Bit mask of the colors to reserve (see BuddyAllocator::ColorCountC)
+     * @return False if the colors are reserved by someone else, or would leave no colors for everyone else
+     */
+    bool ReserveCacheColors(Scheduler::TaskStruct& arTask, uint8_t aColors);
+
+    /**
+     * Sets how many pages get mapped around a faulting address, so a task walking through memory doesn't fault on
+     * every page. The count is rounded down to a power of two, and capped at a page table's worth of pages
+     * 
+     * @param aPageCount The number of pages in the fault-around window (0 or 1 to only map the faulting page)
+     */
+    void SetFaultAroundPages(unsigned aPageCount);
+
+    /**
+     * Kernel thread function that keeps a pool of pre-zeroed pages topped up, so zeroed page allocations (like
+     * those in the page fault handler) don't have to clear the page themselves. Blocks once the pool is full, until it
+     * runs low again. Never returns
+     * 
+     * @param apParam Unused
+     */
+    void ZeroPageThread(void const* apParam);
+
+    /**
+     * Kernel thread function that looks for user pages with the same contents, in any task, and merges them into a
+     * single copy-on-write page. Pages of zeros are merged into the shared zero page. Only looks at a few pages
+     * before giving up the CPU, and rests between passes, so it stays out of the way. Never returns
+     * 
+     * @param apParam Unused
+     */
+    void PageMergeThread(void const* apParam);
+
+    /**
+     * Makes sure instructions written to memory through the data cache will be seen by instruction fetches. Must be
+     * called after writing code to memory and before executing it. Works for code that will run at a different
+     * address to the one it was written through, since the whole instruction cache is invalidated
+     * 
+     * @param apStart The start of the memory that was written (in kernel VA space)
+     * @param aSize The number of bytes that were written
+     */
+    void SyncInstructionCache(void const* apStart, size_t aSize);
+
+    /**
+     * Switches the user half of the address space over to the task's page tables. Each address space is tagged with
+     * its own ASID, so the TLB only has to be invalidated when the ASIDs run out
      * 
-     * @param apNewPGD Pointer to the new page global directory
+     * @param arTask The task whose address space should be made current
      */
-    void SetPageGlobalDirectory(PhysicalPtr aNewPGD);
+    void ActivateAddressSpace(Scheduler::TaskStruct& arTask);
 
     /**
      * Calculate the start of the block of the given size containing the given pointer
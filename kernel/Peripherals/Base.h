@@ -16,7 +16,7 @@ namespace MemoryMappedIO
 
     // Local peripheral information sourced from BCM2836 ARM-local peripheral documentation
     // https://www.raspberrypi.org/documentation/hardware/raspberrypi/bcm2836/QA7_rev3.4.pdf
-    constexpr VirtualPtr LocalPeripheralBaseAddr = VirtualPtr{ 0x4000'0000 }.Offset(MemoryManager::KernelVirtualAddressOffset);
+    constexpr VirtualPtr LocalPeripheralBaseAddr = VirtualPtr{ MemoryManager::LocalDeviceBaseAddress.GetAddress() }.Offset(MemoryManager::KernelVirtualAddressOffset);
 }
 
 #endif // KERNEL_PERIPHERALS_BASE_H
\ No newline at end of file
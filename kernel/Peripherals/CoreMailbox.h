@@ -0,0 +1,25 @@
+#ifndef KERNEL_PERIPHERALS_CORE_MAILBOX_H
+#define KERNEL_PERIPHERALS_CORE_MAILBOX_H
+
+#include "Base.h"
+
+namespace MemoryMappedIO::CoreMailbox
+{
+    // Core mailbox information sourced from BCM2836 ARM-local peripheral documentation
+    // https://www.raspberrypi.org/documentation/hardware/raspberrypi/bcm2836/QA7_rev3.4.pdf
+    // Each core has four 32-bit mailboxes, and raises an interrupt while any enabled one is non-zero
+
+    // Enables core 0's mailbox interrupts (as IRQ or FIQ). The other cores have their own registers following this one
+    constexpr VirtualPtr Core0InterruptControl =    LocalPeripheralBaseAddr.Offset(0x0050);
+    // Distance between one core's interrupt control register and the next
+    constexpr uint32_t InterruptControlStride = 4;
+
+    // Write-only - sets the bits written in core 0's mailbox 0
+    constexpr VirtualPtr Core0Mailbox0Set =         LocalPeripheralBaseAddr.Offset(0x0080);
+    // Reads core 0's mailbox 0, and clears the bits written
+    constexpr VirtualPtr Core0Mailbox0ReadClear =   LocalPeripheralBaseAddr.Offset(0x00C0);
+    // Distance between one core's mailbox registers and the next
+    constexpr uint32_t MailboxStride = 0x10;
+}
+
+#endif // KERNEL_PERIPHERALS_CORE_MAILBOX_H
\ No newline at end of file
@@ -550,6 +550,248 @@ namespace DeviceTree
                 }
             }
         }
+
+        /**
+         * Checks to see if the header is one we know how to read
+         * 
+         * @param aHeader The header to check (native endian)
+         * @return True if we can read the blob
+         */
+        constexpr bool IsHeaderValid(fdt_header const& aHeader)
+        {
+            return (aHeader.magic == ExpectedMagic) && (aHeader.version >= ExpectedVersion) && (aHeader.last_comp_version <= ExpectedVersion);
+        }
+
+        /**
+         * Reads a big-endian 32-bit value out of the blob
+         * 
+         * @param apValue The location of the value
+         * @return The value, in native endian
+         */
+        uint32_t ReadUInt32(uint8_t const* const apValue)
+        {
+            uint32_t value = 0;
+            std::memcpy(&value, apValue, sizeof(value));
+            return BEToNative(value);
+        }
+
+        /**
+         * Reads a value made up of multiple 32-bit cells out of the blob (see DeviceTree specification, section 2.2.4)
+         * 
+         * @param apValue The location of the value
+         * @param aCellCount The number of cells in the value (values over 2 cells do not fit and will be truncated)
+         * @return The value, in native endian
+         */
+        uint64_t ReadCells(uint8_t const* const apValue, uint32_t const aCellCount)
+        {
+            constexpr auto bitsPerCell = 32U;
+            uint64_t value = 0;
+            for (auto curCell = 0U; curCell < aCellCount; ++curCell)
+            {
+                // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+                value = (value << bitsPerCell) | ReadUInt32(apValue + (curCell * sizeof(uint32_t)));
+            }
+            return value;
+        }
+
+        /**
+         * Adds a range to a fixed range array, if there's room
+         * 
+         * @param apRanges The array to add to
+         * @param arCount The number of ranges in the array, incremented if added
+         * @param aBegin The start of the range
+         * @param aSize The size of the range (empty ranges are not added)
+         */
+        void AddRange(MemoryRange* const apRanges, size_t& arCount, uint64_t const aBegin, uint64_t const aSize)
+        {
+            if ((aSize == 0) || (arCount >= MemoryMap::MaxRangesC))
+            {
+                // #TODO: Should warn when we drop ranges on the floor
+                return;
+            }
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            apRanges[arCount] = MemoryRange{ PhysicalPtr{ aBegin }, PhysicalPtr{ aBegin + aSize } };
+            ++arCount;
+        }
+
+        /**
+         * Reads the memory reservation map into the memory map
+         * 
+         * @param aHeader The header containing the map offset
+         * @param aBaseAddr The base address for the offset
+         * @param arMap The map to add the reserved ranges to
+         */
+        void ReadMemoryReservationMap(fdt_header const& aHeader, uint8_t const* const aBaseAddr, MemoryMap& arMap)
+        {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            uint8_t const* pcurEntry = aBaseAddr + aHeader.off_mem_rsvmap;
+            auto done = false;
+            while (!done)
+            {
+                fdt_reserve_entry entry;
+                std::memcpy(&entry, pcurEntry, sizeof(entry));
+
+                entry = BEToNative(entry);
+
+                done = (entry.address == 0) && (entry.size == 0);
+                if (!done)
+                {
+                    AddRange(arMap.Reserved, arMap.ReservedCount, entry.address, entry.size);
+                    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+                    pcurEntry += sizeof(entry);
+                }
+            }
+        }
+
+        /**
+         * Checks to see if the node with the given name is a memory node (either "memory" or "memory@<address>")
+         * 
+         * @param apName The node name
+         * @return True if it is a memory node
+         */
+        bool IsMemoryNodeName(char const* const apName)
+        {
+            constexpr char memoryNodeName[] = "memory"; // NOLINT(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+            constexpr auto memoryNodeNameLen = sizeof(memoryNodeName) - 1; // not including terminator
+            auto const nameLen = std::strlen(apName);
+            if (nameLen < memoryNodeNameLen)
+            {
+                return false;
+            }
+            for (auto curChar = 0U; curChar < memoryNodeNameLen; ++curChar)
+            {
+                // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+                if (apName[curChar] != memoryNodeName[curChar])
+                {
+                    return false;
+                }
+            }
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            return (apName[memoryNodeNameLen] == '\0') || (apName[memoryNodeNameLen] == '@');
+        }
+
+        /**
+         * Reads a memory node's reg property into the memory map (see DeviceTree specification, section 2.3.6)
+         * 
+         * @param apValue The property value
+         * @param aLen The length of the property value
+         * @param aAddressCells The number of cells in each address
+         * @param aSizeCells The number of cells in each size
+         * @param arMap The map to add the memory ranges to
+         */
+        void ReadMemoryReg(uint8_t const* const apValue, size_t const aLen, uint32_t const aAddressCells, // NOLINT(bugprone-easily-swappable-parameters)
+            uint32_t const aSizeCells, MemoryMap& arMap)
+        {
+            auto const entrySize = (aAddressCells + aSizeCells) * sizeof(uint32_t);
+            if (entrySize == 0)
+            {
+                return;
+            }
+            for (auto curOffset = 0ULL; (curOffset + entrySize) <= aLen; curOffset += entrySize)
+            {
+                // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+                auto const address = ReadCells(apValue + curOffset, aAddressCells);
+                auto const size = ReadCells(apValue + curOffset + (aAddressCells * sizeof(uint32_t)), aSizeCells);
+                // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+                AddRange(arMap.Memory, arMap.MemoryCount, address, size);
+            }
+        }
+
+        /**
+         * Walks the structure block looking for the root's cell sizes and any memory nodes
+         * 
+         * @param aHeader The header containing the block offset and other data needed
+         * @param aBaseAddr The base address for the offsets
+         * @param arMap The map to add the memory ranges to
+         * @return True if the structure block was read successfully
+         */
+        bool ReadMemoryNodes(fdt_header const& aHeader, uint8_t const* const aBaseAddr, MemoryMap& arMap)
+        {
+            constexpr auto rootDepth = 1U;
+            constexpr auto rootChildDepth = 2U;
+
+            // Defaults from the DeviceTree specification, section 2.3.5
+            auto addressCells = 2U;
+            auto sizeCells = 1U;
+
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            uint8_t const* pcurToken = aBaseAddr + aHeader.off_dt_struct;
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            uint8_t const* const pendOfBlock = aBaseAddr + aHeader.off_dt_struct + aHeader.size_dt_struct;
+            auto depth = 0U;
+            auto inMemoryNode = false;
+            while (pcurToken < pendOfBlock)
+            {
+                auto const token = ReadUInt32(pcurToken);
+                // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+                pcurToken += sizeof(token);
+
+                switch (token)
+                {
+                case FDT_BEGIN_NODE:
+                {
+                    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+                    char const* const pnodeName = reinterpret_cast<char const*>(pcurToken);
+                    ++depth;
+                    if (depth == rootChildDepth)
+                    {
+                        inMemoryNode = IsMemoryNodeName(pnodeName);
+                    }
+                    auto const nameByteLen = std::strlen(pnodeName) + 1; // including terminator
+                    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+                    pcurToken = AlignPointer(pcurToken + nameByteLen, alignof(uint32_t));
+                    break;
+                }
+
+                case FDT_END_NODE:
+                    if (depth == rootChildDepth)
+                    {
+                        inMemoryNode = false;
+                    }
+                    --depth;
+                    break;
+
+                case FDT_PROP:
+                {
+                    fdt_prop_extra_data dataHeader;
+                    std::memcpy(&dataHeader, pcurToken, sizeof(dataHeader));
+                    dataHeader = BEToNative(dataHeader);
+                    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+                    uint8_t const* const pvalue = pcurToken + sizeof(dataHeader);
+                    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast, cppcoreguidelines-pro-bounds-pointer-arithmetic)
+                    char const* const pname = reinterpret_cast<char const*>(aBaseAddr + aHeader.off_dt_strings + dataHeader.nameoff);
+
+                    // Properties always come before child nodes, so the root's cell sizes are known before we get to
+                    // any memory nodes
+                    if ((depth == rootDepth) && (dataHeader.len == sizeof(uint32_t)) && (strcmp(pname, "#address-cells") == 0))
+                    {
+                        addressCells = ReadUInt32(pvalue);
+                    }
+                    else if ((depth == rootDepth) && (dataHeader.len == sizeof(uint32_t)) && (strcmp(pname, "#size-cells") == 0))
+                    {
+                        sizeCells = ReadUInt32(pvalue);
+                    }
+                    else if (inMemoryNode && (depth == rootChildDepth) && (strcmp(pname, "reg") == 0))
+                    {
+                        ReadMemoryReg(pvalue, dataHeader.len, addressCells, sizeCells, arMap);
+                    }
+                    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+                    pcurToken = AlignPointer(pvalue + dataHeader.len, alignof(uint32_t));
+                    break;
+                }
+
+                case FDT_NOP:
+                    break;
+
+                case FDT_END:
+                    return true;
+
+                default:
+                    return false;
+                }
+            }
+            return false; // ran off the end of the table without an FDT_END token
+        }
     }
 
     /**
@@ -588,4 +830,23 @@ namespace DeviceTree
             Print::FormatToMiniUART("Magic mismatch, found {:x}, expected {:x}\r\n", header.magic, ExpectedMagic);
         }
     }
+
+    bool ReadMemoryMap(uint8_t const* const apDTB, MemoryMap& arMap)
+    {
+        arMap = MemoryMap{};
+
+        fdt_header header;
+        std::memcpy(&header, apDTB, sizeof(header));
+
+        header = BEToNative(header);
+
+        if (!IsHeaderValid(header))
+        {
+            return false;
+        }
+
+        arMap.BlobSize = header.totalsize;
+        ReadMemoryReservationMap(header, apDTB, arMap);
+        return ReadMemoryNodes(header, apDTB, arMap) && (arMap.MemoryCount != 0);
+    }
 }
\ No newline at end of file
@@ -1,11 +1,53 @@
 #ifndef KERNEL_PERIPHERALS_DEVICETREE_H
 #define KERNEL_PERIPHERALS_DEVICETREE_H
 
+#include <cstddef>
 #include <cstdint>
+#include "../PointerTypes.h"
 
 namespace DeviceTree
 {
+    /**
+     * A range of physical memory
+     */
+    struct MemoryRange
+    {
+        PhysicalPtr Begin;
+        PhysicalPtr End; // past the end
+    };
+
+    /**
+     * The physical memory layout described by a device tree
+     */
+    struct MemoryMap
+    {
+        static constexpr size_t MaxRangesC = 16;
+
+        // #TODO: Remove lint tags when we get std::array
+        // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+        MemoryRange Memory[MaxRangesC] = {}; // from the reg properties of the /memory nodes
+        size_t MemoryCount = 0;
+        // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+        MemoryRange Reserved[MaxRangesC] = {}; // from the memory reservation block
+        size_t ReservedCount = 0;
+        size_t BlobSize = 0; // size of the device tree blob itself, which isn't in the reservation block
+    };
+
+    /**
+     * Parse a device tree binary blob
+     * 
+     * @param apDTB The device tree blob to read
+     */
     void ParseDeviceTree(uint8_t const* apDTB);
+
+    /**
+     * Reads the physical memory layout out of a device tree binary blob. Any ranges past MaxRangesC are dropped
+     * 
+     * @param apDTB The device tree blob to read
+     * @param arMap OUT: The memory map read from the blob
+     * @return True if the blob was valid and had at least one memory range, false otherwise
+     */
+    bool ReadMemoryMap(uint8_t const* apDTB, MemoryMap& arMap);
 }
 
 #endif // KERNEL_PERIPHERALS_DEVICETREE_H
\ No newline at end of file
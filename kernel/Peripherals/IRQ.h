@@ -29,8 +29,10 @@ namespace MemoryMappedIO::IRQ
     // Below sourced from:
     // https://www.raspberrypi.org/documentation/hardware/raspberrypi/bcm2836/QA7_rev3.4.pdf
 
-    // Shows which interrupts are pending for Core0
+    // Shows which interrupts are pending for Core0. The other cores have their own registers following this one
     constexpr VirtualPtr Core0IRQSource =       LocalPeripheralBaseAddr.Offset(0x0060);
+    // Distance between one core's register and the next
+    constexpr uint32_t CoreRegisterStride = 4;
 }
 
 #endif // KERNEL_PERIPHERALS_IRQ_H
\ No newline at end of file
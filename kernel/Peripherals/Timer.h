@@ -32,6 +32,16 @@ namespace MemoryMappedIO
         // Write-only flags for clearing the interrupt flag and telling it to reload
         constexpr VirtualPtr ClearAndReload =   LocalPeripheralBaseAddr.Offset(0x0038);
     }
+
+    namespace CoreTimer
+    {
+        // Core timer information sourced from BCM2836 ARM-local peripheral documentation
+        // https://www.raspberrypi.org/documentation/hardware/raspberrypi/bcm2836/QA7_rev3.4.pdf
+        // Routes core 0's timer interrupts to IRQ or FIQ. The other cores have their own registers following this one
+        constexpr VirtualPtr Core0InterruptControl = LocalPeripheralBaseAddr.Offset(0x0040);
+        // Distance between one core's register and the next
+        constexpr uint32_t CoreRegisterStride = 4;
+    }
 }
 
 #endif // KERNEL_PERIPHERALS_TIMER_H
\ No newline at end of file
@@ -0,0 +1,144 @@
+#include "PriorityRunQueue.h"
+
+#include <cstdint>
+#include "TaskStructs.h"
+
+namespace Scheduler
+{
+    namespace
+    {
+        constexpr uint32_t BitmapBitsC = 64;
+
+        /**
+         * Obtains the highest level with tasks
+         * 
+         * @param aNonEmptyLevels The bitmap of levels with tasks (must not be 0)
+         * @return The highest level
+         */
+        uint32_t GetHighestLevel(uint64_t const aNonEmptyLevels)
+        {
+            // A single count-leading-zeros instruction
+            return (BitmapBitsC - 1) - static_cast<uint32_t>(__builtin_clzll(aNonEmptyLevels));
+        }
+    }
+
+    void PriorityRunQueue::Enqueue(TaskStruct& arTask)
+    {
+        Append(ActiveArray, arTask);
+        ++Count;
+    }
+
+    void PriorityRunQueue::Expire(TaskStruct& arTask)
+    {
+        Unlink(arTask);
+        Append(ActiveArray ^ 1U, arTask);
+    }
+
+    void PriorityRunQueue::Requeue(TaskStruct& arTask)
+    {
+        Unlink(arTask);
+        Append(ActiveArray, arTask);
+    }
+
+    void PriorityRunQueue::Remove(TaskStruct& arTask)
+    {
+        Unlink(arTask);
+        arTask.Queued = false;
+        --Count;
+    }
+
+    TaskStruct* PriorityRunQueue::PickNext()
+    {
+        if (Arrays[ActiveArray].NonEmptyLevels == 0) // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+        {
+            // Everything has had its turn, so the expired tasks start over
+            ActiveArray ^= 1U;
+        }
+        auto const& active = Arrays[ActiveArray]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+        if (active.NonEmptyLevels == 0)
+        {
+            return nullptr;
+        }
+        return active.pHeads[GetHighestLevel(active.NonEmptyLevels)]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+    }
+
+    TaskStruct* PriorityRunQueue::FindStealable(TaskStruct const* const apExclude) const
+    {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+        auto* const pexpired = FindInArray(Arrays[ActiveArray ^ 1U], apExclude);
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+        return (pexpired != nullptr) ? pexpired : FindInArray(Arrays[ActiveArray], apExclude);
+    }
+
+    void PriorityRunQueue::Append(uint32_t const aArray, TaskStruct& arTask)
+    {
+        auto& rarray = Arrays[aArray]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+        auto const level = GetLevel(arTask.Priority);
+        auto*& rptail = rarray.pTails[level]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+        arTask.pNextQueued = nullptr;
+        arTask.pPrevQueued = rptail;
+        if (rptail != nullptr)
+        {
+            rptail->pNextQueued = &arTask;
+        }
+        else
+        {
+            rarray.pHeads[level] = &arTask; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+            rarray.NonEmptyLevels |= (uint64_t{ 1 } << level);
+        }
+        rptail = &arTask;
+        arTask.Queued = true;
+        arTask.QueuedArray = aArray;
+        arTask.QueuedLevel = level;
+    }
+
+    void PriorityRunQueue::Unlink(TaskStruct& arTask)
+    {
+        // The priority may have changed since the task was queued, so it's found by the level it was queued at
+        auto& rarray = Arrays[arTask.QueuedArray]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+        auto const level = arTask.QueuedLevel;
+        if (arTask.pPrevQueued != nullptr)
+        {
+            arTask.pPrevQueued->pNextQueued = arTask.pNextQueued;
+        }
+        else
+        {
+            rarray.pHeads[level] = arTask.pNextQueued; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+        }
+        if (arTask.pNextQueued != nullptr)
+        {
+            arTask.pNextQueued->pPrevQueued = arTask.pPrevQueued;
+        }
+        else
+        {
+            rarray.pTails[level] = arTask.pPrevQueued; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+        }
+        if (rarray.pHeads[level] == nullptr) // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+        {
+            rarray.NonEmptyLevels &= ~(uint64_t{ 1 } << level);
+        }
+        arTask.pNextQueued = nullptr;
+        arTask.pPrevQueued = nullptr;
+    }
+
+    TaskStruct* PriorityRunQueue::FindInArray(PriorityArray const& aArray, TaskStruct const* const apExclude)
+    {
+        // Only the excluded task can get in the way, so at most two tasks are looked at on each level
+        auto levels = aArray.NonEmptyLevels;
+        while (levels != 0)
+        {
+            auto const level = GetHighestLevel(levels);
+            auto* const phead = aArray.pHeads[level]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+            if (phead != apExclude)
+            {
+                return phead;
+            }
+            if (phead->pNextQueued != nullptr)
+            {
+                return phead->pNextQueued;
+            }
+            levels &= ~(uint64_t{ 1 } << level);
+        }
+        return nullptr;
+    }
+}
\ No newline at end of file
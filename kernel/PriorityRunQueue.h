@@ -0,0 +1,140 @@
+#ifndef KERNEL_PRIORITY_RUN_QUEUE_H
+#define KERNEL_PRIORITY_RUN_QUEUE_H
+
+#include <cstdint>
+
+namespace Scheduler
+{
+    struct TaskStruct;
+
+    /**
+     * Run queue which keeps a FIFO list of tasks for each priority level, plus a bitmap of which levels have tasks, so
+     * enqueuing, removing and picking the next task are all constant time no matter how many tasks there are. Tasks
+     * are split between an active set and an expired set. Tasks that have used up their time slice are moved to the
+     * expired set, and once the active set is empty the two are swapped, so every task gets a turn before any task
+     * gets a second one (the same as recharging every task's counter used to)
+     */
+    class PriorityRunQueue
+    {
+    public:
+        /**
+         * Number of priority levels (task priorities outside of this are clamped to the nearest level)
+         */
+        static constexpr uint32_t PriorityLevelsC = 64;
+
+        /**
+         * Obtains the level a task priority is queued at
+         * 
+         * @param aPriority The task priority (higher runs first)
+         * @return The level
+         */
+        static constexpr uint32_t GetLevel(int64_t const aPriority)
+        {
+            if (aPriority < 0)
+            {
+                return 0;
+            }
+            return (aPriority >= PriorityLevelsC) ? (PriorityLevelsC - 1) : static_cast<uint32_t>(aPriority);
+        }
+
+        /**
+         * Adds a task to the back of its level in the active set
+         * 
+         * @param arTask The task to add (must not already be on a queue)
+         */
+        void Enqueue(TaskStruct& arTask);
+
+        /**
+         * Moves a task to the back of its level in the expired set, so it doesn't run again until every task in the
+         * active set has had a turn
+         * 
+         * @param arTask The task to move (must be on this queue)
+         */
+        void Expire(TaskStruct& arTask);
+
+        /**
+         * Moves a task to the back of its level in the active set, so the other tasks at its level get a turn first
+         * but it still runs ahead of every lower level
+         * 
+         * @param arTask The task to move (must be on this queue)
+         */
+        void Requeue(TaskStruct& arTask);
+
+        /**
+         * Removes a task from the queue
+         * 
+         * @param arTask The task to remove (must be on this queue)
+         */
+        void Remove(TaskStruct& arTask);
+
+        /**
+         * Obtains the task that should run next - the first task at the highest level of the active set, swapping the
+         * sets first if the active one is empty. The task stays on the queue
+         * 
+         * @return The task to run next, or null if the queue is empty
+         */
+        [[nodiscard]] TaskStruct* PickNext();
+
+        /**
+         * Finds a task another queue can take, preferring expired tasks, since they have the longest wait to run here
+         * 
+         * @param apExclude A task not to pick (i.e. the one currently running)
+         * @return The task, or null if there is no task other than the excluded one
+         */
+        [[nodiscard]] TaskStruct* FindStealable(TaskStruct const* apExclude) const;
+
+        /**
+         * Obtains the number of tasks on the queue
+         * 
+         * @return The number of tasks
+         */
+        [[nodiscard]] uint32_t GetCount() const { return Count; }
+
+    private:
+        /**
+         * One set of per-level task lists
+         */
+        struct PriorityArray
+        {
+            // #TODO: Remove lint tags when we get std::array
+            // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+            TaskStruct* pHeads[PriorityLevelsC] = {};
+            // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+            TaskStruct* pTails[PriorityLevelsC] = {};
+            uint64_t NonEmptyLevels = 0; // bit N set if level N has tasks
+        };
+        static_assert(PriorityLevelsC <= 64, "Non-empty level bitmap is too small");
+
+        /**
+         * Adds a task to the back of its level in one of the sets
+         * 
+         * @param aArray The index of the set
+         * @param arTask The task to add
+         */
+        void Append(uint32_t aArray, TaskStruct& arTask);
+
+        /**
+         * Unlinks a task from whichever set it's in
+         * 
+         * @param arTask The task to unlink
+         */
+        void Unlink(TaskStruct& arTask);
+
+        /**
+         * Finds a task in one of the sets, looking at the highest levels first
+         * 
+         * @param aArray The set to look in
+         * @param apExclude A task not to pick
+         * @return The task, or null if there isn't one
+         */
+        [[nodiscard]] static TaskStruct* FindInArray(PriorityArray const& aArray, TaskStruct const* apExclude);
+
+        // #TODO: Remove lint tag when we get std::array
+        // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+        PriorityArray Arrays[2];
+        uint32_t ActiveArray = 0; // the other one is the expired set
+        uint32_t Count = 0;
+    };
+}
+
+#endif // KERNEL_PRIORITY_RUN_QUEUE_H
\ No newline at end of file
@@ -0,0 +1,345 @@
+#include "RedBlackTree.h"
+
+namespace Containers
+{
+    namespace
+    {
+        /**
+         * Checks the color of a node, treating the empty leaves as black
+         * 
+         * @param apNode The node to check (may be null)
+         * @return True if the node is red
+         */
+        bool IsRed(RedBlackNode const* const apNode)
+        {
+            return (apNode != nullptr) && apNode->Red;
+        }
+
+        /**
+         * Obtains the left-most node under the given one
+         * 
+         * @param apNode The node to start from (must not be null)
+         * @return The left-most node
+         */
+        RedBlackNode* GetLeftMost(RedBlackNode* apNode)
+        {
+            while (apNode->pLeft != nullptr)
+            {
+                apNode = apNode->pLeft;
+            }
+            return apNode;
+        }
+
+        /**
+         * Obtains the right-most node under the given one
+         * 
+         * @param apNode The node to start from (must not be null)
+         * @return The right-most node
+         */
+        RedBlackNode* GetRightMost(RedBlackNode* apNode)
+        {
+            while (apNode->pRight != nullptr)
+            {
+                apNode = apNode->pRight;
+            }
+            return apNode;
+        }
+    }
+
+    void RedBlackTree::Insert(RedBlackNode& arNode, RedBlackNode* const apParent, bool const aLeftChild)
+    {
+        arNode.pParent = apParent;
+        arNode.pLeft = nullptr;
+        arNode.pRight = nullptr;
+        arNode.Red = true;
+        if (apParent == nullptr)
+        {
+            pRoot = &arNode;
+        }
+        else if (aLeftChild)
+        {
+            apParent->pLeft = &arNode;
+        }
+        else
+        {
+            apParent->pRight = &arNode;
+        }
+        FixAfterInsert(&arNode);
+    }
+
+    void RedBlackTree::Remove(RedBlackNode& arNode)
+    {
+        // The node that ends up taking the removed spot, and its parent (tracked separately since it may be a leaf)
+        RedBlackNode* preplacement = nullptr;
+        RedBlackNode* preplacementParent = nullptr;
+        auto removedRed = arNode.Red;
+        if (arNode.pLeft == nullptr)
+        {
+            preplacement = arNode.pRight;
+            preplacementParent = arNode.pParent;
+            ReplaceChild(arNode.pParent, &arNode, preplacement);
+            if (preplacement != nullptr)
+            {
+                preplacement->pParent = arNode.pParent;
+            }
+        }
+        else if (arNode.pRight == nullptr)
+        {
+            preplacement = arNode.pLeft;
+            preplacementParent = arNode.pParent;
+            ReplaceChild(arNode.pParent, &arNode, preplacement);
+            preplacement->pParent = arNode.pParent;
+        }
+        else
+        {
+            // Two children, so the successor (which has no left child) is moved into the node's place, and it's the
+            // successor's old spot that gets fixed up
+            auto* const psuccessor = GetLeftMost(arNode.pRight);
+            removedRed = psuccessor->Red;
+            preplacement = psuccessor->pRight;
+            if (psuccessor->pParent == &arNode)
+            {
+                preplacementParent = psuccessor;
+            }
+            else
+            {
+                preplacementParent = psuccessor->pParent;
+                preplacementParent->pLeft = preplacement;
+                if (preplacement != nullptr)
+                {
+                    preplacement->pParent = preplacementParent;
+                }
+                psuccessor->pRight = arNode.pRight;
+                psuccessor->pRight->pParent = psuccessor;
+            }
+            ReplaceChild(arNode.pParent, &arNode, psuccessor);
+            psuccessor->pParent = arNode.pParent;
+            psuccessor->pLeft = arNode.pLeft;
+            psuccessor->pLeft->pParent = psuccessor;
+            psuccessor->Red = arNode.Red;
+        }
+
+        if (!removedRed)
+        {
+            FixAfterRemove(preplacement, preplacementParent);
+        }
+        arNode.pParent = nullptr;
+        arNode.pLeft = nullptr;
+        arNode.pRight = nullptr;
+    }
+
+    RedBlackNode* RedBlackTree::GetFirst() const
+    {
+        return (pRoot == nullptr) ? nullptr : GetLeftMost(pRoot);
+    }
+
+    RedBlackNode* RedBlackTree::GetLast() const
+    {
+        return (pRoot == nullptr) ? nullptr : GetRightMost(pRoot);
+    }
+
+    RedBlackNode* RedBlackTree::GetNext(RedBlackNode const& aNode)
+    {
+        if (aNode.pRight != nullptr)
+        {
+            return GetLeftMost(aNode.pRight);
+        }
+        // Climb until we come up from a left child, that parent is the next one
+        auto const* pcurNode = &aNode;
+        auto* pparent = aNode.pParent;
+        while ((pparent != nullptr) && (pcurNode == pparent->pRight))
+        {
+            pcurNode = pparent;
+            pparent = pparent->pParent;
+        }
+        return pparent;
+    }
+
+    RedBlackNode* RedBlackTree::GetPrevious(RedBlackNode const& aNode)
+    {
+        if (aNode.pLeft != nullptr)
+        {
+            return GetRightMost(aNode.pLeft);
+        }
+        auto const* pcurNode = &aNode;
+        auto* pparent = aNode.pParent;
+        while ((pparent != nullptr) && (pcurNode == pparent->pLeft))
+        {
+            pcurNode = pparent;
+            pparent = pparent->pParent;
+        }
+        return pparent;
+    }
+
+    void RedBlackTree::ReplaceChild(RedBlackNode* const apParent, RedBlackNode const* const apOldChild, RedBlackNode* const apNewChild)
+    {
+        if (apParent == nullptr)
+        {
+            pRoot = apNewChild;
+        }
+        else if (apParent->pLeft == apOldChild)
+        {
+            apParent->pLeft = apNewChild;
+        }
+        else
+        {
+            apParent->pRight = apNewChild;
+        }
+    }
+
+    void RedBlackTree::RotateLeft(RedBlackNode& arNode)
+    {
+        auto* const pchild = arNode.pRight;
+        arNode.pRight = pchild->pLeft;
+        if (pchild->pLeft != nullptr)
+        {
+            pchild->pLeft->pParent = &arNode;
+        }
+        pchild->pParent = arNode.pParent;
+        ReplaceChild(arNode.pParent, &arNode, pchild);
+        pchild->pLeft = &arNode;
+        arNode.pParent = pchild;
+    }
+
+    void RedBlackTree::RotateRight(RedBlackNode& arNode)
+    {
+        auto* const pchild = arNode.pLeft;
+        arNode.pLeft = pchild->pRight;
+        if (pchild->pRight != nullptr)
+        {
+            pchild->pRight->pParent = &arNode;
+        }
+        pchild->pParent = arNode.pParent;
+        ReplaceChild(arNode.pParent, &arNode, pchild);
+        pchild->pRight = &arNode;
+        arNode.pParent = pchild;
+    }
+
+    void RedBlackTree::FixAfterInsert(RedBlackNode* apNode)
+    {
+        // The only thing that can be wrong is a red node with a red parent. The root is always black, so a red parent
+        // always has a parent of its own
+        while (IsRed(apNode->pParent))
+        {
+            auto* pparent = apNode->pParent;
+            auto* const pgrandparent = pparent->pParent;
+            if (pparent == pgrandparent->pLeft)
+            {
+                auto* const puncle = pgrandparent->pRight;
+                if (IsRed(puncle))
+                {
+                    // Push the grandparent's black down a level, and carry on from the grandparent
+                    pparent->Red = false;
+                    puncle->Red = false;
+                    pgrandparent->Red = true;
+                    apNode = pgrandparent;
+                    continue;
+                }
+                if (apNode == pparent->pRight)
+                {
+                    RotateLeft(*pparent);
+                    apNode = pparent;
+                    pparent = apNode->pParent;
+                }
+                pparent->Red = false;
+                pgrandparent->Red = true;
+                RotateRight(*pgrandparent);
+            }
+            else
+            {
+                auto* const puncle = pgrandparent->pLeft;
+                if (IsRed(puncle))
+                {
+                    pparent->Red = false;
+                    puncle->Red = false;
+                    pgrandparent->Red = true;
+                    apNode = pgrandparent;
+                    continue;
+                }
+                if (apNode == pparent->pLeft)
+                {
+                    RotateRight(*pparent);
+                    apNode = pparent;
+                    pparent = apNode->pParent;
+                }
+                pparent->Red = false;
+                pgrandparent->Red = true;
+                RotateLeft(*pgrandparent);
+            }
+        }
+        pRoot->Red = false;
+    }
+
+    void RedBlackTree::FixAfterRemove(RedBlackNode* apNode, RedBlackNode* apParent)
+    {
+        // The path through apNode is one black short. Since it lost a black node, its sibling can't be empty
+        while ((apNode != pRoot) && !IsRed(apNode))
+        {
+            if (apNode == apParent->pLeft)
+            {
+                auto* psibling = apParent->pRight;
+                if (psibling->Red)
+                {
+                    psibling->Red = false;
+                    apParent->Red = true;
+                    RotateLeft(*apParent);
+                    psibling = apParent->pRight;
+                }
+                if (!IsRed(psibling->pLeft) && !IsRed(psibling->pRight))
+                {
+                    // Take a black off the sibling's side too, and push the problem up a level
+                    psibling->Red = true;
+                    apNode = apParent;
+                    apParent = apNode->pParent;
+                    continue;
+                }
+                if (!IsRed(psibling->pRight))
+                {
+                    psibling->pLeft->Red = false;
+                    psibling->Red = true;
+                    RotateRight(*psibling);
+                    psibling = apParent->pRight;
+                }
+                psibling->Red = apParent->Red;
+                apParent->Red = false;
+                psibling->pRight->Red = false;
+                RotateLeft(*apParent);
+                apNode = pRoot;
+            }
+            else
+            {
+                auto* psibling = apParent->pLeft;
+                if (psibling->Red)
+                {
+                    psibling->Red = false;
+                    apParent->Red = true;
+                    RotateRight(*apParent);
+                    psibling = apParent->pLeft;
+                }
+                if (!IsRed(psibling->pLeft) && !IsRed(psibling->pRight))
+                {
+                    psibling->Red = true;
+                    apNode = apParent;
+                    apParent = apNode->pParent;
+                    continue;
+                }
+                if (!IsRed(psibling->pLeft))
+                {
+                    psibling->pRight->Red = false;
+                    psibling->Red = true;
+                    RotateLeft(*psibling);
+                    psibling = apParent->pLeft;
+                }
+                psibling->Red = apParent->Red;
+                apParent->Red = false;
+                psibling->pLeft->Red = false;
+                RotateRight(*apParent);
+                apNode = pRoot;
+            }
+        }
+        if (apNode != nullptr)
+        {
+            apNode->Red = false;
+        }
+    }
+}
\ No newline at end of file
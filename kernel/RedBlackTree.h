@@ -0,0 +1,150 @@
+#ifndef KERNEL_RED_BLACK_TREE_H
+#define KERNEL_RED_BLACK_TREE_H
+
+namespace Containers
+{
+    /**
+     * Links for an object stored in a RedBlackTree. Objects inherit from (or embed) this, so the tree never has to
+     * allocate anything
+     */
+    struct RedBlackNode
+    {
+        RedBlackNode* pParent = nullptr;
+        RedBlackNode* pLeft = nullptr;
+        RedBlackNode* pRight = nullptr;
+        bool Red = false;
+    };
+
+    /**
+     * Intrusive red-black tree. The tree doesn't know how its nodes are ordered - callers walk down from the root to
+     * find where a node belongs (the same walk they use to look nodes up), and hand that spot to Insert, which links
+     * the node in and rebalances. Every operation is O(log n), and only ever touches the nodes on a single path.
+     */
+    class RedBlackTree
+    {
+    public:
+        /**
+         * Obtains the root of the tree, to start a search from
+         * 
+         * @return The root node, or null if the tree is empty
+         */
+        [[nodiscard]] RedBlackNode* GetRoot() const { return pRoot; }
+
+        /**
+         * Checks if the tree has no nodes
+         * 
+         * @return True if the tree is empty
+         */
+        [[nodiscard]] bool IsEmpty() const { return pRoot == nullptr; }
+
+        /**
+         * Links a node into the tree and rebalances it
+         * 
+         * @param arNode The node to insert (must not already be in a tree)
+         * @param apParent The node to hang the new node off of, found by searching the tree (null if the tree is empty)
+         * @param aLeftChild True to make the node the parent's left child, false for the right. The chosen child must
+         * be empty
+         */
+        void Insert(RedBlackNode& arNode, RedBlackNode* apParent, bool aLeftChild);
+
+        /**
+         * Inserts a node, using a comparison to find its place. Nodes that compare equal to existing ones are placed
+         * after them
+         * 
+         * @param arNode The node to insert (must not already be in a tree)
+         * @param aLess Functor taking two nodes, returning true if the first belongs before the second
+         */
+        template<class LessT>
+        void InsertOrdered(RedBlackNode& arNode, LessT aLess)
+        {
+            RedBlackNode* pparent = nullptr;
+            auto leftChild = false;
+            for (auto* pcurNode = pRoot; pcurNode != nullptr; pcurNode = leftChild ? pcurNode->pLeft : pcurNode->pRight)
+            {
+                pparent = pcurNode;
+                leftChild = aLess(arNode, *pcurNode);
+            }
+            Insert(arNode, pparent, leftChild);
+        }
+
+        /**
+         * Unlinks a node from the tree and rebalances it
+         * 
+         * @param arNode The node to remove (must be in this tree)
+         */
+        void Remove(RedBlackNode& arNode);
+
+        /**
+         * Obtains the first node in the tree
+         * 
+         * @return The left-most node, or null if the tree is empty
+         */
+        [[nodiscard]] RedBlackNode* GetFirst() const;
+
+        /**
+         * Obtains the last node in the tree
+         * 
+         * @return The right-most node, or null if the tree is empty
+         */
+        [[nodiscard]] RedBlackNode* GetLast() const;
+
+        /**
+         * Obtains the node after the given one
+         * 
+         * @param aNode The node to start from
+         * @return The next node in order, or null if this is the last node
+         */
+        static RedBlackNode* GetNext(RedBlackNode const& aNode);
+
+        /**
+         * Obtains the node before the given one
+         * 
+         * @param aNode The node to start from
+         * @return The previous node in order, or null if this is the first node
+         */
+        static RedBlackNode* GetPrevious(RedBlackNode const& aNode);
+
+    private:
+        /**
+         * Points whatever referenced the old child at the new one
+         * 
+         * @param apParent The parent of the old child (null if it was the root)
+         * @param apOldChild The child being replaced
+         * @param apNewChild The child to replace it with (may be null)
+         */
+        void ReplaceChild(RedBlackNode* apParent, RedBlackNode const* apOldChild, RedBlackNode* apNewChild);
+
+        /**
+         * Rotates the node's right child up into its place
+         * 
+         * @param arNode The node to rotate down (must have a right child)
+         */
+        void RotateLeft(RedBlackNode& arNode);
+
+        /**
+         * Rotates the node's left child up into its place
+         * 
+         * @param arNode The node to rotate down (must have a left child)
+         */
+        void RotateRight(RedBlackNode& arNode);
+
+        /**
+         * Restores the red-black properties after a red node was linked in
+         * 
+         * @param apNode The newly linked node
+         */
+        void FixAfterInsert(RedBlackNode* apNode);
+
+        /**
+         * Restores the red-black properties after a black node was unlinked
+         * 
+         * @param apNode The node that took the removed node's place (may be null)
+         * @param apParent The parent of that spot
+         */
+        void FixAfterRemove(RedBlackNode* apNode, RedBlackNode* apParent);
+
+        RedBlackNode* pRoot = nullptr;
+    };
+}
+
+#endif // KERNEL_RED_BLACK_TREE_H
\ No newline at end of file
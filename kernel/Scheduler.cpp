@@ -6,23 +6,30 @@
 #include <cstring>
 // Technically needed for placement new, but for some reason clang-tidy doesn't pick up on that
 #include <new> // NOLINT(misc-include-cleaner)
+#include "AArch64/CPU.h"
 #include "AArch64/SchedulerDefines.h"
+#include "CoreMailbox.h"
+#include "DeadlineRunQueue.h"
+#include "FairRunQueue.h"
 #include "IRQ.h"
 #include "MemoryManager.h"
 #include "PointerTypes.h"
+#include "PriorityRunQueue.h"
+#include "SlabAllocator.h"
+#include "SpinLock.h"
 #include "TaskStructs.h"
 #include "Timer.h"
+#include "Utils.h"
+#include "VirtualMemoryArea.h"
 
 // How the scheduler currently works:
 //
-// CopyProcess creates a new memory page and puts the task struct at the bottom of the page, with the stack pointer
-// pointing at a certain distance above it.
+// CopyProcess allocates the task struct from an object cache, and a separate page for the task's kernel stack, with
+// the stack pointer pointing at a certain distance below the top of the page.
 //
 // 0xXXXXXXXX +--------------------+ ^
-//            | TaskStruct         | |
-//            +--------------------+ | One page
 //            |                    | |
-//            | Stack (grows up)   | |
+//            | Stack (grows up)   | | One page
 //            +--------------------+ |
 //            | ProcessState       | |
 // 0xXXXX1000 +--------------------+ v
@@ -38,8 +45,6 @@
 // task's stack
 //
 // 0xXXXXXXXX +----------------------+
-//            | TaskStruct           |
-//            +----------------------+
 //            |                      |
 //            +----------------------+
 //            | Task saved registers |
@@ -52,8 +57,6 @@
 // The current task is now handling an interrupt, and grows a little bit more on the stack to pick the task to resume
 //
 // 0xXXXXXXXX +----------------------+
-//            | TaskStruct           |
-//            +----------------------+
 //            |                      |
 //            +----------------------+
 //            | Stack (interrupt)    |
@@ -70,8 +73,6 @@
 // interrupt handler, but interrupts have been re-enabled at this point, so another timer can come in again.
 //
 // 0xXXXXXXXX +----------------------+
-//            | TaskStruct           |
-//            +----------------------+
 //            |                      |
 //            +----------------------+
 //            | Stack (interrupt)    |
@@ -84,8 +85,6 @@
 // 0xXXXX1000 +----------------------+
 //            |         ...          |
 // 0xYYYYYYYY +----------------------+
-//            | TaskStruct           |
-//            +----------------------+
 //            |                      |
 //            | Stack (grows up)     |
 //            +----------------------+
@@ -96,8 +95,6 @@
 // bottom of the second task's stack, and the interrupt stack for that task starts to grow
 //
 // 0xXXXXXXXX +----------------------+
-//            | TaskStruct           |
-//            +----------------------+
 //            |                      |
 //            +----------------------+
 //            | Stack (interrupt)    |
@@ -110,8 +107,6 @@
 // 0xXXXX1000 +----------------------+
 //            |         ...          |
 // 0xYYYYYYYY +----------------------+
-//            | TaskStruct           |
-//            +----------------------+
 //            |                      |
 //            +----------------------+
 //            | Stack (interrupt)    |
@@ -123,8 +118,10 @@
 //            | ProcessState         |
 // 0xYYYY1000 +----------------------+
 //
-// ScheduleImpl is now called, and notes that both tasks have their counter at 0. It then sets the counters to their
-// priority and picks the first task to run again. (Though it could pick either if their priorities were the same)
+// ScheduleImpl is now called, and notes that the second task's time slice is up. It charges the task the time it ran
+// for (scaled by its weight) as virtual runtime, which moves it behind the first task in the fair run queue, so the
+// first task is picked to run again (priority tasks instead get a new counter based on their priority, and move to the
+// back of the priority run queue, which runs ahead of every fair task)
 // cpu_switch_to is called and it restores all the callee-saved registers from the first task context. The link
 // register now points at the end of the SwitchTo function, since that's what it was the last time this task was
 // running. The stack pointer also is set to point at the bottom of the first task's interrupt stack.
@@ -132,8 +129,6 @@
 // collapsing the interrupt stack to 0.
 //
 // 0xXXXXXXXX +----------------------+
-//            | TaskStruct           |
-//            +----------------------+
 //            |                      |
 //            +----------------------+
 //            | Task saved registers |
@@ -144,8 +139,6 @@
 // 0xXXXX1000 +----------------------+
 //            |         ...          |
 // 0xYYYYYYYY +----------------------+
-//            | TaskStruct           |
-//            +----------------------+
 //            |                      |
 //            +----------------------+
 //            | Stack (interrupt)    |
@@ -162,8 +155,6 @@
 // originally happened. And sp now points at the bottom of the task's original stack
 //
 // 0xXXXXXXXX +----------------------+
-//            | TaskStruct           |
-//            +----------------------+
 //            |                      |
 //            | Stack (grows up)     |
 //            +----------------------+
@@ -171,8 +162,6 @@
 // 0xXXXX1000 +----------------------+
 //            |         ...          |
 // 0xYYYYYYYY +----------------------+
-//            | TaskStruct           |
-//            +----------------------+
 //            |                      |
 //            +----------------------+
 //            | Stack (interrupt)    |
@@ -185,6 +174,12 @@
 // 0xYYYY1000 +----------------------+
 //
 // The eret instruction is executed, using the saved elr_el1 register to jump back to whatever the first task was doing
+//
+// With more than one CPU, each CPU has its own run queue and only picks tasks from that, falling back to stealing a
+// task from the busiest other CPU, and then to its idle task. The task a CPU is running lives in tpidr_el1, so it
+// follows the task if it moves. Disabling preemption also takes a single kernel lock, so everything that relied on
+// preemption being disabled to keep other tasks out still does. ScheduleImpl runs with preemption disabled, so the
+// lock is held across cpu_switch_to, and is released by the task being switched to.
 
 namespace
 {
@@ -224,133 +219,585 @@ extern "C"
 
 namespace
 {
-    constexpr auto TimerTickMSC = 200; // tick every 200ms
+    constexpr auto TimerTickMSC = 4; // tick every 4ms, so fair time slices can be kept to their minimum granularity
+    // Priority tasks get 200ms per point of priority (the length of a tick before fair tasks needed finer ones)
+    constexpr int64_t PriorityTimeSliceTicksC = 50;
+    constexpr int64_t RoundRobinTimeSliceTicksC = 25; // 100ms, the same as Linux
+
+    constexpr uint64_t MicrosecondsPerSecondC = 1'000'000;
+    constexpr uint32_t DefaultFairTargetLatencyUSC = 20'000;
+    constexpr uint32_t TimerTickUSC = TimerTickMSC * 1'000;
+    constexpr uint32_t FairMinGranularityUSC = TimerTickUSC; // can't slice any finer than a tick
 
     constexpr auto ThreadSizeC = 4096; // 4k stack size (#TODO: Pull from page size?)
-    constexpr auto NumberOfTasksC = 64U;
+    constexpr auto NumberOfTasksC = Scheduler::MaxTasksC;
+
+    /**
+     * The tasks a CPU takes turns running. Tasks stay on the same queue (and so the same CPU) unless an idle CPU
+     * steals them
+     */
+    struct RunQueue
+    {
+        Scheduler::TaskStruct IdleTask; // runs when nothing else on the queue can (the boot CPU's is the init task)
+        Scheduler::TaskStruct* pCurrentTask = nullptr; // the task the CPU is running, including while it switches away
+        Scheduler::DeadlineRunQueue DeadlineQueue; // deadline tasks, which run ahead of everything else
+        Scheduler::PriorityRunQueue RealTimeQueue; // FIFO and round-robin tasks, which run ahead of priority ones
+        Scheduler::PriorityRunQueue PriorityQueue; // priority tasks, which run ahead of fair ones
+        Scheduler::FairRunQueue FairQueue; // fair tasks
+        Scheduler::TaskStruct* pZombies = nullptr; // exited tasks this CPU has switched away from, through pNextQueued
+        bool Online = false; // set once the CPU is ready to be handed tasks
+        bool Sleeping = false; // set while the CPU is idle and waiting for an interrupt, with its tick stopped
+    };
 
     // #TODO: We'll want something better to avoid the lint tag
     // NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
 
-    Scheduler::TaskStruct InitTask; // task running kernel init
-    Scheduler::TaskStruct* pCurrentTask = &InitTask;
+    MemoryManager::TypedObjectCache<Scheduler::TaskStruct> TaskCache;
+
+    // Held by whichever CPU is running with preemption disabled (see PreemptDisable)
+    Sync::SpinLock KernelLock;
+
+    // How long it should take for every fair task on a CPU to get a turn (see SetFairTargetLatency)
+    uint32_t FairTargetLatencyUS = DefaultFairTargetLatencyUSC;
 
     // #TODO: Convert to std::array when we have it to remove lint
     // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
-    Scheduler::TaskStruct* Tasks[NumberOfTasksC] = { &InitTask, nullptr };
+    RunQueue RunQueues[Scheduler::MaxCPUsC];
 
-    auto NumberOfTasks = 1;
+    // #TODO: Convert to std::array when we have it to remove lint
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+    Scheduler::TaskStruct* Tasks[NumberOfTasksC] = { &RunQueues[0].IdleTask, nullptr };
 
     // NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
 
     /**
-     * Enable scheduler preemption in the current task
+     * Obtains the task running on this CPU. It's kept in a register rather than looked up by CPU, so it stays correct
+     * even if the task is moved to another CPU between the lookup and the use
+     * 
+     * @return The currently running task
      */
-    void PreemptEnable()
+    Scheduler::TaskStruct* GetCurrentTaskPtr()
     {
-        // #TODO: Assert/error when we have it
-        --pCurrentTask->PreemptCount;
+        Scheduler::TaskStruct* ptask = nullptr;
+        // NOLINTNEXTLINE(hicpp-no-assembler)
+        asm volatile("mrs %[task], tpidr_el1" : [task] "=r"(ptask));
+        return ptask;
     }
 
     /**
-     * Disable scheduler preemption in the current task
+     * Sets the task running on this CPU
+     * 
+     * @param apTask The task
      */
-    void PreemptDisable()
+    void SetCurrentTaskPtr(Scheduler::TaskStruct* const apTask)
+    {
+        // NOLINTNEXTLINE(hicpp-no-assembler)
+        asm volatile("msr tpidr_el1, %[task]" : : [task] "r"(apTask) : "memory");
+    }
+
+    /**
+     * Masks interrupts on this CPU
+     * 
+     * @return The previous interrupt mask, to pass to RestoreInterrupts
+     */
+    uint64_t MaskInterrupts()
+    {
+        uint64_t daif = 0;
+        // NOLINTNEXTLINE(hicpp-no-assembler)
+        asm volatile(
+            "mrs %[daif], daif\n"
+            "msr daifset, #2"
+            : [daif] "=r"(daif)
+            : // no inputs
+            : "memory"
+        );
+        return daif;
+    }
+
+    /**
+     * Puts the interrupt mask back to what it was before MaskInterrupts
+     * 
+     * @param aDAIF The value returned from MaskInterrupts
+     */
+    void RestoreInterrupts(uint64_t const aDAIF)
     {
-        ++pCurrentTask->PreemptCount;
+        // NOLINTNEXTLINE(hicpp-no-assembler)
+        asm volatile("msr daif, %[daif]" : : [daif] "r"(aDAIF) : "memory");
     }
 
     /**
-     * Helper to disable scheduler preempting in the current scope
+     * Obtains the number of tasks on a CPU's run queue
+     * 
+     * @param aQueue The run queue
+     * @return The number of tasks, not counting the idle task
      */
-    struct DisablePreemptingInScope
+    uint32_t GetTaskCount(RunQueue const& aQueue)
     {
-        /**
-         * Constructor - disables scheduler preempting
-         */
-        [[nodiscard]] DisablePreemptingInScope()
+        return aQueue.DeadlineQueue.GetCount() + aQueue.RealTimeQueue.GetCount() + aQueue.PriorityQueue.GetCount() +
+            aQueue.FairQueue.GetCount();
+    }
+
+    /**
+     * Wakes a sleeping CPU
+     * 
+     * @param arQueue The CPU's run queue
+     * @param aCPU The CPU
+     */
+    void Wake(RunQueue& arQueue, uint32_t const aCPU)
+    {
+        // Cleared here, so only the first task to arrive sends an interrupt
+        arQueue.Sleeping = false;
+        CoreMailbox::Send(aCPU);
+    }
+
+    /**
+     * Makes sure a task just added to a CPU's run queue gets run. Sleeping CPUs have stopped their ticks, so won't
+     * notice new work (or steal it) by themselves. Must be called with preemption disabled
+     * 
+     * @param aCPU The CPU the task was added to
+     */
+    void WakeForWork(uint32_t const aCPU)
+    {
+        auto& rqueue = RunQueues[aCPU]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+        if (rqueue.Sleeping)
+        {
+            Wake(rqueue, aCPU);
+            return;
+        }
+        if (GetTaskCount(rqueue) < 2)
+        {
+            return;
+        }
+        // More than the CPU can run at once, so let a sleeping one steal some
+        for (auto curCPU = 0U; curCPU < Scheduler::MaxCPUsC; ++curCPU)
         {
-            PreemptDisable();
+            auto& rotherQueue = RunQueues[curCPU]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+            if (rotherQueue.Sleeping)
+            {
+                Wake(rotherQueue, curCPU);
+                return;
+            }
         }
+    }
 
-        /**
-         * Destructor - reenables scheduler preempting
-         */
-        ~DisablePreemptingInScope()
+    /**
+     * Adds a task to a CPU's run queue
+     * 
+     * @param aCPU The CPU to run the task
+     * @param arTask The task to add
+     */
+    void Enqueue(uint32_t const aCPU, Scheduler::TaskStruct& arTask)
+    {
+        auto& rqueue = RunQueues[aCPU]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+        arTask.CPU = aCPU;
+        switch (arTask.Policy)
         {
-            PreemptEnable();
+        case Scheduler::SchedulingPolicy::Fair:
+            rqueue.FairQueue.Enqueue(arTask);
+            break;
+        case Scheduler::SchedulingPolicy::Priority:
+            rqueue.PriorityQueue.Enqueue(arTask);
+            break;
+        case Scheduler::SchedulingPolicy::Fifo:
+        case Scheduler::SchedulingPolicy::RoundRobin:
+            rqueue.RealTimeQueue.Enqueue(arTask);
+            break;
+        case Scheduler::SchedulingPolicy::Deadline:
+            rqueue.DeadlineQueue.Enqueue(arTask, Timing::GetSystemCounterValue());
+            break;
         }
+        WakeForWork(aCPU);
+    }
 
-        // Disable copying/moving
-        DisablePreemptingInScope(const DisablePreemptingInScope&) = delete;
-        DisablePreemptingInScope(DisablePreemptingInScope&&) = delete;
-        DisablePreemptingInScope& operator=(const DisablePreemptingInScope&) = delete;
-        DisablePreemptingInScope& operator=(DisablePreemptingInScope&&) = delete;
-    };
+    /**
+     * Removes a task from the run queue it's on
+     * 
+     * @param arTask The task to remove
+     */
+    void Dequeue(Scheduler::TaskStruct& arTask)
+    {
+        auto& rqueue = RunQueues[arTask.CPU]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+        switch (arTask.Policy)
+        {
+        case Scheduler::SchedulingPolicy::Fair:
+            rqueue.FairQueue.Remove(arTask);
+            break;
+        case Scheduler::SchedulingPolicy::Priority:
+            rqueue.PriorityQueue.Remove(arTask);
+            break;
+        case Scheduler::SchedulingPolicy::Fifo:
+        case Scheduler::SchedulingPolicy::RoundRobin:
+            rqueue.RealTimeQueue.Remove(arTask);
+            break;
+        case Scheduler::SchedulingPolicy::Deadline:
+            rqueue.DeadlineQueue.Remove(arTask);
+            break;
+        }
+    }
+
+    /**
+     * Gives a task a full time slice for the tasks whose slices are counted in ticks
+     * 
+     * @param arTask The task
+     */
+    void ResetCounter(Scheduler::TaskStruct& arTask)
+    {
+        arTask.Counter = (arTask.Policy == Scheduler::SchedulingPolicy::Priority) ?
+            (arTask.Priority * PriorityTimeSliceTicksC) : RoundRobinTimeSliceTicksC;
+    }
+
+    /**
+     * Converts microseconds to counter-timer cycles
+     * 
+     * @param aMicroseconds The time in microseconds
+     * @return The time in counter-timer cycles
+     */
+    uint64_t MicrosecondsToCycles(uint64_t const aMicroseconds)
+    {
+        return (aMicroseconds * Timing::GetSystemCounterClockFrequencyHz()) / MicrosecondsPerSecondC;
+    }
+
+    /**
+     * Obtains how long a fair task should run for before another task gets a turn
+     * 
+     * @param aQueue The run queue the task is on
+     * @param aTask The task
+     * @return The time slice, in counter-timer cycles
+     */
+    uint64_t GetFairTimeSlice(RunQueue const& aQueue, Scheduler::TaskStruct const& aTask)
+    {
+        auto const targetLatency = MicrosecondsToCycles(__atomic_load_n(&FairTargetLatencyUS, __ATOMIC_RELAXED));
+        return aQueue.FairQueue.GetTimeSlice(aTask, targetLatency, MicrosecondsToCycles(FairMinGranularityUSC));
+    }
 
     /**
      * Switch from running the current task to the next task
      * 
+     * @param arQueue The run queue of this CPU
      * @param apNextTask The next task to run
      */
-    void SwitchTo(Scheduler::TaskStruct* const apNextTask)
+    void SwitchTo(RunQueue& arQueue, Scheduler::TaskStruct* const apNextTask)
     {
-        if (pCurrentTask == apNextTask)
+        auto* const pprevTask = arQueue.pCurrentTask;
+        if (pprevTask == apNextTask)
         {
             return;
         }
-        auto* const pprevTask = pCurrentTask;
-        pCurrentTask = apNextTask;
-        MemoryManager::SetPageGlobalDirectory(pCurrentTask->MemoryState.PageGlobalDirectory);
+        // Other CPUs can't take the previous task until we let go of the kernel lock, and we don't do that until we're
+        // running the next task, by which point the previous one's registers are all saved
+        arQueue.pCurrentTask = apNextTask;
+        SetCurrentTaskPtr(apNextTask);
+        MemoryManager::ActivateAddressSpace(*apNextTask);
         cpu_switch_to(pprevTask, apNextTask);
     }
 
+    /**
+     * Frees the kernel stacks and task structures of the exited tasks a CPU has switched away from, and gives their
+     * slots back
+     * 
+     * @param arQueue The run queue of this CPU
+     */
+    void ReapZombies(RunQueue& arQueue)
+    {
+        while (arQueue.pZombies != nullptr)
+        {
+            auto* const pzombie = arQueue.pZombies;
+            arQueue.pZombies = pzombie->pNextQueued;
+            for (auto& prTask : Tasks)
+            {
+                if (prTask == pzombie)
+                {
+                    prTask = nullptr;
+                    break;
+                }
+            }
+            MemoryManager::FreePages(pzombie->pKernelStack);
+            TaskCache.Free(pzombie);
+        }
+    }
+
+    /**
+     * Takes a task from the busiest other CPU, for a CPU that has run out of tasks of its own
+     * 
+     * @param aCPU The CPU that is out of tasks
+     * @return The task that was moved to the CPU's run queue, or null if no CPU had one to spare
+     */
+    Scheduler::TaskStruct* StealTask(uint32_t const aCPU)
+    {
+        RunQueue* pbusiestQueue = nullptr;
+        for (auto curCPU = 0U; curCPU < Scheduler::MaxCPUsC; ++curCPU)
+        {
+            auto& rqueue = RunQueues[curCPU]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+            // A CPU with a single task is going to run it itself, so there's nothing to gain from moving it
+            if ((curCPU != aCPU) && rqueue.Online && (GetTaskCount(rqueue) > 1) &&
+                ((pbusiestQueue == nullptr) || (GetTaskCount(rqueue) > GetTaskCount(*pbusiestQueue))))
+            {
+                pbusiestQueue = &rqueue;
+            }
+        }
+        if (pbusiestQueue == nullptr)
+        {
+            return nullptr;
+        }
+
+        // Deadline tasks stay put, since their reservation was only checked against their own CPU
+        auto* ptask = pbusiestQueue->RealTimeQueue.FindStealable(pbusiestQueue->pCurrentTask);
+        if (ptask == nullptr)
+        {
+            ptask = pbusiestQueue->PriorityQueue.FindStealable(pbusiestQueue->pCurrentTask);
+        }
+        if (ptask == nullptr)
+        {
+            ptask = pbusiestQueue->FairQueue.FindStealable(pbusiestQueue->pCurrentTask);
+        }
+        if (ptask == nullptr)
+        {
+            return nullptr;
+        }
+        Dequeue(*ptask);
+        if (ptask->Policy == Scheduler::SchedulingPolicy::Fair)
+        {
+            // Virtual runtimes only mean anything relative to the rest of their queue, so keep the task the same
+            // distance from the front
+            ptask->VirtualRuntime = ptask->VirtualRuntime - pbusiestQueue->FairQueue.GetMinVirtualRuntime() +
+                RunQueues[aCPU].FairQueue.GetMinVirtualRuntime(); // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+        }
+        Enqueue(aCPU, *ptask);
+        return ptask;
+    }
+
+    /**
+     * Puts the task a CPU is switching away from back in its place on the run queue, charging it for the time it ran
+     * 
+     * @param arQueue The run queue of this CPU
+     * @param arTask The task that was running (must still be queued)
+     * @param aNow The current counter-timer value
+     */
+    void RequeuePrevious(RunQueue& arQueue, Scheduler::TaskStruct& arTask, uint64_t const aNow)
+    {
+        switch (arTask.Policy)
+        {
+        case Scheduler::SchedulingPolicy::Fair:
+            arQueue.FairQueue.ChargeRuntime(arTask, aNow - arTask.ExecStart);
+            break;
+        case Scheduler::SchedulingPolicy::Priority:
+            if (arTask.Counter <= 0)
+            {
+                // Out of time, so it gets a new time slice sized by its priority, but doesn't get to use it until
+                // everything else on the queue has had a turn
+                ResetCounter(arTask);
+                arQueue.PriorityQueue.Expire(arTask);
+            }
+            break;
+        case Scheduler::SchedulingPolicy::Fifo:
+        case Scheduler::SchedulingPolicy::RoundRobin:
+            // FIFO tasks only run out of time by giving up the CPU. Either way they go behind the other tasks at their
+            // priority, but stay ahead of every lower one
+            if (arTask.Counter <= 0)
+            {
+                ResetCounter(arTask);
+                arQueue.RealTimeQueue.Requeue(arTask);
+            }
+            break;
+        case Scheduler::SchedulingPolicy::Deadline:
+            arQueue.DeadlineQueue.ChargeRuntime(arTask, aNow - arTask.ExecStart);
+            break;
+        }
+    }
+
+    /**
+     * Sets the CPU's timer to fire at the next tick, or sooner if the scheduler has to look at things before then -
+     * when a throttled deadline task's next period starts, or when the running deadline task uses up its runtime.
+     * Waiting for the tick would let a deadline task overrun its reservation, or start late, by up to a tick
+     * 
+     * @param aQueue The run queue of this CPU
+     * @param aTask The task that is about to run
+     * @param aNow The current counter-timer value
+     */
+    void ArmTimer(RunQueue const& aQueue, Scheduler::TaskStruct const& aTask, uint64_t const aNow)
+    {
+        auto fireAt = aNow + MicrosecondsToCycles(TimerTickUSC);
+        auto const nextReplenish = aQueue.DeadlineQueue.GetNextReplenish();
+        if (nextReplenish < fireAt)
+        {
+            fireAt = nextReplenish;
+        }
+        if (aTask.Queued && (aTask.Policy == Scheduler::SchedulingPolicy::Deadline) &&
+            ((aTask.ExecStart + aTask.RemainingRuntime) < fireAt))
+        {
+            fireAt = aTask.ExecStart + aTask.RemainingRuntime;
+        }
+        CoreTimer::SetOneShot(fireAt);
+    }
+
     /**
      * Find and resume a running task
      */
     void ScheduleImpl()
     {
-        // Make sure we don't get called while we're in the middle of picking a task
-        DisablePreemptingInScope const disablePreempt;
+        // Make sure we don't get called while we're in the middle of picking a task, and that nobody else is picking
+        // at the same time
+        Scheduler::DisablePreemptingInScope const disablePreempt;
 
-        auto foundTask = false;
-        auto taskToResume = 0U;
-        while (!foundTask)
+        // We can't be moved to another CPU with preemption disabled, so this stays correct
+        auto const cpu = AArch64::CPU::GetCurrentCore();
+        auto& rqueue = RunQueues[cpu]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+
+        ReapZombies(rqueue);
+
+        auto const now = Timing::GetSystemCounterValue();
+        auto* const pprevTask = rqueue.pCurrentTask;
+        if (pprevTask->Queued)
         {
-            // Find the task with the largest counter value (i.e. the one that has the highest priority that has
-            // not run in a while)
-            auto largestCounter = -1LL;
-            taskToResume = 0;
-            for (auto curTask = 0U; curTask < NumberOfTasksC; ++curTask)
+            if (pprevTask->State == Scheduler::TaskState::Zombie)
             {
-                // #TODO: Can hopefully remove lint tag when we get std::array
-                auto const* const ptask = Tasks[curTask]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
-                if ((ptask != nullptr) && (ptask->State == Scheduler::TaskState::Running) && (ptask->Counter > largestCounter))
-                {
-                    largestCounter = ptask->Counter;
-                    taskToResume = curTask;
-                }
+                // It's still on its stack until we switch away, so it's freed the next time we schedule
+                Dequeue(*pprevTask);
+                pprevTask->pNextQueued = rqueue.pZombies;
+                rqueue.pZombies = pprevTask;
             }
-            // If we don't find any running task with a non-zero counter, then we need to go and reset all their
-            // counters according to their priority
-            foundTask = (largestCounter > 0);
-            if (!foundTask)
+            else
             {
-                for (auto* const pcurTask : Tasks)
+                RequeuePrevious(rqueue, *pprevTask, now);
+                if (pprevTask->State == Scheduler::TaskState::Blocked)
                 {
-                    if (pcurTask != nullptr)
-                    {
-                        // Increment the counter by the priority, ensuring that we don't go above 2 * priority
-                        // So the longer the task has been waiting, the higher the counter should be.
-                        pcurTask->Counter = (pcurTask->Counter / 1) + pcurTask->Priority;
-                    }
+                    // Charged for the time it ran, but left off the queue until it's unblocked
+                    Dequeue(*pprevTask);
                 }
             }
-            // If at least one task is running, then we should only loop around once. If all tasks are not running
-            // then we keep looping until a task changes its state to running again (i.e. via an interrupt)
         }
-        // #TODO: Can hopefully remove lint tag when we get std::array
-        SwitchTo(Tasks[taskToResume]); // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+        rqueue.DeadlineQueue.Replenish(now);
+
+        auto* pnextTask = rqueue.DeadlineQueue.PickNext();
+        if (pnextTask == nullptr)
+        {
+            pnextTask = rqueue.RealTimeQueue.PickNext();
+        }
+        if (pnextTask == nullptr)
+        {
+            pnextTask = rqueue.PriorityQueue.PickNext();
+        }
+        if (pnextTask == nullptr)
+        {
+            pnextTask = rqueue.FairQueue.PickNext();
+        }
+        if (pnextTask == nullptr)
+        {
+            pnextTask = StealTask(cpu);
+        }
+        if (pnextTask == nullptr)
+        {
+            // Nothing to do anywhere
+            pnextTask = &rqueue.IdleTask;
+        }
+        pnextTask->ExecStart = now;
+        ArmTimer(rqueue, *pnextTask, now);
+        SwitchTo(rqueue, pnextTask);
+    }
+
+    /**
+     * Works out if the running task should give up the CPU at a tick, either because its time is up or because a task
+     * that runs ahead of it might be waiting. Runs without the kernel lock, so it only reads counts that other CPUs may
+     * change, and leaves the real decision to ScheduleImpl. That includes the deadline queue, which other CPUs add to
+     * when they unblock one of its tasks, so only the state it publishes for lock-free readers is looked at
+     * 
+     * @param aQueue The run queue of this CPU
+     * @param arTask The running task
+     * @param aNow The current counter-timer value
+     * @return True if the task should be preempted
+     */
+    bool ShouldPreempt(RunQueue const& aQueue, Scheduler::TaskStruct& arTask, uint64_t const aNow)
+    {
+        if (!arTask.Queued)
+        {
+            // The idle task looks for work every tick
+            return true;
+        }
+
+        auto const deadlineWaiting = aQueue.DeadlineQueue.HasReady() || (aQueue.DeadlineQueue.GetNextReplenish() <= aNow);
+        auto const ranCycles = aNow - arTask.ExecStart;
+        switch (arTask.Policy)
+        {
+        case Scheduler::SchedulingPolicy::Fair:
+            return (ranCycles >= GetFairTimeSlice(aQueue, arTask)) || deadlineWaiting ||
+                (aQueue.RealTimeQueue.GetCount() > 0) || (aQueue.PriorityQueue.GetCount() > 0);
+        case Scheduler::SchedulingPolicy::Priority:
+            --arTask.Counter;
+            return (arTask.Counter <= 0) || deadlineWaiting || (aQueue.RealTimeQueue.GetCount() > 0);
+        case Scheduler::SchedulingPolicy::Fifo:
+            // Another real-time task may have a higher priority
+            return deadlineWaiting || (aQueue.RealTimeQueue.GetCount() > 1);
+        case Scheduler::SchedulingPolicy::RoundRobin:
+            --arTask.Counter;
+            return (arTask.Counter <= 0) || deadlineWaiting || (aQueue.RealTimeQueue.GetCount() > 1);
+        case Scheduler::SchedulingPolicy::Deadline:
+            // Nothing else can get an earlier deadline until a throttled task is replenished
+            return (ranCycles >= arTask.RemainingRuntime) || (aQueue.DeadlineQueue.GetNextReplenish() <= aNow);
+        }
+        return true;
+    }
+
+    /**
+     * Checks if a CPU has anything on its run queue that can run (throttled deadline tasks can't until their next
+     * period)
+     * 
+     * @param aQueue The run queue
+     * @return True if there's a task to run
+     */
+    bool HasRunnableTask(RunQueue const& aQueue)
+    {
+        return (aQueue.DeadlineQueue.PickNext() != nullptr) || (aQueue.RealTimeQueue.GetCount() > 0) ||
+            (aQueue.PriorityQueue.GetCount() > 0) || (aQueue.FairQueue.GetCount() > 0);
+    }
+
+    /**
+     * Puts the CPU to sleep until there's something for it to run, with its tick stopped. The timer is only left to
+     * fire for the next throttled deadline task, and anything else that needs us sends an interrupt (see WakeForWork).
+     * Before sleeping, the CPU frees the tasks it last switched away from, and steals a task from any other CPU that
+     * has more than it can run
+     */
+    void SleepUntilWork()
+    {
+        // An interrupt between deciding to sleep and the wfi would be handled and forgotten, leaving nothing to wake us.
+        // With them masked it's left pending instead, and wfi returns straight away
+        auto const interruptMask = MaskInterrupts();
+        auto const cpu = AArch64::CPU::GetCurrentCore();
+        auto& rqueue = RunQueues[cpu]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+        auto sleeping = false;
+        {
+            // Other CPUs hold the kernel lock while adding tasks and checking if we're sleeping, so either we see their
+            // task here, or they see we're sleeping and wake us
+            Scheduler::DisablePreemptingInScope const disablePreempt;
+            // An exiting task's stack is only freed once we've switched away from it, which may have been to here
+            ReapZombies(rqueue);
+            // Other CPUs only wake us for work when they're handed it, not for what they already had queued, so
+            // anything spare has to be picked up now (the stolen task is run by the next schedule)
+            if (!HasRunnableTask(rqueue) && (StealTask(cpu) == nullptr))
+            {
+                sleeping = true;
+                rqueue.Sleeping = true;
+                CoreTimer::SetOneShot(rqueue.DeadlineQueue.GetNextReplenish());
+            }
+        }
+        // Can't look at the flag itself, since a CPU waking us clears it
+        if (!sleeping)
+        {
+            RestoreInterrupts(interruptMask);
+            return;
+        }
+
+        // NOLINTNEXTLINE(hicpp-no-assembler)
+        asm volatile("wfi" : : : "memory");
+
+        {
+            Scheduler::DisablePreemptingInScope const disablePreempt;
+            rqueue.Sleeping = false;
+        }
+        // Restarting the tick clears the one-shot if that's what woke us, but all it was for was to get us to schedule
+        // again, which the idle loop does next. Anything else that woke us is still pending, and handled once
+        // interrupts are restored
+        CoreTimer::RestartRepeating();
+        RestoreInterrupts(interruptMask);
     }
 
     /**
@@ -360,13 +807,17 @@ namespace
      */
     void TimerTick(void const* const /*apParam*/)
     {
-        // Only switch task if the counter has run out and it hasn't been blocked
-        --pCurrentTask->Counter;
-        if ((pCurrentTask->Counter > 0) || (pCurrentTask->PreemptCount > 0))
+        // Only switch task if it should give up the CPU and it hasn't been blocked
+        auto* const pcurrentTask = GetCurrentTaskPtr();
+        // We're in an interrupt, so can't be moved to another CPU
+        auto const& rqueue = RunQueues[AArch64::CPU::GetCurrentCore()]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+        auto const now = Timing::GetSystemCounterValue();
+        if (!ShouldPreempt(rqueue, *pcurrentTask, now) || (pcurrentTask->PreemptCount > 0))
         {
+            // The tick just went back to repeating, but something may be due before the next one
+            ArmTimer(rqueue, *pcurrentTask, now);
             return;
         }
-        pCurrentTask->Counter = 0;
 
         // Interrupts are disabled while handing one, so re-enable them for the schedule call because some tasks
         // might be waiting from an interrupt and we want them to be able to get them while the scheduler is trying
@@ -388,7 +839,7 @@ namespace
      */
     void* GetTargetStateMemoryForTask(Scheduler::TaskStruct const* const apTask)
     {
-        const auto state = std::bit_cast<uintptr_t>(apTask) + ThreadSizeC - sizeof(ProcessState);
+        const auto state = std::bit_cast<uintptr_t>(apTask->pKernelStack) + ThreadSizeC - sizeof(ProcessState);
         return std::bit_cast<void*>(state);
     }
 }
@@ -400,40 +851,235 @@ extern "C"
      */
     void schedule_tail()
     {
-        PreemptEnable();
+        Scheduler::PreemptEnable();
     }
 }
 
 namespace Scheduler
 {
+    void PreemptEnable()
+    {
+        // An interrupt between updating the count and the lock would find them disagreeing, and either deadlock on
+        // the lock we hold or run without it
+        auto const interruptMask = MaskInterrupts();
+        auto* const pcurrentTask = GetCurrentTaskPtr();
+        // #TODO: Assert/error when we have it
+        if (pcurrentTask->PreemptCount == 1)
+        {
+            KernelLock.Unlock();
+        }
+        --pcurrentTask->PreemptCount;
+        RestoreInterrupts(interruptMask);
+    }
+
+    void PreemptDisable()
+    {
+        // Every task's code was written expecting nothing else to run while it has preemption disabled, which used to
+        // be true with a single CPU. The kernel lock keeps it true with more than one. The lock is held across task
+        // switches, and released by the task switched to (either in ScheduleImpl or schedule_tail)
+        auto const interruptMask = MaskInterrupts();
+        auto* const pcurrentTask = GetCurrentTaskPtr();
+        ++pcurrentTask->PreemptCount;
+        if (pcurrentTask->PreemptCount == 1)
+        {
+            KernelLock.Lock();
+        }
+        RestoreInterrupts(interruptMask);
+    }
+
+    void InitCPU()
+    {
+        auto const cpu = AArch64::CPU::GetCurrentCore();
+        auto& rqueue = RunQueues[cpu]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+        SetCurrentTaskPtr(&rqueue.IdleTask);
+
+        DisablePreemptingInScope const disablePreempt;
+        rqueue.pCurrentTask = &rqueue.IdleTask;
+        rqueue.Online = true;
+    }
+
     void InitTimer()
     {
-        // We're using a local timer instead of the global timer because it works on both QEMU and real hardware
-        //LocalTimer::RegisterCallback(TimerTickMSC, TimerTick, nullptr);
-        // #TODO: Local timer cannot be used until we figure out how to get the local peripheral addresses mapped in
-        // the mmu. Since they start at 0x4000'0000 they are out of range of our current single page mmu setup.
-        Timer::RegisterCallback(TimerTickMSC, TimerTick, nullptr);
+        // Each core has its own generic timer, which (unlike the system timer) can interrupt any core
+        CoreTimer::RegisterCallback(TimerTickMSC, TimerTick, nullptr);
+    }
+
+    void RunIdleLoop()
+    {
+        while (true)
+        {
+            // Runs everything else there is, only coming back here once there's nothing left
+            ScheduleImpl();
+            SleepUntilWork();
+        }
+    }
+
+    void SetFairTargetLatency(uint32_t const aLatencyUS)
+    {
+        // Anything shorter than the minimum granularity would just be stretched out to it anyway
+        __atomic_store_n(&FairTargetLatencyUS, (aLatencyUS < FairMinGranularityUSC) ? FairMinGranularityUSC : aLatencyUS, __ATOMIC_RELAXED);
+    }
+
+    bool SetPolicy(SchedulingPolicy const aPolicy, int64_t const aPriority)
+    {
+        switch (aPolicy)
+        {
+        case SchedulingPolicy::Fair:
+            if ((aPriority < FairRunQueue::MinNiceC) || (aPriority > FairRunQueue::MaxNiceC))
+            {
+                return false;
+            }
+            break;
+        case SchedulingPolicy::Priority:
+        case SchedulingPolicy::Fifo:
+        case SchedulingPolicy::RoundRobin:
+            // Priority 0 would give a priority task no time slice, so both start at 1 (like Linux real-time tasks)
+            if ((aPriority < 1) || (aPriority >= PriorityRunQueue::PriorityLevelsC))
+            {
+                return false;
+            }
+            break;
+        case SchedulingPolicy::Deadline:
+            // Needs a reservation, so has to go through SetDeadline
+            return false;
+        }
+
+        {
+            DisablePreemptingInScope const disablePreempt;
+            auto* const pcurrentTask = GetCurrentTaskPtr();
+            if (!pcurrentTask->Queued)
+            {
+                // The idle tasks only run when nothing else can
+                return false;
+            }
+            auto& rqueue = RunQueues[pcurrentTask->CPU]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+            Dequeue(*pcurrentTask);
+            if (pcurrentTask->Policy == SchedulingPolicy::Deadline)
+            {
+                rqueue.DeadlineQueue.Release(*pcurrentTask);
+            }
+            pcurrentTask->Policy = aPolicy;
+            if (aPolicy == SchedulingPolicy::Fair)
+            {
+                pcurrentTask->Nice = static_cast<int32_t>(aPriority);
+                pcurrentTask->VirtualRuntime = rqueue.FairQueue.GetMinVirtualRuntime();
+            }
+            else
+            {
+                pcurrentTask->Priority = aPriority;
+            }
+            ResetCounter(*pcurrentTask);
+            Enqueue(pcurrentTask->CPU, *pcurrentTask);
+            pcurrentTask->ExecStart = Timing::GetSystemCounterValue();
+        }
+        // Something may now run ahead of us
+        ScheduleImpl();
+        return true;
+    }
+
+    bool SetDeadline(uint32_t const aRuntimeUS, uint32_t const aPeriodUS)
+    {
+        if ((aRuntimeUS == 0) || (aRuntimeUS > aPeriodUS))
+        {
+            return false;
+        }
+        auto const runtime = MicrosecondsToCycles(aRuntimeUS);
+        auto const period = MicrosecondsToCycles(aPeriodUS);
+
+        {
+            DisablePreemptingInScope const disablePreempt;
+            auto* const pcurrentTask = GetCurrentTaskPtr();
+            // Only checked against the CPU we're on, since deadline tasks are never moved to another
+            auto& rqueue = RunQueues[pcurrentTask->CPU]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+            if (!pcurrentTask->Queued || (runtime == 0) || !rqueue.DeadlineQueue.CanAdmit(*pcurrentTask, runtime, period))
+            {
+                return false;
+            }
+            Dequeue(*pcurrentTask);
+            if (pcurrentTask->Policy == SchedulingPolicy::Deadline)
+            {
+                rqueue.DeadlineQueue.Release(*pcurrentTask);
+            }
+            pcurrentTask->Policy = SchedulingPolicy::Deadline;
+            pcurrentTask->DeadlineRuntime = runtime;
+            pcurrentTask->DeadlinePeriod = period;
+            rqueue.DeadlineQueue.Reserve(*pcurrentTask);
+            // The new reservation starts with a period of its own
+            pcurrentTask->AbsoluteDeadline = 0;
+            Enqueue(pcurrentTask->CPU, *pcurrentTask);
+            pcurrentTask->ExecStart = Timing::GetSystemCounterValue();
+        }
+        ScheduleImpl();
+        return true;
     }
 
     void Schedule()
     {
-        pCurrentTask->Counter = 0;
+        GetCurrentTaskPtr()->Counter = 0;
         ScheduleImpl();
     }
 
+    void Block()
+    {
+        GetCurrentTaskPtr()->State = TaskState::Blocked;
+    }
+
+    void Unblock(TaskStruct& arTask)
+    {
+        DisablePreemptingInScope const disablePreempt;
+        if (arTask.State != TaskState::Blocked)
+        {
+            return;
+        }
+        arTask.State = TaskState::Running;
+        // If it hasn't scheduled since blocking, it's still on its queue and just carries on. Deadline tasks kept their
+        // reservation while blocked, and the queue decides if they carry on with their current period
+        if (!arTask.Queued)
+        {
+            if (arTask.Policy == SchedulingPolicy::Fair)
+            {
+                // Don't let it make up for all the time it was blocked at the expense of everything else
+                auto const& rqueue = RunQueues[arTask.CPU]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+                if (arTask.VirtualRuntime < rqueue.FairQueue.GetMinVirtualRuntime())
+                {
+                    arTask.VirtualRuntime = rqueue.FairQueue.GetMinVirtualRuntime();
+                }
+            }
+            Enqueue(arTask.CPU, arTask);
+        }
+    }
+
     int CopyProcess(uint32_t const aCloneFlags, ProcessFunctionPtr const apProcessFn, void const* const apParam)
     {
         // Make sure we don't get preempted in the middle of making a new task
         DisablePreemptingInScope const disablePreempt;
+        auto* const pcurrentTask = GetCurrentTaskPtr();
+
+        auto processID = 0U;
+        while ((processID < NumberOfTasksC) && (Tasks[processID] != nullptr)) // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+        {
+            ++processID;
+        }
+        if (processID == NumberOfTasksC)
+        {
+            return -1;
+        }
 
-        auto* const pmemory = MemoryManager::AllocateKernelPage();
-        if (pmemory == nullptr)
+        // The stack is about to have the process state written to it, and nothing reads the rest before writing it
+        auto* const pkernelStack = MemoryManager::AllocateUnzeroedPages(0);
+        if (pkernelStack == nullptr)
         {
             return -1;
         }
 
         // #TODO: We'll want proper ownership figured out
-        auto* const pnewTask = new (pmemory) TaskStruct{}; // NOLINT(cppcoreguidelines-owning-memory)
+        auto* const pnewTask = TaskCache.Allocate();
+        if (pnewTask == nullptr)
+        {
+            MemoryManager::FreePages(pkernelStack);
+            return -1;
+        }
+        pnewTask->pKernelStack = pkernelStack;
 
         auto* const puninitializedState = GetTargetStateMemoryForTask(pnewTask);
         // #TODO: We'll want proper ownership figured out
@@ -447,30 +1093,55 @@ namespace Scheduler
         else
         {
             // extract and clone the current processor state
-            auto* const psourceState = std::bit_cast<ProcessState*>(GetTargetStateMemoryForTask(pCurrentTask));
+            auto* const psourceState = std::bit_cast<ProcessState*>(GetTargetStateMemoryForTask(pcurrentTask));
             *pnewState = *psourceState;
             pnewState->Registers[0] = 0; // make sure ret_from_fork knows this is the new user process
-            MemoryManager::CopyVirtualMemory(*pnewTask, *pCurrentTask);
+            if (!MemoryManager::CopyVirtualMemory(*pnewTask, *pcurrentTask))
+            {
+                // Whatever was copied before running out of memory has to be given back
+                MemoryManager::ReleaseAddressSpace(*pnewTask);
+                pnewState->~ProcessState();
+                TaskCache.Free(pnewTask);
+                MemoryManager::FreePages(pkernelStack);
+                return -1;
+            }
         }
 
         pnewTask->Flags = aCloneFlags;
-        pnewTask->Priority = pCurrentTask->Priority;
-        pnewTask->Counter = pnewTask->Priority;
+        // A deadline task's reservation is its own, so its children have to share the CPU fairly instead
+        pnewTask->Policy = (pcurrentTask->Policy == SchedulingPolicy::Deadline) ? SchedulingPolicy::Fair : pcurrentTask->Policy;
+        pnewTask->Priority = pcurrentTask->Priority;
+        pnewTask->Nice = pcurrentTask->Nice;
+        ResetCounter(*pnewTask);
         pnewTask->PreemptCount = 1; // disable preemption until schedule_tail
 
         pnewTask->Context.pc = std::bit_cast<uint64_t>(&ret_from_fork);
         pnewTask->Context.sp = std::bit_cast<uint64_t>(pnewState);
-        auto const processID = NumberOfTasks++;
         // #TODO: Can likely clean up lint tag when we get std::array
         Tasks[processID] = pnewTask; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
-        return processID;
+
+        // Start the task on whichever CPU has the least to do
+        auto targetCPU = 0U;
+        for (auto curCPU = 1U; curCPU < MaxCPUsC; ++curCPU)
+        {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+            if (RunQueues[curCPU].Online && (GetTaskCount(RunQueues[curCPU]) < GetTaskCount(RunQueues[targetCPU])))
+            {
+                targetCPU = curCPU;
+            }
+        }
+        // Start level with the tasks already there, so it neither has to catch up nor gets to starve them
+        pnewTask->VirtualRuntime = RunQueues[targetCPU].FairQueue.GetMinVirtualRuntime(); // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+        Enqueue(targetCPU, *pnewTask);
+        return static_cast<int>(processID);
     }
 
     // #TODO: Need better parameter types to avoid bugprone API. Maybe a span for start + size
     bool MoveToUserMode(void const* const apStart, std::size_t const aSize, uintptr_t const aPC) // NOLINT(bugprone-easily-swappable-parameters)
     {
         // We expect the state to have been constructed by CopyProcess before getting here
-        auto* const pstate = std::bit_cast<ProcessState*>(GetTargetStateMemoryForTask(pCurrentTask));
+        auto* const pcurrentTask = GetCurrentTaskPtr();
+        auto* const pstate = std::bit_cast<ProcessState*>(GetTargetStateMemoryForTask(pcurrentTask));
 
         pstate->ProgramCounter = aPC;
         pstate->ProcessorState = PSRModeEL0tC;
@@ -479,14 +1150,23 @@ namespace Scheduler
         // page for us, hence why we can just blindly set StackPointer here.
         pstate->StackPointer = 2 * MemoryManager::PageSize;
 
-        auto* const pcodePage = MemoryManager::AllocateUserPage(*pCurrentTask, VirtualPtr{});
+        if (!MemoryManager::MapAnonymousArea(*pcurrentTask, VirtualPtr{}, MemoryManager::PageSize, MemoryManager::AreaProtection::ReadC | MemoryManager::AreaProtection::ExecuteC) ||
+            !MemoryManager::MapAnonymousArea(*pcurrentTask, VirtualPtr{ MemoryManager::PageSize }, MemoryManager::PageSize, MemoryManager::AreaProtection::ReadC | MemoryManager::AreaProtection::WriteC))
+        {
+            pstate->~ProcessState();
+            return false;
+        }
+
+        auto* const pcodePage = MemoryManager::AllocateUserPage(*pcurrentTask, VirtualPtr{});
         if (pcodePage == nullptr)
         {
             pstate->~ProcessState();
             return false;
         }
         memcpy(pcodePage, apStart, aSize);
-        MemoryManager::SetPageGlobalDirectory(pCurrentTask->MemoryState.PageGlobalDirectory);
+        // The code went through the data cache, so make sure the instruction fetches will see it
+        MemoryManager::SyncInstructionCache(pcodePage, aSize);
+        MemoryManager::ActivateAddressSpace(*pcurrentTask);
         return true;
     }
 
@@ -495,16 +1175,20 @@ namespace Scheduler
         {
             // Make sure we don't get preempted in the middle of cleaning up the task
             DisablePreemptingInScope const disablePreempt;
+            auto* const pcurrentTask = GetCurrentTaskPtr();
 
-            // Flag the task as a zombie so it isn't rescheduled
-            for (auto* const pcurTask : Tasks)
+            // Nothing in user space will run again, so its memory can go now. The kernel stack and task structure are
+            // still in use until we switch away, so those are freed when the next schedule reaps the zombie
+            MemoryManager::ReleaseAddressSpace(*pcurrentTask);
+
+            // The reservation is held until the task exits, even while it's blocked, so give it back for others
+            if (pcurrentTask->Policy == SchedulingPolicy::Deadline)
             {
-                if (pcurTask == pCurrentTask)
-                {
-                    pcurTask->State = TaskState::Zombie;
-                    break;
-                }
+                RunQueues[pcurrentTask->CPU].DeadlineQueue.Release(*pcurrentTask); // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
             }
+
+            // Flag the task as a zombie so it isn't rescheduled
+            pcurrentTask->State = TaskState::Zombie;
         }
         // Won't ever return because a new task will be scheduled and this one is now flagged as a zombie
         Schedule();
@@ -512,6 +1196,18 @@ namespace Scheduler
 
     TaskStruct& GetCurrentTask()
     {
-        return *pCurrentTask;
+        return *GetCurrentTaskPtr();
+    }
+
+    TaskStruct* GetRunningTask(uint32_t const aCPU)
+    {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+        return (aCPU < MaxCPUsC) ? RunQueues[aCPU].pCurrentTask : nullptr;
+    }
+
+    TaskStruct* GetTask(uint32_t const aProcessID)
+    {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+        return (aProcessID < NumberOfTasksC) ? Tasks[aProcessID] : nullptr;
     }
 }
\ No newline at end of file
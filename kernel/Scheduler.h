@@ -3,21 +3,90 @@
 
 #include <cstddef>
 #include <cstdint>
+#include "AArch64/SchedulerDefines.h"
 
 namespace Scheduler
 {
     struct TaskStruct;
+    enum class SchedulingPolicy : uint32_t;
 
     /**
-     * Initializes the scheduler on the CPU timer
+     * The most tasks that can exist at once (process IDs are always less than this)
+     */
+    constexpr uint32_t MaxTasksC = 64;
+
+    /**
+     * The most CPUs that can be running tasks
+     */
+    constexpr uint32_t MaxCPUsC = CPU_COUNT;
+
+    /**
+     * Sets up the calling CPU's run queue, making whatever is running on it the CPU's idle task, and starts handing it
+     * tasks. Must be called by each CPU before anything on it disables preemption
+     */
+    void InitCPU();
+
+    /**
+     * Initializes the scheduler on the calling CPU's timer (each CPU has to call this for itself)
      */
     void InitTimer();
 
     /**
-     * Voluntarily give up the CPU and schedule another task to run
+     * Turns the caller into the calling CPU's idle task, which runs whatever else there is and puts the CPU to sleep
+     * (with its tick stopped) whenever there's nothing. Must be called by each CPU once it's set up
+     */
+    [[noreturn]] void RunIdleLoop();
+
+    /**
+     * Sets how long it should take for every fair task on a CPU to get a turn. Each fair task's time slice is its
+     * weighted share of this, though no shorter than the scheduler tick, so with many tasks it's stretched out
+     * 
+     * @param aLatencyUS The target latency in microseconds (20ms by default)
+     */
+    void SetFairTargetLatency(uint32_t aLatencyUS);
+
+    /**
+     * Moves the calling task to another scheduling class. Deadline tasks, then FIFO and round-robin tasks, then priority
+     * tasks all run ahead of fair tasks, so this may switch to another task before returning
+     * 
+     * @param aPolicy The class to move to (anything but Deadline, which needs SetDeadline)
+     * @param aPriority The nice level for fair tasks (-20 to 19), or the priority for the others (1 to 63)
+     * @return True if the task was moved, false if the class or priority wasn't valid
+     */
+    bool SetPolicy(SchedulingPolicy aPolicy, int64_t aPriority);
+
+    /**
+     * Moves the calling task to the deadline class, reserving a runtime out of every period on the CPU it's on. The
+     * reservation is refused if it would take the CPU's deadline tasks over 95% of it between them. It's held, even
+     * while the task is blocked, until the task exits or moves to another class. This may switch to another task
+     * before returning
+     * 
+     * @param aRuntimeUS The runtime to reserve each period, in microseconds
+     * @param aPeriodUS The length of each period (and so the deadline), in microseconds
+     * @return True if the task was moved, false if the reservation was invalid or didn't fit
+     */
+    bool SetDeadline(uint32_t aRuntimeUS, uint32_t aPeriodUS);
+
+    /**
+     * Voluntarily give up the CPU and schedule another task to run. Must not be called with preemption disabled
      */
     void Schedule();
 
+    /**
+     * Marks the calling task as blocked. Must be called with preemption disabled, in the same scope as the check of
+     * whatever the task is waiting for, and then followed by Schedule once preemption is enabled again. That takes the
+     * task off its run queue until Unblock is called for it, unless Unblock was already called in between
+     */
+    void Block();
+
+    /**
+     * Lets a blocked task run again, putting it back on the run queue of the CPU it last ran on. Does nothing if the
+     * task isn't blocked
+     * 
+     * @param arTask The task to unblock
+     */
+    void Unblock(TaskStruct& arTask);
+
     using ProcessFunctionPtr = void(*)(void const* apParam);
 
     namespace CreationFlags
@@ -56,6 +125,63 @@ namespace Scheduler
      * @return The currently running task
      */
     TaskStruct& GetCurrentTask();
+
+    /**
+     * Obtains the task running on a CPU. It may be switched out as soon as preemption is enabled, so the pointer
+     * should only be held onto with preemption disabled
+     * 
+     * @param aCPU The CPU to check
+     * @return The task running on the CPU, or null if the CPU isn't running tasks
+     */
+    TaskStruct* GetRunningTask(uint32_t aCPU);
+
+    /**
+     * Obtains the task with the given process ID. The task may exit as soon as preemption is enabled, so the pointer
+     * should only be held onto with preemption disabled
+     * 
+     * @param aProcessID The process ID of the task
+     * @return The task, or null if there is no task with that ID
+     */
+    TaskStruct* GetTask(uint32_t aProcessID);
+
+    /**
+     * Enable scheduler preemption in the current task, releasing the kernel lock once the outermost disable is undone
+     */
+    void PreemptEnable();
+
+    /**
+     * Disable scheduler preemption in the current task (calls nest, and must be matched by PreemptEnable). The
+     * outermost disable also takes the kernel lock, so no other CPU runs with preemption disabled at the same time
+     */
+    void PreemptDisable();
+
+    /**
+     * Helper to disable scheduler preempting in the current scope
+     */
+    struct DisablePreemptingInScope
+    {
+        /**
+         * Constructor - disables scheduler preempting
+         */
+        [[nodiscard]] DisablePreemptingInScope()
+        {
+            PreemptDisable();
+        }
+
+        /**
+         * Destructor - reenables scheduler preempting
+         */
+        ~DisablePreemptingInScope()
+        {
+            PreemptEnable();
+        }
+
+        // Disable copying/moving
+        DisablePreemptingInScope(const DisablePreemptingInScope&) = delete;
+        DisablePreemptingInScope(DisablePreemptingInScope&&) = delete;
+        DisablePreemptingInScope& operator=(const DisablePreemptingInScope&) = delete;
+        DisablePreemptingInScope& operator=(DisablePreemptingInScope&&) = delete;
+    };
 }
 
 #endif // KERNEL_SCHEDULER_H
\ No newline at end of file
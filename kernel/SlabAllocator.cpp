@@ -0,0 +1,314 @@
+#include "SlabAllocator.h"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include "BuddyAllocator.h"
+#include "MemoryManager.h"
+#include "Scheduler.h"
+
+namespace MemoryManager
+{
+    /**
+     * Lives at the start of every slab, with the objects following it
+     */
+    struct SlabHeader
+    {
+        SlabCache* pCache = nullptr; // cache that owns this slab
+        SlabHeader* pNext = nullptr; // next slab in the cache's partial list
+        SlabHeader* pPrev = nullptr; // previous slab in the cache's partial list
+        void* pFreeList = nullptr; // objects that have been freed, most recently freed first
+        uint8_t* pNextUnused = nullptr; // objects past this point have never been handed out
+        std::size_t InUseCount = 0;
+    };
+
+    namespace
+    {
+        /**
+         * Free objects hold the pointer to the next free object in their first bytes
+         */
+        struct FreeObject
+        {
+            FreeObject* pNext = nullptr;
+        };
+
+        /**
+         * Flags or unflags every frame in a block of pages as being part of a slab
+         * 
+         * @param apSlab The start of the slab
+         * @param aOrder The order of the slab
+         * @param aIsSlab Whether to set or clear the slab flag
+         */
+        void MarkSlabFrames(void* const apSlab, unsigned const aOrder, bool const aIsSlab)
+        {
+            auto const slabAddress = std::bit_cast<uintptr_t>(apSlab);
+            for (auto curPage = 0ULL; curPage < (1ULL << aOrder); ++curPage)
+            {
+                auto* const pframe = GetPageFrame(std::bit_cast<void*>(slabAddress + (curPage * PageSize)));
+                if (aIsSlab)
+                {
+                    pframe->Flags |= PageFrameFlags::SlabC;
+                    // the slab order lets us find the header from any object in it
+                    pframe->Order = static_cast<uint8_t>(aOrder);
+                }
+                else
+                {
+                    pframe->Flags &= static_cast<uint8_t>(~PageFrameFlags::SlabC);
+                }
+            }
+        }
+
+        /**
+         * Finds the header of the slab holding the object
+         * 
+         * @param apObject The object to look up
+         * @return The header of the slab, or null if the object isn't in a slab
+         */
+        SlabHeader* FindSlab(void const* const apObject)
+        {
+            auto const* const pframe = GetPageFrame(apObject);
+            if ((pframe == nullptr) || ((pframe->Flags & PageFrameFlags::SlabC) == 0))
+            {
+                return nullptr;
+            }
+            // slabs are allocated as a single naturally-aligned block, so the header is at the start of that block
+            auto const slabStart = CalculateBlockStart(std::bit_cast<uintptr_t>(apObject), PageSize << pframe->Order);
+            return std::bit_cast<SlabHeader*>(slabStart);
+        }
+
+        // Size classes for the kernel heap, each double the last
+        constexpr std::size_t SmallestSizeClassC = 16;
+        constexpr std::size_t LargestSizeClassC = 2048;
+        constexpr auto SizeClassCount = 8U;
+        static_assert((SmallestSizeClassC << (SizeClassCount - 1)) == LargestSizeClassC, "Unexpected size class count");
+
+        // Constant-initialized, so they're usable before static constructors run
+        // NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+        // #TODO: Remove lint tag when we get std::array
+        // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+        constinit SlabCache SizeClassCaches[SizeClassCount] = {
+            SlabCache{ 16, 16 },
+            SlabCache{ 32, 16 },
+            SlabCache{ 64, 16 },
+            SlabCache{ 128, 16 },
+            SlabCache{ 256, 16 },
+            SlabCache{ 512, 16 },
+            SlabCache{ 1024, 16 },
+            SlabCache{ 2048, 16 },
+        };
+        // NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+    }
+
+    static_assert(sizeof(SlabHeader) <= 48, "Slab header has grown, update SlabCache::HeaderSizeC");
+
+    SlabCache::~SlabCache()
+    {
+        // #TODO: Panic if there are still objects allocated
+        if (pEmptySlab != nullptr)
+        {
+            ReleaseSlab(pEmptySlab);
+        }
+    }
+
+    void* SlabCache::Allocate()
+    {
+        // Caches are shared by every task on every CPU, so they rely on the kernel lock taken by disabling preemption
+        Scheduler::DisablePreemptingInScope const disablePreempt;
+
+        if (pPartialSlabs == nullptr)
+        {
+            auto* pslab = pEmptySlab;
+            pEmptySlab = nullptr;
+            if (pslab == nullptr)
+            {
+                pslab = CreateSlab();
+                if (pslab == nullptr)
+                {
+                    return nullptr;
+                }
+            }
+            pPartialSlabs = pslab;
+        }
+
+        auto* const pslab = pPartialSlabs;
+        void* pobject = nullptr;
+        if (pslab->pFreeList != nullptr)
+        {
+            auto* const pfreeObject = static_cast<FreeObject*>(pslab->pFreeList);
+            pslab->pFreeList = pfreeObject->pNext;
+            pobject = pfreeObject;
+        }
+        else
+        {
+            // Objects are handed out in order the first time through, so a new slab doesn't have to touch every object
+            // to build its free list
+            pobject = pslab->pNextUnused;
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            pslab->pNextUnused += ObjectSize;
+        }
+        ++pslab->InUseCount;
+
+        if (pslab->InUseCount == Capacity)
+        {
+            // Slab is full, so drop it from the partial list until something is freed back to it
+            pPartialSlabs = pslab->pNext;
+            if (pPartialSlabs != nullptr)
+            {
+                pPartialSlabs->pPrev = nullptr;
+            }
+            pslab->pNext = nullptr;
+        }
+        return pobject;
+    }
+
+    void SlabCache::Free(void* const apObject)
+    {
+        if (apObject == nullptr)
+        {
+            return;
+        }
+        Scheduler::DisablePreemptingInScope const disablePreempt;
+        auto* const pslab = FindSlab(apObject);
+        if (pslab == nullptr)
+        {
+            // #TODO: Panic, since this wasn't allocated from a slab
+            return;
+        }
+        pslab->pCache->FreeToSlab(pslab, apObject);
+    }
+
+    SlabHeader* SlabCache::CreateSlab()
+    {
+        auto* const pmemory = AllocateUnzeroedPages(SlabOrder);
+        if (pmemory == nullptr)
+        {
+            return nullptr;
+        }
+        MarkSlabFrames(pmemory, SlabOrder, true);
+
+        auto* const pslab = new (pmemory) SlabHeader{}; // NOLINT(cppcoreguidelines-owning-memory)
+        pslab->pCache = this;
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        pslab->pNextUnused = static_cast<uint8_t*>(pmemory) + FirstObjectOffset;
+        return pslab;
+    }
+
+    void SlabCache::ReleaseSlab(SlabHeader* const apSlab)
+    {
+        MarkSlabFrames(apSlab, SlabOrder, false);
+        FreePages(apSlab);
+    }
+
+    void SlabCache::FreeToSlab(SlabHeader* const apSlab, void* const apObject)
+    {
+        auto const wasFull = (apSlab->InUseCount == Capacity);
+
+        auto* const pfreeObject = new (apObject) FreeObject{ static_cast<FreeObject*>(apSlab->pFreeList) }; // NOLINT(cppcoreguidelines-owning-memory)
+        apSlab->pFreeList = pfreeObject;
+        --apSlab->InUseCount;
+
+        if (wasFull)
+        {
+            // Back on the front of the partial list, since it now has the hottest free object
+            apSlab->pPrev = nullptr;
+            apSlab->pNext = pPartialSlabs;
+            if (pPartialSlabs != nullptr)
+            {
+                pPartialSlabs->pPrev = apSlab;
+            }
+            pPartialSlabs = apSlab;
+        }
+
+        if (apSlab->InUseCount == 0)
+        {
+            // Pull the empty slab out of the partial list, and either keep it around or give it back
+            if (apSlab->pPrev != nullptr)
+            {
+                apSlab->pPrev->pNext = apSlab->pNext;
+            }
+            else
+            {
+                pPartialSlabs = apSlab->pNext;
+            }
+            if (apSlab->pNext != nullptr)
+            {
+                apSlab->pNext->pPrev = apSlab->pPrev;
+            }
+            apSlab->pNext = nullptr;
+            apSlab->pPrev = nullptr;
+
+            if (pEmptySlab == nullptr)
+            {
+                pEmptySlab = apSlab;
+            }
+            else
+            {
+                ReleaseSlab(apSlab);
+            }
+        }
+    }
+
+    void* HeapAllocate(std::size_t const aSize)
+    {
+        if (aSize > PageSize)
+        {
+            // Finding physically contiguous pages gets harder the longer we run, and nothing on the heap needs them
+            return AllocateKernelVirtual(aSize);
+        }
+        if (aSize > LargestSizeClassC)
+        {
+            return AllocateUnzeroedPages(0);
+        }
+
+        auto sizeClass = 0U;
+        while ((SmallestSizeClassC << sizeClass) < aSize)
+        {
+            ++sizeClass;
+        }
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+        return SizeClassCaches[sizeClass].Allocate();
+    }
+
+    void HeapFree(void* const apMemory)
+    {
+        if (apMemory == nullptr)
+        {
+            return;
+        }
+        if (IsKernelVirtualAddress(apMemory))
+        {
+            FreeKernelVirtual(apMemory);
+            return;
+        }
+        auto const* const pframe = GetPageFrame(apMemory);
+        if (pframe == nullptr)
+        {
+            // #TODO: Panic, since this isn't memory we handed out
+            return;
+        }
+        if ((pframe->Flags & PageFrameFlags::SlabC) != 0)
+        {
+            SlabCache::Free(apMemory);
+        }
+        else
+        {
+            FreePages(apMemory);
+        }
+    }
+}
+
+// Called by kernel_stdlib to implement operator new and delete
+extern "C"
+{
+    // NOLINTBEGIN(bugprone-reserved-identifier,cert-dcl37-c,cert-dcl51-cpp)
+    void* __kernel_stdlib_allocate(std::size_t const aSize) noexcept
+    {
+        return MemoryManager::HeapAllocate(aSize);
+    }
+
+    void __kernel_stdlib_free(void* const apBlock) noexcept
+    {
+        MemoryManager::HeapFree(apBlock);
+    }
+    // NOLINTEND(bugprone-reserved-identifier,cert-dcl37-c,cert-dcl51-cpp)
+}
\ No newline at end of file
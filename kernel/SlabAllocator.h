@@ -0,0 +1,211 @@
+#ifndef KERNEL_SLAB_ALLOCATOR_H
+#define KERNEL_SLAB_ALLOCATOR_H
+
+#include <cstddef>
+#include <cstdint>
+// Technically needed for placement new, but for some reason clang-tidy doesn't pick up on that
+#include <new> // NOLINT(misc-include-cleaner)
+#include <utility>
+#include "MemoryManager.h"
+
+namespace MemoryManager
+{
+    struct SlabHeader;
+
+    /**
+     * Cache of fixed-size objects carved out of slabs of physically contiguous pages. Freed objects are pushed onto
+     * the front of their slab's free list, and slabs with free objects are kept at the front of the cache, so the next
+     * allocation gets the most recently freed (and likely still cache-warm) object.
+     */
+    class SlabCache
+    {
+    public:
+        /**
+         * The largest number of pages in a single slab, as a buddy allocator order
+         */
+        static constexpr unsigned MaxSlabOrderC = 2;
+
+        /**
+         * Sets up a cache for the given object size. No memory is allocated until the first object is
+         * 
+         * @param aObjectSize The size of each object
+         * @param aAlignment The alignment of each object (must be a power of 2)
+         */
+        constexpr SlabCache(std::size_t const aObjectSize, std::size_t const aAlignment)
+            : ObjectSize{ RoundUp(aObjectSize < sizeof(void*) ? sizeof(void*) : aObjectSize, aAlignment < alignof(void*) ? alignof(void*) : aAlignment) }
+            , FirstObjectOffset{ RoundUp(HeaderSizeC, aAlignment) }
+        {
+            // Pick the smallest slab that fits a reasonable number of objects, so large objects don't waste most of
+            // a page each
+            while ((SlabOrder < MaxSlabOrderC) && (CalculateCapacity(SlabOrder) < MinObjectsPerSlabC))
+            {
+                ++SlabOrder;
+            }
+            Capacity = CalculateCapacity(SlabOrder);
+        }
+
+        // Disable copying/moving, since the slabs point back at their cache
+        SlabCache(SlabCache const&) = delete;
+        SlabCache(SlabCache&&) = delete;
+        SlabCache& operator=(SlabCache const&) = delete;
+        SlabCache& operator=(SlabCache&&) = delete;
+
+        /**
+         * Returns the cached empty slab to the page allocator. Any objects still allocated from the cache are leaked
+         */
+        ~SlabCache();
+
+        /**
+         * Allocates an object from the cache (uninitialized)
+         * 
+         * @return The new object, or null if out of memory
+         */
+        [[nodiscard]] void* Allocate();
+
+        /**
+         * Returns an object to the cache it was allocated from
+         * 
+         * @param apObject The object to free (may be null)
+         */
+        static void Free(void* apObject);
+
+        /**
+         * Obtains the size of each object in the cache (may be larger than requested, to fit alignment)
+         * 
+         * @return The object size
+         */
+        [[nodiscard]] constexpr std::size_t GetObjectSize() const { return ObjectSize; }
+
+        /**
+         * Obtains the number of objects each slab can hold
+         * 
+         * @return The number of objects per slab
+         */
+        [[nodiscard]] constexpr std::size_t GetObjectsPerSlab() const { return Capacity; }
+
+    private:
+        // Large enough for SlabHeader, checked in the cpp file where the header is defined
+        static constexpr std::size_t HeaderSizeC = 48;
+        static constexpr std::size_t MinObjectsPerSlabC = 8;
+
+        /**
+         * Rounds a value up to a multiple of a power of 2
+         * 
+         * @param aValue The value to round
+         * @param aMultiple The multiple to round to (must be a power of 2)
+         * @return The rounded value
+         */
+        static constexpr std::size_t RoundUp(std::size_t const aValue, std::size_t const aMultiple)
+        {
+            return (aValue + aMultiple - 1) & ~(aMultiple - 1);
+        }
+
+        /**
+         * Calculates the number of objects a slab of the given order could hold
+         * 
+         * @param aOrder The order of the slab
+         * @return The number of objects
+         */
+        [[nodiscard]] constexpr std::size_t CalculateCapacity(unsigned const aOrder) const
+        {
+            return ((PageSize << aOrder) - FirstObjectOffset) / ObjectSize;
+        }
+
+        /**
+         * Allocates a new, empty slab for this cache
+         * 
+         * @return The new slab, or null if out of memory
+         */
+        SlabHeader* CreateSlab();
+
+        /**
+         * Returns an empty slab's pages to the page allocator
+         * 
+         * @param apSlab The slab to release
+         */
+        void ReleaseSlab(SlabHeader* apSlab);
+
+        /**
+         * Returns an object to this cache
+         * 
+         * @param apSlab The slab the object came from
+         * @param apObject The object to free
+         */
+        void FreeToSlab(SlabHeader* apSlab, void* apObject);
+
+        std::size_t ObjectSize = 0;
+        std::size_t FirstObjectOffset = 0;
+        std::size_t Capacity = 0;
+        unsigned SlabOrder = 0;
+        SlabHeader* pPartialSlabs = nullptr; // slabs with at least one free object (full slabs are not tracked)
+        SlabHeader* pEmptySlab = nullptr; // a single empty slab is kept around to avoid thrashing the page allocator
+    };
+
+    /**
+     * Object cache for a specific type, which handles construction and destruction
+     */
+    template<typename T>
+    class TypedObjectCache
+    {
+    public:
+        /**
+         * Sets up the cache. No memory is allocated until the first object is
+         */
+        constexpr TypedObjectCache()
+            : Cache{ sizeof(T), alignof(T) }
+        {}
+
+        /**
+         * Allocates and constructs an object
+         * 
+         * @param aArgs Arguments to pass to the object's constructor
+         * @return The new object, or null if out of memory
+         */
+        template<typename... ArgTs>
+        [[nodiscard]] T* Allocate(ArgTs&&... aArgs)
+        {
+            auto* const pmemory = Cache.Allocate();
+            if (pmemory == nullptr)
+            {
+                return nullptr;
+            }
+            return new (pmemory) T{ std::forward<ArgTs>(aArgs)... }; // NOLINT(cppcoreguidelines-owning-memory)
+        }
+
+        /**
+         * Destructs and frees an object allocated from this cache
+         * 
+         * @param apObject The object to free (may be null)
+         */
+        void Free(T* const apObject)
+        {
+            if (apObject == nullptr)
+            {
+                return;
+            }
+            apObject->~T();
+            SlabCache::Free(apObject);
+        }
+
+    private:
+        SlabCache Cache;
+    };
+
+    /**
+     * Allocates memory from the kernel heap. Small sizes come from the size class slab caches, sizes up to a page
+     * get a whole page, and anything larger is a kernel virtual allocation (see AllocateKernelVirtual)
+     * 
+     * @param aSize The size of the memory to allocate
+     * @return The allocated memory (uninitialized), or null if out of memory
+     */
+    [[nodiscard]] void* HeapAllocate(std::size_t aSize);
+
+    /**
+     * Returns memory allocated with HeapAllocate
+     * 
+     * @param apMemory The memory to free (may be null)
+     */
+    void HeapFree(void* apMemory);
+}
+
+#endif // KERNEL_SLAB_ALLOCATOR_H
\ No newline at end of file
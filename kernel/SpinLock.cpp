@@ -0,0 +1,38 @@
+#include "SpinLock.h"
+
+namespace Sync
+{
+    void SpinLock::Lock()
+    {
+        while (!TryLock())
+        {
+            // Only read until it looks free, so the waiting CPUs aren't fighting over the cache line
+            while (__atomic_load_n(&Locked, __ATOMIC_RELAXED))
+            {
+                // Sleeps until the next event. If the lock was released between the read and here, its event is
+                // already pending and this returns straight away
+                // NOLINTNEXTLINE(hicpp-no-assembler)
+                asm volatile("wfe");
+            }
+        }
+    }
+
+    bool SpinLock::TryLock()
+    {
+        return !__atomic_exchange_n(&Locked, true, __ATOMIC_ACQUIRE);
+    }
+
+    void SpinLock::Unlock()
+    {
+        __atomic_store_n(&Locked, false, __ATOMIC_RELEASE);
+        // Make sure the store is visible before waking anyone up to look at it
+        // NOLINTNEXTLINE(hicpp-no-assembler)
+        asm volatile(
+            "dsb ish\n"
+            "sev"
+            : // no outputs
+            : // no inputs
+            : "memory"
+        );
+    }
+}
\ No newline at end of file
@@ -0,0 +1,35 @@
+#ifndef KERNEL_SPIN_LOCK_H
+#define KERNEL_SPIN_LOCK_H
+
+namespace Sync
+{
+    /**
+     * Lock for data shared between CPUs. Waiting CPUs spin (sleeping until something signals an event), so the lock
+     * should only be held for short periods, and never across anything that could wait on another CPU
+     */
+    class SpinLock
+    {
+    public:
+        /**
+         * Takes the lock, waiting until it is free
+         */
+        void Lock();
+
+        /**
+         * Takes the lock if it's free
+         * 
+         * @return True if the lock was taken
+         */
+        [[nodiscard]] bool TryLock();
+
+        /**
+         * Releases the lock, waking up anyone waiting on it
+         */
+        void Unlock();
+
+    private:
+        bool Locked = false;
+    };
+}
+
+#endif // KERNEL_SPIN_LOCK_H
\ No newline at end of file
@@ -1,6 +1,9 @@
 #include <bit>
+#include <cstdint>
 #include "MiniUart.h"
 #include "Scheduler.h"
+#include "SystemCallDefines.h"
+#include "TaskStructs.h"
 
 namespace
 {
@@ -31,6 +34,48 @@ namespace
     {
         Scheduler::ExitProcess();
     }
+
+    /**
+     * System call to move the process to another scheduling class
+     * 
+     * @param aPolicy The class to move to (one of the SCHED_POLICY_ values)
+     * @param aPriority The nice level for the fair class, or the priority for the others
+     * @return 0 if the process was moved, negative if the class or priority wasn't valid
+     */
+    int32_t SystemCallSetPolicy(uint32_t const aPolicy, int64_t const aPriority)
+    {
+        auto policy = Scheduler::SchedulingPolicy::Fair;
+        switch (aPolicy)
+        {
+        case SCHED_POLICY_FAIR:
+            policy = Scheduler::SchedulingPolicy::Fair;
+            break;
+        case SCHED_POLICY_PRIORITY:
+            policy = Scheduler::SchedulingPolicy::Priority;
+            break;
+        case SCHED_POLICY_FIFO:
+            policy = Scheduler::SchedulingPolicy::Fifo;
+            break;
+        case SCHED_POLICY_ROUND_ROBIN:
+            policy = Scheduler::SchedulingPolicy::RoundRobin;
+            break;
+        default:
+            return -1;
+        }
+        return Scheduler::SetPolicy(policy, aPriority) ? 0 : -1;
+    }
+
+    /**
+     * System call to move the process to the deadline scheduling class
+     * 
+     * @param aRuntimeUS The runtime to reserve each period, in microseconds
+     * @param aPeriodUS The length of each period, in microseconds
+     * @return 0 if the process was moved, negative if the reservation was invalid or didn't fit
+     */
+    int32_t SystemCallSetDeadline(uint32_t const aRuntimeUS, uint32_t const aPeriodUS)
+    {
+        return Scheduler::SetDeadline(aRuntimeUS, aPeriodUS) ? 0 : -1;
+    }
 }
 
 extern "C"
@@ -39,6 +84,8 @@ extern "C"
     extern const void* const p_sys_call_table_s[] = {
         std::bit_cast<const void*>(&SystemCallWrite),
         std::bit_cast<const void*>(&SystemCallFork),
-        std::bit_cast<const void*>(&SystemCallExit)
+        std::bit_cast<const void*>(&SystemCallExit),
+        std::bit_cast<const void*>(&SystemCallSetPolicy),
+        std::bit_cast<const void*>(&SystemCallSetDeadline)
     };
 }
\ No newline at end of file
@@ -6,7 +6,15 @@
 #define SYS_WRITE_INDEX 0
 #define SYS_FORK_INDEX 1
 #define SYS_EXIT_INDEX 2
+#define SYS_SET_POLICY_INDEX 3
+#define SYS_SET_DEADLINE_INDEX 4
 
-#define SYSCALL_COUNT 3
+#define SYSCALL_COUNT 5
+
+// Scheduling classes for SYS_SET_POLICY_INDEX
+#define SCHED_POLICY_FAIR 0
+#define SCHED_POLICY_PRIORITY 1
+#define SCHED_POLICY_FIFO 2
+#define SCHED_POLICY_ROUND_ROBIN 3
 
 #endif // KERNEL_SYSTEM_CALL_DEFINES_H
\ No newline at end of file
@@ -1,9 +1,9 @@
 #ifndef KERNEL_TASK_STRUCTS_H
 #define KERNEL_TASK_STRUCTS_H
 
-#include <cstddef>
 #include <cstdint>
 #include "PointerTypes.h"
+#include "RedBlackTree.h"
 
 namespace Scheduler
 {
@@ -31,34 +31,68 @@ namespace Scheduler
     enum class TaskState : int64_t
     {
         Running,
+        Blocked, // taken off its run queue at the next schedule, until Scheduler::Unblock
         Zombie
     };
 
-    constexpr std::size_t MaxProcessPagesCS = 16U;
+    struct MemoryManagerState
+    {
+        PhysicalPtr PageGlobalDirectory;
+        uint64_t ASIDContext = 0; // ASID and the generation it was handed out in (see MemoryManager::ASIDAllocator)
+        Containers::RedBlackTree Areas; // MemoryManager::VirtualMemoryArea, ordered by start address
+        uint8_t CacheColors = 0; // L2 cache colors reserved for this task alone (see MemoryManager::ReserveCacheColors)
+    };
 
-    struct UserPage
+    enum class SchedulingPolicy : uint32_t
     {
-        PhysicalPtr PhysicalAddress;
-        VirtualPtr VirtualAddress;
+        Fair, // shares the CPU with the other fair tasks by weight (see FairRunQueue)
+        Priority, // runs ahead of fair tasks, highest priority first, with longer time slices for higher priorities
+        Fifo, // runs ahead of priority tasks, highest priority first, until it gives up the CPU
+        RoundRobin, // as Fifo, but takes turns with tasks of the same priority
+        Deadline // runs ahead of everything else, earliest deadline first, for a reserved runtime each period
     };
 
-    struct MemoryManagerState
+    struct TaskStruct;
+
+    // Links a task into a FairRunQueue's or DeadlineRunQueue's tree. The node is a member rather than a base so
+    // TaskStruct stays standard layout (the assembly relies on offsetof(TaskStruct, Context)), and it must stay first
+    // so a tree node can be turned back into this
+    struct RunQueueTreeNode
     {
-        PhysicalPtr PageGlobalDirectory;
-        uint32_t UserPagesCount = 0;
-        UserPage UserPages[MaxProcessPagesCS] = {}; // NOLINT(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
-        uint32_t KernelPagesCount = 0;
-        PhysicalPtr KernelPages[MaxProcessPagesCS] = {}; // NOLINT(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+        Containers::RedBlackNode Node;
+        TaskStruct* pTask = nullptr;
     };
 
     struct TaskStruct
     {
         CPUContext Context;
         TaskState State = TaskState::Running;
-        int64_t Counter = 0; // decrements each timer tick. When reaches 0, another task will be scheduled
-        int64_t Priority = 1; // copied to Counter when a task is scheduled, so higher priority will run for longer
+        SchedulingPolicy Policy = SchedulingPolicy::Fair;
+        // Decrements each timer tick. When reaches 0, another task will be scheduled (priority and round-robin tasks
+        // only)
+        int64_t Counter = 0;
+        // Higher runs first, and priority tasks get a longer Counter (priority and real-time tasks only)
+        int64_t Priority = 1;
+        int32_t Nice = 0; // lower nice levels get a bigger share of the CPU (fair tasks only)
+        uint64_t VirtualRuntime = 0; // counter-timer cycles run, scaled by weight (fair tasks only)
+        uint64_t ExecStart = 0; // counter-timer value when the task last started running
+        // Reservation and current period, all in counter-timer cycles (deadline tasks only)
+        uint64_t DeadlineRuntime = 0; // runtime the task gets each period
+        uint64_t DeadlinePeriod = 0; // length of each period, which ends at the task's deadline
+        uint64_t AbsoluteDeadline = 0; // counter-timer value the current period ends at
+        uint64_t RemainingRuntime = 0; // runtime left in the current period
+        bool Throttled = false; // set once the task has used up its runtime, until its next period starts
         int64_t PreemptCount = 0; // If non-zero, task will not be preempted
         uint64_t Flags = 0;
+        void* pKernelStack = nullptr; // bottom of the task's kernel stack page (null for the idle tasks)
+        uint32_t CPU = 0; // the CPU whose run queue the task is on
+        bool Queued = false; // set while the task is on a run queue
+        // Links and position on the run queue (see PriorityRunQueue, FairRunQueue and DeadlineRunQueue)
+        TaskStruct* pNextQueued = nullptr;
+        TaskStruct* pPrevQueued = nullptr;
+        uint32_t QueuedArray = 0;
+        uint32_t QueuedLevel = 0;
+        RunQueueTreeNode QueuedNode;
         MemoryManagerState MemoryState;
     };
 } // Scheduler namespace
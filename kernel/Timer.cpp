@@ -25,11 +25,53 @@ namespace
     constexpr uint32_t LocalTimerClearInterruptAck = 1U << 31U;
     // constexpr uint32_t LocalTimerReload = 1U << 30U; // currently unused
 
+    // CNTP_CTL_EL0 flags (the interrupt mask bit is left clear)
+    constexpr uint64_t CoreTimerControlEnable = 1U << 0U;
+
+    CoreTimer::CallbackFunctionPtr pCoreTimerCallback = nullptr;
+    const void* pCoreTimerParam = nullptr;
+
     // Have to save this off so we can access it and set up the global timer to re-fire
     uint32_t GlobalTimerInterval = 0U;
+    // Same for the core timers, in system counter ticks
+    uint64_t CoreTimerInterval = 0U;
 
     // NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
 
+    /**
+     * Sets the calling core's physical timer to fire after the given number of system counter ticks
+     * 
+     * @param aTicks Number of ticks until the timer fires
+     */
+    void SetCoreTimerCountdown(uint64_t const aTicks)
+    {
+        // Writing the countdown also clears the interrupt condition from the last time it fired
+        // NOLINTNEXTLINE(hicpp-no-assembler)
+        asm volatile(
+            "msr cntp_tval_el0, %[ticks]"
+            : // no outputs
+            : [ticks] "r"(aTicks) // inputs
+            : // no bashed registers
+        );
+    }
+
+    /**
+     * Sets the calling core's physical timer control flags
+     * 
+     * @param aControl The flags (CoreTimerControlEnable to enable the timer, 0 to disable it)
+     */
+    void SetCoreTimerControl(uint64_t const aControl)
+    {
+        // NOLINTNEXTLINE(hicpp-no-assembler)
+        asm volatile(
+            "msr cntp_ctl_el0, %[control]\n"
+            "isb"
+            : // no outputs
+            : [control] "r"(aControl) // inputs
+            : // no bashed registers
+        );
+    }
+
     /**
      * "Sanitizes" the frequency reported by the system counter clock so it can be used to set up the local timer
      * 
@@ -128,4 +170,56 @@ namespace LocalTimer
         
         pLocalTimerCallback(pLocalTimerParam);
     }
+}
+
+namespace CoreTimer
+{
+    // Each core has its own physical timer (part of the generic timer, rather than a peripheral) which counts down
+    // from the value we give it, using the system counter. Each core has its interrupt routed to it by
+    // ExceptionVectors::EnableInterruptController, and has to set the countdown again each time it fires. An idle core
+    // can instead give it an absolute time to fire at once (or turn it off), so it isn't woken by ticks it doesn't need.
+
+    void RegisterCallback(uint32_t const aIntervalMS, CallbackFunctionPtr const apCallback, void const* const apParam)
+    {
+        pCoreTimerCallback = apCallback;
+        pCoreTimerParam = apParam;
+
+        constexpr uint64_t MSPerSecond = 1'000U;
+        CoreTimerInterval = (uint64_t{ Timing::GetSystemCounterClockFrequencyHz() } * aIntervalMS) / MSPerSecond;
+
+        RestartRepeating();
+    }
+
+    void SetOneShot(uint64_t const aCounterValue)
+    {
+        if (aCounterValue == UINT64_MAX)
+        {
+            SetCoreTimerControl(0);
+            return;
+        }
+        // Unlike the countdown, the compare value is absolute, so there's no drift between reading the counter and
+        // setting it (writing it also clears the interrupt condition, unless the time has already passed)
+        // NOLINTNEXTLINE(hicpp-no-assembler)
+        asm volatile(
+            "msr cntp_cval_el0, %[value]"
+            : // no outputs
+            : [value] "r"(aCounterValue) // inputs
+            : // no bashed registers
+        );
+        SetCoreTimerControl(CoreTimerControlEnable);
+    }
+
+    void RestartRepeating()
+    {
+        SetCoreTimerCountdown(CoreTimerInterval);
+        SetCoreTimerControl(CoreTimerControlEnable);
+    }
+
+    void HandleIRQ()
+    {
+        // set up the timer to trigger again
+        SetCoreTimerCountdown(CoreTimerInterval);
+
+        pCoreTimerCallback(pCoreTimerParam);
+    }
 }
\ No newline at end of file
@@ -45,4 +45,39 @@ namespace LocalTimer
     void HandleIRQ();
 }
 
+namespace CoreTimer
+{
+    // Triggered every timer tick
+    using CallbackFunctionPtr = void(*)(void const* apParam);
+
+    /**
+     * Set up the calling core's timer to fire repeatedly with a certain interval and trigger the specified callback.
+     * Each core has its own timer, so every core that wants ticks has to call this. The callback is shared by all
+     * cores, and any existing callback will be overwritten.
+     * 
+     * @param aIntervalMS Amount of time between callbacks firing in milliseconds
+     * @param apCallback Function to triggers when the interrupt fires
+     * @param apParam Parameter to send to the function
+     */
+    void RegisterCallback(uint32_t aIntervalMS, CallbackFunctionPtr apCallback, void const* apParam);
+
+    /**
+     * Stops the calling core's repeating timer, and has it fire once at the given time instead. Firing goes back to
+     * repeating at the registered interval
+     * 
+     * @param aCounterValue The system counter value to fire at, or UINT64_MAX to not fire at all
+     */
+    void SetOneShot(uint64_t aCounterValue);
+
+    /**
+     * Starts the calling core's timer repeating at the registered interval again, counting from now
+     */
+    void RestartRepeating();
+
+    /**
+     * Handle an interrupt from the calling core's timer
+     */
+    void HandleIRQ();
+}
+
 #endif // KERNEL_TIMER_H
\ No newline at end of file
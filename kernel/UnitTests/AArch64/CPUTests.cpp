@@ -15,6 +15,14 @@ namespace UnitTests::AArch64::CPU
             EmitTestResult(::AArch64::CPU::GetCurrentExceptionLevel() == ::AArch64::CPU::ExceptionLevel::EL1, "Exception level");
         }
 
+        /**
+         * Test to make sure the tests are run by the boot core
+         */
+        void CurrentCoreTest()
+        {
+            EmitTestResult(::AArch64::CPU::GetCurrentCore() == 0, "Current core");
+        }
+
         /**
          * Test to make sure floating point instructions are enabled and working
          */
@@ -74,6 +82,7 @@ namespace UnitTests::AArch64::CPU
     void Run()
     {
         ExceptionLevelTest();
+        CurrentCoreTest();
         FloatingPointTest();
         SIMDTest();
     }
@@ -54,6 +54,19 @@ namespace UnitTests::AArch64::MemoryDescriptor
                 && !::AArch64::Descriptor::Fault::IsType(0b11)
                 , "Fault descriptor IsType with just type bits");
             EmitTestResult(::AArch64::Descriptor::Fault::IsType(0b1100), "Fault descriptor with non type bits");
+
+            // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+            uint64_t buffer[3] = { 0xFF, 0xFF, 0xFF };
+            ::AArch64::Descriptor::Fault::Write(testDescriptor, static_cast<uint64_t*>(buffer), 1);
+            EmitTestResult(buffer[0] == 0xFF
+                && buffer[1] == 0
+                && buffer[2] == 0xFF
+                , "Fault descriptor Write");
+
+            ::AArch64::Descriptor::Fault const valueDescriptor{ 0x1234'5670ULL | 0b11 };
+            EmitTestResult(valueDescriptor.Value() == 0x1234'5670ULL && ::AArch64::Descriptor::Fault::IsType(valueDescriptor.Value()), "Fault descriptor carries a value, without the type bits");
+            ::AArch64::Descriptor::Fault::Write(valueDescriptor, static_cast<uint64_t*>(buffer), 1);
+            EmitTestResult(buffer[1] == 0x1234'5670ULL, "Fault descriptor Write with a value");
         }
 
         /**
@@ -141,6 +154,46 @@ namespace UnitTests::AArch64::MemoryDescriptor
             EmitTestResult(Details::TestAccessor::GetDescriptorValue(testDescriptor) == (prevDescriptorValue | (static_cast<uint32_t>(rawAF) << 10U))
                 && rawAF == readAF
                 , "Block {} descriptor AF get/set", apBlockTypeName);
+
+            prevDescriptorValue = Details::TestAccessor::GetDescriptorValue(testDescriptor);
+
+            // SH [9:8]
+            auto const rawSH = BlockT::Shareability::InnerShareable; // 0b11
+            testDescriptor.SH(rawSH);
+            auto const readSH = testDescriptor.SH();
+            EmitTestResult(Details::TestAccessor::GetDescriptorValue(testDescriptor) == (prevDescriptorValue | (static_cast<uint32_t>(rawSH) << 8U))
+                && rawSH == readSH
+                , "Block {} descriptor SH get/set", apBlockTypeName);
+
+            prevDescriptorValue = Details::TestAccessor::GetDescriptorValue(testDescriptor);
+
+            // nG [11]
+            auto const rawNG = true;
+            testDescriptor.nG(rawNG);
+            auto const readNG = testDescriptor.nG();
+            EmitTestResult(Details::TestAccessor::GetDescriptorValue(testDescriptor) == (prevDescriptorValue | (static_cast<uint32_t>(rawNG) << 11U))
+                && rawNG == readNG
+                , "Block {} descriptor nG get/set", apBlockTypeName);
+
+            prevDescriptorValue = Details::TestAccessor::GetDescriptorValue(testDescriptor);
+
+            // Software [58:55]
+            auto const rawSoftware = 0b1010;
+            testDescriptor.Software(rawSoftware);
+            auto const readSoftware = testDescriptor.Software();
+            EmitTestResult(Details::TestAccessor::GetDescriptorValue(testDescriptor) == (prevDescriptorValue | (static_cast<uint64_t>(rawSoftware) << 55U))
+                && rawSoftware == readSoftware
+                , "Block {} descriptor Software get/set", apBlockTypeName);
+
+            prevDescriptorValue = Details::TestAccessor::GetDescriptorValue(testDescriptor);
+
+            // Contiguous [52]
+            auto const rawContiguous = true;
+            testDescriptor.Contiguous(rawContiguous);
+            auto const readContiguous = testDescriptor.Contiguous();
+            EmitTestResult(Details::TestAccessor::GetDescriptorValue(testDescriptor) == (prevDescriptorValue | (static_cast<uint64_t>(rawContiguous) << 52U))
+                && rawContiguous == readContiguous
+                , "Block {} descriptor Contiguous get/set", apBlockTypeName);
             
             // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
             uint64_t buffer[3] = {};
@@ -195,6 +248,38 @@ namespace UnitTests::AArch64::MemoryDescriptor
             EmitTestResult(Details::TestAccessor::GetDescriptorValue(testDescriptor) == 0x0000'FEFE'FEFE'F4D7
                 && rawAF == readAF
                 , "Page descriptor AF get/set");
+
+            // Software [58:55]
+            auto const rawSoftware = 0b1010;
+            testDescriptor.Software(rawSoftware);
+            auto const readSoftware = testDescriptor.Software();
+            EmitTestResult(Details::TestAccessor::GetDescriptorValue(testDescriptor) == 0x0500'FEFE'FEFE'F4D7
+                && rawSoftware == readSoftware
+                , "Page descriptor Software get/set");
+
+            // SH [9:8]
+            auto const rawSH = ::AArch64::Descriptor::Page::Shareability::InnerShareable; // 0b11
+            testDescriptor.SH(rawSH);
+            auto const readSH = testDescriptor.SH();
+            EmitTestResult(Details::TestAccessor::GetDescriptorValue(testDescriptor) == 0x0500'FEFE'FEFE'F7D7
+                && rawSH == readSH
+                , "Page descriptor SH get/set");
+
+            // nG [11]
+            auto const rawNG = true;
+            testDescriptor.nG(rawNG);
+            auto const readNG = testDescriptor.nG();
+            EmitTestResult(Details::TestAccessor::GetDescriptorValue(testDescriptor) == 0x0500'FEFE'FEFE'FFD7
+                && rawNG == readNG
+                , "Page descriptor nG get/set");
+
+            // Contiguous [52]
+            auto const rawContiguous = true;
+            testDescriptor.Contiguous(rawContiguous);
+            auto const readContiguous = testDescriptor.Contiguous();
+            EmitTestResult(Details::TestAccessor::GetDescriptorValue(testDescriptor) == 0x0510'FEFE'FEFE'FFD7
+                && rawContiguous == readContiguous
+                , "Page descriptor Contiguous get/set");
             
             // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
             uint64_t buffer[3] = {};
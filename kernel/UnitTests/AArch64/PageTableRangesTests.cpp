@@ -0,0 +1,456 @@
+#include "PageTableRangesTests.h"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "../../AArch64/MemoryDescriptor.h"
+#include "../../AArch64/MemoryPageTables.h"
+#include "../../AArch64/PageTableRanges.h"
+#include "../../MemoryManager.h"
+#include "../../PointerTypes.h"
+#include "../../Utils.h"
+#include "../Framework.h"
+
+// Using a lot of "magic numbers" in tests, so just silence the lint for the file
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+
+namespace UnitTests::AArch64::PageTableRanges
+{
+    namespace
+    {
+        using ::MemoryManager::PageSize;
+
+        constexpr auto MaxTestTablesC = 6U;
+
+        // NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+        // #TODO: Remove lint tag when we get std::array
+        // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+        alignas(PageSize) uint64_t TestTableMemory[MaxTestTablesC][::AArch64::PageTable::PointersPerTable];
+        // NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+        /**
+         * Hands out tables from our test memory, which is in the kernel image and so is offset-mapped
+         */
+        class TestTables
+        {
+        public:
+            /**
+             * Sets up the tables, clearing out anything left by a previous test
+             * 
+             * @param aTableLimit How many tables may be allocated
+             */
+            explicit TestTables(unsigned const aTableLimit)
+                : TableLimit{ aTableLimit }
+            {
+                memset(static_cast<void*>(TestTableMemory), 0, sizeof(TestTableMemory));
+            }
+
+            /**
+             * Allocates the next test table
+             * 
+             * @return The physical address of the table, or null if we're at the limit
+             */
+            PhysicalPtr AllocateTable()
+            {
+                if (TablesAllocated >= TableLimit)
+                {
+                    return PhysicalPtr{};
+                }
+                // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+                auto const tableVA = std::bit_cast<uintptr_t>(&TestTableMemory[TablesAllocated][0]);
+                ++TablesAllocated;
+                return PhysicalPtr{ tableVA - ::MemoryManager::KernelVirtualAddressOffset };
+            }
+
+            /**
+             * Converts a table's physical address into a pointer
+             * 
+             * @param aTable The table's physical address
+             * @return The pointer to the table
+             */
+            static uint64_t* GetTablePointer(PhysicalPtr const aTable)
+            {
+                return std::bit_cast<uint64_t*>(aTable.GetAddress() + ::MemoryManager::KernelVirtualAddressOffset);
+            }
+
+            /**
+             * Obtains the number of tables allocated so far
+             * 
+             * @return The allocated table count
+             */
+            [[nodiscard]] unsigned GetTablesAllocated() const { return TablesAllocated; }
+
+            /**
+             * Records a run of pages being invalidated
+             * 
+             * @param aStart The virtual address of the first page
+             * @param aSize The size of the run in bytes
+             */
+            void InvalidateRun(VirtualPtr const aStart, size_t const aSize) const
+            {
+                ++RunsInvalidated;
+                LastInvalidatedStart = aStart;
+                LastInvalidatedSize = aSize;
+            }
+
+            /**
+             * Obtains the number of runs invalidated so far
+             * 
+             * @return The invalidated run count
+             */
+            [[nodiscard]] unsigned GetRunsInvalidated() const { return RunsInvalidated; }
+
+            /**
+             * Obtains the start of the last run invalidated
+             * 
+             * @return The virtual address of the run
+             */
+            [[nodiscard]] VirtualPtr GetLastInvalidatedStart() const { return LastInvalidatedStart; }
+
+            /**
+             * Obtains the size of the last run invalidated
+             * 
+             * @return The size of the run in bytes
+             */
+            [[nodiscard]] size_t GetLastInvalidatedSize() const { return LastInvalidatedSize; }
+
+        private:
+            unsigned TableLimit = 0;
+            unsigned TablesAllocated = 0;
+            // The operations only get const access for invalidating
+            mutable unsigned RunsInvalidated = 0;
+            mutable VirtualPtr LastInvalidatedStart;
+            mutable size_t LastInvalidatedSize = 0;
+        };
+
+        /**
+         * Looks up the page descriptor for an address
+         * 
+         * @param aRoot The root table
+         * @param arTables The tables
+         * @param aAddress The address to look up
+         * @param arDescriptor OUT: The descriptor, if the address is mapped
+         * @return True if the address is mapped to a page
+         */
+        bool LookUpPage(::AArch64::PageTable::Level0View const aRoot, TestTables& arTables, VirtualPtr const aAddress,
+            ::AArch64::Descriptor::Page& arDescriptor)
+        {
+            auto* const ppageTable = ::AArch64::PageTable::FindPageTable<false>(aRoot, aAddress, arTables);
+            if (ppageTable == nullptr)
+            {
+                return false;
+            }
+            auto found = false;
+            ::AArch64::PageTable::Level3View{ ppageTable }.GetEntryForVA(aAddress).Visit(Overloaded{
+                [](::AArch64::Descriptor::Fault) {},
+                [&found, &arDescriptor](::AArch64::Descriptor::Page const aDescriptor)
+                {
+                    found = true;
+                    arDescriptor = aDescriptor;
+                }
+            });
+            return found;
+        }
+
+        // Four pages straddling a 2MB boundary, so two last level tables are needed
+        constexpr auto TestStartC = VirtualPtr{ 0x1F'E000 };
+        constexpr auto TestPageCountC = 4U;
+        constexpr auto TestPAC = PhysicalPtr{ 0x8000'0000 };
+
+        /**
+         * Maps the test range
+         * 
+         * @param arTables The tables to map into
+         * @return The root table
+         */
+        ::AArch64::PageTable::Level0View MapTestRange(TestTables& arTables)
+        {
+            auto const root = ::AArch64::PageTable::Level0View{ TestTables::GetTablePointer(arTables.AllocateTable()) };
+            ::AArch64::Descriptor::Page attributes;
+            attributes.AF(true);
+            attributes.AP(::AArch64::Descriptor::Page::AccessPermissions::KernelRWUserRW);
+            ::AArch64::PageTable::MapRange(root, TestStartC, TestPageCountC * PageSize, TestPAC, attributes, arTables);
+            return root;
+        }
+
+        /**
+         * Ensure a range is mapped to consecutive pages with the requested attributes
+         */
+        void MapRangeTest()
+        {
+            TestTables tables{ MaxTestTablesC };
+            auto const root = MapTestRange(tables);
+            EmitTestResult(tables.GetTablesAllocated() == 5, "MapRange makes each table once");
+
+            auto allMapped = true;
+            for (auto curPage = 0U; curPage < TestPageCountC; ++curPage)
+            {
+                ::AArch64::Descriptor::Page descriptor;
+                allMapped = allMapped && LookUpPage(root, tables, TestStartC.Offset(curPage * PageSize), descriptor)
+                    && (descriptor.Address() == TestPAC.Offset(curPage * PageSize))
+                    && (descriptor.AP() == ::AArch64::Descriptor::Page::AccessPermissions::KernelRWUserRW)
+                    && descriptor.AF();
+            }
+            EmitTestResult(allMapped, "MapRange maps every page in the range");
+
+            ::AArch64::Descriptor::Page descriptor;
+            EmitTestResult(!LookUpPage(root, tables, TestStartC.Offset(TestPageCountC * PageSize), descriptor), "MapRange stops at the end of the range");
+
+            TestTables limitedTables{ 4 };
+            auto const limitedRoot = ::AArch64::PageTable::Level0View{ TestTables::GetTablePointer(limitedTables.AllocateTable()) };
+            EmitTestResult(!::AArch64::PageTable::MapRange(limitedRoot, TestStartC, TestPageCountC * PageSize, TestPAC, ::AArch64::Descriptor::Page{}, limitedTables),
+                "MapRange fails when out of tables");
+        }
+
+        /**
+         * Ensure protecting a range only changes mapped pages in the range
+         */
+        void ProtectRangeTest()
+        {
+            TestTables tables{ MaxTestTablesC };
+            auto const root = MapTestRange(tables);
+
+            // Starts a page before the mapping, to make sure unmapped pages are skipped
+            ::AArch64::PageTable::ProtectRange(root, TestStartC.Offset(0 - PageSize), 3 * PageSize, ::AArch64::Descriptor::Page::AccessPermissions::KernelROUserRO, tables);
+
+            ::AArch64::Descriptor::Page before;
+            EmitTestResult(!LookUpPage(root, tables, TestStartC.Offset(0 - PageSize), before), "ProtectRange doesn't map unmapped pages");
+
+            auto permissionsCorrect = true;
+            for (auto curPage = 0U; curPage < TestPageCountC; ++curPage)
+            {
+                ::AArch64::Descriptor::Page descriptor;
+                auto const expected = (curPage < 2) ? ::AArch64::Descriptor::Page::AccessPermissions::KernelROUserRO : ::AArch64::Descriptor::Page::AccessPermissions::KernelRWUserRW;
+                permissionsCorrect = permissionsCorrect && LookUpPage(root, tables, TestStartC.Offset(curPage * PageSize), descriptor)
+                    && (descriptor.AP() == expected)
+                    && (descriptor.Address() == TestPAC.Offset(curPage * PageSize));
+            }
+            EmitTestResult(permissionsCorrect, "ProtectRange changes permissions on just the range");
+        }
+
+        /**
+         * Ensure unmapping a range removes the pages and reports each one
+         */
+        void UnmapRangeTest()
+        {
+            TestTables tables{ MaxTestTablesC };
+            auto const root = MapTestRange(tables);
+
+            auto unmappedCount = 0U;
+            auto reportsCorrect = true;
+            ::AArch64::PageTable::UnmapRange(root, TestStartC.Offset(PageSize), TestPageCountC * PageSize, tables,
+                [&unmappedCount, &reportsCorrect](VirtualPtr const aAddress, ::AArch64::Descriptor::Page const aDescriptor)
+                {
+                    ++unmappedCount;
+                    reportsCorrect = reportsCorrect
+                        && (aDescriptor.Address().GetAddress() - TestPAC.GetAddress() == aAddress.GetAddress() - TestStartC.GetAddress());
+                });
+            EmitTestResult(unmappedCount == TestPageCountC - 1 && reportsCorrect, "UnmapRange reports each mapped page");
+
+            ::AArch64::Descriptor::Page descriptor;
+            EmitTestResult(LookUpPage(root, tables, TestStartC, descriptor)
+                && !LookUpPage(root, tables, TestStartC.Offset(PageSize), descriptor)
+                && !LookUpPage(root, tables, TestStartC.Offset((TestPageCountC - 1) * PageSize), descriptor)
+                , "UnmapRange removes just the range");
+
+            // A huge range with no tables should be skipped without touching anything
+            unmappedCount = 0;
+            ::AArch64::PageTable::UnmapRange(root, VirtualPtr{ 0x80'0000'0000 }, 0x80'0000'0000, tables,
+                [&unmappedCount](VirtualPtr, ::AArch64::Descriptor::Page)
+                {
+                    ++unmappedCount;
+                });
+            EmitTestResult(unmappedCount == 0 && tables.GetTablesAllocated() == 5, "UnmapRange skips missing tables");
+        }
+
+        /**
+         * Ensure block mapping uses blocks where aligned and pages elsewhere
+         */
+        void MapRangeWithBlocksTest()
+        {
+            // A page-aligned start, then a 2MB aligned block, then a page past the block
+            constexpr auto blockVA = VirtualPtr{ 0x20'0000 };
+            constexpr auto blockPA = PhysicalPtr{ 0x8020'0000 };
+            constexpr auto blockStartVA = VirtualPtr{ blockVA.GetAddress() - 2 * PageSize };
+            constexpr auto blockStartPA = PhysicalPtr{ blockPA.GetAddress() - 2 * PageSize };
+            constexpr auto blockSize = 2 * PageSize + ::MemoryManager::L2BlockSize + PageSize;
+
+            TestTables tables{ MaxTestTablesC };
+            auto const root = ::AArch64::PageTable::Level0View{ TestTables::GetTablePointer(tables.AllocateTable()) };
+            ::AArch64::Descriptor::Page attributes;
+            attributes.AF(true);
+            attributes.AP(::AArch64::Descriptor::Page::AccessPermissions::KernelRWUserNone);
+            attributes.nG(true);
+            auto const mapped = ::AArch64::PageTable::MapRangeWithBlocks(root, blockStartVA, blockSize, blockStartPA, attributes, tables);
+            EmitTestResult(mapped && tables.GetTablesAllocated() == 5, "MapRangeWithBlocks only makes page tables around the block");
+
+            ::AArch64::Descriptor::Page descriptor;
+            EmitTestResult(LookUpPage(root, tables, blockStartVA, descriptor) && (descriptor.Address() == blockStartPA)
+                && LookUpPage(root, tables, blockVA.Offset(::MemoryManager::L2BlockSize), descriptor)
+                && (descriptor.Address() == blockPA.Offset(::MemoryManager::L2BlockSize))
+                && !LookUpPage(root, tables, blockVA.Offset(::MemoryManager::L2BlockSize + PageSize), descriptor)
+                , "MapRangeWithBlocks maps the unaligned ends with pages");
+
+            auto* const plevel1 = ::AArch64::PageTable::Details::GetLowerTable<false>(root, blockVA, tables);
+            auto* const plevel2 = ::AArch64::PageTable::Details::GetLowerTable<false>(::AArch64::PageTable::Level1View{ plevel1 }, blockVA, tables);
+            auto blockCorrect = false;
+            ::AArch64::PageTable::Level2View{ plevel2 }.GetEntryForVA(blockVA).Visit(Overloaded{
+                [&blockCorrect, blockPA](::AArch64::Descriptor::L2Block const aBlock)
+                {
+                    blockCorrect = (aBlock.Address() == blockPA)
+                        && (aBlock.AP() == ::AArch64::Descriptor::L2Block::AccessPermissions::KernelRWUserNone)
+                        && aBlock.AF() && aBlock.nG();
+                },
+                [](auto) {}
+            });
+            EmitTestResult(blockCorrect, "MapRangeWithBlocks maps the aligned middle with a 2MB block");
+
+            // A 1GB aligned range should only need the level 1 table
+            constexpr auto hugeAddress = 0x4000'0000ULL;
+            TestTables hugeTables{ MaxTestTablesC };
+            auto const hugeRoot = ::AArch64::PageTable::Level0View{ TestTables::GetTablePointer(hugeTables.AllocateTable()) };
+            auto const hugeMapped = ::AArch64::PageTable::MapRangeWithBlocks(hugeRoot, VirtualPtr{ hugeAddress }, hugeAddress, PhysicalPtr{ hugeAddress }, attributes, hugeTables);
+            auto* const phugeLevel1 = ::AArch64::PageTable::Details::GetLowerTable<false>(hugeRoot, VirtualPtr{ hugeAddress }, hugeTables);
+            auto hugeCorrect = false;
+            ::AArch64::PageTable::Level1View{ phugeLevel1 }.GetEntryForVA(VirtualPtr{ hugeAddress }).Visit(Overloaded{
+                [&hugeCorrect, hugeAddress](::AArch64::Descriptor::L1Block const aBlock)
+                {
+                    hugeCorrect = (aBlock.Address() == PhysicalPtr{ hugeAddress });
+                },
+                [](auto) {}
+            });
+            EmitTestResult(hugeMapped && hugeCorrect && hugeTables.GetTablesAllocated() == 2, "MapRangeWithBlocks maps 1GB blocks");
+        }
+
+        /**
+         * Ensure a block can be turned into a table of pages covering the same memory
+         */
+        void MakeTableFromBlockTest()
+        {
+            constexpr auto blockVA = VirtualPtr{ 0x20'0000 };
+            constexpr auto blockPA = PhysicalPtr{ 0x8020'0000 };
+
+            TestTables tables{ MaxTestTablesC };
+            auto const root = ::AArch64::PageTable::Level0View{ TestTables::GetTablePointer(tables.AllocateTable()) };
+            EmitTestResult(::AArch64::PageTable::FindBlockTable<false>(root, blockVA, tables) == nullptr, "FindBlockTable doesn't make tables unless asked");
+            auto* const plevel2 = ::AArch64::PageTable::FindBlockTable<true>(root, blockVA, tables);
+            EmitTestResult(plevel2 != nullptr && tables.GetTablesAllocated() == 3, "FindBlockTable makes the level 1 and 2 tables");
+
+            ::AArch64::Descriptor::L2Block block;
+            block.Address(blockPA);
+            block.AF(true);
+            block.AP(::AArch64::Descriptor::L2Block::AccessPermissions::KernelROUserRO);
+            block.nG(true);
+            block.Software(0b0101);
+            auto const newTable = ::AArch64::PageTable::MakeTableFromBlock(block, tables);
+            EmitTestResult(newTable != PhysicalPtr{}, "MakeTableFromBlock makes a table");
+
+            ::AArch64::Descriptor::Table tableDescriptor;
+            tableDescriptor.Address(newTable);
+            ::AArch64::PageTable::Level2View{ plevel2 }.SetEntryForVA(blockVA, tableDescriptor);
+
+            auto allPages = true;
+            for (auto curPage = 0U; curPage < ::AArch64::PageTable::PointersPerTable; ++curPage)
+            {
+                ::AArch64::Descriptor::Page descriptor;
+                allPages = allPages && LookUpPage(root, tables, blockVA.Offset(curPage * PageSize), descriptor)
+                    && (descriptor.Address() == blockPA.Offset(curPage * PageSize))
+                    && (descriptor.AP() == ::AArch64::Descriptor::Page::AccessPermissions::KernelROUserRO)
+                    && descriptor.AF() && descriptor.nG() && (descriptor.Software() == 0b0101) && descriptor.Contiguous();
+            }
+            EmitTestResult(allPages, "MakeTableFromBlock maps every page of the block with the block's attributes");
+        }
+
+        /**
+         * Checks the contiguous hint on a run of pages
+         * 
+         * @param aRoot The root table
+         * @param arTables The tables
+         * @param aStart The first page to check
+         * @param aPageCount The number of pages to check
+         * @param aExpected The expected hint value
+         * @return True if every page is mapped and has the expected hint
+         */
+        bool CheckContiguous(::AArch64::PageTable::Level0View const aRoot, TestTables& arTables, VirtualPtr const aStart,
+            unsigned const aPageCount, bool const aExpected)
+        {
+            auto allMatch = true;
+            for (auto curPage = 0U; curPage < aPageCount; ++curPage)
+            {
+                ::AArch64::Descriptor::Page descriptor;
+                allMatch = allMatch && LookUpPage(aRoot, arTables, aStart.Offset(curPage * PageSize), descriptor)
+                    && (descriptor.Contiguous() == aExpected);
+            }
+            return allMatch;
+        }
+
+        /**
+         * Ensure aligned runs get the contiguous hint, and lose it when only part of them changes
+         */
+        void ContiguousHintTest()
+        {
+            // A page either side of an aligned 64KB run
+            constexpr auto runVA = VirtualPtr{ 0x11'0000 };
+            constexpr auto runPA = PhysicalPtr{ 0x8011'0000 };
+            constexpr auto runPages = 16U;
+
+            TestTables tables{ MaxTestTablesC };
+            auto const root = ::AArch64::PageTable::Level0View{ TestTables::GetTablePointer(tables.AllocateTable()) };
+            ::AArch64::Descriptor::Page attributes;
+            attributes.AF(true);
+            attributes.AP(::AArch64::Descriptor::Page::AccessPermissions::KernelRWUserRW);
+            ::AArch64::PageTable::MapRange(root, runVA.Offset(0 - PageSize), (runPages + 2) * PageSize, runPA.Offset(0 - PageSize), attributes, tables);
+            EmitTestResult(CheckContiguous(root, tables, runVA, runPages, true)
+                && CheckContiguous(root, tables, runVA.Offset(0 - PageSize), 1, false)
+                && CheckContiguous(root, tables, runVA.Offset(runPages * PageSize), 1, false)
+                , "MapRange hints just the aligned run");
+
+            ::AArch64::PageTable::ProtectRange(root, runVA, runPages * PageSize, ::AArch64::Descriptor::Page::AccessPermissions::KernelROUserRO, tables);
+            EmitTestResult(CheckContiguous(root, tables, runVA, runPages, true) && (tables.GetRunsInvalidated() == 0),
+                "ProtectRange keeps the hint on a whole run");
+
+            ::AArch64::PageTable::ProtectRange(root, runVA.Offset(4 * PageSize), PageSize, ::AArch64::Descriptor::Page::AccessPermissions::KernelRWUserRW, tables);
+            EmitTestResult(CheckContiguous(root, tables, runVA, runPages, false), "ProtectRange breaks up a partially changed run");
+            EmitTestResult((tables.GetRunsInvalidated() == 1) && (tables.GetLastInvalidatedStart() == runVA) &&
+                (tables.GetLastInvalidatedSize() == runPages * PageSize), "Breaking up a run invalidates the whole run once");
+
+            // Misaligned physical memory can't use the hint
+            TestTables misalignedTables{ MaxTestTablesC };
+            auto const misalignedRoot = ::AArch64::PageTable::Level0View{ TestTables::GetTablePointer(misalignedTables.AllocateTable()) };
+            ::AArch64::PageTable::MapRange(misalignedRoot, runVA, runPages * PageSize, runPA.Offset(PageSize), attributes, misalignedTables);
+            EmitTestResult(CheckContiguous(misalignedRoot, misalignedTables, runVA, runPages, false), "MapRange doesn't hint misaligned physical memory");
+
+            // 16 2MB blocks make a contiguous run, but a 17th on its own doesn't
+            constexpr auto blockRunAddress = 0x200'0000ULL;
+            TestTables blockTables{ MaxTestTablesC };
+            auto const blockRoot = ::AArch64::PageTable::Level0View{ TestTables::GetTablePointer(blockTables.AllocateTable()) };
+            ::AArch64::PageTable::MapRangeWithBlocks(blockRoot, VirtualPtr{ blockRunAddress }, blockRunAddress + ::MemoryManager::L2BlockSize, PhysicalPtr{ blockRunAddress }, attributes, blockTables);
+            auto* const plevel2 = ::AArch64::PageTable::FindBlockTable<false>(blockRoot, VirtualPtr{ blockRunAddress }, blockTables);
+            auto hintedBlocks = 0U;
+            for (auto curBlock = 0U; curBlock < 17; ++curBlock)
+            {
+                ::AArch64::PageTable::Level2View{ plevel2 }.GetEntryForVA(VirtualPtr{ blockRunAddress + (curBlock * ::MemoryManager::L2BlockSize) }).Visit(Overloaded{
+                    [&hintedBlocks](::AArch64::Descriptor::L2Block const aBlock)
+                    {
+                        hintedBlocks += aBlock.Contiguous() ? 1U : 0U;
+                    },
+                    [](auto) {}
+                });
+            }
+            EmitTestResult(hintedBlocks == 16, "MapRangeWithBlocks hints aligned runs of blocks");
+        }
+    }
+
+    void Run()
+    {
+        MapRangeTest();
+        ProtectRangeTest();
+        UnmapRangeTest();
+        MapRangeWithBlocksTest();
+        MakeTableFromBlockTest();
+        ContiguousHintTest();
+    }
+}
+
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
\ No newline at end of file
@@ -0,0 +1,12 @@
+#ifndef KERNEL_UNITTESTS_AARCH64_PAGETABLERANGESTESTS_H
+#define KERNEL_UNITTESTS_AARCH64_PAGETABLERANGESTESTS_H
+
+namespace UnitTests::AArch64::PageTableRanges
+{
+    /**
+     * Run all runtime tests
+     */
+    void Run();
+}
+
+#endif // KERNEL_UNITTESTS_AARCH64_PAGETABLERANGESTESTS_H
\ No newline at end of file
@@ -62,6 +62,31 @@ namespace UnitTests::AArch64::SystemRegisters
         // development continues, I'm not sure of a better way to do it. At least by hand-writing the code in the tests
         // the hope is that any typos will be caught (i.e. if Read is reading the wrong register).
 
+        /**
+         * Test the CNTHCTL_EL2 register wrapper
+         */
+        void CNTHCTL_EL2Test()
+        {
+            ::AArch64::CNTHCTL_EL2 testRegister;
+            EmitTestResult(Details::TestAccessor::GetRegisterValue(testRegister) == 0, "CNTHCTL_EL2 default value");
+
+            // EL1PCTEN [0]
+            testRegister.EL1PCTEN(true);
+            auto const readEL1PCTEN = testRegister.EL1PCTEN();
+            EmitTestResult(Details::TestAccessor::GetRegisterValue(testRegister) == 0x1
+                && readEL1PCTEN
+                , "CNTHCTL_EL2 EL1PCTEN get/set");
+
+            // EL1PCEN [1]
+            testRegister.EL1PCEN(true);
+            auto const readEL1PCEN = testRegister.EL1PCEN();
+            EmitTestResult(Details::TestAccessor::GetRegisterValue(testRegister) == 0x3
+                && readEL1PCEN
+                , "CNTHCTL_EL2 EL1PCEN get/set");
+
+            // Read/Write not tested as we're running in EL1, and it can only be read/written in EL2
+        }
+
         /**
          * Test the CPACR_EL1 register wrapper
          */
@@ -139,6 +164,34 @@ namespace UnitTests::AArch64::SystemRegisters
             // Read/Write not tested as we're running in EL1, and it can only be read/written in EL2
         }
 
+        /**
+         * Test the ID_AA64MMFR0_EL1 register wrapper
+         */
+        void ID_AA64MMFR0_EL1Test()
+        {
+            ::AArch64::ID_AA64MMFR0_EL1 const testRegister;
+            EmitTestResult(Details::TestAccessor::GetRegisterValue(testRegister) == 0, "ID_AA64MMFR0_EL1 default value");
+
+            // clang-tidy doesn't pick up on this being an output variable
+            // NOLINTNEXTLINE(misc-const-correctness)
+            uint64_t readRawValue = 0;
+            // NOLINTNEXTLINE(hicpp-no-assembler)
+            asm volatile(
+                "mrs %[value], id_aa64mmfr0_el1"
+                :[value] "=r"(readRawValue) // outputs
+                : // no inputs
+                : // no bashed registers
+            );
+            auto const readRegister = ::AArch64::ID_AA64MMFR0_EL1::Read();
+            EmitTestResult(Details::TestAccessor::GetRegisterValue(readRegister) == readRawValue, "ID_AA64MMFR0_EL1 read");
+
+            // ASIDBits [7:4]
+            auto const readASIDBits = readRegister.ASIDBits();
+            EmitTestResult(static_cast<uint64_t>(readASIDBits) == ((readRawValue >> 4U) & 0b1111U)
+                && (readASIDBits == ::AArch64::ID_AA64MMFR0_EL1::ASIDSize::Bits8 || readASIDBits == ::AArch64::ID_AA64MMFR0_EL1::ASIDSize::Bits16)
+                , "ID_AA64MMFR0_EL1 ASIDBits get");
+        }
+
         /**
          * Test the MAIR_EL1 Attribute wrapper
          */
@@ -146,11 +199,13 @@ namespace UnitTests::AArch64::SystemRegisters
         {
             auto const normal = ::AArch64::MAIR_EL1::Attribute::NormalMemory();
             auto const device = ::AArch64::MAIR_EL1::Attribute::DeviceMemory();
+            auto const cacheable = ::AArch64::MAIR_EL1::Attribute::NormalCacheableMemory();
             // we're testing the == and != operators, so they're technically not redundant
             // NOLINTNEXTLINE(misc-redundant-expression)
             EmitTestResult((normal == normal) && !(normal == device), "MAIR_EL1 Attribute ==");
             // NOLINTNEXTLINE(misc-redundant-expression)
             EmitTestResult(!(normal != normal) && (normal != device), "MAIR_EL1 Attribute !=");
+            EmitTestResult((cacheable != normal) && (cacheable != device), "MAIR_EL1 cacheable Attribute is distinct");
         }
 
         /**
@@ -208,6 +263,20 @@ namespace UnitTests::AArch64::SystemRegisters
             EmitTestResult(Details::TestAccessor::GetRegisterValue(testRegister) == 0x30D0'0981
                 && readM
                 , "SCTLR_EL1 M get/set");
+
+            // C [2]
+            testRegister.C(true);
+            auto const readC = testRegister.C();
+            EmitTestResult(Details::TestAccessor::GetRegisterValue(testRegister) == 0x30D0'0985
+                && readC
+                , "SCTLR_EL1 C get/set");
+
+            // I [12]
+            testRegister.I(true);
+            auto const readI = testRegister.I();
+            EmitTestResult(Details::TestAccessor::GetRegisterValue(testRegister) == 0x30D0'1985
+                && readI
+                , "SCTLR_EL1 I get/set");
             
             // Write not tested as it affects system operation
 
@@ -310,6 +379,55 @@ namespace UnitTests::AArch64::SystemRegisters
             EmitTestResult(Details::TestAccessor::GetRegisterValue(testRegister) == 0xC039'8029
                 && readTG1 == ::AArch64::TCR_EL1::T1Granule::Size64kb
                 , "TCR_EL1 TG1 get/set");
+
+            // IRGN0 [9:8]
+            testRegister.IRGN0(::AArch64::TCR_EL1::Cacheability::WriteBackWriteAllocate); // 0b01
+            auto const readIRGN0 = testRegister.IRGN0();
+            EmitTestResult(Details::TestAccessor::GetRegisterValue(testRegister) == 0xC039'8129
+                && readIRGN0 == ::AArch64::TCR_EL1::Cacheability::WriteBackWriteAllocate
+                , "TCR_EL1 IRGN0 get/set");
+
+            // ORGN0 [11:10]
+            testRegister.ORGN0(::AArch64::TCR_EL1::Cacheability::WriteThrough); // 0b10
+            auto const readORGN0 = testRegister.ORGN0();
+            EmitTestResult(Details::TestAccessor::GetRegisterValue(testRegister) == 0xC039'8929
+                && readORGN0 == ::AArch64::TCR_EL1::Cacheability::WriteThrough
+                , "TCR_EL1 ORGN0 get/set");
+
+            // SH0 [13:12]
+            testRegister.SH0(::AArch64::TCR_EL1::Shareability::InnerShareable); // 0b11
+            auto const readSH0 = testRegister.SH0();
+            EmitTestResult(Details::TestAccessor::GetRegisterValue(testRegister) == 0xC039'B929
+                && readSH0 == ::AArch64::TCR_EL1::Shareability::InnerShareable
+                , "TCR_EL1 SH0 get/set");
+
+            // IRGN1 [25:24]
+            testRegister.IRGN1(::AArch64::TCR_EL1::Cacheability::WriteBackNoWriteAllocate); // 0b11
+            auto const readIRGN1 = testRegister.IRGN1();
+            EmitTestResult(Details::TestAccessor::GetRegisterValue(testRegister) == 0xC339'B929
+                && readIRGN1 == ::AArch64::TCR_EL1::Cacheability::WriteBackNoWriteAllocate
+                , "TCR_EL1 IRGN1 get/set");
+
+            // ORGN1 [27:26]
+            testRegister.ORGN1(::AArch64::TCR_EL1::Cacheability::WriteBackWriteAllocate); // 0b01
+            auto const readORGN1 = testRegister.ORGN1();
+            EmitTestResult(Details::TestAccessor::GetRegisterValue(testRegister) == 0xC739'B929
+                && readORGN1 == ::AArch64::TCR_EL1::Cacheability::WriteBackWriteAllocate
+                , "TCR_EL1 ORGN1 get/set");
+
+            // SH1 [29:28]
+            testRegister.SH1(::AArch64::TCR_EL1::Shareability::OuterShareable); // 0b10
+            auto const readSH1 = testRegister.SH1();
+            EmitTestResult(Details::TestAccessor::GetRegisterValue(testRegister) == 0xE739'B929
+                && readSH1 == ::AArch64::TCR_EL1::Shareability::OuterShareable
+                , "TCR_EL1 SH1 get/set");
+
+            // AS [36]
+            testRegister.AS(true);
+            auto const readAS = testRegister.AS();
+            EmitTestResult(Details::TestAccessor::GetRegisterValue(testRegister) == 0x0000'0010'E739'B929
+                && readAS
+                , "TCR_EL1 AS get/set");
             
             // Write not tested as it affects system operation
 
@@ -340,6 +458,13 @@ namespace UnitTests::AArch64::SystemRegisters
             EmitTestResult(Details::TestAccessor::GetRegisterValue(testRegister) == 0x0000'AAAA'AAAA'AAA4
                 && readT0SZ == PhysicalPtr{ 0x0000'AAAA'AAAA'AAA4 } // top bits and bottom bit get masked off
                 , "TTBRn_EL1 BADDR get/set");
+
+            // ASID [63:48]
+            testRegister.ASID(0x1234);
+            auto const readASID = testRegister.ASID();
+            EmitTestResult(Details::TestAccessor::GetRegisterValue(testRegister) == 0x1234'AAAA'AAAA'AAA4
+                && readASID == 0x1234
+                , "TTBRn_EL1 ASID get/set");
             
             // Write0/1 not tested as it affects system operation
 
@@ -368,10 +493,12 @@ namespace UnitTests::AArch64::SystemRegisters
 
     void Run()
     {
+        CNTHCTL_EL2Test();
         CPACR_EL1Test();
         CPTR_EL2Test();
         HCR_EL2Test();
         HSTR_EL2Test();
+        ID_AA64MMFR0_EL1Test();
         MAIR_EL1AttributeTest();
         MAIR_EL1Test();
         SCTLR_EL1Test();
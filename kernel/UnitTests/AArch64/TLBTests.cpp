@@ -0,0 +1,51 @@
+#include "TLBTests.h"
+
+#include <bit>
+#include <cstdint>
+#include "../../AArch64/TLB.h"
+#include "../../PointerTypes.h"
+#include "../Framework.h"
+
+// Using a lot of "magic numbers" in tests, so just silence the lint for the file
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+
+namespace UnitTests::AArch64::TLB
+{
+    namespace
+    {
+        using ::AArch64::TLB::Details::MakeOperand;
+
+        static_assert(MakeOperand(0, VirtualPtr{ 0x1234'5678 }) == 0x1'2345, "Operand should hold the page number");
+        static_assert(MakeOperand(0x1234, VirtualPtr{ 0x1FFF }) == 0x1234'0000'0000'0001, "Operand should hold the ASID in the top bits");
+        static_assert(MakeOperand(0, VirtualPtr{ 0xFFFF'0000'0000'1000 }) == 0x0000'0FF0'0000'0001, "Operand should keep the upper VA bits that select the table");
+
+        /**
+         * Ensure invalidating translations that are in use doesn't break them
+         */
+        void InvalidateTest()
+        {
+            // The stack is mapped with global kernel entries, which invalidations by address remove regardless of ASID
+            volatile uint32_t testValue = 0x1234;
+            auto const address = VirtualPtr{ std::bit_cast<uintptr_t>(&testValue) };
+
+            ::AArch64::TLB::InvalidatePage(0, address, ::AArch64::TLB::Entries::LastLevel);
+            EmitTestResult(testValue == 0x1234, "Invalidated page can still be accessed");
+
+            ::AArch64::TLB::InvalidateRange(0, address, 0x3000, ::AArch64::TLB::Entries::AllLevels);
+            EmitTestResult(testValue == 0x1234, "Invalidated range can still be accessed");
+
+            ::AArch64::TLB::InvalidateASID(0);
+            EmitTestResult(testValue == 0x1234, "Invalidated ASID can still be accessed");
+
+            ::AArch64::TLB::InvalidateAll();
+            EmitTestResult(testValue == 0x1234, "Memory can still be accessed after invalidating everything");
+        }
+    }
+
+    void Run()
+    {
+        InvalidateTest();
+    }
+}
+
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
\ No newline at end of file
@@ -0,0 +1,12 @@
+#ifndef KERNEL_UNITTESTS_AARCH64_TLBTESTS_H
+#define KERNEL_UNITTESTS_AARCH64_TLBTESTS_H
+
+namespace UnitTests::AArch64::TLB
+{
+    /**
+     * Run all runtime tests
+     */
+    void Run();
+}
+
+#endif // KERNEL_UNITTESTS_AARCH64_TLBTESTS_H
\ No newline at end of file
@@ -0,0 +1,93 @@
+#include "ASIDAllocatorTests.h"
+
+#include <cstdint>
+
+#include "../ASIDAllocator.h"
+
+#include "Framework.h"
+
+namespace UnitTests::ASIDAllocator
+{
+    // NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    namespace
+    {
+        using ::MemoryManager::ASIDAllocator;
+
+        /**
+         * Ensure ASIDs are handed out in order, and kept while the generation is current
+         */
+        void AssignmentTest()
+        {
+            ASIDAllocator allocator{ 256 };
+
+            auto firstContext = ASIDAllocator::UnassignedContextC;
+            auto secondContext = ASIDAllocator::UnassignedContextC;
+            auto const firstRollover = allocator.Refresh(firstContext);
+            auto const secondRollover = allocator.Refresh(secondContext);
+            EmitTestResult(!firstRollover && !secondRollover, "New ASIDs don't start a new generation");
+            EmitTestResult(ASIDAllocator::GetASID(firstContext) == 1 && ASIDAllocator::GetASID(secondContext) == 2, "ASIDs handed out in order, skipping the kernel ASID");
+
+            auto const oldContext = firstContext;
+            EmitTestResult(!allocator.Refresh(firstContext) && firstContext == oldContext, "Current ASID is kept");
+        }
+
+        /**
+         * Ensure running out of ASIDs starts a new generation and reassigns old contexts
+         */
+        void RolloverTest()
+        {
+            ASIDAllocator allocator{ 4 };
+
+            auto firstContext = ASIDAllocator::UnassignedContextC;
+            auto secondContext = ASIDAllocator::UnassignedContextC;
+            auto thirdContext = ASIDAllocator::UnassignedContextC;
+            allocator.Refresh(firstContext);
+            allocator.Refresh(secondContext);
+            allocator.Refresh(thirdContext);
+            EmitTestResult(ASIDAllocator::GetASID(thirdContext) == 3, "Last ASID handed out");
+
+            auto fourthContext = ASIDAllocator::UnassignedContextC;
+            EmitTestResult(allocator.Refresh(fourthContext), "Running out of ASIDs starts a new generation");
+            EmitTestResult(ASIDAllocator::GetASID(fourthContext) == 1, "New generation starts after the kernel ASID");
+
+            auto const oldContext = secondContext;
+            EmitTestResult(!allocator.Refresh(secondContext) && secondContext != oldContext && ASIDAllocator::GetASID(secondContext) == 2, "Old generation context gets a new ASID");
+        }
+
+        /**
+         * Ensure contexts live on other CPUs keep their ASIDs across a new generation, and nobody else is given them
+         */
+        void LiveContextTest()
+        {
+            ASIDAllocator allocator{ 4 };
+
+            auto firstContext = ASIDAllocator::UnassignedContextC;
+            auto secondContext = ASIDAllocator::UnassignedContextC;
+            auto thirdContext = ASIDAllocator::UnassignedContextC;
+            auto unassignedContext = ASIDAllocator::UnassignedContextC;
+            allocator.Refresh(firstContext);
+            allocator.Refresh(secondContext);
+            allocator.Refresh(thirdContext);
+
+            uint64_t* const liveContexts[] = { &secondContext, &unassignedContext }; // NOLINT(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+            auto fourthContext = ASIDAllocator::UnassignedContextC;
+            EmitTestResult(allocator.Refresh(fourthContext, liveContexts, 2), "Running out of ASIDs with live contexts starts a new generation");
+            EmitTestResult(ASIDAllocator::GetASID(fourthContext) == 1, "New context gets the first free ASID");
+            EmitTestResult(unassignedContext == ASIDAllocator::UnassignedContextC, "Unassigned live context is left alone");
+
+            auto const liveContext = secondContext;
+            EmitTestResult(!allocator.Refresh(secondContext) && secondContext == liveContext && ASIDAllocator::GetASID(secondContext) == 2, "Live context keeps its ASID in the new generation");
+
+            allocator.Refresh(firstContext);
+            EmitTestResult(ASIDAllocator::GetASID(firstContext) == 3, "Reserved ASID is skipped");
+        }
+    }
+    // NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+
+    void Run()
+    {
+        AssignmentTest();
+        RolloverTest();
+        LiveContextTest();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,12 @@
+#ifndef KERNEL_UNITTESTS_ASIDALLOCATORTESTS_H
+#define KERNEL_UNITTESTS_ASIDALLOCATORTESTS_H
+
+namespace UnitTests::ASIDAllocator
+{
+    /**
+     * Run all runtime tests
+     */
+    void Run();
+}
+
+#endif // KERNEL_UNITTESTS_ASIDALLOCATORTESTS_H
\ No newline at end of file
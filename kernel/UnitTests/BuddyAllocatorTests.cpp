@@ -0,0 +1,214 @@
+#include "BuddyAllocatorTests.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include "../BuddyAllocator.h"
+#include "../MemoryManager.h"
+#include "../PointerTypes.h"
+
+#include "Framework.h"
+
+namespace UnitTests::BuddyAllocator
+{
+    // NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    namespace
+    {
+        using ::MemoryManager::PageSize;
+
+        // The allocator never touches the memory it manages, so we can hand it a made-up physical address
+        constexpr auto TestBase = PhysicalPtr{ 0x1000'0000 };
+        constexpr auto TestFrameCount = 32U;
+
+        /**
+         * Obtains the address of the page at the given index from our test base
+         * 
+         * @param aIndex The index of the page
+         * @return The address of the page
+         */
+        constexpr PhysicalPtr PageAt(size_t const aIndex)
+        {
+            return TestBase.Offset(aIndex * PageSize);
+        }
+
+        /**
+         * Ensure an allocator with no free ranges fails allocations
+         */
+        void EmptyAllocatorTest()
+        {
+            // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+            ::MemoryManager::PageFrame frames[TestFrameCount];
+            ::MemoryManager::BuddyAllocator allocator;
+            EmitTestResult(allocator.Allocate(0) == PhysicalPtr{}, "Allocation fails before Init");
+
+            allocator.Init(TestBase, frames, TestFrameCount);
+            EmitTestResult(allocator.GetFreePageCount() == 0, "No pages free after Init");
+            EmitTestResult(allocator.Allocate(0) == PhysicalPtr{}, "Allocation fails with no free ranges");
+        }
+
+        /**
+         * Ensure large blocks are split and merged back together
+         */
+        void SplitAndMergeTest()
+        {
+            // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+            ::MemoryManager::PageFrame frames[TestFrameCount];
+            ::MemoryManager::BuddyAllocator allocator;
+            allocator.Init(TestBase, frames, TestFrameCount);
+            allocator.AddFreeRange(PageAt(0), PageAt(16));
+            EmitTestResult(allocator.GetFreePageCount() == 16, "Free range adds pages");
+
+            auto const firstPage = allocator.Allocate(0);
+            auto const secondPage = allocator.Allocate(0);
+            EmitTestResult(firstPage == PageAt(0) && secondPage == PageAt(1), "Order 0 allocations split from the start of the block");
+            EmitTestResult(allocator.GetFreePageCount() == 14, "Allocations remove pages");
+
+            auto const largeBlock = allocator.Allocate(3);
+            EmitTestResult(largeBlock == PageAt(8), "Order 3 allocation is naturally aligned");
+            EmitTestResult(allocator.Allocate(4) == PhysicalPtr{}, "Allocation fails when no block is large enough");
+
+            allocator.Free(firstPage);
+            allocator.Free(secondPage);
+            allocator.Free(largeBlock);
+            EmitTestResult(allocator.GetFreePageCount() == 16, "Frees return pages");
+            EmitTestResult(allocator.Allocate(4) == PageAt(0), "Freed buddies merge back into a single block");
+        }
+
+        /**
+         * Ensure unaligned free ranges are carved into aligned blocks
+         */
+        void UnalignedRangeTest()
+        {
+            // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+            ::MemoryManager::PageFrame frames[TestFrameCount];
+            ::MemoryManager::BuddyAllocator allocator;
+            allocator.Init(TestBase, frames, TestFrameCount);
+
+            // partial pages on either side get dropped, and pages outside the managed span are ignored
+            allocator.AddFreeRange(TestBase.Offset(PageSize + 1), PageAt(8).Offset(PageSize - 1));
+            allocator.AddFreeRange(PageAt(TestFrameCount - 1), PageAt(TestFrameCount + 4));
+            EmitTestResult(allocator.GetFreePageCount() == 7, "Unaligned and out of range pages are dropped");
+            EmitTestResult(allocator.Allocate(2) == PageAt(4), "Unaligned range is split into aligned blocks");
+            EmitTestResult(allocator.Allocate(2) == PhysicalPtr{}, "Unaligned range has no other large blocks");
+        }
+
+        /**
+         * Ensure split blocks can be freed a page at a time, and merge back together once they all are
+         */
+        void SplitAllocatedTest()
+        {
+            // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+            ::MemoryManager::PageFrame frames[TestFrameCount];
+            ::MemoryManager::BuddyAllocator allocator;
+            allocator.Init(TestBase, frames, TestFrameCount);
+            allocator.AddFreeRange(PageAt(0), PageAt(4));
+
+            auto const block = allocator.Allocate(2);
+            allocator.GetFrame(block)->RefCount = 3;
+            allocator.SplitAllocated(block);
+            auto refCountsCopied = true;
+            for (auto curPage = 0U; curPage < 4; ++curPage)
+            {
+                auto const* const pframe = allocator.GetFrame(PageAt(curPage));
+                refCountsCopied = refCountsCopied && (pframe->Order == 0) && (pframe->RefCount == 3);
+            }
+            EmitTestResult(refCountsCopied, "Split pages are single pages with the block's reference count");
+
+            allocator.Free(PageAt(1));
+            allocator.Free(PageAt(2));
+            EmitTestResult(allocator.GetFreePageCount() == 2 && allocator.Allocate(1) == PhysicalPtr{}, "Split pages are freed individually");
+
+            allocator.Free(PageAt(0));
+            allocator.Free(PageAt(3));
+            EmitTestResult(allocator.Allocate(2) == block, "Split pages merge back into the block");
+        }
+
+        /**
+         * Ensure colored allocations only hand out pages of the allowed colors
+         */
+        void ColoredAllocationTest()
+        {
+            // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+            ::MemoryManager::PageFrame frames[TestFrameCount];
+            ::MemoryManager::BuddyAllocator allocator;
+            allocator.Init(TestBase, frames, TestFrameCount);
+            allocator.AddFreeRange(PageAt(0), PageAt(16));
+
+            using ::MemoryManager::BuddyAllocator;
+            EmitTestResult(BuddyAllocator::GetColor(PageAt(0)) == 0 && BuddyAllocator::GetColor(PageAt(13)) == 5, "Colors follow the physical address");
+
+            auto const preferredPage = allocator.AllocateColored(BuddyAllocator::AllColorsC, 5);
+            EmitTestResult(preferredPage == PageAt(5) || preferredPage == PageAt(13), "Preferred color is used when available");
+
+            auto const secondPage = allocator.AllocateColored(1U << 5U, 5);
+            EmitTestResult(secondPage != PhysicalPtr{} && secondPage != preferredPage && BuddyAllocator::GetColor(secondPage) == 5, "Every page of a color can be found");
+            EmitTestResult(allocator.AllocateColored(1U << 5U, 5) == PhysicalPtr{}, "Allocation fails when the allowed colors run out");
+
+            auto const nextColorPage = allocator.AllocateColored((1U << 5U) | (1U << 6U), 5);
+            EmitTestResult(BuddyAllocator::GetColor(nextColorPage) == 6, "Next allowed color is used when the preferred one runs out");
+            EmitTestResult(allocator.GetFreePageCount() == 13, "Colored allocations remove pages");
+
+            allocator.Free(preferredPage);
+            allocator.Free(secondPage);
+            allocator.Free(nextColorPage);
+            EmitTestResult(allocator.Allocate(4) == PageAt(0), "Colored pages merge back into a single block");
+        }
+
+        /**
+         * Ensure colored allocations find a page even when it's further down a free list than the quick scan looks
+         */
+        void ColorFullScanTest()
+        {
+            constexpr auto frameCount = 64U;
+            // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+            ::MemoryManager::PageFrame frames[frameCount];
+            ::MemoryManager::BuddyAllocator allocator;
+            allocator.Init(TestBase, frames, frameCount);
+            allocator.AddFreeRange(PageAt(0), PageAt(frameCount));
+            for (auto curPage = 0U; curPage < frameCount; ++curPage)
+            {
+                static_cast<void>(allocator.Allocate(0));
+            }
+
+            // Free the only page of color 3 first, so the even pages freed after it end up ahead of it on the list
+            allocator.Free(PageAt(3));
+            for (auto curPage = 4U; curPage < frameCount; curPage += 2)
+            {
+                allocator.Free(PageAt(curPage));
+            }
+
+            EmitTestResult(allocator.AllocateColored(1U << 3U, 3) == PageAt(3), "Page past the scan limit is still found");
+            EmitTestResult(allocator.AllocateColored(1U << 3U, 3) == PhysicalPtr{}, "Allocation fails once the full scan finds nothing");
+        }
+
+        /**
+         * Ensure frees of pointers we didn't hand out are ignored
+         */
+        void InvalidFreeTest()
+        {
+            // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+            ::MemoryManager::PageFrame frames[TestFrameCount];
+            ::MemoryManager::BuddyAllocator allocator;
+            allocator.Init(TestBase, frames, TestFrameCount);
+            allocator.AddFreeRange(PageAt(0), PageAt(2));
+
+            auto const page = allocator.Allocate(0);
+            allocator.Free(page);
+            allocator.Free(page);
+            allocator.Free(PageAt(TestFrameCount + 1));
+            EmitTestResult(allocator.GetFreePageCount() == 2, "Double free and unmanaged frees are ignored");
+        }
+    }
+    // NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+
+    void Run()
+    {
+        EmptyAllocatorTest();
+        SplitAndMergeTest();
+        UnalignedRangeTest();
+        SplitAllocatedTest();
+        ColoredAllocationTest();
+        ColorFullScanTest();
+        InvalidFreeTest();
+    }
+}
\ No newline at end of file
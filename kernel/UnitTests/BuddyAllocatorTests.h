@@ -0,0 +1,12 @@
+#ifndef KERNEL_UNITTESTS_BUDDYALLOCATORTESTS_H
+#define KERNEL_UNITTESTS_BUDDYALLOCATORTESTS_H
+
+namespace UnitTests::BuddyAllocator
+{
+    /**
+     * Run all runtime tests
+     */
+    void Run();
+}
+
+#endif // KERNEL_UNITTESTS_BUDDYALLOCATORTESTS_H
\ No newline at end of file
@@ -0,0 +1,171 @@
+#include "DeadlineRunQueueTests.h"
+
+#include <cstdint>
+
+#include "../DeadlineRunQueue.h"
+#include "../TaskStructs.h"
+
+#include "Framework.h"
+
+namespace UnitTests::DeadlineRunQueue
+{
+    // NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    namespace
+    {
+        using ::Scheduler::DeadlineRunQueue;
+        using ::Scheduler::TaskStruct;
+
+        /**
+         * Ensure the task with the earliest deadline is picked
+         */
+        void PickTest()
+        {
+            DeadlineRunQueue queue;
+            EmitTestResult(queue.PickNext() == nullptr, "Empty queue has nothing to pick");
+
+            TaskStruct slowTask;
+            slowTask.Policy = ::Scheduler::SchedulingPolicy::Deadline;
+            slowTask.DeadlineRuntime = 100;
+            slowTask.DeadlinePeriod = 1000;
+            TaskStruct fastTask;
+            fastTask.Policy = ::Scheduler::SchedulingPolicy::Deadline;
+            fastTask.DeadlineRuntime = 10;
+            fastTask.DeadlinePeriod = 100;
+            queue.Enqueue(slowTask, 0);
+            queue.Enqueue(fastTask, 0);
+            EmitTestResult((slowTask.AbsoluteDeadline == 1000) && (slowTask.RemainingRuntime == 100), "Enqueued task starts its first period");
+            EmitTestResult(queue.PickNext() == &fastTask, "Task with the earliest deadline picked first");
+
+            TaskStruct laterTask;
+            laterTask.Policy = ::Scheduler::SchedulingPolicy::Deadline;
+            laterTask.DeadlineRuntime = 10;
+            laterTask.DeadlinePeriod = 100;
+            queue.Enqueue(laterTask, 950);
+            EmitTestResult(queue.PickNext() == &fastTask, "Deadlines count from when the task was enqueued");
+
+            queue.Remove(fastTask);
+            EmitTestResult(queue.PickNext() == &slowTask, "Next earliest deadline picked once the first is gone");
+            queue.Remove(slowTask);
+            queue.Remove(laterTask);
+            EmitTestResult((queue.GetCount() == 0) && (queue.PickNext() == nullptr) && !slowTask.Queued, "Removed tasks leave the queue empty");
+        }
+
+        /**
+         * Ensure tasks are throttled once their runtime is used up, and replenished at their deadline
+         */
+        void ThrottleTest()
+        {
+            DeadlineRunQueue queue;
+            TaskStruct fastTask;
+            fastTask.Policy = ::Scheduler::SchedulingPolicy::Deadline;
+            fastTask.DeadlineRuntime = 10;
+            fastTask.DeadlinePeriod = 100;
+            TaskStruct slowTask;
+            slowTask.Policy = ::Scheduler::SchedulingPolicy::Deadline;
+            slowTask.DeadlineRuntime = 100;
+            slowTask.DeadlinePeriod = 1000;
+            queue.Enqueue(fastTask, 0);
+            queue.Enqueue(slowTask, 0);
+            EmitTestResult(queue.GetNextReplenish() == UINT64_MAX, "Nothing to replenish before anything is throttled");
+
+            queue.ChargeRuntime(fastTask, 4);
+            EmitTestResult((fastTask.RemainingRuntime == 6) && (queue.PickNext() == &fastTask), "Task with runtime left keeps its place");
+            queue.ChargeRuntime(fastTask, 8);
+            EmitTestResult(fastTask.Throttled && (queue.PickNext() == &slowTask), "Task that used up its runtime is throttled");
+            EmitTestResult((queue.GetNextReplenish() == 100) && (queue.GetCount() == 2), "Throttled task stays on the queue until its deadline");
+
+            queue.Replenish(99);
+            EmitTestResult(queue.PickNext() == &slowTask, "Task isn't replenished before its deadline");
+            queue.Replenish(100);
+            EmitTestResult(!fastTask.Throttled && (fastTask.RemainingRuntime == 10) && (fastTask.AbsoluteDeadline == 200), "Task is replenished for its next period at its deadline");
+            EmitTestResult(queue.PickNext() == &fastTask, "Replenished task runs ahead of a later deadline");
+            EmitTestResult(queue.HasReady() && (queue.GetNextReplenish() == UINT64_MAX), "Replenishing publishes the queue's new state");
+
+            queue.ChargeRuntime(fastTask, 10);
+            queue.Replenish(550);
+            EmitTestResult(fastTask.AbsoluteDeadline == 650, "Task replenished after missing a period starts over from now");
+
+            queue.ChargeRuntime(slowTask, 100);
+            queue.Remove(slowTask);
+            EmitTestResult((queue.GetNextReplenish() == UINT64_MAX) && (queue.GetCount() == 1), "Throttled task can be removed");
+            queue.Remove(fastTask);
+        }
+
+        /**
+         * Ensure reservations are refused once they would take too much of the CPU
+         */
+        void AdmitTest()
+        {
+            EmitTestResult(DeadlineRunQueue::GetBandwidth(1, 2) == DeadlineRunQueue::FullBandwidthC / 2, "Half the CPU is half the bandwidth");
+            EmitTestResult(DeadlineRunQueue::GetBandwidth(1, 3) * 3 >= DeadlineRunQueue::FullBandwidthC, "Bandwidth is rounded up");
+
+            DeadlineRunQueue queue;
+            TaskStruct halfTask;
+            TaskStruct otherTask;
+            EmitTestResult(queue.CanAdmit(halfTask, 50, 100), "Reservation fits on an empty queue");
+            halfTask.Policy = ::Scheduler::SchedulingPolicy::Deadline;
+            halfTask.DeadlineRuntime = 50;
+            halfTask.DeadlinePeriod = 100;
+            queue.Reserve(halfTask);
+            queue.Enqueue(halfTask, 0);
+            EmitTestResult(queue.CanAdmit(otherTask, 45, 100), "Reservation fits up to the limit");
+            EmitTestResult(!queue.CanAdmit(otherTask, 46, 100), "Reservation past the limit is refused");
+            EmitTestResult(!queue.CanAdmit(otherTask, 96, 100), "Reservation past the limit on its own is refused");
+            EmitTestResult(queue.CanAdmit(halfTask, 95, 100), "Task's own reservation is replaced rather than added to");
+
+            queue.Remove(halfTask);
+            EmitTestResult(!queue.CanAdmit(otherTask, 46, 100), "Task off the queue keeps its reservation");
+            queue.Release(halfTask);
+            EmitTestResult((queue.GetTotalBandwidth() == 0) && queue.CanAdmit(otherTask, 95, 100), "Released reservation can be taken by others");
+        }
+
+        /**
+         * Ensure a task that blocks and wakes keeps its reservation and carries on with its period, rather than being
+         * handed a fresh runtime
+         */
+        void BlockTest()
+        {
+            DeadlineRunQueue queue;
+            TaskStruct halfTask;
+            halfTask.Policy = ::Scheduler::SchedulingPolicy::Deadline;
+            halfTask.DeadlineRuntime = 50;
+            halfTask.DeadlinePeriod = 100;
+            queue.Reserve(halfTask);
+            queue.Enqueue(halfTask, 0);
+            TaskStruct otherTask;
+
+            queue.ChargeRuntime(halfTask, 20);
+            queue.Remove(halfTask);
+            EmitTestResult(!queue.CanAdmit(otherTask, 46, 100), "Blocked task's bandwidth can't be admitted by others");
+            queue.Enqueue(halfTask, 40);
+            EmitTestResult((halfTask.AbsoluteDeadline == 100) && (halfTask.RemainingRuntime == 30) && (queue.PickNext() == &halfTask), "Task waking with time to finish its runtime keeps its period");
+            EmitTestResult(queue.GetTotalBandwidth() == DeadlineRunQueue::GetBandwidth(50, 100), "Waking doesn't reserve the bandwidth again");
+
+            queue.ChargeRuntime(halfTask, 30);
+            queue.Remove(halfTask);
+            queue.Enqueue(halfTask, 80);
+            EmitTestResult(halfTask.Throttled && !queue.HasReady() && (queue.GetNextReplenish() == 100), "Task that used up its runtime stays throttled when it wakes");
+
+            queue.Replenish(100);
+            queue.ChargeRuntime(halfTask, 10);
+            queue.Remove(halfTask);
+            queue.Enqueue(halfTask, 190);
+            EmitTestResult((halfTask.AbsoluteDeadline == 290) && (halfTask.RemainingRuntime == 50), "Task waking too close to its deadline starts a new period");
+
+            queue.Remove(halfTask);
+            queue.Enqueue(halfTask, 400);
+            EmitTestResult((halfTask.AbsoluteDeadline == 500) && (halfTask.RemainingRuntime == 50), "Task waking after its deadline starts a new period");
+            queue.Remove(halfTask);
+            queue.Release(halfTask);
+        }
+    }
+    // NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+
+    void Run()
+    {
+        PickTest();
+        ThrottleTest();
+        AdmitTest();
+        BlockTest();
+    }
+}
\ No newline at end of file
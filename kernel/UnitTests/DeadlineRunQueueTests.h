@@ -0,0 +1,12 @@
+#ifndef KERNEL_UNITTESTS_DEADLINERUNQUEUETESTS_H
+#define KERNEL_UNITTESTS_DEADLINERUNQUEUETESTS_H
+
+namespace UnitTests::DeadlineRunQueue
+{
+    /**
+     * Run all runtime tests
+     */
+    void Run();
+}
+
+#endif // KERNEL_UNITTESTS_DEADLINERUNQUEUETESTS_H
\ No newline at end of file
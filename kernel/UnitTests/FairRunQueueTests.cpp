@@ -0,0 +1,155 @@
+#include "FairRunQueueTests.h"
+
+#include "../FairRunQueue.h"
+#include "../TaskStructs.h"
+
+#include "Framework.h"
+
+namespace UnitTests::FairRunQueue
+{
+    // NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    namespace
+    {
+        using ::Scheduler::FairRunQueue;
+        using ::Scheduler::TaskStruct;
+
+        /**
+         * Ensure the task with the least virtual runtime is picked, and tasks with the same runtime are picked in order
+         */
+        void PickTest()
+        {
+            FairRunQueue queue;
+            EmitTestResult(queue.PickNext() == nullptr, "Empty queue has nothing to pick");
+
+            TaskStruct lateTask;
+            lateTask.VirtualRuntime = 300;
+            TaskStruct firstEarlyTask;
+            firstEarlyTask.VirtualRuntime = 100;
+            TaskStruct secondEarlyTask;
+            secondEarlyTask.VirtualRuntime = 100;
+            TaskStruct middleTask;
+            middleTask.VirtualRuntime = 200;
+            queue.Enqueue(lateTask);
+            queue.Enqueue(firstEarlyTask);
+            queue.Enqueue(secondEarlyTask);
+            queue.Enqueue(middleTask);
+            EmitTestResult(queue.GetCount() == 4, "Enqueued tasks are counted");
+            EmitTestResult(queue.PickNext() == &firstEarlyTask, "Task with the least virtual runtime picked first");
+
+            queue.Remove(firstEarlyTask);
+            EmitTestResult(queue.PickNext() == &secondEarlyTask, "Tasks with the same virtual runtime picked in the order they were added");
+            queue.Remove(secondEarlyTask);
+            queue.Remove(middleTask);
+            queue.Remove(lateTask);
+            EmitTestResult((queue.GetCount() == 0) && (queue.PickNext() == nullptr) && !lateTask.Queued, "Removed tasks leave the queue empty");
+        }
+
+        /**
+         * Ensure running is charged by weight, so lighter tasks fall behind faster
+         */
+        void ChargeTest()
+        {
+            EmitTestResult(FairRunQueue::GetWeight(0) == FairRunQueue::NiceZeroWeightC, "Nice level 0 has the reference weight");
+            EmitTestResult((FairRunQueue::GetWeight(-21) == FairRunQueue::GetWeight(FairRunQueue::MinNiceC)) && (FairRunQueue::GetWeight(20) == FairRunQueue::GetWeight(FairRunQueue::MaxNiceC)), "Nice levels out of range are clamped");
+
+            FairRunQueue queue;
+            TaskStruct normalTask;
+            TaskStruct niceTask;
+            niceTask.Nice = 5;
+            queue.Enqueue(normalTask);
+            queue.Enqueue(niceTask);
+
+            queue.ChargeRuntime(normalTask, 1000);
+            EmitTestResult(normalTask.VirtualRuntime == 1000, "Nice level 0 task is charged real time");
+            EmitTestResult(queue.PickNext() == &niceTask, "Charged task moves behind the task that hasn't run");
+
+            queue.ChargeRuntime(niceTask, 1000);
+            EmitTestResult(niceTask.VirtualRuntime == (1000 * FairRunQueue::NiceZeroWeightC) / FairRunQueue::GetWeight(5), "Nicer task is charged more than real time");
+            EmitTestResult(queue.PickNext() == &normalTask, "Heavier task runs again first after the same real time");
+        }
+
+        /**
+         * Ensure time slices split the target latency by weight, stretching it when there are too many tasks
+         */
+        void TimeSliceTest()
+        {
+            FairRunQueue queue;
+            TaskStruct firstTask;
+            TaskStruct secondTask;
+            EmitTestResult(queue.GetTimeSlice(firstTask, 20000, 4000) == 20000, "Lone task gets the whole target latency");
+
+            queue.Enqueue(firstTask);
+            queue.Enqueue(secondTask);
+            EmitTestResult(queue.GetTimeSlice(firstTask, 20000, 4000) == 10000, "Tasks of the same weight split the target latency evenly");
+
+            TaskStruct niceTask;
+            niceTask.Nice = 5;
+            queue.Remove(secondTask);
+            queue.Enqueue(niceTask);
+            auto const totalWeight = FairRunQueue::GetWeight(0) + FairRunQueue::GetWeight(5);
+            EmitTestResult((queue.GetTimeSlice(firstTask, 20000, 4000) == (20000 * FairRunQueue::GetWeight(0)) / totalWeight) && (queue.GetTimeSlice(niceTask, 20000, 4000) == (20000 * FairRunQueue::GetWeight(5)) / totalWeight), "Tasks split the target latency by weight");
+            queue.Remove(niceTask);
+            queue.Remove(firstTask);
+
+            // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays, hicpp-avoid-c-arrays, modernize-avoid-c-arrays)
+            TaskStruct tasks[10];
+            for (auto& rtask : tasks)
+            {
+                queue.Enqueue(rtask);
+            }
+            EmitTestResult(queue.GetTimeSlice(tasks[0], 20000, 4000) == 4000, "Target latency is stretched to give every task the minimum granularity");
+        }
+
+        /**
+         * Ensure the minimum virtual runtime follows the front of the queue, but never goes backwards
+         */
+        void MinVirtualRuntimeTest()
+        {
+            FairRunQueue queue;
+            TaskStruct firstTask;
+            firstTask.VirtualRuntime = 100;
+            TaskStruct secondTask;
+            secondTask.VirtualRuntime = 200;
+            queue.Enqueue(firstTask);
+            queue.Enqueue(secondTask);
+            EmitTestResult(queue.GetMinVirtualRuntime() == 100, "Minimum virtual runtime follows the first task");
+
+            queue.ChargeRuntime(firstTask, 500);
+            EmitTestResult(queue.GetMinVirtualRuntime() == 200, "Minimum virtual runtime moves up when the first task runs");
+
+            TaskStruct newTask;
+            newTask.VirtualRuntime = 50;
+            queue.Enqueue(newTask);
+            EmitTestResult((queue.PickNext() == &newTask) && (queue.GetMinVirtualRuntime() == 200), "Minimum virtual runtime doesn't go backwards");
+        }
+
+        /**
+         * Ensure the task furthest back is offered for stealing, unless it's excluded
+         */
+        void StealTest()
+        {
+            FairRunQueue queue;
+            TaskStruct frontTask;
+            frontTask.VirtualRuntime = 100;
+            EmitTestResult(queue.FindStealable(nullptr) == nullptr, "Nothing to steal from an empty queue");
+            queue.Enqueue(frontTask);
+            EmitTestResult(queue.FindStealable(&frontTask) == nullptr, "Excluded task isn't stolen");
+
+            TaskStruct backTask;
+            backTask.VirtualRuntime = 300;
+            queue.Enqueue(backTask);
+            EmitTestResult(queue.FindStealable(nullptr) == &backTask, "Task with the most virtual runtime is stolen");
+            EmitTestResult(queue.FindStealable(&backTask) == &frontTask, "Next task is stolen if the last is excluded");
+        }
+    }
+    // NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+
+    void Run()
+    {
+        PickTest();
+        ChargeTest();
+        TimeSliceTest();
+        MinVirtualRuntimeTest();
+        StealTest();
+    }
+}
\ No newline at end of file
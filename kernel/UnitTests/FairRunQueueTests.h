@@ -0,0 +1,12 @@
+#ifndef KERNEL_UNITTESTS_FAIRRUNQUEUETESTS_H
+#define KERNEL_UNITTESTS_FAIRRUNQUEUETESTS_H
+
+namespace UnitTests::FairRunQueue
+{
+    /**
+     * Run all runtime tests
+     */
+    void Run();
+}
+
+#endif // KERNEL_UNITTESTS_FAIRRUNQUEUETESTS_H
\ No newline at end of file
@@ -7,17 +7,30 @@
 #include "AArch64/CPUTests.h"
 #include "AArch64/MemoryDescriptorTests.h"
 #include "AArch64/MemoryPageTablesTests.h"
+#include "AArch64/PageTableRangesTests.h"
 #include "AArch64/SystemRegistersTests.h"
+#include "AArch64/TLBTests.h"
 #include "KernelStdlib/BitsetTests.h"
 #include "KernelStdlib/CStringTests.h"
 #include "KernelStdlib/ExceptionTests.h"
 #include "KernelStdlib/NewTests.h"
 #include "KernelStdlib/TypeInfoTests.h"
 #include "KernelStdlib/UtilityTests.h"
+#include "Peripherals/DeviceTreeTests.h"
+#include "ASIDAllocatorTests.h"
+#include "BuddyAllocatorTests.h"
+#include "DeadlineRunQueueTests.h"
+#include "FairRunQueueTests.h"
+#include "LZ4Tests.h"
 #include "MemoryManagerTests.h"
 #include "PointerTypesTests.h"
 #include "PrintTests.h"
+#include "PriorityRunQueueTests.h"
+#include "RedBlackTreeTests.h"
+#include "SlabAllocatorTests.h"
+#include "SpinLockTests.h"
 #include "UtilsTests.h"
+#include "VirtualMemoryAreaTests.h"
 
 namespace UnitTests
 {
@@ -178,10 +191,12 @@ namespace UnitTests
         AArch64::CPU::Run();
         AArch64::MemoryDescriptor::Run();
         AArch64::MemoryPageTables::Run();
+        AArch64::PageTableRanges::Run();
         AArch64::SystemRegisters::Run();
+        AArch64::TLB::Run();
 
-        // Devices/* not tested as right now they're just constexpr values
-        // #TODO: Devices/DeviceTree.h/cpp untested
+        // Devices/* not tested as right now they're just constexpr values, other than the device tree
+        Peripherals::DeviceTree::Run();
 
         // No runtime tests for bit
         KernelStdlib::Bitset::Run();
@@ -195,19 +210,29 @@ namespace UnitTests
         // No runtime tests for type_traits
         KernelStdlib::Utility::Run();
 
+        ASIDAllocator::Run();
+        BuddyAllocator::Run();
+        DeadlineRunQueue::Run();
         // #TODO: Exceptions.cpp untested (currently just unimplemented stubs)
         // #TODO: ExceptionVectorHandlers.h/cpp/S untested (not sure if testable)
+        FairRunQueue::Run();
         // #TODO: IRQ.h/S untested (likely untestable)
+        LZ4::Run();
         MemoryManager::Run();
         PointerTypes::Run();
         // #TODO: MiniUart.h/cpp untested (likely untestable - though basically tested due to all our UART output)
         Print::Run();
+        PriorityRunQueue::Run();
+        RedBlackTree::Run();
         // #TODO: Scheduler.h/cpp/S untested (not sure if testable, other than our running user apps)
+        SlabAllocator::Run();
+        SpinLock::Run();
         // #TODO: SystemCall.cpp untested (not sure if testable, other than our running user apps)
         // #TODO: TaskStructs.h untested (currently just contains POD types)
         // #TODO: Timer.h/cpp untested (not sure if testable, as testing might disrupt OS behavior)
         // #TODO: TypeInfo.cpp untested (currently just contains types filled by the compiler)
         Utils::Run();
+        VirtualMemoryArea::Run();
 
         // Build a quick reference output at the end
         // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
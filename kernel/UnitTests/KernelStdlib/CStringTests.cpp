@@ -55,6 +55,21 @@ namespace UnitTests::KernelStdlib::CString
             EmitTestResult((intArray[0] == expectedInt) && (intArray[1] == expectedInt) && (intArray[2] == 20U) && (intArray[3] == 25U), "memset fills partial int array");
         }
 
+        /**
+         * Run tests on memcmp
+         */
+        void MemcmpTest()
+        {
+            constexpr unsigned arraySize = 4;
+
+            unsigned char const lhs[arraySize] = {1U, 2U, 3U, 4U};
+            unsigned char const same[arraySize] = {1U, 2U, 3U, 4U};
+            unsigned char const larger[arraySize] = {1U, 2U, 200U, 0U};
+            EmitTestResult(memcmp(lhs, same, arraySize) == 0, "memcmp equality");
+            EmitTestResult(memcmp(lhs, larger, arraySize) < 0 && memcmp(larger, lhs, arraySize) > 0, "memcmp orders by the first differing byte, unsigned");
+            EmitTestResult(memcmp(lhs, larger, 2) == 0, "memcmp only compares the bytes it is told to");
+        }
+
         /**
          * Make sure strcmp handles equality
          */
@@ -98,6 +113,7 @@ namespace UnitTests::KernelStdlib::CString
     {
         MemcpyTest();
         MemsetTest();
+        MemcmpTest();
         StrcmpEqualTest();
         StrcmpLTTest();
         StrcmpGTTest();
@@ -1,11 +1,44 @@
 #include "NewTests.h"
 
+#include <cstdint>
 #include <new> // NOLINT(misc-include-cleaner)
+#include "../Framework.h"
 
 namespace UnitTests::KernelStdlib::New
 {
+    // NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    namespace
+    {
+        /**
+         * Ensure new and delete allocate usable memory
+         */
+        void NewDeleteTest()
+        {
+            auto* const pvalue = new uint64_t{ 1234 }; // NOLINT(cppcoreguidelines-owning-memory)
+            EmitTestResult(*pvalue == 1234, "new constructs value");
+            delete pvalue; // NOLINT(cppcoreguidelines-owning-memory)
+
+            auto* const parray = new uint32_t[16]{}; // NOLINT(cppcoreguidelines-owning-memory)
+            parray[15] = 5; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            EmitTestResult((parray[0] == 0) && (parray[15] == 5), "new[] constructs values"); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            delete[] parray; // NOLINT(cppcoreguidelines-owning-memory)
+        }
+
+        /**
+         * Ensure nothrow new returns null when it can't allocate
+         */
+        void NothrowNewTest()
+        {
+            // far larger than the largest block the page allocator can hand out
+            auto* const pmemory = new (std::nothrow) uint8_t[1ULL << 40U]; // NOLINT(cppcoreguidelines-owning-memory)
+            EmitTestResult(pmemory == nullptr, "nothrow new returns null on failure");
+        }
+    }
+    // NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+
     void Run()
     {
-        // #TODO: No tests yet, probably will need some ones later
+        NewDeleteTest();
+        NothrowNewTest();
     }
 }
\ No newline at end of file
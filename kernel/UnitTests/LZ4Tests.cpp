@@ -0,0 +1,113 @@
+#include "LZ4Tests.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "../LZ4.h"
+
+#include "Framework.h"
+
+namespace UnitTests::LZ4
+{
+    // NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    // NOLINTBEGIN(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+    // NOLINTBEGIN(cppcoreguidelines-pro-bounds-array-to-pointer-decay,hicpp-no-array-decay)
+    namespace
+    {
+        constexpr size_t BufferSizeC = 256;
+
+        // Kept off the stack, since the table is bigger than a kernel stack
+        // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+        ::LZ4::CompressionTable Table;
+
+        /**
+         * Compresses and decompresses a buffer, checking it comes back the same
+         * 
+         * @param apSource The data to compress
+         * @param aSourceSize The size of the data
+         * @param arCompressedSize OUT: The size of the compressed data
+         * @return True if the data made the round trip intact
+         */
+        bool RoundTrip(uint8_t const* const apSource, size_t const aSourceSize, size_t& arCompressedSize)
+        {
+            uint8_t compressed[BufferSizeC * 2] = {};
+            uint8_t decompressed[BufferSizeC] = {};
+            arCompressedSize = ::LZ4::CompressBlock(apSource, aSourceSize, compressed, sizeof(compressed), Table);
+            auto decompressedSize = size_t{ 0 };
+            return (arCompressedSize != 0) &&
+                ::LZ4::DecompressBlock(compressed, arCompressedSize, decompressed, sizeof(decompressed), decompressedSize) &&
+                (decompressedSize == aSourceSize) && (memcmp(decompressed, apSource, aSourceSize) == 0);
+        }
+
+        /**
+         * Ensure a hand-encoded block decodes, including an overlapping match
+         */
+        void DecompressTest()
+        {
+            // "abcd" as literals, then a match 4 back for 8 bytes, then "xyz" as the final literals
+            uint8_t const encoded[] = { 0x44, 'a', 'b', 'c', 'd', 0x04, 0x00, 0x30, 'x', 'y', 'z' };
+            char output[32] = {};
+            auto outputSize = size_t{ 0 };
+            auto const decoded = ::LZ4::DecompressBlock(encoded, sizeof(encoded), reinterpret_cast<uint8_t*>(output), sizeof(output), outputSize);
+            EmitTestResult(decoded && (outputSize == 15) && (memcmp(output, "abcdabcdabcdxyz", 15) == 0), "Hand-encoded block decodes");
+        }
+
+        /**
+         * Ensure malformed blocks are rejected rather than read or written out of bounds
+         */
+        void MalformedTest()
+        {
+            uint8_t output[8] = {};
+            auto outputSize = size_t{ 0 };
+            uint8_t const offsetTooFar[] = { 0x10, 'a', 0x02, 0x00, 0x00 };
+            EmitTestResult(!::LZ4::DecompressBlock(offsetTooFar, sizeof(offsetTooFar), output, sizeof(output), outputSize), "Match before the start of the output is rejected");
+            uint8_t const truncated[] = { 0x50, 'a', 'b' };
+            EmitTestResult(!::LZ4::DecompressBlock(truncated, sizeof(truncated), output, sizeof(output), outputSize), "Truncated literals are rejected");
+            uint8_t const tooLong[] = { 0x1F, 'a', 0x01, 0x00, 0x00 };
+            EmitTestResult(!::LZ4::DecompressBlock(tooLong, sizeof(tooLong), output, sizeof(output), outputSize), "Output overflow is rejected");
+        }
+
+        /**
+         * Ensure data compresses and comes back the same
+         */
+        void RoundTripTest()
+        {
+            uint8_t zeros[BufferSizeC] = {};
+            auto compressedSize = size_t{ 0 };
+            EmitTestResult(RoundTrip(zeros, sizeof(zeros), compressedSize) && (compressedSize < 32), "Zeros round trip and compress well");
+
+            uint8_t pattern[BufferSizeC] = {};
+            for (auto curByte = 0U; curByte < sizeof(pattern); ++curByte)
+            {
+                pattern[curByte] = static_cast<uint8_t>((curByte % 7) * 3);
+            }
+            EmitTestResult(RoundTrip(pattern, sizeof(pattern), compressedSize) && (compressedSize < (sizeof(pattern) / 4)), "Repeating pattern round trips and compresses");
+
+            // A simple LCG, so there's nothing for the compressor to find
+            uint8_t noise[BufferSizeC] = {};
+            auto state = 12345U;
+            for (auto& rbyte : noise)
+            {
+                state = (state * 1103515245U) + 12345U;
+                rbyte = static_cast<uint8_t>(state >> 24U);
+            }
+            EmitTestResult(RoundTrip(noise, sizeof(noise), compressedSize), "Noise round trips");
+
+            uint8_t small[BufferSizeC / 4] = {};
+            EmitTestResult(::LZ4::CompressBlock(noise, sizeof(noise), small, sizeof(small), Table) == 0, "Compression fails when the output doesn't fit");
+
+            EmitTestResult(RoundTrip(pattern, 3, compressedSize) && RoundTrip(pattern, 0, compressedSize), "Tiny inputs round trip");
+        }
+    }
+    // NOLINTEND(cppcoreguidelines-pro-bounds-array-to-pointer-decay,hicpp-no-array-decay)
+    // NOLINTEND(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+    // NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+
+    void Run()
+    {
+        DecompressTest();
+        MalformedTest();
+        RoundTripTest();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,12 @@
+#ifndef KERNEL_UNITTESTS_LZ4TESTS_H
+#define KERNEL_UNITTESTS_LZ4TESTS_H
+
+namespace UnitTests::LZ4
+{
+    /**
+     * Run all runtime tests
+     */
+    void Run();
+}
+
+#endif // KERNEL_UNITTESTS_LZ4TESTS_H
\ No newline at end of file
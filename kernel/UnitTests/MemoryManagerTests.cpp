@@ -28,7 +28,7 @@ namespace UnitTests::MemoryManager
         // #TODO: AllocateUserPage tests
         // #TODO: CopyVirtualMemory tests
 
-        // SetPageGlobalDirectory modifies system state in a way that would likely screw things up, so not really
+        // ActivateAddressSpace modifies system state in a way that would likely screw things up, so not really
         // able to be tested
     }
 
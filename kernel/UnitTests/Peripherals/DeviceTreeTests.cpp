@@ -0,0 +1,247 @@
+#include "DeviceTreeTests.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "../../Peripherals/DeviceTree.h"
+#include "../../PointerTypes.h"
+#include "../Framework.h"
+
+// Using a lot of "magic numbers" in tests, so just silence the lint for the file
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+
+namespace UnitTests::Peripherals::DeviceTree
+{
+    namespace
+    {
+        constexpr size_t TestBlobSize = 512;
+
+        /**
+         * Helper to build a device tree blob in memory, since we have no way to load one from disk
+         */
+        class BlobWriter
+        {
+        public:
+            /**
+             * Writes a big-endian 32-bit value at the current position
+             * 
+             * @param aValue The value to write
+             */
+            void Put32(uint32_t const aValue)
+            {
+                constexpr auto bitsPerByte = 8U;
+                for (auto curByte = 0U; curByte < sizeof(aValue); ++curByte)
+                {
+                    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+                    Blob[Position++] = static_cast<uint8_t>(aValue >> ((sizeof(aValue) - 1 - curByte) * bitsPerByte));
+                }
+            }
+
+            /**
+             * Writes a big-endian 64-bit value at the current position
+             * 
+             * @param aValue The value to write
+             */
+            void Put64(uint64_t const aValue)
+            {
+                Put32(static_cast<uint32_t>(aValue >> 32U));
+                Put32(static_cast<uint32_t>(aValue));
+            }
+
+            /**
+             * Writes a string (with terminator) at the current position
+             * 
+             * @param apString The string to write
+             * @param aPad Whether to pad the string out to 4 bytes (strings in the strings block are not padded)
+             */
+            void PutString(char const* const apString, bool const aPad = true)
+            {
+                auto const length = std::strlen(apString) + 1;
+                // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+                std::memcpy(&Blob[Position], apString, length);
+                Position += length;
+                if (aPad)
+                {
+                    Position = (Position + 3) & ~size_t{ 3 };
+                }
+            }
+
+            /**
+             * Writes a property with a list of 32-bit cells as the value
+             * 
+             * @param aNameOffset The offset of the property name in the strings block
+             * @param apCells The cells to write
+             * @param aCellCount The number of cells
+             */
+            void PutCellsProperty(uint32_t const aNameOffset, uint32_t const* const apCells, uint32_t const aCellCount)
+            {
+                Put32(0x03); // FDT_PROP
+                Put32(aCellCount * static_cast<uint32_t>(sizeof(uint32_t)));
+                Put32(aNameOffset);
+                for (auto curCell = 0U; curCell < aCellCount; ++curCell)
+                {
+                    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+                    Put32(apCells[curCell]);
+                }
+            }
+
+            /**
+             * Obtains the current write position
+             * 
+             * @return The offset from the start of the blob
+             */
+            [[nodiscard]] uint32_t GetPosition() const { return static_cast<uint32_t>(Position); }
+
+            /**
+             * Moves the write position
+             * 
+             * @param aPosition The new offset from the start of the blob
+             */
+            void SetPosition(uint32_t const aPosition) { Position = aPosition; }
+
+            /**
+             * Obtains the blob data
+             * 
+             * @return The blob data
+             */
+            [[nodiscard]] uint8_t const* GetBlob() const { return Blob; }
+
+        private:
+            // Header values have to be aligned for the reservation block
+            // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+            alignas(8) uint8_t Blob[TestBlobSize] = {};
+            size_t Position = 0;
+        };
+
+        // Offsets into the strings block
+        constexpr uint32_t AddressCellsName = 0;
+        constexpr uint32_t SizeCellsName = 15;
+        constexpr uint32_t RegName = 27;
+
+        /**
+         * Builds a test blob with a memory node and a reservation
+         * 
+         * @param arWriter The writer to build the blob in
+         * @param aMemoryNodeName The name of the node holding the memory ranges
+         * @param aAddressCells The number of cells for each address in the memory node
+         */
+        void BuildTestBlob(BlobWriter& arWriter, char const* const aMemoryNodeName, uint32_t const aAddressCells)
+        {
+            constexpr uint32_t headerSize = 40;
+            arWriter.SetPosition(headerSize);
+
+            auto const reservationOffset = arWriter.GetPosition();
+            arWriter.Put64(0x0);
+            arWriter.Put64(0x1000);
+            arWriter.Put64(0);
+            arWriter.Put64(0);
+
+            auto const structOffset = arWriter.GetPosition();
+            arWriter.Put32(0x01); // FDT_BEGIN_NODE
+            arWriter.PutString("");
+            arWriter.PutCellsProperty(AddressCellsName, &aAddressCells, 1);
+            constexpr uint32_t sizeCells = 1;
+            arWriter.PutCellsProperty(SizeCellsName, &sizeCells, 1);
+
+            arWriter.Put32(0x01); // FDT_BEGIN_NODE
+            arWriter.PutString("soc");
+            // a reg property on a non-memory node should be ignored
+            constexpr uint32_t socReg[] = { 0x7E00'0000, 0x0100'0000 }; // NOLINT(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+            arWriter.PutCellsProperty(RegName, socReg, 2);
+            arWriter.Put32(0x02); // FDT_END_NODE
+
+            arWriter.Put32(0x01); // FDT_BEGIN_NODE
+            arWriter.PutString(aMemoryNodeName);
+            if (aAddressCells == 2)
+            {
+                constexpr uint32_t memoryReg[] = { 0x0, 0x0, 0x3B40'0000, 0x0, 0x4000'0000, 0x1000'0000 }; // NOLINT(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+                arWriter.PutCellsProperty(RegName, memoryReg, 6);
+            }
+            else
+            {
+                constexpr uint32_t memoryReg[] = { 0x0, 0x3B40'0000, 0x4000'0000, 0x1000'0000 }; // NOLINT(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+                arWriter.PutCellsProperty(RegName, memoryReg, 4);
+            }
+            arWriter.Put32(0x02); // FDT_END_NODE
+
+            arWriter.Put32(0x02); // FDT_END_NODE
+            arWriter.Put32(0x09); // FDT_END
+            auto const structSize = arWriter.GetPosition() - structOffset;
+
+            auto const stringsOffset = arWriter.GetPosition();
+            arWriter.PutString("#address-cells", false);
+            arWriter.PutString("#size-cells", false);
+            arWriter.PutString("reg", false);
+            auto const stringsSize = arWriter.GetPosition() - stringsOffset;
+            auto const totalSize = arWriter.GetPosition();
+
+            arWriter.SetPosition(0);
+            arWriter.Put32(0xd00dfeed); // magic
+            arWriter.Put32(totalSize);
+            arWriter.Put32(structOffset);
+            arWriter.Put32(stringsOffset);
+            arWriter.Put32(reservationOffset);
+            arWriter.Put32(17); // version
+            arWriter.Put32(16); // last_comp_version
+            arWriter.Put32(0); // boot_cpuid_phys
+            arWriter.Put32(stringsSize);
+            arWriter.Put32(structSize);
+        }
+
+        /**
+         * Ensure the memory map is read from the memory node and reservation block
+         */
+        void ReadMemoryMapTest()
+        {
+            BlobWriter writer;
+            BuildTestBlob(writer, "memory@0", 1);
+
+            ::DeviceTree::MemoryMap map;
+            auto const result = ::DeviceTree::ReadMemoryMap(writer.GetBlob(), map);
+            EmitTestResult(result, "Read memory map succeeds");
+            EmitTestResult(map.MemoryCount == 2, "Read memory map finds only the memory node ranges");
+            EmitTestResult((map.Memory[0].Begin == PhysicalPtr{ 0x0 }) && (map.Memory[0].End == PhysicalPtr{ 0x3B40'0000 }), "Read memory map first range");
+            EmitTestResult((map.Memory[1].Begin == PhysicalPtr{ 0x4000'0000 }) && (map.Memory[1].End == PhysicalPtr{ 0x5000'0000 }), "Read memory map second range");
+            EmitTestResult((map.ReservedCount == 1) && (map.Reserved[0].Begin == PhysicalPtr{ 0x0 }) && (map.Reserved[0].End == PhysicalPtr{ 0x1000 }), "Read memory map reservations");
+            EmitTestResult(map.BlobSize != 0, "Read memory map blob size");
+        }
+
+        /**
+         * Ensure the root's cell counts are respected
+         */
+        void ReadMemoryMapCellsTest()
+        {
+            BlobWriter writer;
+            BuildTestBlob(writer, "memory", 2);
+
+            ::DeviceTree::MemoryMap map;
+            auto const result = ::DeviceTree::ReadMemoryMap(writer.GetBlob(), map);
+            EmitTestResult(result && (map.MemoryCount == 2) && (map.Memory[1].Begin == PhysicalPtr{ 0x4000'0000 }) && (map.Memory[1].End == PhysicalPtr{ 0x5000'0000 }), "Read memory map with 64-bit addresses");
+        }
+
+        /**
+         * Ensure a blob without a memory node, or with a bad header, fails
+         */
+        void ReadMemoryMapFailureTest()
+        {
+            BlobWriter writer;
+            BuildTestBlob(writer, "memoryx", 1);
+
+            ::DeviceTree::MemoryMap map;
+            EmitTestResult(!::DeviceTree::ReadMemoryMap(writer.GetBlob(), map), "Read memory map fails without a memory node");
+
+            writer.SetPosition(0);
+            writer.Put32(0xdeadbeef);
+            EmitTestResult(!::DeviceTree::ReadMemoryMap(writer.GetBlob(), map), "Read memory map fails with bad magic");
+        }
+    }
+
+    void Run()
+    {
+        ReadMemoryMapTest();
+        ReadMemoryMapCellsTest();
+        ReadMemoryMapFailureTest();
+    }
+}
+
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
\ No newline at end of file
@@ -0,0 +1,12 @@
+#ifndef KERNEL_UNITTESTS_PERIPHERALS_DEVICETREETESTS_H
+#define KERNEL_UNITTESTS_PERIPHERALS_DEVICETREETESTS_H
+
+namespace UnitTests::Peripherals::DeviceTree
+{
+    /**
+     * Run all runtime tests
+     */
+    void Run();
+}
+
+#endif // KERNEL_UNITTESTS_PERIPHERALS_DEVICETREETESTS_H
\ No newline at end of file
@@ -0,0 +1,140 @@
+#include "PriorityRunQueueTests.h"
+
+#include "../PriorityRunQueue.h"
+#include "../TaskStructs.h"
+
+#include "Framework.h"
+
+namespace UnitTests::PriorityRunQueue
+{
+    // NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    namespace
+    {
+        using ::Scheduler::PriorityRunQueue;
+        using ::Scheduler::TaskStruct;
+
+        /**
+         * Ensure the highest priority task is picked, and tasks of the same priority are picked in order
+         */
+        void PickTest()
+        {
+            PriorityRunQueue queue;
+            EmitTestResult(queue.PickNext() == nullptr, "Empty queue has nothing to pick");
+
+            TaskStruct lowTask;
+            lowTask.Priority = 1;
+            TaskStruct firstHighTask;
+            firstHighTask.Priority = 5;
+            TaskStruct secondHighTask;
+            secondHighTask.Priority = 5;
+            queue.Enqueue(lowTask);
+            queue.Enqueue(firstHighTask);
+            queue.Enqueue(secondHighTask);
+            EmitTestResult(queue.GetCount() == 3, "Enqueued tasks are counted");
+            EmitTestResult(queue.PickNext() == &firstHighTask, "Highest priority task picked first");
+
+            queue.Remove(firstHighTask);
+            EmitTestResult(queue.PickNext() == &secondHighTask, "Same priority tasks picked in the order they were added");
+            queue.Remove(secondHighTask);
+            EmitTestResult(queue.PickNext() == &lowTask, "Lower priority task picked once the higher ones are gone");
+            queue.Remove(lowTask);
+            EmitTestResult((queue.GetCount() == 0) && (queue.PickNext() == nullptr) && !lowTask.Queued, "Removed tasks leave the queue empty");
+        }
+
+        /**
+         * Ensure expired tasks wait for the rest of the active tasks, whatever their priority
+         */
+        void ExpireTest()
+        {
+            PriorityRunQueue queue;
+            TaskStruct lowTask;
+            lowTask.Priority = 1;
+            TaskStruct highTask;
+            highTask.Priority = 10;
+            queue.Enqueue(lowTask);
+            queue.Enqueue(highTask);
+
+            queue.Expire(highTask);
+            EmitTestResult(queue.PickNext() == &lowTask, "Expired high priority task waits for active low priority task");
+            queue.Expire(lowTask);
+            EmitTestResult(queue.PickNext() == &highTask, "Sets are swapped once every task has expired");
+            EmitTestResult(queue.GetCount() == 2, "Expiring doesn't change the count");
+        }
+
+        /**
+         * Ensure requeued tasks go behind the rest of their level, but stay ahead of lower levels
+         */
+        void RequeueTest()
+        {
+            PriorityRunQueue queue;
+            TaskStruct lowTask;
+            lowTask.Priority = 1;
+            TaskStruct firstHighTask;
+            firstHighTask.Priority = 10;
+            TaskStruct secondHighTask;
+            secondHighTask.Priority = 10;
+            queue.Enqueue(lowTask);
+            queue.Enqueue(firstHighTask);
+            queue.Enqueue(secondHighTask);
+
+            queue.Requeue(firstHighTask);
+            EmitTestResult(queue.PickNext() == &secondHighTask, "Requeued task waits for the rest of its level");
+            queue.Requeue(secondHighTask);
+            EmitTestResult(queue.PickNext() == &firstHighTask, "Requeued task still runs ahead of lower levels");
+            EmitTestResult(queue.GetCount() == 3, "Requeuing doesn't change the count");
+        }
+
+        /**
+         * Ensure priorities outside of the levels are clamped
+         */
+        void LevelTest()
+        {
+            EmitTestResult(PriorityRunQueue::GetLevel(-5) == 0, "Negative priority clamped to the lowest level");
+            EmitTestResult(PriorityRunQueue::GetLevel(1000) == PriorityRunQueue::PriorityLevelsC - 1, "Large priority clamped to the highest level");
+
+            PriorityRunQueue queue;
+            TaskStruct lowTask;
+            lowTask.Priority = -5;
+            TaskStruct highTask;
+            highTask.Priority = 1000;
+            queue.Enqueue(lowTask);
+            queue.Enqueue(highTask);
+            EmitTestResult(queue.PickNext() == &highTask, "Clamped priorities keep their order");
+            queue.Remove(highTask);
+            queue.Remove(lowTask);
+        }
+
+        /**
+         * Ensure stealing skips the excluded task, and prefers expired tasks
+         */
+        void StealTest()
+        {
+            PriorityRunQueue queue;
+            TaskStruct runningTask;
+            runningTask.Priority = 1;
+            EmitTestResult(queue.FindStealable(nullptr) == nullptr, "Nothing to steal from an empty queue");
+            queue.Enqueue(runningTask);
+            EmitTestResult(queue.FindStealable(&runningTask) == nullptr, "Excluded task isn't stolen");
+
+            TaskStruct activeTask;
+            activeTask.Priority = 1;
+            TaskStruct expiredTask;
+            expiredTask.Priority = 1;
+            queue.Enqueue(activeTask);
+            queue.Enqueue(expiredTask);
+            EmitTestResult(queue.FindStealable(&runningTask) == &activeTask, "Task behind the excluded task is stolen");
+            queue.Expire(expiredTask);
+            EmitTestResult(queue.FindStealable(&runningTask) == &expiredTask, "Expired task stolen first");
+        }
+    }
+    // NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+
+    void Run()
+    {
+        PickTest();
+        ExpireTest();
+        RequeueTest();
+        LevelTest();
+        StealTest();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,12 @@
+#ifndef KERNEL_UNITTESTS_PRIORITYRUNQUEUETESTS_H
+#define KERNEL_UNITTESTS_PRIORITYRUNQUEUETESTS_H
+
+namespace UnitTests::PriorityRunQueue
+{
+    /**
+     * Run all runtime tests
+     */
+    void Run();
+}
+
+#endif // KERNEL_UNITTESTS_PRIORITYRUNQUEUETESTS_H
\ No newline at end of file
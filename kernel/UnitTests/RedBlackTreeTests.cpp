@@ -0,0 +1,181 @@
+#include "RedBlackTreeTests.h"
+
+#include <cstdint>
+
+#include "../RedBlackTree.h"
+
+#include "Framework.h"
+
+namespace UnitTests::RedBlackTree
+{
+    // NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    namespace
+    {
+        using ::Containers::RedBlackNode;
+        using ::Containers::RedBlackTree;
+
+        /**
+         * Test node with a key to order by
+         */
+        struct KeyedNode: RedBlackNode
+        {
+            uint32_t Key = 0;
+        };
+
+        /**
+         * Orders nodes by key
+         * 
+         * @param aLhs The first node
+         * @param aRhs The second node
+         * @return True if the first node's key is smaller
+         */
+        bool KeyLess(RedBlackNode const& aLhs, RedBlackNode const& aRhs)
+        {
+            return static_cast<KeyedNode const&>(aLhs).Key < static_cast<KeyedNode const&>(aRhs).Key;
+        }
+
+        /**
+         * Checks the red-black properties of a subtree
+         * 
+         * @param apNode The root of the subtree (may be null)
+         * @param apParent The node's expected parent
+         * @param arValid OUT: Set to false if anything is wrong
+         * @return The number of black nodes on every path down from the node
+         */
+        uint32_t CheckSubtree(RedBlackNode const* const apNode, RedBlackNode const* const apParent, bool& arValid)
+        {
+            if (apNode == nullptr)
+            {
+                return 1;
+            }
+            if (apNode->pParent != apParent)
+            {
+                arValid = false;
+            }
+            if (apNode->Red && (((apNode->pLeft != nullptr) && apNode->pLeft->Red) || ((apNode->pRight != nullptr) && apNode->pRight->Red)))
+            {
+                arValid = false;
+            }
+            auto const leftHeight = CheckSubtree(apNode->pLeft, apNode, arValid);
+            auto const rightHeight = CheckSubtree(apNode->pRight, apNode, arValid);
+            if (leftHeight != rightHeight)
+            {
+                arValid = false;
+            }
+            return leftHeight + (apNode->Red ? 0U : 1U);
+        }
+
+        /**
+         * Checks the tree is balanced and its nodes are in order
+         * 
+         * @param aTree The tree to check
+         * @param aExpectedCount How many nodes should be in the tree
+         * @return True if the tree is valid
+         */
+        bool CheckTree(RedBlackTree const& aTree, uint32_t const aExpectedCount)
+        {
+            auto valid = (aTree.GetRoot() == nullptr) || !aTree.GetRoot()->Red;
+            CheckSubtree(aTree.GetRoot(), nullptr, valid);
+
+            auto count = 0U;
+            KeyedNode const* pprevious = nullptr;
+            for (auto const* pcurNode = aTree.GetFirst(); pcurNode != nullptr; pcurNode = RedBlackTree::GetNext(*pcurNode))
+            {
+                auto const* const pkeyed = static_cast<KeyedNode const*>(pcurNode);
+                valid = valid && ((pprevious == nullptr) || (pprevious->Key <= pkeyed->Key));
+                pprevious = pkeyed;
+                ++count;
+            }
+            return valid && (count == aExpectedCount) && (aTree.GetLast() == pprevious);
+        }
+
+        /**
+         * Ensure an empty tree has nothing in it
+         */
+        void EmptyTest()
+        {
+            RedBlackTree const tree;
+            EmitTestResult(tree.IsEmpty() && (tree.GetRoot() == nullptr) && (tree.GetFirst() == nullptr) && (tree.GetLast() == nullptr), "Empty tree has no nodes");
+        }
+
+        /**
+         * Ensure inserting keeps the tree balanced and in order
+         */
+        void InsertTest()
+        {
+            constexpr auto nodeCount = 64U;
+            // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+            KeyedNode nodes[nodeCount];
+            RedBlackTree tree;
+            for (auto curNode = 0U; curNode < nodeCount; ++curNode)
+            {
+                // scatter the keys so every rotation case gets hit
+                // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+                nodes[curNode].Key = (curNode * 37U) % nodeCount;
+                // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+                tree.InsertOrdered(nodes[curNode], KeyLess);
+            }
+            EmitTestResult(CheckTree(tree, nodeCount), "Scattered inserts stay balanced and in order");
+            EmitTestResult(static_cast<KeyedNode const*>(tree.GetFirst())->Key == 0 && static_cast<KeyedNode const*>(tree.GetLast())->Key == nodeCount - 1, "First and last nodes are the smallest and largest");
+            EmitTestResult(static_cast<KeyedNode const*>(RedBlackTree::GetPrevious(*tree.GetLast()))->Key == nodeCount - 2, "Previous walks backwards");
+
+            RedBlackTree sortedTree;
+            // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+            KeyedNode sortedNodes[nodeCount];
+            for (auto curNode = 0U; curNode < nodeCount; ++curNode)
+            {
+                // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+                sortedNodes[curNode].Key = curNode;
+                // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+                sortedTree.InsertOrdered(sortedNodes[curNode], KeyLess);
+            }
+            EmitTestResult(CheckTree(sortedTree, nodeCount), "Sorted inserts stay balanced");
+        }
+
+        /**
+         * Ensure removing keeps the tree balanced and in order
+         */
+        void RemoveTest()
+        {
+            constexpr auto nodeCount = 64U;
+            // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+            KeyedNode nodes[nodeCount];
+            RedBlackTree tree;
+            for (auto curNode = 0U; curNode < nodeCount; ++curNode)
+            {
+                // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+                nodes[curNode].Key = (curNode * 37U) % nodeCount;
+                // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+                tree.InsertOrdered(nodes[curNode], KeyLess);
+            }
+
+            auto valid = true;
+            auto remaining = nodeCount;
+            for (auto curNode = 0U; curNode < nodeCount; curNode += 2)
+            {
+                // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+                tree.Remove(nodes[curNode]);
+                --remaining;
+                valid = valid && CheckTree(tree, remaining);
+            }
+            EmitTestResult(valid, "Tree stays balanced and in order while removing half the nodes");
+
+            // Take the rest out from the root, so removing nodes with two children gets exercised
+            while (!tree.IsEmpty())
+            {
+                tree.Remove(*tree.GetRoot());
+                --remaining;
+                valid = valid && CheckTree(tree, remaining);
+            }
+            EmitTestResult(valid && (remaining == 0), "Tree stays balanced while removing the root until empty");
+        }
+    }
+    // NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+
+    void Run()
+    {
+        EmptyTest();
+        InsertTest();
+        RemoveTest();
+    }
+}
\ No newline at end of file
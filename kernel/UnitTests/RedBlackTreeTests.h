@@ -0,0 +1,12 @@
+#ifndef KERNEL_UNITTESTS_REDBLACKTREETESTS_H
+#define KERNEL_UNITTESTS_REDBLACKTREETESTS_H
+
+namespace UnitTests::RedBlackTree
+{
+    /**
+     * Run all runtime tests
+     */
+    void Run();
+}
+
+#endif // KERNEL_UNITTESTS_REDBLACKTREETESTS_H
\ No newline at end of file
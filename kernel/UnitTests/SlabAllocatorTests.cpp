@@ -0,0 +1,171 @@
+#include "SlabAllocatorTests.h"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#include "../MemoryManager.h"
+#include "../SlabAllocator.h"
+
+#include "Framework.h"
+
+namespace UnitTests::SlabAllocator
+{
+    // NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    namespace
+    {
+        /**
+         * Test object that tracks its construction and destruction
+         */
+        struct TrackedObject
+        {
+            /**
+             * Constructor
+             * 
+             * @param arLiveCount Counter to increment while we're alive
+             * @param aValue Value to store
+             */
+            TrackedObject(int& arLiveCount, uint64_t const aValue)
+                : LiveCount{ arLiveCount }
+                , Value{ aValue }
+            {
+                ++LiveCount;
+            }
+
+            /**
+             * Destructor
+             */
+            ~TrackedObject()
+            {
+                --LiveCount;
+            }
+
+            // Disable copying/moving
+            TrackedObject(TrackedObject const&) = delete;
+            TrackedObject(TrackedObject&&) = delete;
+            TrackedObject& operator=(TrackedObject const&) = delete;
+            TrackedObject& operator=(TrackedObject&&) = delete;
+
+            int& LiveCount;
+            uint64_t Value = 0;
+        };
+
+        /**
+         * Ensure slabs are sized to hold a reasonable number of objects
+         */
+        void SlabSizingTest()
+        {
+            ::MemoryManager::SlabCache const smallCache{ 16, 16 };
+            EmitTestResult((smallCache.GetObjectSize() == 16) && (smallCache.GetObjectsPerSlab() > 200), "Small objects fill a single page");
+
+            ::MemoryManager::SlabCache const tinyCache{ 1, 1 };
+            EmitTestResult(tinyCache.GetObjectSize() == sizeof(void*), "Objects are large enough for the free list");
+
+            ::MemoryManager::SlabCache const oddCache{ 40, 32 };
+            EmitTestResult(oddCache.GetObjectSize() == 64, "Object size is rounded up to alignment");
+
+            ::MemoryManager::SlabCache const largeCache{ 2048, 16 };
+            EmitTestResult(largeCache.GetObjectsPerSlab() >= 7, "Large objects use a larger slab");
+        }
+
+        /**
+         * Ensure objects are unique, aligned, and freed objects are handed back out first
+         */
+        void AllocateFreeTest()
+        {
+            ::MemoryManager::SlabCache cache{ 48, 16 };
+
+            auto* const pfirst = cache.Allocate();
+            auto* const psecond = cache.Allocate();
+            EmitTestResult((pfirst != nullptr) && (psecond != nullptr) && (pfirst != psecond), "Slab allocations are unique");
+            EmitTestResult(((std::bit_cast<uintptr_t>(pfirst) % 16) == 0) && ((std::bit_cast<uintptr_t>(psecond) % 16) == 0), "Slab allocations are aligned");
+
+            ::MemoryManager::SlabCache::Free(pfirst);
+            auto* const pthird = cache.Allocate();
+            EmitTestResult(pthird == pfirst, "Most recently freed object is reused first");
+
+            ::MemoryManager::SlabCache::Free(psecond);
+            ::MemoryManager::SlabCache::Free(pthird);
+        }
+
+        /**
+         * Ensure caches grow past a single slab and shrink back down
+         */
+        void MultipleSlabTest()
+        {
+            static constexpr auto objectCount = 600U;
+            ::MemoryManager::SlabCache cache{ 16, 16 };
+            EmitTestResult(cache.GetObjectsPerSlab() < objectCount, "Slab cache test needs multiple slabs");
+
+            // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+            void* objects[objectCount] = {};
+            auto allSucceeded = true;
+            for (auto& pobject : objects)
+            {
+                pobject = cache.Allocate();
+                allSucceeded = allSucceeded && (pobject != nullptr);
+            }
+            EmitTestResult(allSucceeded, "Slab cache grows past a single slab");
+
+            for (auto* const pobject : objects)
+            {
+                ::MemoryManager::SlabCache::Free(pobject);
+            }
+            // if the slab lists were damaged by emptying the slabs, this would hand out a bad pointer or crash
+            auto* const pobject = cache.Allocate();
+            EmitTestResult(pobject != nullptr, "Slab cache allocates after emptying its slabs");
+            ::MemoryManager::SlabCache::Free(pobject);
+        }
+
+        /**
+         * Ensure typed caches construct and destruct their objects
+         */
+        void TypedObjectCacheTest()
+        {
+            ::MemoryManager::TypedObjectCache<TrackedObject> cache;
+            auto liveCount = 0;
+            auto* const pobject = cache.Allocate(liveCount, 1234U);
+            EmitTestResult((pobject != nullptr) && (pobject->Value == 1234U) && (liveCount == 1), "Typed cache constructs objects");
+            cache.Free(pobject);
+            EmitTestResult(liveCount == 0, "Typed cache destructs objects");
+        }
+
+        /**
+         * Ensure heap allocations of various sizes are usable and can be freed
+         */
+        void HeapTest()
+        {
+            auto* const psmall = static_cast<uint8_t*>(::MemoryManager::HeapAllocate(1));
+            auto* const pmedium = static_cast<uint8_t*>(::MemoryManager::HeapAllocate(2000));
+            auto* const plarge = static_cast<uint8_t*>(::MemoryManager::HeapAllocate(3 * ::MemoryManager::PageSize));
+            EmitTestResult((psmall != nullptr) && (pmedium != nullptr) && (plarge != nullptr), "Heap allocations succeed");
+            EmitTestResult((std::bit_cast<uintptr_t>(plarge) % ::MemoryManager::PageSize) == 0, "Large heap allocations are page aligned");
+
+            // make sure we can write to all the memory we asked for
+            // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            psmall[0] = 1;
+            pmedium[1999] = 2;
+            plarge[(3 * ::MemoryManager::PageSize) - 1] = 3;
+            EmitTestResult((psmall[0] == 1) && (pmedium[1999] == 2) && (plarge[(3 * ::MemoryManager::PageSize) - 1] == 3), "Heap allocations are writable");
+            // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+            ::MemoryManager::HeapFree(plarge);
+            ::MemoryManager::HeapFree(pmedium);
+            ::MemoryManager::HeapFree(psmall);
+
+            auto* const psmallAgain = ::MemoryManager::HeapAllocate(8);
+            EmitTestResult(psmallAgain == psmall, "Heap reuses freed memory of the same size class");
+            ::MemoryManager::HeapFree(psmallAgain);
+        }
+    }
+    // NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+
+    void Run()
+    {
+        SlabSizingTest();
+        AllocateFreeTest();
+        MultipleSlabTest();
+        TypedObjectCacheTest();
+        HeapTest();
+    }
+}
\ No newline at end of file
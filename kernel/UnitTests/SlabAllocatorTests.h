@@ -0,0 +1,12 @@
+#ifndef KERNEL_UNITTESTS_SLABALLOCATORTESTS_H
+#define KERNEL_UNITTESTS_SLABALLOCATORTESTS_H
+
+namespace UnitTests::SlabAllocator
+{
+    /**
+     * Run all runtime tests
+     */
+    void Run();
+}
+
+#endif // KERNEL_UNITTESTS_SLABALLOCATORTESTS_H
\ No newline at end of file
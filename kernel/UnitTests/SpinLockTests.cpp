@@ -0,0 +1,44 @@
+#include "SpinLockTests.h"
+
+#include "../SpinLock.h"
+
+#include "Framework.h"
+
+namespace UnitTests::SpinLock
+{
+    namespace
+    {
+        /**
+         * Ensure the lock can only be taken once until it is released
+         */
+        void TryLockTest()
+        {
+            Sync::SpinLock lock;
+            EmitTestResult(lock.TryLock(), "Free lock can be taken");
+            EmitTestResult(!lock.TryLock(), "Held lock can't be taken");
+            lock.Unlock();
+            EmitTestResult(lock.TryLock(), "Released lock can be taken again");
+            lock.Unlock();
+        }
+
+        /**
+         * Ensure Lock takes a free lock without waiting
+         */
+        void LockTest()
+        {
+            Sync::SpinLock lock;
+            lock.Lock();
+            EmitTestResult(!lock.TryLock(), "Lock takes the lock");
+            lock.Unlock();
+            lock.Lock();
+            EmitTestResult(!lock.TryLock(), "Lock takes a released lock");
+            lock.Unlock();
+        }
+    }
+
+    void Run()
+    {
+        TryLockTest();
+        LockTest();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,12 @@
+#ifndef KERNEL_UNITTESTS_SPINLOCKTESTS_H
+#define KERNEL_UNITTESTS_SPINLOCKTESTS_H
+
+namespace UnitTests::SpinLock
+{
+    /**
+     * Run all runtime tests
+     */
+    void Run();
+}
+
+#endif // KERNEL_UNITTESTS_SPINLOCKTESTS_H
\ No newline at end of file
@@ -0,0 +1,115 @@
+#include "VirtualMemoryAreaTests.h"
+
+#include <cstddef>
+
+#include "../MemoryManager.h"
+#include "../PointerTypes.h"
+#include "../RedBlackTree.h"
+#include "../VirtualMemoryArea.h"
+
+#include "Framework.h"
+
+namespace UnitTests::VirtualMemoryArea
+{
+    // NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    namespace
+    {
+        using ::MemoryManager::PageSize;
+
+        /**
+         * Makes an area covering the given pages
+         * 
+         * @param aFirstPage The index of the first page in the area
+         * @param aPageCount The number of pages in the area
+         * @return The area
+         */
+        ::MemoryManager::VirtualMemoryArea MakeArea(size_t const aFirstPage, size_t const aPageCount)
+        {
+            ::MemoryManager::VirtualMemoryArea area;
+            area.Start = VirtualPtr{ aFirstPage * PageSize };
+            area.Length = aPageCount * PageSize;
+            area.Protection = ::MemoryManager::AreaProtection::ReadC;
+            return area;
+        }
+
+        /**
+         * Ensure addresses are found in the area containing them, and nowhere else
+         */
+        void FindTest()
+        {
+            Containers::RedBlackTree areas;
+            auto lowArea = MakeArea(0, 1);
+            auto middleArea = MakeArea(4, 4);
+            auto highArea = MakeArea(16, 512);
+            ::MemoryManager::InsertArea(areas, middleArea);
+            ::MemoryManager::InsertArea(areas, highArea);
+            ::MemoryManager::InsertArea(areas, lowArea);
+
+            EmitTestResult(::MemoryManager::FindArea(areas, VirtualPtr{}) == &lowArea, "Address at the start of an area is found");
+            EmitTestResult(::MemoryManager::FindArea(areas, VirtualPtr{ (8 * PageSize) - 1 }) == &middleArea, "Last byte of an area is found");
+            EmitTestResult(::MemoryManager::FindArea(areas, VirtualPtr{ 8 * PageSize }) == nullptr, "Byte after an area isn't found");
+            EmitTestResult(::MemoryManager::FindArea(areas, VirtualPtr{ PageSize }) == nullptr, "Gap between areas isn't found");
+            EmitTestResult(::MemoryManager::FindArea(areas, VirtualPtr{ 300 * PageSize }) == &highArea, "Middle of a large area is found");
+        }
+
+        /**
+         * Ensure overlapping areas are rejected
+         */
+        void OverlapTest()
+        {
+            Containers::RedBlackTree areas;
+            auto existingArea = MakeArea(4, 4);
+            EmitTestResult(::MemoryManager::InsertArea(areas, existingArea), "Area added to empty tree");
+
+            auto overlapStart = MakeArea(2, 3);
+            auto overlapEnd = MakeArea(7, 2);
+            auto inside = MakeArea(5, 1);
+            auto surrounding = MakeArea(0, 16);
+            EmitTestResult(!::MemoryManager::InsertArea(areas, overlapStart) && !::MemoryManager::InsertArea(areas, overlapEnd), "Areas overlapping either end are rejected");
+            EmitTestResult(!::MemoryManager::InsertArea(areas, inside) && !::MemoryManager::InsertArea(areas, surrounding), "Areas inside or around another are rejected");
+
+            auto touchingBelow = MakeArea(2, 2);
+            auto touchingAbove = MakeArea(8, 1);
+            EmitTestResult(::MemoryManager::InsertArea(areas, touchingBelow) && ::MemoryManager::InsertArea(areas, touchingAbove), "Areas touching either end are added");
+
+            auto const* const pfirst = ::MemoryManager::GetFirstArea(areas);
+            auto const* const psecond = (pfirst == nullptr) ? nullptr : ::MemoryManager::GetNextArea(*pfirst);
+            auto const* const pthird = (psecond == nullptr) ? nullptr : ::MemoryManager::GetNextArea(*psecond);
+            EmitTestResult((pfirst == &touchingBelow) && (psecond == &existingArea) && (pthird == &touchingAbove) && (::MemoryManager::GetNextArea(*pthird) == nullptr), "Areas are walked in address order");
+        }
+
+        /**
+         * Ensure free ranges are found in the lowest gap that fits, with room for the guard on both sides
+         */
+        void FreeRangeTest()
+        {
+            Containers::RedBlackTree areas;
+            auto const rangeStart = VirtualPtr{ 16 * PageSize };
+            auto const rangeSize = 32 * PageSize;
+            VirtualPtr start;
+            EmitTestResult(::MemoryManager::FindFreeRange(areas, rangeStart, rangeSize, 4 * PageSize, PageSize, start) && (start == rangeStart), "Empty range is used from the start");
+            EmitTestResult(!::MemoryManager::FindFreeRange(areas, rangeStart, rangeSize, 33 * PageSize, PageSize, start), "Area bigger than the range doesn't fit");
+
+            auto belowRange = MakeArea(8, 8);
+            auto firstArea = MakeArea(16, 2);
+            auto secondArea = MakeArea(21, 4);
+            ::MemoryManager::InsertArea(areas, belowRange);
+            ::MemoryManager::InsertArea(areas, firstArea);
+            ::MemoryManager::InsertArea(areas, secondArea);
+
+            // Pages 18 to 20 are free, which only leaves one page once the guards on either side are taken out
+            EmitTestResult(::MemoryManager::FindFreeRange(areas, rangeStart, rangeSize, PageSize, PageSize, start) && (start == VirtualPtr{ 19 * PageSize }), "Small area fits between the guards");
+            EmitTestResult(::MemoryManager::FindFreeRange(areas, rangeStart, rangeSize, 3 * PageSize, PageSize, start) && (start == VirtualPtr{ 26 * PageSize }), "Area too big for the gap goes after the last area");
+            EmitTestResult(::MemoryManager::FindFreeRange(areas, rangeStart, rangeSize, 22 * PageSize, PageSize, start) && (start == VirtualPtr{ 26 * PageSize }), "Area exactly filling the rest of the range fits");
+            EmitTestResult(!::MemoryManager::FindFreeRange(areas, rangeStart, rangeSize, 23 * PageSize, PageSize, start), "Area past the end of the range doesn't fit");
+        }
+    }
+    // NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+
+    void Run()
+    {
+        FindTest();
+        OverlapTest();
+        FreeRangeTest();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,12 @@
+#ifndef KERNEL_UNITTESTS_VIRTUALMEMORYAREATESTS_H
+#define KERNEL_UNITTESTS_VIRTUALMEMORYAREATESTS_H
+
+namespace UnitTests::VirtualMemoryArea
+{
+    /**
+     * Run all runtime tests
+     */
+    void Run();
+}
+
+#endif // KERNEL_UNITTESTS_VIRTUALMEMORYAREATESTS_H
\ No newline at end of file
@@ -47,4 +47,21 @@ namespace Timing
 
         return static_cast<uint32_t>(frequency);
     }
+
+    uint64_t GetSystemCounterValue()
+    {
+        // Lint check here is wrong, because it doesn't understand the asm output directive
+        // NOLINTNEXTLINE(misc-const-correctness)
+        uint64_t value = 0;
+
+        // NOLINTNEXTLINE(hicpp-no-assembler)
+        asm volatile("isb\n" // make sure the read isn't done early
+            "mrs %0, CNTPCT_EL0"
+            :"=r"(value) // output
+            : // no inputs
+            : // no clobbered registers
+        );
+
+        return value;
+    }
 }
\ No newline at end of file
@@ -41,6 +41,14 @@ namespace Timing
      * @return The current clock frequency in Hz
      */
     uint32_t GetSystemCounterClockFrequencyHz();
+
+    /**
+     * Obtain the current value of the system counter, which ticks at GetSystemCounterClockFrequencyHz and is shared by
+     * all cores
+     * 
+     * @return The current counter value
+     */
+    uint64_t GetSystemCounterValue();
 }
 
 /**
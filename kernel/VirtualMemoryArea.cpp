@@ -0,0 +1,109 @@
+#include "VirtualMemoryArea.h"
+
+namespace MemoryManager
+{
+    namespace
+    {
+        /**
+         * Converts a tree node back into the area it is part of
+         * 
+         * @param apNode The node (may be null)
+         * @return The area, or null if the node was null
+         */
+        VirtualMemoryArea* ToArea(Containers::RedBlackNode* const apNode)
+        {
+            return static_cast<VirtualMemoryArea*>(apNode);
+        }
+    }
+
+    VirtualMemoryArea* FindArea(Containers::RedBlackTree const& aAreas, VirtualPtr const aAddress)
+    {
+        auto* pcurArea = ToArea(aAreas.GetRoot());
+        while (pcurArea != nullptr)
+        {
+            if (aAddress < pcurArea->Start)
+            {
+                pcurArea = ToArea(pcurArea->pLeft);
+            }
+            else if (pcurArea->Contains(aAddress))
+            {
+                return pcurArea;
+            }
+            else
+            {
+                pcurArea = ToArea(pcurArea->pRight);
+            }
+        }
+        return nullptr;
+    }
+
+    bool InsertArea(Containers::RedBlackTree& arAreas, VirtualMemoryArea& arArea)
+    {
+        Containers::RedBlackNode* pparent = nullptr;
+        auto leftChild = false;
+        auto* pcurArea = ToArea(arAreas.GetRoot());
+        while (pcurArea != nullptr)
+        {
+            pparent = pcurArea;
+            // Areas don't overlap, so if the new one doesn't fit entirely on one side of this one, it overlaps it
+            if ((arArea.Start < pcurArea->Start) && ((pcurArea->Start.GetAddress() - arArea.Start.GetAddress()) >= arArea.Length))
+            {
+                leftChild = true;
+                pcurArea = ToArea(pcurArea->pLeft);
+            }
+            else if ((arArea.Start >= pcurArea->Start) && !pcurArea->Contains(arArea.Start))
+            {
+                leftChild = false;
+                pcurArea = ToArea(pcurArea->pRight);
+            }
+            else
+            {
+                return false;
+            }
+        }
+        arAreas.Insert(arArea, pparent, leftChild);
+        return true;
+    }
+
+    VirtualMemoryArea* GetFirstArea(Containers::RedBlackTree const& aAreas)
+    {
+        return ToArea(aAreas.GetFirst());
+    }
+
+    VirtualMemoryArea* GetNextArea(VirtualMemoryArea const& aArea)
+    {
+        return ToArea(Containers::RedBlackTree::GetNext(aArea));
+    }
+
+    bool FindFreeRange(Containers::RedBlackTree const& aAreas, VirtualPtr const aRangeStart, size_t const aRangeSize,
+        size_t const aSize, size_t const aGuardSize, VirtualPtr& arStart)
+    {
+        // Offsets from the start of the range, so a range at the top of the address space doesn't overflow
+        auto candidate = size_t{ 0 };
+        for (auto const* pcurArea = GetFirstArea(aAreas); pcurArea != nullptr; pcurArea = GetNextArea(*pcurArea))
+        {
+            if (pcurArea->Start < aRangeStart)
+            {
+                continue;
+            }
+            auto const areaOffset = pcurArea->Start.GetAddress() - aRangeStart.GetAddress();
+            if (areaOffset >= aRangeSize)
+            {
+                break;
+            }
+            if ((areaOffset >= candidate) && ((areaOffset - candidate) >= (aSize + aGuardSize)))
+            {
+                break;
+            }
+            auto const afterArea = areaOffset + pcurArea->Length + aGuardSize;
+            candidate = (afterArea > candidate) ? afterArea : candidate;
+        }
+
+        if ((candidate > aRangeSize) || ((aRangeSize - candidate) < aSize))
+        {
+            return false;
+        }
+        arStart = aRangeStart.Offset(candidate);
+        return true;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,102 @@
+#ifndef KERNEL_VIRTUAL_MEMORY_AREA_H
+#define KERNEL_VIRTUAL_MEMORY_AREA_H
+
+#include <cstddef>
+#include <cstdint>
+#include "PointerTypes.h"
+#include "RedBlackTree.h"
+
+namespace MemoryManager
+{
+    // What user code is allowed to do with an area
+    namespace AreaProtection
+    {
+        constexpr uint8_t ReadC = 0x1;
+        constexpr uint8_t WriteC = 0x2;
+        constexpr uint8_t ExecuteC = 0x4; // #TODO: Not enforced until the page descriptors expose UXN
+    }
+
+    /**
+     * Where the pages of an area come from
+     */
+    enum class AreaBacking : uint8_t
+    {
+        Anonymous, // zeroed pages, allocated when first touched
+    };
+
+    /**
+     * A range of a task's address space that user code is allowed to touch. The areas only say what may be mapped -
+     * the page tables are the record of what actually is, so an area can be any size without costing anything until
+     * its pages are used. Areas never overlap, and are kept in a tree ordered by start address.
+     */
+    struct VirtualMemoryArea: Containers::RedBlackNode
+    {
+        VirtualPtr Start; // page aligned
+        size_t Length = 0; // in bytes, a multiple of the page size
+        uint8_t Protection = 0; // AreaProtection flags
+        AreaBacking Backing = AreaBacking::Anonymous;
+
+        /**
+         * Checks if an address is inside the area
+         * 
+         * @param aAddress The address to check
+         * @return True if the address is in the area
+         */
+        [[nodiscard]] bool Contains(VirtualPtr const aAddress) const
+        {
+            // done this way so an area at the top of the address space doesn't overflow
+            return (aAddress >= Start) && ((aAddress.GetAddress() - Start.GetAddress()) < Length);
+        }
+    };
+
+    /**
+     * Finds the area containing an address
+     * 
+     * @param aAreas The tree of areas to search
+     * @param aAddress The address to look up
+     * @return The area containing the address, or null if it isn't in any area
+     */
+    VirtualMemoryArea* FindArea(Containers::RedBlackTree const& aAreas, VirtualPtr aAddress);
+
+    /**
+     * Adds an area to the tree, unless it overlaps an area already there
+     * 
+     * @param arAreas The tree of areas to add to
+     * @param arArea The area to add (must not be in a tree already)
+     * @return True if the area was added, false if it overlaps another one
+     */
+    bool InsertArea(Containers::RedBlackTree& arAreas, VirtualMemoryArea& arArea);
+
+    /**
+     * Obtains the first area in address order
+     * 
+     * @param aAreas The tree of areas
+     * @return The lowest area, or null if there are none
+     */
+    VirtualMemoryArea* GetFirstArea(Containers::RedBlackTree const& aAreas);
+
+    /**
+     * Obtains the area after the given one in address order
+     * 
+     * @param aArea The area to start from
+     * @return The next area up, or null if this is the highest one
+     */
+    VirtualMemoryArea* GetNextArea(VirtualMemoryArea const& aArea);
+
+    /**
+     * Finds the lowest place in a range where a new area fits, keeping a guard gap between it and the areas on
+     * either side
+     * 
+     * @param aAreas The tree of areas
+     * @param aRangeStart The start of the range to look in
+     * @param aRangeSize The size of the range to look in
+     * @param aSize The size of the new area
+     * @param aGuardSize How much unused space to leave between areas
+     * @param arStart OUT: The start of the space found
+     * @return False if there isn't enough space anywhere in the range
+     */
+    bool FindFreeRange(Containers::RedBlackTree const& aAreas, VirtualPtr aRangeStart, size_t aRangeSize, size_t aSize,
+        size_t aGuardSize, VirtualPtr& arStart);
+}
+
+#endif // KERNEL_VIRTUAL_MEMORY_AREA_H
\ No newline at end of file
@@ -8,6 +8,8 @@ extern "C"
     void call_sys_write(const char* apString);
     int32_t call_sys_fork();
     void call_sys_exit();
+    int32_t call_sys_set_policy(uint32_t aPolicy, int64_t aPriority);
+    int32_t call_sys_set_deadline(uint32_t aRuntimeUS, uint32_t aPeriodUS);
 }
 
 namespace SystemCall
@@ -29,4 +31,16 @@ namespace SystemCall
     {
         call_sys_exit();
     }
+
+    __attribute__((section(".text.user")))
+    int32_t SetPolicy(SchedulingPolicy const aPolicy, int64_t const aPriority)
+    {
+        return call_sys_set_policy(static_cast<uint32_t>(aPolicy), aPriority);
+    }
+
+    __attribute__((section(".text.user")))
+    int32_t SetDeadline(uint32_t const aRuntimeUS, uint32_t const aPeriodUS)
+    {
+        return call_sys_set_deadline(aRuntimeUS, aPeriodUS);
+    }
 }
\ No newline at end of file
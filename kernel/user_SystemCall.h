@@ -2,9 +2,18 @@
 #define KERNEL_USER_SYSTEM_CALL_H
 
 #include <cstdint>
+#include "SystemCallDefines.h"
 
 namespace SystemCall
 {
+    enum class SchedulingPolicy : uint32_t
+    {
+        Fair = SCHED_POLICY_FAIR, // shares the CPU with other fair processes by nice level
+        Priority = SCHED_POLICY_PRIORITY, // runs ahead of fair processes, with longer time slices for higher priorities
+        Fifo = SCHED_POLICY_FIFO, // runs ahead of priority processes, highest priority first, until it gives up the CPU
+        RoundRobin = SCHED_POLICY_ROUND_ROBIN // as Fifo, but takes turns with processes of the same priority
+    };
+
     /**
      * Write a string to UART
      * 
@@ -23,6 +32,25 @@ namespace SystemCall
      * Exits the calling process
      */
     void Exit();
+
+    /**
+     * Moves the calling process to another scheduling class
+     * 
+     * @param aPolicy The class to move to
+     * @param aPriority The nice level for the fair class (-20 to 19), or the priority for the others (1 to 63)
+     * @return 0 if the process was moved, negative if the class or priority wasn't valid
+     */
+    int32_t SetPolicy(SchedulingPolicy aPolicy, int64_t aPriority);
+
+    /**
+     * Moves the calling process to the deadline scheduling class, which runs ahead of every other class, earliest
+     * deadline first. The process gets the runtime it reserves out of every period, but no more
+     * 
+     * @param aRuntimeUS The runtime to reserve each period, in microseconds
+     * @param aPeriodUS The length of each period (and so the deadline), in microseconds
+     * @return 0 if the process was moved, negative if the reservation was invalid or didn't fit on its CPU
+     */
+    int32_t SetDeadline(uint32_t aRuntimeUS, uint32_t aPeriodUS);
 }
 
 #endif // KERNEL_USER_SYSTEM_CALL_H
\ No newline at end of file
@@ -30,6 +30,17 @@ extern "C"
      */
     void* memset(void* apDest, int aChar, size_t aCount);
 
+    /**
+     * Compare two blocks of memory byte by byte
+     * 
+     * @param apLHS Left-hand memory to compare
+     * @param apRHS Right-hand memory to compare
+     * @param aCount Number of bytes to compare
+     * 
+     * @return 0 if they are equal, negative if the first differing byte is smaller in LHS, positive if it is larger
+     */
+    int memcmp(void const* apLHS, void const* apRHS, size_t aCount);
+
     /**
      * Compare two zero-terminated strings
      * 
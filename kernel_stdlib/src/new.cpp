@@ -1,13 +1,53 @@
 #include <new>
 
-// #TODO: Eventually need a real implementation. For now, we just need something for the linker to use
+#include <cstddef>
+#include <exception>
 
-void operator delete([[maybe_unused]] void* __apBlock) noexcept
+// Out of line so that there is only one instance
+std::nothrow_t const std::nothrow{}; // NOLINT(cert-dcl58-cpp)
+
+void* operator new(std::size_t const __aSize)
+{
+    auto* const pblock = __kernel_stdlib_allocate(__aSize);
+    if (pblock == nullptr)
+    {
+        // #TODO: Should throw std::bad_alloc once exceptions actually work
+        std::terminate();
+    }
+    return pblock;
+}
+
+void* operator new[](std::size_t const __aSize)
+{
+    return operator new(__aSize);
+}
+
+void* operator new(std::size_t const __aSize, std::nothrow_t const& /*__aTag*/) noexcept
+{
+    return __kernel_stdlib_allocate(__aSize);
+}
+
+void* operator new[](std::size_t const __aSize, std::nothrow_t const& /*__aTag*/) noexcept
+{
+    return __kernel_stdlib_allocate(__aSize);
+}
+
+void operator delete(void* const __apBlock) noexcept
+{
+    __kernel_stdlib_free(__apBlock);
+}
+
+void operator delete[](void* const __apBlock) noexcept
+{
+    __kernel_stdlib_free(__apBlock);
+}
+
+void operator delete(void* const __apBlock, std::size_t /*__aSize*/) noexcept
 {
-    // #TODO: Implement
+    __kernel_stdlib_free(__apBlock);
 }
 
-void operator delete[]([[maybe_unused]] void* __apBlock) noexcept
+void operator delete[](void* const __apBlock, std::size_t /*__aSize*/) noexcept
 {
-    // #TODO: Implement
+    __kernel_stdlib_free(__apBlock);
 }
\ No newline at end of file
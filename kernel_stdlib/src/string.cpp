@@ -23,6 +23,20 @@ extern "C"
         return apDest;
     }
 
+    int memcmp(void const* const apLHS, void const* const apRHS, size_t const aCount)
+    {
+        auto const plhsBytes = reinterpret_cast<unsigned char const*>(apLHS);
+        auto const prhsBytes = reinterpret_cast<unsigned char const*>(apRHS);
+        for (auto curByte = static_cast<size_t>(0u); curByte < aCount; ++curByte)
+        {
+            if (plhsBytes[curByte] != prhsBytes[curByte])
+            {
+                return static_cast<int>(plhsBytes[curByte]) - static_cast<int>(prhsBytes[curByte]);
+            }
+        }
+        return 0;
+    }
+
     int strcmp(char const* const apLHS, char const* const apRHS)
     {
         auto retVal = 0;